@@ -113,6 +113,12 @@ mcsCOMPL_STAT logExit(void);
  */
 mcsCOMPL_STAT logEnableThreadContext(void);
 
+/**
+ * Return whether the log context of the current thread is enabled
+ * \return mcsTRUE if the log context is enabled, mcsFALSE otherwise.
+ */
+mcsLOGICAL    logIsThreadContextEnabled(void);
+
 /**
  * Return the internal buffer of the log context
  * @return internal buffer of the log context or NULL if the log context is disabled.
@@ -1028,6 +1028,21 @@ mcsCOMPL_STAT logEnableThreadContext(void)
     return mcsFAILURE;
 }
 
+/**
+ * Return whether the log context of the current thread is enabled
+ * \return mcsTRUE if the log context is enabled, mcsFALSE otherwise.
+ */
+mcsLOGICAL logIsThreadContextEnabled(void)
+{
+    logTHREAD_CONTEXT *logContext = logGetThreadContext();
+
+    if (IS_NOT_NULL(logContext))
+    {
+        return logContext->enabled;
+    }
+    return mcsFALSE;
+}
+
 /**
  * Return the internal buffer of the log context and disable the log context
  * @return internal buffer of the log context or NULL if the log context is disabled.
@@ -97,6 +97,8 @@ typedef struct
     
     mcsUINT32   fileMode;           /* optional file operation mode (0=none, 1=load, 2=save) */
 
+    mcsLOGICAL  fileShared;         /* mcsTRUE if the FILE descriptor is owned by the caller (not closed) */
+
 } miscDYN_BUF;
 
 
@@ -211,6 +213,9 @@ mcsCOMPL_STAT miscDynBufSaveInASCIIFile     (miscDYN_BUF *dynBuf,
 mcsCOMPL_STAT miscDynBufSaveBufferedToFile  (miscDYN_BUF *dynBuf,
                                              const char        *fileName);
 
+mcsCOMPL_STAT miscDynBufSaveBufferedToStream(miscDYN_BUF *dynBuf,
+                                             FILE              *stream);
+
 mcsLOGICAL    miscDynBufIsSavingBuffer      (miscDYN_BUF *dynBuf);
 mcsCOMPL_STAT miscDynBufSaveBufferIfNeeded  (miscDYN_BUF *dynBuf);
 
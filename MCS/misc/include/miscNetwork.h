@@ -19,6 +19,12 @@ extern "C"
 #endif
 
 
+/*
+ * System Headers
+ */
+#include <time.h>
+
+
 /*
  * MCS Headers
  */
@@ -39,6 +45,8 @@ mcsCOMPL_STAT miscGetHostName(char *hostName, const mcsUINT32 length);
 mcsCOMPL_STAT miscGetHostByName(char *ipAddress, const char *hostName);
 mcsINT8       miscPerformHttpGet(const char *uri, miscDYN_BUF *outputBuffer, const mcsUINT32 timeout);
 mcsINT8       miscPerformHttpPost(const char *uri, const char *data, miscDYN_BUF *outputBuffer, const mcsUINT32 timeout);
+mcsINT8       miscPerformHttpPostWithDeadline(const char *uri, const char *data, miscDYN_BUF *outputBuffer,
+                                              const mcsUINT32 timeout, const time_t deadline);
 char *        miscUrlEncode(const char *str);
 char *        miscUrlDecode(const char *str);
 
@@ -718,11 +718,15 @@ void miscDynBufCloseFile(miscDYN_BUF *dynBuf)
 
             logTest("miscDynBufCloseFile: saved (%zu bytes)", dynBuf->fileStoredBytes);
         }
-        /* close file anyway */
-        fclose(dynBuf->fileDesc);
+        /* close file anyway (unless given by the caller) */
+        if (dynBuf->fileShared == mcsFALSE)
+        {
+            fclose(dynBuf->fileDesc);
+        }
 
         dynBuf->fileDesc = NULL;
         dynBuf->fileMode = FILE_MODE_NONE;
+        dynBuf->fileShared = mcsFALSE;
     }
     dynBuf->fileStoredBytes = 0;
     dynBuf->fileOffsetBytes = 0;
@@ -1999,6 +2003,8 @@ static mcsCOMPL_STAT miscDynBufWriteFileBlock(miscDYN_BUF *dynBuf, miscDynSIZE c
     /* Test if the Dynamic Buffer has been saved correctly */
     if (savedSize != bytesToWrite)
     {
+        /* reset mode to avoid flushing again while closing */
+        dynBuf->fileMode = FILE_MODE_NONE;
         miscDynBufCloseFile(dynBuf);
         return mcsFAILURE;
     }
@@ -2095,6 +2101,37 @@ mcsCOMPL_STAT miscDynBufSaveBufferedToFile(miscDYN_BUF *dynBuf,
     return mcsSUCCESS;
 }
 
+/**
+ * Save the Dynamic Buffer content by blocks in the given stream (already
+ * opened): the buffered content is written now and next blocks are written by
+ * miscDynBufSaveBufferIfNeeded() and miscDynBufCloseFile().
+ *
+ * @warning The given stream is not closed by miscDynBufCloseFile().
+ *
+ * @param dynBuf address of a Dynamic Buffer structure
+ * @param stream stream opened in 'write' mode
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is
+ * returned.
+ */
+mcsCOMPL_STAT miscDynBufSaveBufferedToStream(miscDYN_BUF *dynBuf,
+                                             FILE        *stream)
+{
+    FAIL_FALSE(miscDynBufIsInitialised(dynBuf));
+    FAIL_NULL(stream);
+
+    /* Ensure closing previous file */
+    miscDynBufCloseFile(dynBuf);
+
+    /* keep reference to FILE* until explicit miscDynBufCloseFile() */
+    dynBuf->fileDesc = stream;
+    dynBuf->fileMode = FILE_MODE_SAVE;
+    dynBuf->fileShared = mcsTRUE;
+
+    /* Save the buffered content (if any) */
+    return miscDynBufSaveBuffer(dynBuf);
+}
+
 mcsLOGICAL miscDynBufIsSavingBuffer(miscDYN_BUF *dynBuf)
 {
     if (miscDynBufIsInitialised(dynBuf) == mcsFALSE)
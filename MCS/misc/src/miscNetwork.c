@@ -27,6 +27,7 @@
 #include <netdb.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <time.h>
 
 
 /*
@@ -164,6 +165,29 @@ mcsCOMPL_STAT miscGetHostByName(char *ipAddress, const char *hostName)
  * @return 0 on successful completion. Otherwise the return code as 8-bits integer is returned.
  */
 mcsINT8 miscPerformHttpPost(const char *uri, const char *data, miscDYN_BUF *outputBuffer, const mcsUINT32 timeout)
+{
+    return miscPerformHttpPostWithDeadline(uri, data, outputBuffer, timeout, 0);
+}
+
+/**
+ * Perform the given request as an HTTP POST before the given deadline.
+ *
+ * Each try is limited to the given timeout and to the time left before the
+ * deadline; no retry is performed if the deadline would be exceeded.
+ *
+ * @param uri the HTTP request that should be performed
+ *   (eg. http://site.org/script.php?).
+ * @param data the POST data that should be performed
+ *   (eg. p1=v1&p2=v2).
+ * @param outputBuffer address of the receiving, already allocated dynamic buffer
+ * in which the query result will be stored.
+ * @param timeout maximum connection timeout (in seconds, 30 if 0 is given).
+ * @param deadline absolute deadline (see time()) or 0 if none.
+ *
+ * @return 0 on successful completion. Otherwise the return code as 8-bits integer is returned.
+ */
+mcsINT8 miscPerformHttpPostWithDeadline(const char *uri, const char *data, miscDYN_BUF *outputBuffer,
+                                        const mcsUINT32 timeout, const time_t deadline)
 {
     /* Test 'uri' parameter validity */
     if (uri == NULL)
@@ -189,10 +213,13 @@ mcsINT8 miscPerformHttpPost(const char *uri, const char *data, miscDYN_BUF *outp
     /* 30sec timeout, -s makes curl silent, -S reports errors, -L indicates HTTP location */
     mcsUINT32 internalTimeout = (timeout > 0 ? timeout : 30);
 
-    /* disable redirects with HTTP POST as not well supported (Violate RFC 2616/10.3.3 and switch from POST to GET) */
-    static const char* staticCommand = "/usr/bin/curl --max-redirs 0 --max-time %d --retry 3 -S -s -L \"%s\" -d \"%s\"";
+    /*
+     * disable redirects with HTTP POST as not well supported (Violate RFC 2616/10.3.3 and switch from POST to GET)
+     * curl retries (transient errors) are limited to the same timeout
+     */
+    static const char* staticCommand = "/usr/bin/curl --max-redirs 0 --max-time %d --retry 3 --retry-max-time %d -S -s -L \"%s\" -d \"%s\"";
 
-    int composedCommandLength = strlen(staticCommand) + strlen(uri) + strlen(data) + 10 + 1;
+    int composedCommandLength = strlen(staticCommand) + strlen(uri) + strlen(data) + 20 + 1;
 
     /* Forging the command */
     char* composedCommand = (char*) malloc(composedCommandLength * sizeof (char));
@@ -201,7 +228,6 @@ mcsINT8 miscPerformHttpPost(const char *uri, const char *data, miscDYN_BUF *outp
         errAdd(miscERR_ALLOC);
         return mcsFAILURE;
     }
-    snprintf(composedCommand, composedCommandLength, staticCommand, internalTimeout, uri, data);
 
     /* retry up to 3 times to avoid http errors */
     mcsINT8 executionStatus = mcsFAILURE;
@@ -216,12 +242,31 @@ mcsINT8 miscPerformHttpPost(const char *uri, const char *data, miscDYN_BUF *outp
         /* sleep 3 seconds before retrying query */
         if (tryCount != 0)
         {
+            /* do not retry if the deadline would be exceeded */
+            if ((deadline != 0) && (time(NULL) + waitDuration >= deadline))
+            {
+                logInfo("Deadline reached: no HTTP POST retry (exec status = %d)", executionStatus);
+                break;
+            }
             logInfo("Waiting %ds before retrying...", waitDuration);
             sleep(waitDuration);
             waitDuration *= 2;
             logInfo("Retrying HTTP POST (exec status = %d)", executionStatus);
         }
 
+        /* limit the try duration to the time left before the deadline */
+        mcsUINT32 tryTimeout = internalTimeout;
+        if (deadline != 0)
+        {
+            const time_t remaining = deadline - time(NULL);
+
+            if (remaining < (time_t) tryTimeout)
+            {
+                tryTimeout = (remaining > 1) ? (mcsUINT32) remaining : 1;
+            }
+        }
+        snprintf(composedCommand, composedCommandLength, staticCommand, tryTimeout, tryTimeout, uri, data);
+
         /* Executing the command */
         executionStatus = miscDynBufExecuteCommand(outputBuffer, composedCommand);
 
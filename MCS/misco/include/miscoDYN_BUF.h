@@ -90,6 +90,7 @@ public:
     mcsCOMPL_STAT SaveInASCIIFile        (const char       *fileName);
 
     mcsCOMPL_STAT SaveBufferedToFile     (const char       *fileName);
+    mcsCOMPL_STAT SaveBufferedToStream   (FILE             *stream);
     mcsLOGICAL    IsSavingBuffer         ();
     mcsCOMPL_STAT SaveBufferIfNeeded     ();
     mcsCOMPL_STAT CloseFile              ();
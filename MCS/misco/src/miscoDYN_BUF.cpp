@@ -229,6 +229,14 @@ mcsCOMPL_STAT miscoDYN_BUF::SaveBufferedToFile(const char *fileName)
     return miscDynBufSaveBufferedToFile(&_dynBuf, fileName);
 }
 
+/**
+ * @sa miscDynBufSaveBufferedToStream() documentation in the 'misc' module
+ */
+mcsCOMPL_STAT miscoDYN_BUF::SaveBufferedToStream(FILE *stream)
+{
+    return miscDynBufSaveBufferedToStream(&_dynBuf, stream);
+}
+
 mcsLOGICAL miscoDYN_BUF::IsSavingBuffer()
 {
     return miscDynBufIsSavingBuffer(&_dynBuf);
@@ -21,6 +21,14 @@
 #include "thrd.h"
 
 
+/*
+ * Constants definition
+ */
+
+/** Number of last messages kept for readers (ring buffer) */
+#define sdbENTRY_RING_SIZE 16
+
+
 /*
  * Class declaration
  */
@@ -30,6 +38,11 @@
  *
  * This class provides protected method to read and write a database entry; i.e.
  * includes mutual-exclusion mechanism for readind and writing operations.
+ *
+ * Readers waiting for a new message are woken up by the writer (condition
+ * variable). The last sdbENTRY_RING_SIZE messages are kept so that several
+ * readers, each using its own cursor (see ReadNext()), see every message.
+ * Clearing the entry also wakes up waiting readers (empty message).
  */
 class sdbENTRY
 {
@@ -43,7 +56,13 @@ public:
     mcsCOMPL_STAT  Write   (const char*     message);
     mcsCOMPL_STAT  Read    (mcsSTRING256*   message,
                                mcsLOGICAL   waitNewMessage = mcsFALSE,
-                               mcsINT32     timeoutInMs = -1);
+                               mcsINT32     timeoutInSec = -1);
+    mcsCOMPL_STAT  ReadNext(mcsSTRING256*   message,
+                            mcsUINT32*      cursor,
+                            mcsINT32        timeoutInSec = -1);
+    mcsCOMPL_STAT  Peek    (mcsSTRING256*   message,
+                            mcsUINT32*      nbWrites);
+    mcsCOMPL_STAT  Clear   (void);
 protected:
     
 private:
@@ -52,9 +71,14 @@ private:
     sdbENTRY(const sdbENTRY&);
     sdbENTRY& operator=(const sdbENTRY&);
 
+    mcsCOMPL_STAT  WaitWrite(mcsUINT32 nbWrites, mcsINT32 timeoutInSec);
+
     thrdMUTEX      _mutex;
-    mcsSTRING256   _buffer;
-    mcsLOGICAL     _isNewMessage;
+    pthread_cond_t _cond;
+    mcsSTRING256   _ring[sdbENTRY_RING_SIZE];
+    mcsUINT32      _nbWrites;
+    mcsUINT32      _nbReads;
+    mcsUINT32      _nbClears;
 };
 
 #endif /*!sdbENTRY_H*/
@@ -34,7 +34,15 @@ using namespace std;
 /*
  * System Headers 
  */
-#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+/*
+ * Local macros
+ */
+
+/** return the message of the given write number (ring buffer) */
+#define sdbENTRY_MESSAGE(nbWrites) _ring[((nbWrites) - 1) % sdbENTRY_RING_SIZE]
 
 /*
  * Static members definition 
@@ -47,9 +55,18 @@ using namespace std;
 sdbENTRY::sdbENTRY()
 {
     thrdMutexInit(&_mutex);
-    
-    _isNewMessage = mcsFALSE;
-    memset(_buffer, '\0', mcsLEN256);
+
+    // use the monotonic clock for timeouts:
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    _nbWrites = 0;
+    _nbReads = 0;
+    _nbClears = 0;
+    memset(_ring, '\0', sizeof (_ring));
 }
 
 /**
@@ -57,6 +74,7 @@ sdbENTRY::sdbENTRY()
  */
 sdbENTRY::~sdbENTRY()
 {
+    pthread_cond_destroy(&_cond);
     thrdMutexDestroy(&_mutex);
 }
 
@@ -66,7 +84,7 @@ sdbENTRY::~sdbENTRY()
  */
 
 /**
- * Write a new message in the entry.
+ * Write a new message in the entry and wake up waiting readers.
  *
  * @param message a null-terminated string.
  *
@@ -86,12 +104,16 @@ mcsCOMPL_STAT sdbENTRY::Write(const char* message)
         return mcsFAILURE;
     }
 
-    // Copy the new message to the internal buffer
-    strncpy(_buffer, message, mcsLEN256 - 1);
+    _nbWrites++;
+
+    // Copy the new message to the ring buffer
+    char* buffer = sdbENTRY_MESSAGE(_nbWrites);
+    strncpy(buffer, message, mcsLEN256 - 1);
+    buffer[mcsLEN256 - 1] = '\0';
 
-    logDebug("new message written('%s')", _buffer);
+    logDebug("new message written('%s')", buffer);
 
-    _isNewMessage = mcsTRUE;
+    pthread_cond_broadcast(&_cond);
 
     if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
     {
@@ -104,6 +126,9 @@ mcsCOMPL_STAT sdbENTRY::Write(const char* message)
 /**
  * Read a message from the entry.
  *
+ * This reader consumes the last message: intermediate messages written since
+ * the previous read are skipped (see ReadNext() to get every message).
+ *
  * @param message an already allocated buffer to return the entry content.
  * @param waitNewMessage if mcsTRUE wait for a new message to be posted,
  * otherwise return the current one.
@@ -123,84 +148,250 @@ mcsCOMPL_STAT sdbENTRY::Read(mcsSTRING256*     message,
         return mcsFAILURE;
     }
 
-    // Loop configuration
-    int period;     /* Number of usec the program is suspended */
-    int decrement;  /* Timer decremenent */
-    int remTime;    /* Remaining time (in usec) before timeout expiration */
-    
-    // Wait forever
-    if (timeoutInSec == -1)
+    // Lock data access
+    if (thrdMutexLock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    // Wait for a message not read yet
+    if ((waitNewMessage == mcsTRUE) && (WaitWrite(_nbReads, timeoutInSec) == mcsFAILURE))
+    {
+        thrdMutexUnlock(&_mutex);
+        return mcsFAILURE;
+    }
+
+    // Return the last message
+    if (_nbWrites == 0)
     {
-        remTime = 1000;
-        period = 100000; // 100 ms
-        decrement = 0;   // Remaining time will be never decremented
+        ((char*) message)[0] = '\0';
     }
-    // Given time-out
     else
     {
-        remTime = (timeoutInSec * 1000000);
-        period = 100000; // 100 ms
-        decrement = period;
+        strncpy((char*) message, sdbENTRY_MESSAGE(_nbWrites), mcsLEN256);
     }
+    _nbReads = _nbWrites;
 
-    // Loop
-    const bool isLogDebug = doLog(logDEBUG);
-    
-    mcsLOGICAL first = mcsTRUE;
-    mcsLOGICAL done = mcsFALSE;
-    while (done == mcsFALSE)
-    {            
-        // Lock data access
-        if (thrdMutexLock(&_mutex) == mcsFAILURE)
-        {
-            return mcsFAILURE;
-        }
-        
-        // If message has been changed
-        if ((waitNewMessage == mcsFALSE) || (_isNewMessage == mcsTRUE))
-        {
-            // Return it
-            strncpy((char*)message, _buffer, mcsLEN256 - 1); // ???
+    logDebug("new message read('%s')", message);
 
-            if (isLogDebug)
-            {
-                logDebug("new message read('%s')", message);
-            }
+    // Unlock data access
+    if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
 
-            _isNewMessage = mcsFALSE;
+    return mcsSUCCESS;
+}
 
-            done = mcsTRUE;
-        }
+/**
+ * Read the next message given by the reader cursor, waiting for it if needed.
+ *
+ * Each reader owns its cursor (number of messages already read, 0 initially)
+ * so that several readers see every message in order, without consuming
+ * messages for other readers. A reader late by more than sdbENTRY_RING_SIZE
+ * messages skips the oldest ones. If the entry is cleared meanwhile, an empty
+ * message is returned and the cursor is reset.
+ *
+ * @param message an already allocated buffer to return the next message.
+ * @param cursor reader cursor (updated).
+ * @param timeoutInSec if not -1, wait for a new message until the specified
+ * amount of seconds, otherwise wait forever.
+ *
+ * @return mcsSUCCESS or mcsFAILURE (timeout expired).
+ */
+mcsCOMPL_STAT sdbENTRY::ReadNext(mcsSTRING256*     message,
+                                 mcsUINT32*        cursor,
+                                 mcsINT32          timeoutInSec)
+{
+    // Check parameters
+    if (message == NULL)
+    {
+        errAdd(sdbERR_NULL_PARAM, "message");
+        return mcsFAILURE;
+    }
+    if (cursor == NULL)
+    {
+        errAdd(sdbERR_NULL_PARAM, "cursor");
+        return mcsFAILURE;
+    }
+
+    if (thrdMutexLock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    // entry cleared since the last read:
+    if (*cursor > _nbWrites)
+    {
+        *cursor = 0;
+    }
+
+    const mcsUINT32 nbClears = _nbClears;
+
+    if (WaitWrite(*cursor, timeoutInSec) == mcsFAILURE)
+    {
+        thrdMutexUnlock(&_mutex);
+        return mcsFAILURE;
+    }
+
+    // entry cleared while waiting:
+    if (_nbClears != nbClears)
+    {
+        *cursor = 0;
+        ((char*) message)[0] = '\0';
+
+        return thrdMutexUnlock(&_mutex);
+    }
+
+    // skip overwritten messages:
+    if (_nbWrites - *cursor > sdbENTRY_RING_SIZE)
+    {
+        *cursor = _nbWrites - sdbENTRY_RING_SIZE;
+    }
+    (*cursor)++;
+
+    strncpy((char*) message, sdbENTRY_MESSAGE(*cursor), mcsLEN256);
 
-        // Unlock data access
-        if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
+    if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Get the current message of the entry without consuming it.
+ *
+ * Unlike Read(), the new message flag is left unchanged so that other readers
+ * are not affected; the number of written messages allows the caller to
+ * detect changes.
+ *
+ * @param message an already allocated buffer to return the entry content.
+ * @param nbWrites number of messages written so far.
+ *
+ * @return mcsSUCCESS or mcsFAILURE.
+ */
+mcsCOMPL_STAT sdbENTRY::Peek(mcsSTRING256*     message,
+                             mcsUINT32*        nbWrites)
+{
+    // Check parameters
+    if (message == NULL)
+    {
+        errAdd(sdbERR_NULL_PARAM, "message");
+        return mcsFAILURE;
+    }
+    if (nbWrites == NULL)
+    {
+        errAdd(sdbERR_NULL_PARAM, "nbWrites");
+        return mcsFAILURE;
+    }
+
+    if (thrdMutexLock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    if (_nbWrites == 0)
+    {
+        ((char*) message)[0] = '\0';
+    }
+    else
+    {
+        strncpy((char*) message, sdbENTRY_MESSAGE(_nbWrites), mcsLEN256);
+    }
+    *nbWrites = _nbWrites;
+
+    if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Clear the entry (no message and no write) to reuse it for a new request
+ * and wake up waiting readers.
+ *
+ * @return mcsSUCCESS or mcsFAILURE.
+ */
+mcsCOMPL_STAT sdbENTRY::Clear(void)
+{
+    if (thrdMutexLock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    _nbWrites = 0;
+    _nbReads = 0;
+    _nbClears++;
+    memset(_ring, '\0', sizeof (_ring));
+
+    pthread_cond_broadcast(&_cond);
+
+    if (thrdMutexUnlock(&_mutex) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    return mcsSUCCESS;
+}
+
+
+/*
+ * Private methods
+ */
+
+/**
+ * Wait (within lock) until more than the given number of messages are written
+ * or the entry is cleared.
+ *
+ * @param nbWrites number of messages already seen by the reader.
+ * @param timeoutInSec if not -1, wait until the specified amount of seconds,
+ * otherwise wait forever.
+ *
+ * @return mcsSUCCESS or mcsFAILURE (timeout expired).
+ */
+mcsCOMPL_STAT sdbENTRY::WaitWrite(mcsUINT32 nbWrites, mcsINT32 timeoutInSec)
+{
+    if (_nbWrites != nbWrites)
+    {
+        return mcsSUCCESS;
+    }
+
+    const mcsUINT32 nbClears = _nbClears;
+
+    logDebug("waiting for new message");
+
+    if (timeoutInSec == -1)
+    {
+        while ((_nbWrites == nbWrites) && (_nbClears == nbClears))
         {
-            return mcsFAILURE;
+            pthread_cond_wait(&_cond, &_mutex);
         }
+        return mcsSUCCESS;
+    }
 
-        // Suspend process if no message was available
-        if (done == mcsFALSE)
-        {
-            // Check if time-out has expired
-            if (remTime <= 0)
-            {
-                errAdd(sdbERR_TIMEOUT_EXPIRED);
-                return mcsFAILURE;
-            }
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeoutInSec;
 
-            // Suspend process
-            if (isLogDebug && first == mcsTRUE)
+    while ((_nbWrites == nbWrites) && (_nbClears == nbClears))
+    {
+        if (pthread_cond_timedwait(&_cond, &_mutex, &deadline) == ETIMEDOUT)
+        {
+            if ((_nbWrites != nbWrites) || (_nbClears != nbClears))
             {
-                logDebug("waiting for new message (sleeping %dms before retry)", period / 1000);
-                first = mcsFALSE;
+                break;
             }
-            
-            usleep(period);
-            remTime -= decrement;
+            errAdd(sdbERR_TIMEOUT_EXPIRED);
+            return mcsFAILURE;
         }
     }
 
     return mcsSUCCESS;
 }
 
+
 /*___oOo___*/
@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <iostream>
 #include <unistd.h>
+#include <string.h>
+#include <stdio.h>
 
 
 /**
@@ -60,6 +62,148 @@ thrdFCT_RET myThreadFunction(thrdFCT_ARG param)
     return NULL;
 }
 
+/** number of messages written for the reader tests */
+#define NB_MESSAGES 10
+
+/* check that the reader gets every message in order */
+thrdFCT_RET myReaderFunction(thrdFCT_ARG param)
+{
+    sdbENTRY* entry = (sdbENTRY*) param;
+
+    mcsSTRING256 message, expected;
+    mcsUINT32 cursor = 0;
+
+    for (int i = 1; i <= NB_MESSAGES; i++)
+    {
+        if (entry->ReadNext(&message, &cursor, 5) == mcsFAILURE)
+        {
+            errCloseStack();
+            return (thrdFCT_RET) 1;
+        }
+        sprintf(expected, "message %d", i);
+        if ((strcmp(message, expected) != 0) || (cursor != (mcsUINT32) i))
+        {
+            cout << "Reader got '" << message << "' instead of '" << expected << "'." << endl;
+            return (thrdFCT_RET) 1;
+        }
+    }
+
+    return NULL;
+}
+
+/* wait for a message until the entry is cleared */
+thrdFCT_RET myClearedReaderFunction(thrdFCT_ARG param)
+{
+    sdbENTRY* entry = (sdbENTRY*) param;
+
+    mcsSTRING256 message;
+    mcsUINT32 cursor = 0;
+
+    if ((entry->ReadNext(&message, &cursor) == mcsFAILURE) || (message[0] != '\0') || (cursor != 0))
+    {
+        errCloseStack();
+        return (thrdFCT_RET) 1;
+    }
+
+    return NULL;
+}
+
+/* 
+ * Run the reader tests (silent unless a check fails)
+ */
+static mcsCOMPL_STAT myTestReaders(void)
+{
+    mcsSTRING256 message;
+    mcsUINT32 cursor;
+
+    // two readers each see every message
+    {
+        sdbENTRY entry;
+
+        thrdTHREAD_STRUCT reader1, reader2;
+        reader1.function  = myReaderFunction;
+        reader1.parameter = (thrdFCT_ARG) &entry;
+        reader2.function  = myReaderFunction;
+        reader2.parameter = (thrdFCT_ARG) &entry;
+
+        thrdThreadCreate(&reader1);
+        thrdThreadCreate(&reader2);
+
+        for (int i = 1; i <= NB_MESSAGES; i++)
+        {
+            sprintf(message, "message %d", i);
+            entry.Write(message);
+            usleep(1000);
+        }
+
+        thrdThreadWait(&reader1);
+        thrdThreadWait(&reader2);
+
+        if ((reader1.result != NULL) || (reader2.result != NULL))
+        {
+            cout << "Readers did not see every message." << endl;
+            return mcsFAILURE;
+        }
+    }
+
+    // a reader late by more than sdbENTRY_RING_SIZE messages skips the oldest ones
+    {
+        sdbENTRY entry;
+
+        for (int i = 1; i <= sdbENTRY_RING_SIZE + 4; i++)
+        {
+            sprintf(message, "message %d", i);
+            entry.Write(message);
+        }
+
+        cursor = 0;
+        if ((entry.ReadNext(&message, &cursor, 0) == mcsFAILURE) || (strcmp(message, "message 5") != 0) || (cursor != 5))
+        {
+            cout << "Late reader got '" << message << "' instead of 'message 5'." << endl;
+            return mcsFAILURE;
+        }
+
+        // timeout: no new message
+        cursor = sdbENTRY_RING_SIZE + 4;
+        if (entry.ReadNext(&message, &cursor, 1) == mcsSUCCESS)
+        {
+            cout << "Reader did not time out." << endl;
+            return mcsFAILURE;
+        }
+        errResetStack();
+
+        if (cursor != sdbENTRY_RING_SIZE + 4)
+        {
+            cout << "Reader cursor changed on timeout." << endl;
+            return mcsFAILURE;
+        }
+    }
+
+    // clearing the entry wakes up waiting readers
+    {
+        sdbENTRY entry;
+
+        thrdTHREAD_STRUCT reader;
+        reader.function  = myClearedReaderFunction;
+        reader.parameter = (thrdFCT_ARG) &entry;
+
+        thrdThreadCreate(&reader);
+        usleep(100000);
+
+        entry.Clear();
+
+        thrdThreadWait(&reader);
+
+        if (reader.result != NULL)
+        {
+            cout << "Reader not woken up by Clear()." << endl;
+            return mcsFAILURE;
+        }
+    }
+
+    return mcsSUCCESS;
+}
+
  
 
 /* 
@@ -84,6 +228,11 @@ int main(int argc, char *argv[])
 
     logSetStdoutLogLevel(logINFO);
 
+    if (myTestReaders() == mcsFAILURE)
+    {
+        exit (EXIT_FAILURE);
+    }
+
     {
         sdbENTRY entry;
 
@@ -98,7 +247,7 @@ int main(int argc, char *argv[])
         cout << "Reading message right away :" << endl;
         for (int i = 0; i < 5; i++)
         {
-            if (entry.Read(message) == mcsFAILURE)
+            if (entry.Read(&message) == mcsFAILURE)
             {
                 errCloseStack();
                 exit (EXIT_FAILURE);
@@ -111,7 +260,7 @@ int main(int argc, char *argv[])
         cout << "Reading message with a 1 second timeout :" << endl;
         for (int i = 0; i < 5; i++)
         {
-            if (entry.Read(message, mcsTRUE, 1000) == mcsFAILURE)
+            if (entry.Read(&message, mcsTRUE, 1000) == mcsFAILURE)
             {
                 cout << " Reader timed out." << endl;
             }
@@ -126,7 +275,7 @@ int main(int argc, char *argv[])
         cout << "Reading message without any timeout :" << endl;
         for (int i = 0; i < 3; i++)
         {
-            if (entry.Read(message, mcsTRUE) == mcsFAILURE)
+            if (entry.Read(&message, mcsTRUE) == mcsFAILURE)
             {
                 errCloseStack();
                 exit (EXIT_FAILURE);
@@ -16,6 +16,8 @@
 #include "thrdThreadFunctions.h"
 #include "thrdMutex.h"
 #include "thrdSemaphore.h"
+#include "thrdRateLimiter.h"
+#include "thrdPriorityGate.h"
  
 
 #endif /*!thrd_H*/
@@ -20,3 +20,7 @@
 #define thrdERR_MUTEX_NOT_INIT 9   /**<  The mutex has not been properly initialized. */
 #define thrdERR_MUTEX_LOCKED 8   /**<  The mutex is locked. */
 #define thrdERR_ERRNO 10   /**<  System call '%.100s' error : errno='%.100s' -&gt; '%.100s'. */
+#define thrdERR_RATE_LIMITER_FULL 11   /**<  Too many rate limiters (max %d): can not add host '%.100s'. */
+#define thrdERR_RATE_LIMITER_BUDGET 12   /**<  Invalid rate limiter budget for host '%.100s': rate=%lf burst=%d. */
+#define thrdERR_PRIORITY_GATE_FULL 13   /**<  Too many priority gates (max %d): can not add gate '%.100s'. */
+#define thrdERR_PRIORITY_GATE_SLOTS 14   /**<  Invalid priority gate '%.100s': %d slots with %d reserved slots. */
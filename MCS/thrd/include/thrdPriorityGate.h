@@ -0,0 +1,130 @@
+#ifndef thrdPRIORITY_GATE_H
+#define thrdPRIORITY_GATE_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Declaration of thrdPriorityGate functions.
+ */
+
+
+/* The following piece of code alternates the linkage type to C for all
+functions declared within the braces, which is necessary to use the
+functions in C++-code.
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * System header
+ */
+#include <pthread.h>
+
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+
+/*
+ * Constants definition
+ */
+/** Max number of priority gates */
+#define thrdPRIORITY_GATE_MAX   8
+
+
+/*
+ * Enumeration type definition
+ */
+
+/**
+ * Request priority classes (highest first)
+ */
+typedef enum
+{
+    thrdPRIORITY_INTERACTIVE = 0,   /**< interactive requests (GUI, one star) */
+    thrdPRIORITY_NORMAL,            /**< regular requests */
+    thrdPRIORITY_BATCH,             /**< batch work using idle capacity */
+    thrdNB_PRIORITIES
+} thrdPRIORITY;
+
+
+/*
+ * Structure type definition
+ */
+
+/**
+ * Priority gate: counting semaphore of a shared resource (threads, outbound
+ * connections, CPU) served by strict priority. Some slots are reserved to
+ * interactive requests so they never wait for batch work holding the others.
+ */
+typedef struct
+{
+    mcsSTRING32     name;                                   /**< gate name */
+    pthread_mutex_t mutex;                                  /**< mutex protecting the gate state */
+    pthread_cond_t  cond[thrdNB_PRIORITIES];                /**< signaled when a slot is available for the class */
+    mcsUINT32       nbSlots;                                /**< number of slots */
+    mcsUINT32       nbReserved;                             /**< number of slots reserved to interactive requests */
+    mcsUINT32       nbUsed;                                 /**< number of used slots */
+    mcsUINT32       nbWaiting[thrdNB_PRIORITIES];           /**< number of waiting callers */
+    /* statistics */
+    mcsUINT64       nbAcquired[thrdNB_PRIORITIES];          /**< number of acquired slots */
+    mcsUINT64       nbWaits[thrdNB_PRIORITIES];             /**< number of acquires that had to wait */
+    mcsUINT64       waitTime[thrdNB_PRIORITIES];            /**< total wait time (us) */
+    mcsUINT64       maxWaitTime[thrdNB_PRIORITIES];         /**< max wait time (us) */
+} thrdPRIORITY_GATE;
+
+/**
+ * Statistics of one priority gate
+ */
+typedef struct
+{
+    mcsSTRING32 name;                                       /**< gate name */
+    mcsUINT32   nbSlots;                                    /**< number of slots */
+    mcsUINT32   nbReserved;                                 /**< number of slots reserved to interactive requests */
+    mcsUINT32   nbUsed;                                     /**< number of used slots */
+    mcsUINT32   nbWaiting[thrdNB_PRIORITIES];               /**< number of waiting callers */
+    mcsUINT64   nbAcquired[thrdNB_PRIORITIES];              /**< number of acquired slots */
+    mcsUINT64   nbWaits[thrdNB_PRIORITIES];                 /**< number of acquires that had to wait */
+    mcsDOUBLE   waitTime[thrdNB_PRIORITIES];                /**< total wait time (ms) */
+    mcsDOUBLE   maxWaitTime[thrdNB_PRIORITIES];             /**< max wait time (ms) */
+} thrdPRIORITY_GATE_STATS;
+
+
+/*
+ * Public functions declaration
+ */
+thrdPRIORITY_GATE* thrdPriorityGateGet     (const char *name,
+                                            const mcsUINT32 nbSlots,
+                                            const mcsUINT32 nbReserved);
+
+mcsCOMPL_STAT      thrdPriorityGateAcquire (thrdPRIORITY_GATE *gate,
+                                            const thrdPRIORITY priority);
+
+mcsLOGICAL         thrdPriorityGateTryAcquire(thrdPRIORITY_GATE *gate,
+                                              const thrdPRIORITY priority);
+
+mcsCOMPL_STAT      thrdPriorityGateRelease (thrdPRIORITY_GATE *gate);
+
+mcsCOMPL_STAT      thrdPriorityGateGetStats(const mcsUINT32 index,
+                                            thrdPRIORITY_GATE_STATS *stats);
+
+void               thrdPrioritySet         (const thrdPRIORITY priority);
+
+thrdPRIORITY       thrdPriorityGet         (void);
+
+const char*        thrdPriorityGetName     (const thrdPRIORITY priority);
+
+#ifdef __cplusplus
+};
+#endif
+
+
+#endif /*!thrdPRIORITY_GATE_H*/
+
+/*___oOo___*/
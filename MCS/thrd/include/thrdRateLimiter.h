@@ -0,0 +1,100 @@
+#ifndef thrdRATE_LIMITER_H
+#define thrdRATE_LIMITER_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Declaration of thrdRateLimiter functions.
+ */
+
+
+/* The following piece of code alternates the linkage type to C for all
+functions declared within the braces, which is necessary to use the
+functions in C++-code.
+*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+
+/*
+ * Constants definition
+ */
+/** Max number of rate limiters (hosts) */
+#define thrdRATE_LIMITER_MAX    16
+
+
+/*
+ * Structure type definition
+ */
+
+/**
+ * Token bucket rate limiter of one host (generic cell rate algorithm):
+ * the bucket state is one theoretical arrival time updated by compare and
+ * swap, so callers reserve their slot without lock and are served in the
+ * reservation (FIFO) order.
+ */
+typedef struct
+{
+    mcsSTRING256       host;            /**< host name */
+    volatile mcsINT64  interval;        /**< emission interval (us) = 1 / rate */
+    volatile mcsINT64  tolerance;       /**< burst tolerance (us) = (burst - 1) x interval */
+    volatile mcsINT64  tat;             /**< theoretical arrival time (us) */
+    /* statistics */
+    volatile mcsUINT64 nbAcquired;      /**< number of acquired tokens */
+    volatile mcsUINT64 nbRejected;      /**< number of rejected try-acquire */
+    volatile mcsUINT64 nbWaits;         /**< number of acquires that had to wait */
+    volatile mcsUINT64 waitTime;        /**< total wait time (us) */
+    volatile mcsUINT64 maxWaitTime;     /**< max wait time (us) */
+} thrdRATE_LIMITER;
+
+/**
+ * Statistics of one rate limiter
+ */
+typedef struct
+{
+    mcsSTRING256 host;                  /**< host name */
+    mcsDOUBLE    rate;                  /**< budget (tokens per second) */
+    mcsUINT32    burst;                 /**< burst allowance (tokens) */
+    mcsUINT64    nbAcquired;            /**< number of acquired tokens */
+    mcsUINT64    nbRejected;            /**< number of rejected try-acquire */
+    mcsUINT64    nbWaits;               /**< number of acquires that had to wait */
+    mcsDOUBLE    waitTime;              /**< total wait time (ms) */
+    mcsDOUBLE    maxWaitTime;           /**< max wait time (ms) */
+} thrdRATE_LIMITER_STATS;
+
+
+/*
+ * Public functions declaration
+ */
+thrdRATE_LIMITER* thrdRateLimiterGet      (const char *url,
+                                           const mcsDOUBLE rate,
+                                           const mcsUINT32 burst);
+
+mcsCOMPL_STAT     thrdRateLimiterSetBudget(thrdRATE_LIMITER *limiter,
+                                           const mcsDOUBLE rate,
+                                           const mcsUINT32 burst);
+
+mcsCOMPL_STAT     thrdRateLimiterAcquire  (thrdRATE_LIMITER *limiter);
+
+mcsLOGICAL        thrdRateLimiterTryAcquire(thrdRATE_LIMITER *limiter);
+
+mcsCOMPL_STAT     thrdRateLimiterGetStats (const mcsUINT32 index,
+                                           thrdRATE_LIMITER_STATS *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+
+#endif /*!thrdRATE_LIMITER_H*/
+
+/*___oOo___*/
@@ -0,0 +1,483 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Priority gates shared by requests of different priority classes.
+ *
+ * A priority gate limits the number of concurrent users of one resource
+ * (worker threads, outbound HTTP connections, CPU) and serves waiting callers
+ * by strict priority:
+ * @li interactive requests may use all slots,
+ * @li normal and batch requests may not use the slots reserved to
+ * interactive requests,
+ * @li a caller never overtakes a waiting caller of a higher class.
+ *
+ * So batch work soaks up idle capacity but interactive requests get the next
+ * free slot (or a reserved one) whatever the batch backlog.
+ *
+ * The priority of the request served by the current thread is kept in thread
+ * local storage (see thrdPrioritySet) so lower layers use it without knowing
+ * the request.
+ *
+ * @n
+ * @ex
+ * @code
+ * #include "thrdPriorityGate.h"
+ *
+ * /# 8 concurrent queries, 2 reserved to interactive requests #/
+ * thrdPRIORITY_GATE* gate = thrdPriorityGateGet("http", 8, 2);
+ *
+ * if (thrdPriorityGateAcquire(gate, thrdPriorityGet()) == mcsSUCCESS)
+ * {
+ *     /# query the host #/
+ *     thrdPriorityGateRelease(gate);
+ * }
+ * @endcode
+ */
+
+/*
+ * System Headers
+ */
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "thrdPriorityGate.h"
+#include "thrdPrivate.h"
+#include "thrdErrors.h"
+
+
+/*
+ * Local Variables
+ */
+
+/** priority gates (never removed) */
+static thrdPRIORITY_GATE thrdPriorityGates[thrdPRIORITY_GATE_MAX];
+
+/** number of priority gates (published after initialization) */
+static volatile mcsUINT32 thrdNbPriorityGates = 0;
+
+/** mutex to register new priority gates */
+static pthread_mutex_t thrdPriorityGateMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** thread local storage key of the current priority */
+static pthread_key_t thrdPriorityKey;
+
+/** one-time initialization of the thread local storage key */
+static pthread_once_t thrdPriorityKeyOnce = PTHREAD_ONCE_INIT;
+
+/** priority class names */
+static const char* thrdPriorityNames[thrdNB_PRIORITIES] = {"interactive", "normal", "batch"};
+
+
+/*
+ * Local functions declaration
+ */
+static mcsINT64  thrdPriorityGateNow(void);
+static mcsUINT32 thrdPriorityGateGetLimit(const thrdPRIORITY_GATE *gate, const thrdPRIORITY priority);
+static mcsLOGICAL thrdPriorityGateIsAvailable(const thrdPRIORITY_GATE *gate, const thrdPRIORITY priority);
+static void      thrdPriorityGateSignal(thrdPRIORITY_GATE *gate);
+static void      thrdPriorityKeyInit(void);
+
+
+/*
+ * Public functions definition
+ */
+
+/**
+ * Return the priority gate of the given name.
+ *
+ * The priority gate is created with the given slots on first use; the slots
+ * of an existing priority gate are not modified.
+ *
+ * @param name gate name
+ * @param nbSlots number of slots (max concurrent users)
+ * @param nbReserved number of slots reserved to interactive requests (less
+ * than nbSlots)
+ *
+ * @return the priority gate or NULL if an error occurred.
+ */
+thrdPRIORITY_GATE* thrdPriorityGateGet(const char *name,
+                                       const mcsUINT32 nbSlots,
+                                       const mcsUINT32 nbReserved)
+{
+    /* Verify parameter validity */
+    if (name == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "name");
+        return NULL;
+    }
+    if ((nbSlots == 0) || (nbReserved >= nbSlots))
+    {
+        errAdd(thrdERR_PRIORITY_GATE_SLOTS, name, nbSlots, nbReserved);
+        return NULL;
+    }
+
+    thrdPRIORITY_GATE* gate = NULL;
+    mcsUINT32 i;
+
+    pthread_mutex_lock(&thrdPriorityGateMutex);
+
+    for (i = 0; i < thrdNbPriorityGates; i++)
+    {
+        if (strcmp(thrdPriorityGates[i].name, name) == 0)
+        {
+            gate = &thrdPriorityGates[i];
+            break;
+        }
+    }
+
+    if (gate == NULL)
+    {
+        if (thrdNbPriorityGates < thrdPRIORITY_GATE_MAX)
+        {
+            gate = &thrdPriorityGates[thrdNbPriorityGates];
+
+            memset(gate, 0, sizeof (thrdPRIORITY_GATE));
+            strncpy(gate->name, name, sizeof (gate->name) - 1);
+            gate->nbSlots    = nbSlots;
+            gate->nbReserved = nbReserved;
+
+            pthread_mutex_init(&gate->mutex, NULL);
+            for (i = 0; i < thrdNB_PRIORITIES; i++)
+            {
+                pthread_cond_init(&gate->cond[i], NULL);
+            }
+
+            logInfo("Priority gate[%s]: %u slots (%u reserved to interactive requests)", gate->name, nbSlots, nbReserved);
+
+            /* publish the new priority gate */
+            __sync_synchronize();
+            thrdNbPriorityGates++;
+        }
+        else
+        {
+            errAdd(thrdERR_PRIORITY_GATE_FULL, thrdPRIORITY_GATE_MAX, name);
+        }
+    }
+
+    pthread_mutex_unlock(&thrdPriorityGateMutex);
+
+    return gate;
+}
+
+/**
+ * Acquire one slot of the given priority gate: the caller waits until a slot
+ * is available for its priority class and no caller of a higher class is
+ * waiting.
+ *
+ * @param gate the priority gate
+ * @param priority priority class of the caller
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is
+ * returned.
+ */
+mcsCOMPL_STAT thrdPriorityGateAcquire(thrdPRIORITY_GATE *gate,
+                                      const thrdPRIORITY priority)
+{
+    /* Verify parameter validity */
+    if (gate == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "gate");
+        return mcsFAILURE;
+    }
+
+    const thrdPRIORITY p = ((mcsUINT32) priority < thrdNB_PRIORITIES) ? priority : thrdPRIORITY_NORMAL;
+
+    pthread_mutex_lock(&gate->mutex);
+
+    gate->nbAcquired[p]++;
+
+    if (thrdPriorityGateIsAvailable(gate, p) == mcsFALSE)
+    {
+        const mcsINT64 start = thrdPriorityGateNow();
+
+        gate->nbWaiting[p]++;
+
+        do
+        {
+            pthread_cond_wait(&gate->cond[p], &gate->mutex);
+        }
+        while (thrdPriorityGateIsAvailable(gate, p) == mcsFALSE);
+
+        gate->nbWaiting[p]--;
+
+        const mcsUINT64 wait = thrdPriorityGateNow() - start;
+
+        gate->nbWaits[p]++;
+        gate->waitTime[p] += wait;
+
+        if (wait > gate->maxWaitTime[p])
+        {
+            gate->maxWaitTime[p] = wait;
+        }
+
+        logDebug("Priority gate[%s]: %s wait %.1lf ms", gate->name, thrdPriorityNames[p], 1e-3 * wait);
+
+        gate->nbUsed++;
+
+        /* several slots may have been released: wake up the next waiting caller */
+        thrdPriorityGateSignal(gate);
+    }
+    else
+    {
+        gate->nbUsed++;
+    }
+
+    pthread_mutex_unlock(&gate->mutex);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Acquire one slot of the given priority gate only if it is available now
+ * (see thrdPriorityGateAcquire): the caller never waits.
+ *
+ * @param gate the priority gate
+ * @param priority priority class of the caller
+ *
+ * @return mcsTRUE if a slot was acquired (to release), mcsFALSE otherwise.
+ */
+mcsLOGICAL thrdPriorityGateTryAcquire(thrdPRIORITY_GATE *gate,
+                                      const thrdPRIORITY priority)
+{
+    if (gate == NULL)
+    {
+        return mcsFALSE;
+    }
+
+    const thrdPRIORITY p = ((mcsUINT32) priority < thrdNB_PRIORITIES) ? priority : thrdPRIORITY_NORMAL;
+
+    pthread_mutex_lock(&gate->mutex);
+
+    const mcsLOGICAL acquired = thrdPriorityGateIsAvailable(gate, p);
+
+    if (acquired == mcsTRUE)
+    {
+        gate->nbAcquired[p]++;
+        gate->nbUsed++;
+    }
+
+    pthread_mutex_unlock(&gate->mutex);
+
+    return acquired;
+}
+
+/**
+ * Release one slot of the given priority gate and wake up the highest
+ * priority waiting caller (if any can use the slot).
+ *
+ * @param gate the priority gate
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is
+ * returned.
+ */
+mcsCOMPL_STAT thrdPriorityGateRelease(thrdPRIORITY_GATE *gate)
+{
+    /* Verify parameter validity */
+    if (gate == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "gate");
+        return mcsFAILURE;
+    }
+
+    pthread_mutex_lock(&gate->mutex);
+
+    if (gate->nbUsed != 0)
+    {
+        gate->nbUsed--;
+    }
+
+    thrdPriorityGateSignal(gate);
+
+    pthread_mutex_unlock(&gate->mutex);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the statistics of the priority gate at the given index.
+ *
+ * @param index priority gate index (0 to N-1)
+ * @param stats statistics to fill
+ *
+ * @return mcsSUCCESS on successful completion or mcsFAILURE if there is no
+ * priority gate at the given index (no error added).
+ */
+mcsCOMPL_STAT thrdPriorityGateGetStats(const mcsUINT32 index,
+                                       thrdPRIORITY_GATE_STATS *stats)
+{
+    if ((stats == NULL) || (index >= thrdNbPriorityGates))
+    {
+        return mcsFAILURE;
+    }
+
+    thrdPRIORITY_GATE* gate = &thrdPriorityGates[index];
+
+    pthread_mutex_lock(&gate->mutex);
+
+    strcpy(stats->name, gate->name);
+    stats->nbSlots    = gate->nbSlots;
+    stats->nbReserved = gate->nbReserved;
+    stats->nbUsed     = gate->nbUsed;
+
+    mcsUINT32 p;
+    for (p = 0; p < thrdNB_PRIORITIES; p++)
+    {
+        stats->nbWaiting[p]   = gate->nbWaiting[p];
+        stats->nbAcquired[p]  = gate->nbAcquired[p];
+        stats->nbWaits[p]     = gate->nbWaits[p];
+        stats->waitTime[p]    = 1e-3 * gate->waitTime[p];
+        stats->maxWaitTime[p] = 1e-3 * gate->maxWaitTime[p];
+    }
+
+    pthread_mutex_unlock(&gate->mutex);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Define the priority class of the request served by the current thread.
+ *
+ * @param priority priority class
+ */
+void thrdPrioritySet(const thrdPRIORITY priority)
+{
+    pthread_once(&thrdPriorityKeyOnce, thrdPriorityKeyInit);
+
+    /* store priority + 1 as NULL means undefined */
+    pthread_setspecific(thrdPriorityKey, (void*) (long) (priority + 1));
+}
+
+/**
+ * Return the priority class of the request served by the current thread.
+ *
+ * @return priority class (thrdPRIORITY_NORMAL if undefined)
+ */
+thrdPRIORITY thrdPriorityGet(void)
+{
+    pthread_once(&thrdPriorityKeyOnce, thrdPriorityKeyInit);
+
+    const long value = (long) pthread_getspecific(thrdPriorityKey);
+
+    if ((value <= 0) || (value > thrdNB_PRIORITIES))
+    {
+        return thrdPRIORITY_NORMAL;
+    }
+    return (thrdPRIORITY) (value - 1);
+}
+
+/**
+ * Return the name of the given priority class.
+ *
+ * @param priority priority class
+ *
+ * @return priority class name ("interactive", "normal" or "batch")
+ */
+const char* thrdPriorityGetName(const thrdPRIORITY priority)
+{
+    if ((mcsUINT32) priority >= thrdNB_PRIORITIES)
+    {
+        return "undefined";
+    }
+    return thrdPriorityNames[priority];
+}
+
+
+/*
+ * Local functions definition
+ */
+
+/**
+ * Return the monotonic time (us).
+ * @return monotonic time (us)
+ */
+static mcsINT64 thrdPriorityGateNow(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000L + time.tv_nsec / 1000L;
+}
+
+/**
+ * Return the number of slots usable by the given priority class.
+ * @param gate the priority gate
+ * @param priority priority class
+ * @return number of usable slots
+ */
+static mcsUINT32 thrdPriorityGateGetLimit(const thrdPRIORITY_GATE *gate, const thrdPRIORITY priority)
+{
+    return (priority == thrdPRIORITY_INTERACTIVE) ? gate->nbSlots : gate->nbSlots - gate->nbReserved;
+}
+
+/**
+ * Return mcsTRUE if a slot is available for the given priority class: a free
+ * usable slot and no caller of a higher class waiting (gate mutex locked).
+ * @param gate the priority gate
+ * @param priority priority class
+ * @return mcsTRUE if a slot is available, mcsFALSE otherwise
+ */
+static mcsLOGICAL thrdPriorityGateIsAvailable(const thrdPRIORITY_GATE *gate, const thrdPRIORITY priority)
+{
+    if (gate->nbUsed >= thrdPriorityGateGetLimit(gate, priority))
+    {
+        return mcsFALSE;
+    }
+
+    mcsUINT32 p;
+    for (p = 0; p < (mcsUINT32) priority; p++)
+    {
+        if (gate->nbWaiting[p] != 0)
+        {
+            return mcsFALSE;
+        }
+    }
+    return mcsTRUE;
+}
+
+/**
+ * Wake up one caller of the highest waiting priority class if a slot is
+ * available for it (gate mutex locked); lower classes can not overtake it.
+ * @param gate the priority gate
+ */
+static void thrdPriorityGateSignal(thrdPRIORITY_GATE *gate)
+{
+    mcsUINT32 p;
+    for (p = 0; p < thrdNB_PRIORITIES; p++)
+    {
+        if (gate->nbWaiting[p] != 0)
+        {
+            if (gate->nbUsed < thrdPriorityGateGetLimit(gate, (thrdPRIORITY) p))
+            {
+                pthread_cond_signal(&gate->cond[p]);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Create the thread local storage key of the current priority (once).
+ */
+static void thrdPriorityKeyInit(void)
+{
+    pthread_key_create(&thrdPriorityKey, NULL); /* no destructor */
+}
+
+
+/*___oOo___*/
@@ -0,0 +1,367 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Token bucket rate limiters shared by all clients of one host.
+ *
+ * Each host has one rate limiter defined by its budget (rate in tokens per
+ * second and burst allowance). A token must be acquired before each query:
+ * @li thrdRateLimiterAcquire() reserves the next slot and waits for it,
+ * @li thrdRateLimiterTryAcquire() never waits and fails if no token is left.
+ *
+ * The bucket state is a single theoretical arrival time (generic cell rate
+ * algorithm) updated by compare and swap: no lock is held while waiting and
+ * waiting callers are served in their reservation (FIFO) order.
+ *
+ * @n
+ * @ex
+ * @code
+ * #include "thrdRateLimiter.h"
+ *
+ * /# 10 queries per second, burst of 5 queries #/
+ * thrdRATE_LIMITER* limiter = thrdRateLimiterGet("http://simbad.cds.unistra.fr/simbad/", 10.0, 5);
+ *
+ * if (thrdRateLimiterAcquire(limiter) == mcsSUCCESS)
+ * {
+ *     /# query the host #/
+ * }
+ * @endcode
+ */
+
+/*
+ * System Headers
+ */
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "thrdRateLimiter.h"
+#include "thrdPrivate.h"
+#include "thrdErrors.h"
+
+
+/*
+ * Local Variables
+ */
+
+/** rate limiters (never removed) */
+static thrdRATE_LIMITER thrdRateLimiters[thrdRATE_LIMITER_MAX];
+
+/** number of rate limiters (published after initialization) */
+static volatile mcsUINT32 thrdNbRateLimiters = 0;
+
+/** mutex to register new rate limiters */
+static pthread_mutex_t thrdRateLimiterMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*
+ * Local functions declaration
+ */
+static mcsINT64 thrdRateLimiterNow(void);
+static void     thrdRateLimiterSleep(mcsINT64 duration);
+static void     thrdRateLimiterGetHost(const char *url, mcsSTRING256 host);
+
+
+/*
+ * Public functions definition
+ */
+
+/**
+ * Return the rate limiter of the host of the given URL (or host name).
+ *
+ * The rate limiter is created with the given budget on first use; the budget
+ * of an existing rate limiter is not modified (see thrdRateLimiterSetBudget).
+ *
+ * @param url URL (scheme://host[:port]/path) or host name
+ * @param rate budget (tokens per second)
+ * @param burst burst allowance (max number of tokens acquired without waiting)
+ *
+ * @return the rate limiter or NULL if an error occurred.
+ */
+thrdRATE_LIMITER* thrdRateLimiterGet(const char *url,
+                                     const mcsDOUBLE rate,
+                                     const mcsUINT32 burst)
+{
+    /* Verify parameter validity */
+    if (url == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "url");
+        return NULL;
+    }
+
+    mcsSTRING256 host;
+    thrdRateLimiterGetHost(url, host);
+
+    if ((rate <= 0.0) || (burst == 0))
+    {
+        errAdd(thrdERR_RATE_LIMITER_BUDGET, host, rate, burst);
+        return NULL;
+    }
+
+    thrdRATE_LIMITER* limiter = NULL;
+    mcsUINT32 i;
+
+    pthread_mutex_lock(&thrdRateLimiterMutex);
+
+    for (i = 0; i < thrdNbRateLimiters; i++)
+    {
+        if (strcmp(thrdRateLimiters[i].host, host) == 0)
+        {
+            limiter = &thrdRateLimiters[i];
+            break;
+        }
+    }
+
+    if (limiter == NULL)
+    {
+        if (thrdNbRateLimiters < thrdRATE_LIMITER_MAX)
+        {
+            limiter = &thrdRateLimiters[thrdNbRateLimiters];
+
+            memset(limiter, 0, sizeof (thrdRATE_LIMITER));
+            strcpy(limiter->host, host);
+            thrdRateLimiterSetBudget(limiter, rate, burst);
+
+            logInfo("Rate limiter[%s]: %.1lf queries/s (burst %u)", host, rate, burst);
+
+            /* publish the new rate limiter */
+            __sync_synchronize();
+            thrdNbRateLimiters++;
+        }
+        else
+        {
+            errAdd(thrdERR_RATE_LIMITER_FULL, thrdRATE_LIMITER_MAX, host);
+        }
+    }
+
+    pthread_mutex_unlock(&thrdRateLimiterMutex);
+
+    return limiter;
+}
+
+/**
+ * Change the budget of the given rate limiter.
+ *
+ * @param limiter the rate limiter
+ * @param rate budget (tokens per second)
+ * @param burst burst allowance (max number of tokens acquired without waiting)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is
+ * returned.
+ */
+mcsCOMPL_STAT thrdRateLimiterSetBudget(thrdRATE_LIMITER *limiter,
+                                       const mcsDOUBLE rate,
+                                       const mcsUINT32 burst)
+{
+    /* Verify parameter validity */
+    if (limiter == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "limiter");
+        return mcsFAILURE;
+    }
+    if ((rate <= 0.0) || (burst == 0))
+    {
+        errAdd(thrdERR_RATE_LIMITER_BUDGET, limiter->host, rate, burst);
+        return mcsFAILURE;
+    }
+
+    const mcsINT64 interval = (mcsINT64) (1e6 / rate);
+
+    limiter->interval  = interval;
+    limiter->tolerance = (burst - 1) * interval;
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Acquire one token from the given rate limiter: the next slot is reserved
+ * and the caller waits (without lock) until it is reached.
+ *
+ * @param limiter the rate limiter
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is
+ * returned.
+ */
+mcsCOMPL_STAT thrdRateLimiterAcquire(thrdRATE_LIMITER *limiter)
+{
+    /* Verify parameter validity */
+    if (limiter == NULL)
+    {
+        errAdd(thrdERR_NULL_PARAM, "limiter");
+        return mcsFAILURE;
+    }
+
+    const mcsINT64 now = thrdRateLimiterNow();
+    mcsINT64 tat, newTat;
+
+    /* reserve the next slot */
+    do
+    {
+        tat = limiter->tat;
+        newTat = ((tat > now) ? tat : now) + limiter->interval;
+    }
+    while (__sync_val_compare_and_swap(&limiter->tat, tat, newTat) != tat);
+
+    __sync_fetch_and_add(&limiter->nbAcquired, 1);
+
+    /* wait until the reserved slot */
+    const mcsINT64 wait = tat - limiter->tolerance - now;
+
+    if (wait > 0)
+    {
+        __sync_fetch_and_add(&limiter->nbWaits, 1);
+        __sync_fetch_and_add(&limiter->waitTime, wait);
+
+        mcsUINT64 maxWait = limiter->maxWaitTime;
+        while (((mcsUINT64) wait > maxWait)
+               && (__sync_val_compare_and_swap(&limiter->maxWaitTime, maxWait, wait) != maxWait))
+        {
+            maxWait = limiter->maxWaitTime;
+        }
+
+        logDebug("Rate limiter[%s]: wait %.1lf ms", limiter->host, 1e-3 * wait);
+
+        thrdRateLimiterSleep(wait);
+    }
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Try to acquire one token from the given rate limiter without waiting.
+ *
+ * @param limiter the rate limiter
+ *
+ * @return mcsTRUE if a token was acquired, mcsFALSE otherwise (no token left
+ * or NULL limiter).
+ */
+mcsLOGICAL thrdRateLimiterTryAcquire(thrdRATE_LIMITER *limiter)
+{
+    if (limiter == NULL)
+    {
+        return mcsFALSE;
+    }
+
+    const mcsINT64 now = thrdRateLimiterNow();
+    mcsINT64 tat, newTat;
+
+    do
+    {
+        tat = limiter->tat;
+
+        if (tat - limiter->tolerance > now)
+        {
+            /* no token left */
+            __sync_fetch_and_add(&limiter->nbRejected, 1);
+            return mcsFALSE;
+        }
+        newTat = ((tat > now) ? tat : now) + limiter->interval;
+    }
+    while (__sync_val_compare_and_swap(&limiter->tat, tat, newTat) != tat);
+
+    __sync_fetch_and_add(&limiter->nbAcquired, 1);
+
+    return mcsTRUE;
+}
+
+/**
+ * Return the statistics of the rate limiter at the given index.
+ *
+ * @param index rate limiter index (0 to N-1)
+ * @param stats statistics to fill
+ *
+ * @return mcsSUCCESS on successful completion or mcsFAILURE if there is no
+ * rate limiter at the given index (no error added).
+ */
+mcsCOMPL_STAT thrdRateLimiterGetStats(const mcsUINT32 index,
+                                      thrdRATE_LIMITER_STATS *stats)
+{
+    if ((stats == NULL) || (index >= thrdNbRateLimiters))
+    {
+        return mcsFAILURE;
+    }
+
+    const thrdRATE_LIMITER* limiter = &thrdRateLimiters[index];
+
+    strcpy(stats->host, limiter->host);
+    stats->rate        = 1e6 / limiter->interval;
+    stats->burst       = 1 + limiter->tolerance / limiter->interval;
+    stats->nbAcquired  = limiter->nbAcquired;
+    stats->nbRejected  = limiter->nbRejected;
+    stats->nbWaits     = limiter->nbWaits;
+    stats->waitTime    = 1e-3 * limiter->waitTime;
+    stats->maxWaitTime = 1e-3 * limiter->maxWaitTime;
+
+    return mcsSUCCESS;
+}
+
+
+/*
+ * Local functions definition
+ */
+
+/**
+ * Return the monotonic time (us).
+ * @return monotonic time (us)
+ */
+static mcsINT64 thrdRateLimiterNow(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000L + time.tv_nsec / 1000L;
+}
+
+/**
+ * Sleep for the given duration (us), even if interrupted by signals.
+ * @param duration duration (us)
+ */
+static void thrdRateLimiterSleep(mcsINT64 duration)
+{
+    struct timespec request, remaining;
+
+    request.tv_sec  = duration / 1000000L;
+    request.tv_nsec = (duration % 1000000L) * 1000L;
+
+    while ((nanosleep(&request, &remaining) != 0) && (errno == EINTR))
+    {
+        request = remaining;
+    }
+}
+
+/**
+ * Extract the host name (without port) of the given URL (or host name).
+ * @param url URL or host name
+ * @param host host name
+ */
+static void thrdRateLimiterGetHost(const char *url, mcsSTRING256 host)
+{
+    const char* start = strstr(url, "://");
+    start = (start != NULL) ? start + 3 : url;
+
+    mcsUINT32 len = strcspn(start, ":/?");
+    if (len > mcsLEN256 - 1)
+    {
+        len = mcsLEN256 - 1;
+    }
+    memcpy(host, start, len);
+    host[len] = '\0';
+}
+
+
+/*___oOo___*/
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "thrdThreadFunctions.h"
+#include "thrdPriorityGate.h"
+
+
+/*
+ * Gloval variables
+ */
+thrdPRIORITY_GATE* myGate;
+
+/* order in which the waiting threads got their slot */
+thrdPRIORITY myOrder[2];
+volatile int myNbServed = 0;
+
+
+/*
+ * Local functions
+ */
+thrdFCT_RET myThreadFunction(thrdFCT_ARG param)
+{
+    thrdPRIORITY priority = (thrdPRIORITY) (long) param;
+
+    thrdPrioritySet(priority);
+
+    if (thrdPriorityGateAcquire(myGate, thrdPriorityGet()) == mcsFAILURE)
+    {
+        errCloseStack();
+        return NULL;
+    }
+
+    myOrder[__sync_fetch_and_add(&myNbServed, 1)] = priority;
+
+    usleep(50000);
+
+    thrdPriorityGateRelease(myGate);
+
+    return NULL;
+}
+
+
+/*
+ * Main
+ */
+int main (int argc, char *argv[])
+{
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit (EXIT_FAILURE);
+    }
+
+    logSetStdoutLogLevel(logINFO);
+
+    /* invalid slots */
+    if (thrdPriorityGateGet("invalid", 1, 1) != NULL)
+    {
+        printf("Invalid priority gate accepted\n");
+        exit(EXIT_FAILURE);
+    }
+    errResetStack();
+
+    /* 2 slots, 1 reserved to interactive requests */
+    myGate = thrdPriorityGateGet("test", 2, 1);
+    if (myGate == NULL)
+    {
+        errCloseStack();
+        exit(EXIT_FAILURE);
+    }
+
+    /* same name => same priority gate */
+    if (thrdPriorityGateGet("test", 4, 0) != myGate)
+    {
+        printf("Priority gate not shared by name\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* undefined thread priority */
+    if (thrdPriorityGet() != thrdPRIORITY_NORMAL)
+    {
+        printf("Undefined priority is not normal\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* normal request: takes the only slot usable by normal and batch requests */
+    thrdPriorityGateAcquire(myGate, thrdPRIORITY_NORMAL);
+
+    /* try: no slot left for batch requests, the reserved one for interactive requests */
+    if (thrdPriorityGateTryAcquire(myGate, thrdPRIORITY_BATCH) == mcsTRUE)
+    {
+        printf("Reserved slot acquired by a batch request\n");
+        exit(EXIT_FAILURE);
+    }
+    if (thrdPriorityGateTryAcquire(myGate, thrdPRIORITY_INTERACTIVE) == mcsFALSE)
+    {
+        printf("Reserved slot not acquired by an interactive request\n");
+        exit(EXIT_FAILURE);
+    }
+    thrdPriorityGateRelease(myGate);
+
+    /* batch then normal requests wait */
+    thrdTHREAD_STRUCT batchThread, normalThread;
+    batchThread.function   = myThreadFunction;
+    batchThread.parameter  = (thrdFCT_ARG) (long) thrdPRIORITY_BATCH;
+    thrdThreadCreate(&batchThread);
+
+    usleep(100000);
+
+    normalThread.function  = myThreadFunction;
+    normalThread.parameter = (thrdFCT_ARG) (long) thrdPRIORITY_NORMAL;
+    thrdThreadCreate(&normalThread);
+
+    usleep(100000);
+
+    /* interactive request: uses the reserved slot without waiting */
+    thrdPriorityGateAcquire(myGate, thrdPRIORITY_INTERACTIVE);
+    thrdPriorityGateRelease(myGate);
+
+    if (myNbServed != 0)
+    {
+        printf("Reserved slot used by a %s request\n", thrdPriorityGetName(myOrder[0]));
+        exit(EXIT_FAILURE);
+    }
+
+    /* release the slot: the normal request overtakes the batch one */
+    thrdPriorityGateRelease(myGate);
+
+    thrdThreadWait(&batchThread);
+    thrdThreadWait(&normalThread);
+
+    printf("Served: %s then %s\n", thrdPriorityGetName(myOrder[0]), thrdPriorityGetName(myOrder[1]));
+    if ((myNbServed != 2) || (myOrder[0] != thrdPRIORITY_NORMAL) || (myOrder[1] != thrdPRIORITY_BATCH))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    thrdPRIORITY_GATE_STATS stats;
+    if (thrdPriorityGateGetStats(0, &stats) == mcsSUCCESS)
+    {
+        int p;
+        for (p = 0; p < thrdNB_PRIORITIES; p++)
+        {
+            printf("Priority gate[%s]: %s: %lu acquired / %lu waits\n",
+                   stats.name, thrdPriorityGetName((thrdPRIORITY) p), stats.nbAcquired[p], stats.nbWaits[p]);
+        }
+        if ((stats.nbUsed != 0) || (stats.nbWaits[thrdPRIORITY_INTERACTIVE] != 0))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application with SUCCESS */
+    exit (EXIT_SUCCESS);
+}
+
+
+/*___oOo___*/
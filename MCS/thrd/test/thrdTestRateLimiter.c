@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "thrdThreadFunctions.h"
+#include "thrdRateLimiter.h"
+
+
+/*
+ * Gloval variables
+ */
+thrdRATE_LIMITER* myLimiter;
+
+
+/*
+ * Local functions
+ */
+thrdFCT_RET myThreadFunction(thrdFCT_ARG param)
+{
+    int i;
+
+    for (i = 0; i < 10; i++)
+    {
+        if (thrdRateLimiterAcquire(myLimiter) == mcsFAILURE)
+        {
+            errCloseStack();
+        }
+    }
+
+    return NULL;
+}
+
+static double now(void)
+{
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + 1e-6 * time.tv_usec;
+}
+
+
+/*
+ * Main
+ */
+int main (int argc, char *argv[])
+{
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit (EXIT_FAILURE);
+    }
+
+    logSetStdoutLogLevel(logINFO);
+
+    /* 50 tokens per second, burst of 5 tokens */
+    myLimiter = thrdRateLimiterGet("http://localhost:8080/test", 50.0, 5);
+    if (myLimiter == NULL)
+    {
+        errCloseStack();
+        exit(EXIT_FAILURE);
+    }
+
+    /* same host => same rate limiter */
+    if (thrdRateLimiterGet("localhost", 1.0, 1) != myLimiter)
+    {
+        printf("Rate limiter not shared by host\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* burst: 5 tokens then rejected */
+    int i, nbTokens = 0;
+    for (i = 0; i < 10; i++)
+    {
+        if (thrdRateLimiterTryAcquire(myLimiter) == mcsTRUE)
+        {
+            nbTokens++;
+        }
+    }
+    printf("Burst: %d tokens acquired\n", nbTokens);
+    if (nbTokens != 5)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* 2 threads x 10 tokens at 50 tokens per second: at least ~ 0.4s */
+    double start = now();
+
+    thrdTHREAD_STRUCT myThread;
+    myThread.function  = myThreadFunction;
+    myThread.parameter = NULL;
+    thrdThreadCreate(&myThread);
+
+    myThreadFunction(NULL);
+
+    thrdThreadWait(&myThread);
+
+    double elapsed = now() - start;
+    printf("20 tokens acquired in %.1lf s\n", elapsed);
+    /* never faster than the rate; the upper bound only detects stuck waiters (loaded hosts) */
+    if ((elapsed < 0.3) || (elapsed > 10.0))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    thrdRATE_LIMITER_STATS stats;
+    if (thrdRateLimiterGetStats(0, &stats) == mcsSUCCESS)
+    {
+        printf("Rate limiter[%s]: %.1lf/s burst %u: %lu acquired / %lu rejected / %lu waits\n",
+               stats.host, stats.rate, stats.burst, stats.nbAcquired, stats.nbRejected, stats.nbWaits);
+    }
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application with SUCCESS */
+    exit (EXIT_SUCCESS);
+}
+
+
+/*___oOo___*/
@@ -304,6 +304,14 @@ typedef struct
 
 } alxUNIFORM_DIAMETERS;
 
+/** Structure holding the status of a configuration table (see alxGetTableStatus) */
+typedef struct
+{
+    mcsSTRING64 name;     /** table file name */
+    mcsLOGICAL  loaded;   /** mcsTRUE if the table is loaded */
+    mcsDOUBLE   loadTime; /** load time (ms) */
+} alxTABLE_STATUS;
+
 /** convenience macro */
 #define alxIsDevFlag() \
     IS_TRUE(alxGetDevFlag())
@@ -337,6 +345,8 @@ void alxSedFittingInit(void);
 
 void alxInit(void);
 
+mcsCOMPL_STAT alxGetTableStatus(const mcsUINT32 index, alxTABLE_STATUS* status);
+
 mcsCOMPL_STAT alxInitializeSpectralType(alxSPECTRAL_TYPE* spectralType);
 
 void alxGiveIndexInTableOfSpectralCodes(alxSPECTRAL_TYPE spectralType,
@@ -373,6 +383,15 @@ mcsCOMPL_STAT alxComputeAngularDiameters(const char* msg,
                                          alxDIAMETERS_COVARIANCE diametersCov,
                                          logLEVEL logLevel);
 
+mcsCOMPL_STAT alxComputeAngularDiametersSampled(alxMAGNITUDES magnitudes,
+                                                mcsUINT32     idxMin,
+                                                mcsUINT32     idxMax,
+                                                mcsUINT32     nbRequiredDiameters,
+                                                alxDIAMETERS *diameters,
+                                                alxDATA      *weightedMeanDiams,
+                                                alxDATA      *chi2Diams,
+                                                mcsUINT32    *nbDiameters);
+
 void alxComputeDiameterRms(alxDIAMETERS diameters,
                            alxDATA     *meanDiam,
                            mcsUINT32    nbRequiredDiameters);
@@ -392,12 +411,26 @@ mcsCOMPL_STAT alxComputeGalacticCoordinates(mcsDOUBLE ra,
                                             mcsDOUBLE* gLat,
                                             mcsDOUBLE* gLon);
 
+mcsCOMPL_STAT alxComputeGalacticCoordinatesBatch(mcsUINT32 nbStars,
+                                                 const mcsDOUBLE* ra,
+                                                 const mcsDOUBLE* dec,
+                                                 mcsDOUBLE* gLat,
+                                                 mcsDOUBLE* gLon);
+
 mcsCOMPL_STAT alxComputeVisibility(mcsDOUBLE angDiam,
                                    mcsDOUBLE angDiamError,
                                    mcsDOUBLE baseMax,
                                    mcsDOUBLE wlen,
                                    alxVISIBILITIES* visibilities);
 
+mcsCOMPL_STAT alxComputeVisibilities(mcsUINT32 nbStars,
+                                     const mcsDOUBLE* angDiam,
+                                     const mcsDOUBLE* angDiamError,
+                                     mcsUINT32 nbSamples,
+                                     const mcsDOUBLE* baseline,
+                                     const mcsDOUBLE* wlen,
+                                     alxVISIBILITIES* visibilities);
+
 mcsCOMPL_STAT alxGetResearchAreaSize(mcsDOUBLE ra,
                                      mcsDOUBLE dec,
                                      mcsDOUBLE minMag,
@@ -426,6 +459,16 @@ mcsCOMPL_STAT alxComputeExtinctionCoefficient(mcsDOUBLE *Av,
                                               mcsDOUBLE gLat,
                                               mcsDOUBLE gLon);
 
+mcsCOMPL_STAT alxComputeExtinctionCoefficients(mcsUINT32 nbStars,
+                                               mcsDOUBLE *Av,
+                                               mcsDOUBLE *e_Av,
+                                               mcsDOUBLE *dist,
+                                               mcsDOUBLE *e_dist,
+                                               const mcsDOUBLE *plx,
+                                               const mcsDOUBLE *e_plx,
+                                               const mcsDOUBLE *gLat,
+                                               const mcsDOUBLE *gLon);
+
 mcsCOMPL_STAT alxComputeFluxesFromAkari09(mcsDOUBLE Teff,
                                           mcsDOUBLE *fnu_9,
                                           mcsDOUBLE *fnu_12,
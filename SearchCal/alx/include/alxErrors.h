@@ -24,3 +24,4 @@
 #define alxERR_NULL_PARAMETER 17   /**<  The given '%80s' parameter is NULL. */
 #define alxERR_DIFFJK_NOT_IN_TABLE 18   /**<  J-K differential magnitude (%.3lf) not found in color table '%80s' */
 #define alxERR_NO_LINE_FOUND 20   /**<  no line found, can't interpolate */
+#define alxERR_FILE_WRITE 21   /**<  Cannot write file '%.120s' */
@@ -13,6 +13,7 @@
  * General common includes
  */
 #include "math.h"
+#include <stddef.h>
 
 /* The following piece of code alternates the linkage type to C for all
 functions declared within the braces, which is necessary to use the
@@ -82,6 +83,22 @@ typedef struct
     mcsUINT32 firstLine; /** First line */
 } alxCOLOR_TABLE_INDEX;
 
+/*
+ * Sorted index of one color table column (blanking values ignored): values
+ * which exceed all values of previous lines (increasing) and their lines, so
+ * the first line whose value is greater or equal to a given one is found by
+ * binary search.
+ */
+typedef struct
+{
+    mcsUINT32 nbValues;
+    mcsDOUBLE value[alxNB_SPECTRAL_TYPES];
+    mcsUINT32 line [alxNB_SPECTRAL_TYPES];
+} alxCOLOR_TABLE_VALUE_INDEX;
+
+/* number of spectral type codes in the code map (char) */
+#define alxNB_CODES 256
+
 typedef struct
 {
     mcsLOGICAL           loaded;
@@ -95,6 +112,11 @@ typedef struct
     alxDATA              absMagError[alxNB_SPECTRAL_TYPES]; /* error on absolute magnitudes (any band) */
     mcsUINT32            absMagLineFirst; /* first line with absolute magnitudes (not blanking values) */
     mcsUINT32            absMagLineLast;  /* last  line with absolute magnitudes (not blanking values) */
+    /* lookup indexes (built once loaded) */
+    alxCOLOR_TABLE_VALUE_INDEX valueIndex[alxNB_COLOR_INDEXES]; /* sorted index per color */
+    mcsINT32             codeLineFirst[alxNB_CODES]; /* spectral type code -> first line (-1 if missing) */
+    mcsUINT32            codeLineEnd[alxNB_CODES];   /* spectral type code -> line after its lines */
+    mcsDOUBLE            quantityMax[alxNB_SPECTRAL_TYPES]; /* max quantity from the first line of the code */
 } alxCOLOR_TABLE;
 
 /*
@@ -211,8 +233,15 @@ typedef struct
     mcsDOUBLE  gLonMin[alxNB_MAX_LONGITUDE_STEPS];
     mcsDOUBLE  gLonMax[alxNB_MAX_LONGITUDE_STEPS];
     mcsDOUBLE  coeff[alxNB_MAX_LONGITUDE_STEPS][alxNB_POLYNOMIAL_COEFF_ABSORPTION];
+    mcsDOUBLE  gLonStep; /* longitude step if ranges are regular [i x step; (i + 1) x step[ or 0 */
 } alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION;
 
+/*
+ * Number of (baseline, wavelength) samples processed at once by
+ * alxComputeVisibilities()
+ */
+#define alxNB_VIS_SAMPLES_CHUNK 64
+
 /*
  * Structure containing the number of star according to the magnitude and the
  * galatic coordinates.
@@ -234,6 +263,71 @@ typedef struct
 
 alxEXTINCTION_RATIO_TABLE* alxGetExtinctionRatioTable(void);
 
+alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbsorption(void);
+
+mcsINT32 alxGetLineFromLongitude(alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial,
+                                 mcsDOUBLE gLon);
+
+alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE tableStarType);
+
+mcsINT32 alxGetLineFromSpectralType(alxCOLOR_TABLE *colorTable,
+                                    alxSPECTRAL_TYPE *spectralType,
+                                    mcsLOGICAL checkMissing);
+
+mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
+                             mcsDOUBLE diffMag,
+                             mcsINT32 diffMagId);
+
+/******** Table loading (once per table, thread-safe) */
+/** table loader: load the table (given argument) and return it, or NULL if an error occurred */
+typedef void* (*alxTABLE_LOADER)(void* arg);
+
+/*
+ * Table once-cell: the table is loaded by alxTableOnce() on first use.
+ */
+typedef struct
+{
+    const char*     name;       /** table file name */
+    alxTABLE_LOADER loader;     /** table loader */
+    void*           arg;        /** loader argument */
+    void* volatile  table;      /** loaded table (NULL until loaded) */
+    mcsLOGICAL      registered; /** mcsTRUE if registered (see alxGetTableStatus) */
+    mcsDOUBLE       loadTime;   /** load time (ms) */
+} alxTABLE_ONCE;
+
+void* alxTableOnce(alxTABLE_ONCE* once);
+
+/******** Embedded table images (built from loaded tables by alxTableDump) */
+/*
+ * Layout version of table images: increment it whenever any table structure
+ * changes (field order or types), even if its size is unchanged, so that
+ * outdated embedded images are ignored.
+ */
+#define alxTABLE_IMAGE_VERSION 1
+
+/*
+ * Table image: raw copy of a loaded table structure (except its header i.e.
+ * the loaded flag and file name(s) given by headerSize).
+ */
+typedef struct
+{
+    const char* fileName;   /** table file name */
+    mcsUINT32   version;    /** layout version (alxTABLE_IMAGE_VERSION) */
+    mcsUINT32   size;       /** size of the table structure */
+    mcsUINT32   headerSize; /** size of the header not copied (loaded flag, file names) */
+    const void* data;       /** table structure image */
+} alxTABLE_IMAGE;
+
+mcsLOGICAL alxTableImageLoad(const char* fileName, void* table,
+                             mcsUINT32 size, mcsUINT32 headerSize);
+
+void alxTableImageRegister(const char* fileName, const void* table,
+                           mcsUINT32 size, mcsUINT32 headerSize);
+
+mcsCOMPL_STAT alxTableImageDump(const char* sourceFile, const char* imageDir);
+
+void alxTableImageUseFiles(void);
+
 
 #ifdef __cplusplus
 }
@@ -19,6 +19,8 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
 
 
 /*
@@ -632,17 +634,160 @@ mcsDOUBLE alxComputePolynomial(mcsUINT32 len, mcsDOUBLE* coeffs, mcsDOUBLE* pows
     return p;
 }
 
+/** Maximum number of registered tables */
+#define alxMAX_TABLES 32
+
+/*
+ * To prevent concurrent table loading in multi-threaded context
+ * (recursive as a table loader may use other tables).
+ */
+static mcsMUTEX alxTableMutex = MCS_RECURSIVE_MUTEX_INITIALIZER;
+
+/** registered tables (in load order) */
+static alxTABLE_ONCE* alxTables[alxMAX_TABLES];
+static mcsUINT32 alxNbTables = 0;
+
+/** once control of the alx module initialization */
+static pthread_once_t alxInitOnce = PTHREAD_ONCE_INIT;
+
 /**
- * Initialize the alx module: preload all configuration tables
+ * Return the monotonic time (ms).
+ * @return monotonic time (ms)
  */
-void alxInit(void)
+static mcsDOUBLE alxGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return 1e3 * time.tv_sec + 1e-6 * time.tv_nsec;
+}
+
+/**
+ * Return the table of the given once-cell: the table is loaded by its loader
+ * on first use, only once whatever the number of concurrent threads (a failed
+ * load is retried on next use). The table is registered with its load time
+ * (see alxGetTableStatus).
+ *
+ * @param once table once-cell
+ *
+ * @return pointer onto the loaded table, or NULL if an error occurred.
+ */
+void* alxTableOnce(alxTABLE_ONCE* once)
 {
+    void* table = once->table;
+
+    /* fast path: table already loaded */
+    if (IS_NOT_NULL(table))
+    {
+        return table;
+    }
+
+    mcsMutexLock(&alxTableMutex);
+
+    if (IS_NULL(once->table))
+    {
+        if (IS_FALSE(once->registered) && (alxNbTables < alxMAX_TABLES))
+        {
+            alxTables[alxNbTables++] = once;
+            once->registered = mcsTRUE;
+        }
+
+        const mcsDOUBLE start = alxGetTime();
+
+        table = once->loader(once->arg);
+
+        once->loadTime = alxGetTime() - start;
+
+        if (IS_NOT_NULL(table))
+        {
+            /* publish the table only once completely loaded */
+            __sync_synchronize();
+            once->table = table;
+        }
+    }
+    table = once->table;
+
+    mcsMutexUnlock(&alxTableMutex);
+
+    return table;
+}
+
+/**
+ * Return the status of the registered table at the given index.
+ *
+ * @param index table index (starting from 0)
+ * @param status table status to fill
+ *
+ * @return mcsSUCCESS if the table exists. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxGetTableStatus(const mcsUINT32 index, alxTABLE_STATUS* status)
+{
+    mcsCOMPL_STAT result = mcsFAILURE;
+
+    mcsMutexLock(&alxTableMutex);
+
+    if (IS_NOT_NULL(status) && (index < alxNbTables))
+    {
+        const alxTABLE_ONCE* once = alxTables[index];
+
+        strncpy(status->name, once->name, sizeof (mcsSTRING64) - 1);
+        status->name[sizeof (mcsSTRING64) - 1] = '\0';
+        status->loaded   = IS_NOT_NULL(once->table) ? mcsTRUE : mcsFALSE;
+        status->loadTime = once->loadTime;
+
+        result = mcsSUCCESS;
+    }
+
+    mcsMutexUnlock(&alxTableMutex);
+
+    return result;
+}
+
+/**
+ * Preload all configuration tables (called once)
+ */
+static void alxInitTables(void)
+{
+    const mcsDOUBLE start = alxGetTime();
+
     alxAngularDiameterInit();
     alxMissingMagnitudeInit();
     alxInterstellarAbsorptionInit();
     alxResearchAreaInit();
     alxLD2UDInit();
     alxSedFittingInit();
+
+    const mcsDOUBLE elapsed = alxGetTime() - start;
+
+    /* Report table status */
+    alxTABLE_STATUS status;
+    mcsUINT32 i, nbLoaded = 0;
+
+    for (i = 0; alxGetTableStatus(i, &status) == mcsSUCCESS; i++)
+    {
+        if (IS_TRUE(status.loaded))
+        {
+            nbLoaded++;
+            logDebug("Table '%s' loaded in %.3lf ms", status.name, status.loadTime);
+        }
+        else
+        {
+            logWarning("Table '%s' not loaded", status.name);
+        }
+    }
+
+    logInfo("alx initialized: %u / %u tables loaded in %.1lf ms", nbLoaded, i, elapsed);
+}
+
+/**
+ * Initialize the alx module: preload all configuration tables.
+ *
+ * Tables are loaded once (thread-safe) by alxTableOnce(), even if used before
+ * alxInit() or concurrently. Preloading avoids the loading cost on the first
+ * requests.
+ */
+void alxInit(void)
+{
+    pthread_once(&alxInitOnce, alxInitTables);
 }
 
 /*___oOo___*/
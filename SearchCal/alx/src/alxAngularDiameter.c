@@ -104,7 +104,7 @@ void alxSetDeprecatedFlag(mcsLOGICAL flag)
  * @usedfiles alxAngDiamPolynomial.cfg : file containing the polynomial coefficients to compute the angular diameters.
  * @usedfiles alxAngDiamPolynomialCovariance.cfg : file containing the covariance between polynomial coefficients to compute the angular diameter error.
  */
-static alxPOLYNOMIAL_ANGULAR_DIAMETER *alxGetPolynomialForAngularDiameter(void)
+static void* alxLoadPolynomialForAngularDiameter(void* arg)
 {
     static alxPOLYNOMIAL_ANGULAR_DIAMETER polynomial = {mcsFALSE, "alxAngDiamPolynomial.cfg", "alxAngDiamPolynomialCovariance.cfg",
                                                         { 0},
@@ -121,6 +121,13 @@ static alxPOLYNOMIAL_ANGULAR_DIAMETER *alxGetPolynomialForAngularDiameter(void)
         return &polynomial;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(polynomial.fileName, &polynomial, sizeof (alxPOLYNOMIAL_ANGULAR_DIAMETER), offsetof(alxPOLYNOMIAL_ANGULAR_DIAMETER, nbCoeff))))
+    {
+        polynomial.loaded = mcsTRUE;
+        return &polynomial;
+    }
+
     /*
      * Build the dynamic buffer which will contain the coefficient file for angular diameter computation
      */
@@ -321,12 +328,28 @@ static alxPOLYNOMIAL_ANGULAR_DIAMETER *alxGetPolynomialForAngularDiameter(void)
     }
     free(fileName);
 
+    /* Register the table for table images */
+    alxTableImageRegister(polynomial.fileName, &polynomial, sizeof (alxPOLYNOMIAL_ANGULAR_DIAMETER), offsetof(alxPOLYNOMIAL_ANGULAR_DIAMETER, nbCoeff));
+
     /* Specify that the polynomial has been loaded */
     polynomial.loaded = mcsTRUE;
 
     return &polynomial;
 }
 
+/** once-cell of the angular diameter polynomial coefficients */
+static alxTABLE_ONCE polynomialOnce = {"alxAngDiamPolynomial.cfg", alxLoadPolynomialForAngularDiameter, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the polynomial coefficients for angular diameter computation and their covariance matrix (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+static alxPOLYNOMIAL_ANGULAR_DIAMETER *alxGetPolynomialForAngularDiameter(void)
+{
+    return (alxPOLYNOMIAL_ANGULAR_DIAMETER*) alxTableOnce(&polynomialOnce);
+}
+
 /**
  * Compute am angular diameters for a given color-index based
  * on the coefficients from table. If a magnitude is not set,
@@ -626,6 +649,242 @@ mcsCOMPL_STAT alxComputeAngularDiameters(const char* msg,
     return mcsSUCCESS;
 }
 
+/**
+ * Compute stellar angular diameters and their weighted mean for all spectral
+ * type indexes in [idxMin .. idxMax] (spectral type uncertainty or faint stars).
+ *
+ * Gives the same results as alxComputeAngularDiameters() and
+ * alxComputeMeanAngularDiameter() called for every index, but magnitude terms
+ * (color coefficients, magnitude covariance terms) are computed once and the
+ * polynomials and their errors are evaluated for all indexes in one sweep.
+ *
+ * @param magnitudes B V R Ic J H K L M N (Johnson / 2MASS / WISE)
+ * @param idxMin first spectral type index
+ * @param idxMax last spectral type index
+ * @param nbRequiredDiameters minimum number of valid diameters
+ * @param diameters the computed diameters [idxMax - idxMin + 1]
+ * @param weightedMeanDiams the weighted mean diameters [idxMax - idxMin + 1]
+ * @param chi2Diams the chi2 of the weighted mean diameters [idxMax - idxMin + 1]
+ * @param nbDiameters the number of valid diameters [idxMax - idxMin + 1]
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxComputeAngularDiametersSampled(alxMAGNITUDES magnitudes,
+                                                mcsUINT32     idxMin,
+                                                mcsUINT32     idxMax,
+                                                mcsUINT32     nbRequiredDiameters,
+                                                alxDIAMETERS *diameters,
+                                                alxDATA      *weightedMeanDiams,
+                                                alxDATA      *chi2Diams,
+                                                mcsUINT32    *nbDiameters)
+{
+    FAIL_COND(idxMin > idxMax);
+
+    /* Get polynomial for diameter computation */
+    alxPOLYNOMIAL_ANGULAR_DIAMETER *polynomial;
+    polynomial = alxGetPolynomialForAngularDiameter();
+    FAIL_NULL(polynomial);
+
+    /* Get extinction ratio table CF */
+    alxEXTINCTION_RATIO_TABLE *extinctionRatioTable;
+    extinctionRatioTable = alxGetExtinctionRatioTable();
+    FAIL_NULL(extinctionRatioTable);
+
+    const mcsUINT32 nbSamples = idxMax - idxMin + 1;
+    const mcsUINT32 nbCoeffs = alxNB_POLYNOMIAL_COEFF_DIAMETER;
+
+    mcsUINT32 i, j, n, nI, nJ, nK, nL;
+    mcsUINT32 x, y;
+    mcsDOUBLE* row;
+    mcsDOUBLE coeff;
+
+    /* 1. magnitude terms (independent of the spectral type) */
+    const mcsDOUBLE *avCoeffs = extinctionRatioTable->coeff;
+    mcsDOUBLE cmI[alxNB_DIAMS];
+    mcsDOUBLE cmJ[alxNB_DIAMS];
+    mcsDOUBLE magTerm[alxNB_DIAMS];
+    mcsDOUBLE magErrTerm[alxNB_DIAMS];
+    mcsLOGICAL magSet[alxNB_DIAMS];
+    alxCONFIDENCE_INDEX magConfIndex[alxNB_DIAMS];
+    alxDATA mI, mJ;
+
+    for (i = 0; i < alxNB_DIAMS; i++)
+    {
+        nI = alxDIAM_BAND_A[i];
+        nJ = alxDIAM_BAND_B[i];
+
+        cmI[i] = avCoeffs[nI] / (avCoeffs[nI] - avCoeffs[nJ]);
+        cmJ[i] = avCoeffs[nJ] / (avCoeffs[nI] - avCoeffs[nJ]);
+
+        mI = magnitudes[nI];
+        mJ = magnitudes[nJ];
+
+        magSet[i] = (alxIsNotSet(mI) || alxIsNotSet(mJ)) ? mcsFALSE : mcsTRUE;
+        magTerm[i] = 0.2 * (cmJ[i] * mI.value - cmI[i] * mJ.value);
+        magErrTerm[i] = 0.04 * ( alxSquare(cmJ[i] * mI.error) + alxSquare(cmI[i] * mJ.error) );
+
+        magConfIndex[i] = (mI.confIndex <= mJ.confIndex) ? mI.confIndex : mJ.confIndex;
+        if ((mI.error <= 0.0) || (mJ.error <= 0.0))
+        {
+            magConfIndex[i] = alxCONFIDENCE_LOW;
+        }
+    }
+
+    /* term_M of the covariance matrix (see alxComputeAngularDiameters) */
+    mcsDOUBLE termM[alxNB_DIAMS][alxNB_DIAMS];
+
+    for (i = 0; i < alxNB_DIAMS; i++)
+    {
+        nI = alxDIAM_BAND_A[i];
+        nJ = alxDIAM_BAND_B[i];
+
+        const mcsDOUBLE varMI = alxSquare(magnitudes[nI].error);
+        const mcsDOUBLE varMJ = alxSquare(magnitudes[nJ].error);
+
+        for (j = 0; j <= i; j++)
+        {
+            nK = alxDIAM_BAND_A[j];
+            nL = alxDIAM_BAND_B[j];
+
+            if (nI == nK)
+            {
+                termM[i][j] = (nJ == nL) ? 0.04 * ( alxSquare(cmJ[i]) * varMI + alxSquare(cmI[i]) * varMJ )
+                        : 0.04 * ( cmJ[i] * cmJ[j] * varMI);
+            }
+            else if (nJ == nL)
+            {
+                termM[i][j] = 0.04 * ( cmI[i] * cmI[j] * varMJ );
+            }
+            else
+            {
+                termM[i][j] = 0.0;
+            }
+        }
+    }
+
+    /* 2. pows (sp)^[0..n] for all spectral type indexes */
+    mcsDOUBLE pows[nbCoeffs][nbSamples];
+    mcsDOUBLE sp[nbCoeffs];
+
+    for (n = 0; n < nbSamples; n++)
+    {
+        alxComputePows(nbCoeffs, (mcsDOUBLE) (idxMin + n), sp);
+
+        for (x = 0; x < nbCoeffs; x++)
+        {
+            pows[x][n] = sp[x];
+        }
+    }
+
+    /* 3. polynomials and their errors for all spectral type indexes (same summation order) */
+    mcsDOUBLE pIJ[nbSamples];
+    mcsDOUBLE termAn[nbSamples];
+
+    for (i = 0; i < alxNB_DIAMS; i++)
+    {
+        const mcsUINT32 nbDiamCoeffs = polynomial->nbCoeff[i];
+        const mcsUINT32 offsetIJ = i * alxNB_POLYNOMIAL_COEFF_DIAMETER;
+
+        if (IS_FALSE(magSet[i]))
+        {
+            for (n = 0; n < nbSamples; n++)
+            {
+                alxDATAClear(diameters[n][i]);
+            }
+            continue;
+        }
+
+        for (n = 0; n < nbSamples; n++)
+        {
+            pIJ[n] = 0.0;
+            termAn[n] = 0.0;
+        }
+        for (x = 0; x < nbDiamCoeffs; x++)
+        {
+            coeff = polynomial->coeff[i][x];
+
+            for (n = 0; n < nbSamples; n++)
+            {
+                pIJ[n] += coeff * pows[x][n];
+            }
+        }
+        for (x = 0; x < nbDiamCoeffs; x++)
+        {
+            row = polynomial->polynomCoefCovMatrix[offsetIJ + x];
+
+            for (y = 0; y < nbDiamCoeffs; y++)
+            {
+                coeff = row[offsetIJ + y];
+
+                for (n = 0; n < nbSamples; n++)
+                {
+                    termAn[n] += coeff * pows[x][n] * pows[y][n];
+                }
+            }
+        }
+        for (n = 0; n < nbSamples; n++)
+        {
+            alxDATA* diam = &diameters[n][i];
+
+            diam->value = alxPow10(pIJ[n] + magTerm[i]);
+            diam->error = absError(diam->value, sqrt(termAn[n] + magErrTerm[i]));
+            diam->confIndex = magConfIndex[i];
+            diam->isSet = mcsTRUE;
+        }
+    }
+
+    /* 4. covariance matrix and weighted mean diameter for each spectral type index */
+    alxDIAMETERS_COVARIANCE diametersCov;
+    mcsDOUBLE term_an;
+    mcsSTRING16 msg;
+
+    for (n = 0; n < nbSamples; n++)
+    {
+        for (i = 0; i < alxNB_DIAMS; i++)
+        {
+            if (isDiameterValid(diameters[n][i]))
+            {
+                for (j = 0; j <= i; j++)
+                {
+                    const mcsUINT32 offsetIJ = i * alxNB_POLYNOMIAL_COEFF_DIAMETER;
+                    const mcsUINT32 offsetKL = j * alxNB_POLYNOMIAL_COEFF_DIAMETER;
+                    term_an = 0.0;
+
+                    for (x = 0; x < nbCoeffs; x++)
+                    {
+                        row = polynomial->polynomCoefCovMatrix[offsetIJ + x];
+
+                        for (y = 0; y < nbCoeffs; y++)
+                        {
+                            term_an += row[offsetKL + y] * pows[x][n] * pows[y][n];
+                        }
+                    }
+                    diametersCov[i][j] = term_an + termM[i][j];
+                    diametersCov[j][i] = term_an + termM[i][j];
+                }
+            }
+            else
+            {
+                for (j = 0; j <= i; j++)
+                {
+                    diametersCov[j][i] = diametersCov[i][j] = NAN;
+                }
+            }
+        }
+
+        if (doLog(logDEBUG))
+        {
+            sprintf(msg, "SP=%u", idxMin + n);
+            alxLogAngularDiameters(msg, diameters[n], logDEBUG);
+        }
+
+        FAIL(alxComputeMeanAngularDiameter(diameters[n], diametersCov, nbRequiredDiameters, &weightedMeanDiams[n],
+                                           &chi2Diams[n], &nbDiameters[n], NULL, logDEBUG));
+    }
+
+    return mcsSUCCESS;
+}
+
 mcsCOMPL_STAT alxComputeMeanAngularDiameter(alxDIAMETERS diameters,
                                             alxDIAMETERS_COVARIANCE diametersCov,
                                             mcsUINT32    nbRequiredDiameters,
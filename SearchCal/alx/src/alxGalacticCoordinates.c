@@ -132,4 +132,56 @@ mcsCOMPL_STAT alxComputeGalacticCoordinates(mcsDOUBLE ra,
     return mcsSUCCESS;
 }
 
+/**
+ * Compute galactic coordinates (longitude and latitude) of several stars.
+ *
+ * Same computation as alxComputeGalacticCoordinates() on arrays: the galactic
+ * pole terms are computed once, the trigonometric terms of each star only
+ * once (cos(b) cancels in atan2) and no log is done per star.
+ *
+ * @param nbStars number of stars
+ * @param ra right ascensions J2000 in degree [nbStars]
+ * @param dec declinations J2000 in degree [nbStars]
+ * @param gLat galactic latitudes in degree in range [-90, 90] [nbStars]
+ * @param gLon galactic longitudes in degree in range [0, 360[ [nbStars]
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxComputeGalacticCoordinatesBatch(mcsUINT32 nbStars,
+                                                 const mcsDOUBLE* ra,
+                                                 const mcsDOUBLE* dec,
+                                                 mcsDOUBLE* gLat,
+                                                 mcsDOUBLE* gLon)
+{
+    /* galactic pole terms */
+    const mcsDOUBLE cosPole = cos(1.097288);
+    const mcsDOUBLE sinPole = sin(1.097288);
+
+    mcsUINT32 i;
+    mcsDOUBLE raRad, decRad, sinDec, cosDec, sinRa, cosRa, lon;
+
+    for (i = 0; i < nbStars; i++)
+    {
+        /* Convert ra/dec from degrees (decimal) to radians */
+        raRad  = ra[i] * alxDEG_IN_RAD - 4.936838;
+        decRad = dec[i] * alxDEG_IN_RAD;
+
+        sinDec = sin(decRad);
+        cosDec = cos(decRad);
+        sinRa  = sin(raRad);
+        cosRa  = cos(raRad);
+
+        /* asin() gives the galactic latitude in [-90, 90] */
+        gLat[i] = asin((sinDec * cosPole) - (cosDec * sinRa * sinPole)) * alxRAD_IN_DEG;
+
+        /* Calculate galactic longitude and convert it to degrees */
+        lon = fmod((atan2(cosDec * sinRa * cosPole + sinDec * sinPole, cosDec * cosRa) + 0.574737) * alxRAD_IN_DEG, 360.0);
+
+        /* if gLon has negative value => put it in positive value */
+        gLon[i] = (lon < 0.0) ? lon + 360.0 : lon;
+    }
+
+    return mcsSUCCESS;
+}
+
 /*___oOo___*/
@@ -41,11 +41,6 @@
 /* Rv coefficient = 3.1 */
 static mcsDOUBLE Rv = 3.10;
 
-/*
- * Local Functions declaration
- */
-static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbsorption(void);
-
 /*
  * Local functions definition
  */
@@ -60,14 +55,14 @@ static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbs
  * polynomial coefficients to compute the interstellar absorption.
  * The polynomial coefficients are given for each galactic longitude range
  */
-static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbsorption(void)
+static void* alxLoadPolynomialForInterstellarAbsorption(void* arg)
 {
     static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION polynomial = {mcsFALSE, "alxIntAbsPolynomial.cfg", 0,
         {0.0},
         {0.0},
         {
             {0.0}
-        }};
+        }, 0.0};
 
     /* Check if the structure is loaded into memory. If not load it. */
     if (IS_TRUE(polynomial.loaded))
@@ -75,6 +70,13 @@ static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbs
         return &polynomial;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(polynomial.fileName, &polynomial, sizeof (alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION), offsetof(alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION, nbLines))))
+    {
+        polynomial.loaded = mcsTRUE;
+        return &polynomial;
+    }
+
     /*
      * Build the dynamic buffer which will contain the file of coefficient
      * of angular diameter
@@ -147,11 +149,76 @@ static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbs
     free(fileName);
 
     polynomial.nbLines = lineNum;
+
+    /* Check if longitude ranges are regular [i x step; (i + 1) x step[ (direct lookup) */
+    polynomial.gLonStep = (lineNum > 0) ? polynomial.gLonMax[0] - polynomial.gLonMin[0] : 0.0;
+
+    for (lineNum = 0; lineNum < polynomial.nbLines; lineNum++)
+    {
+        if ((polynomial.gLonMin[lineNum] != lineNum * polynomial.gLonStep)
+                || (polynomial.gLonMax[lineNum] != (lineNum + 1) * polynomial.gLonStep))
+        {
+            logDebug("Irregular longitude ranges in %s", polynomial.fileName);
+            polynomial.gLonStep = 0.0;
+            break;
+        }
+    }
+
+    /* Register the table for table images */
+    alxTableImageRegister(polynomial.fileName, &polynomial, sizeof (alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION), offsetof(alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION, nbLines));
+
     polynomial.loaded = mcsTRUE;
 
     return &polynomial;
 }
 
+/** once-cell of the interstellar absorption polynomial coefficients */
+static alxTABLE_ONCE polynomialOnce = {"alxIntAbsPolynomial.cfg", alxLoadPolynomialForInterstellarAbsorption, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the polynomial coefficients for interstellar absorption computation (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbsorption(void)
+{
+    return (alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION*) alxTableOnce(&polynomialOnce);
+}
+
+/**
+ * Return the line of the polynomial table whose longitude range contains the
+ * given galactic longitude (direct lookup if ranges are regular).
+ *
+ * @param polynomial polynomial coefficients for interstellar absorption
+ * @param gLon galactic longitude value
+ *
+ * @return line number or alxNOT_FOUND
+ */
+mcsINT32 alxGetLineFromLongitude(alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial,
+                                 mcsDOUBLE gLon)
+{
+    mcsINT32 i, first = 0, last = polynomial->nbLines - 1;
+
+    if ((polynomial->gLonStep > 0.0) && (gLon >= 0.0) && (gLon < polynomial->nbLines * polynomial->gLonStep))
+    {
+        /* candidate line (and its neighbours for rounding issues) */
+        i = (mcsINT32) (gLon / polynomial->gLonStep);
+
+        first = (i > 0) ? i - 1 : 0;
+        last  = (i + 1 < polynomial->nbLines) ? i + 1 : polynomial->nbLines - 1;
+    }
+
+    for (i = first; i <= last; i++)
+    {
+        /* If longitude belongs to the range */
+        if ((gLon >= polynomial->gLonMin[i]) && (gLon < polynomial->gLonMax[i]))
+        {
+            return i;
+        }
+    }
+    return alxNOT_FOUND;
+}
+
 /**
  * Return the extinction ratio for interstellar absorption computation .
  *
@@ -161,7 +228,7 @@ static alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* alxGetPolynomialForInterstellarAbs
  * @usedfiles : alxExtinctionRatioTable.cfg : configuration file containing the
  * extinction ratio according to the color (i.e. magnitude band)
  */
-alxEXTINCTION_RATIO_TABLE* alxGetExtinctionRatioTable(void)
+static void* alxLoadExtinctionRatioTable(void* arg)
 {
     static alxEXTINCTION_RATIO_TABLE extinctionRatioTable = {mcsFALSE, "alxExtinctionRatioTable.cfg",
         {0.0},
@@ -173,6 +240,13 @@ alxEXTINCTION_RATIO_TABLE* alxGetExtinctionRatioTable(void)
         return &extinctionRatioTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(extinctionRatioTable.fileName, &extinctionRatioTable, sizeof (alxEXTINCTION_RATIO_TABLE), offsetof(alxEXTINCTION_RATIO_TABLE, rc))))
+    {
+        extinctionRatioTable.loaded = mcsTRUE;
+        return &extinctionRatioTable;
+    }
+
     /*
      * Reset all extinction ratio and coefficients (Rc/Rv)
      */
@@ -322,119 +396,184 @@ alxEXTINCTION_RATIO_TABLE* alxGetExtinctionRatioTable(void)
         logDebug("coeff[%d] = %.3lf", band, extinctionRatioTable.coeff[band]);
     }
 
+    /* Register the table for table images */
+    alxTableImageRegister(extinctionRatioTable.fileName, &extinctionRatioTable, sizeof (alxEXTINCTION_RATIO_TABLE), offsetof(alxEXTINCTION_RATIO_TABLE, rc));
+
     extinctionRatioTable.loaded = mcsTRUE;
 
     return &extinctionRatioTable;
 }
 
+/** once-cell of the extinction ratio table */
+static alxTABLE_ONCE extinctionRatioTableOnce = {"alxExtinctionRatioTable.cfg", alxLoadExtinctionRatioTable, NULL, NULL, mcsFALSE, 0.0};
+
 /**
- * Compute the extinction coefficient in V band (Av) according to the galactic
- * latitude, longitude and distance.
+ * Return the extinction ratio table for interstellar absorption computation (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+alxEXTINCTION_RATIO_TABLE* alxGetExtinctionRatioTable(void)
+{
+    return (alxEXTINCTION_RATIO_TABLE*) alxTableOnce(&extinctionRatioTableOnce);
+}
+
+/** minimum uncertainty on Av set to 0.1 */
+#define alxMIN_AV_ERROR 0.1
+
+/* ensure 0 < distance < 1 kpc */
+#define checkDistance(dist) \
+    ((dist > 0.0) && (dist < 1.0))
+
+/**
+ * Compute the nominal, min and max distances (kpc) from the given parallax.
+ *
+ * @param distances distance array(nominal, min, max) to compute
+ * @param dist distance (pc)
+ * @param e_dist error on distance (pc)
+ * @param plx parallax value (mas, not 0)
+ * @param e_plx error on parallax value
+ */
+static void alxGetDistancesFromParallax(mcsDOUBLE distances[3],
+                                        mcsDOUBLE *dist,
+                                        mcsDOUBLE *e_dist,
+                                        mcsDOUBLE plx,
+                                        mcsDOUBLE e_plx)
+{
+    mcsDOUBLE distance, error;
+    /*
+     * Compute distance and its error in parsecs
+     * dist = 1 / plx
+     * var(dist) = dist^4 x var(plx) = e_plx^2 / plx^4
+     */
+    *dist   = distance = 1000.0         / plx;            /* pc */
+    *e_dist = error    = 1000.0 * e_plx / alxSquare(plx); /* pc */
+
+    /* convert into kpc */
+    distance *= 1e-3;
+    error    *= 1e-3;
+
+    /* Compute distances (kpc) */
+    /* see CheckParallaxes(): plx > 1.0 for polynomial approximations ie distance < 1 kpc */
+    distances[0] = (checkDistance(distance)) ? distance : 0.0;
+    distances[1] = (checkDistance(distance - error)) ? (distance - error) : 0.0; /* min */
+    distances[2] = (checkDistance(distance + error)) ? (distance + error) : 1.0; /* max 1 kpc */
+}
+
+/**
+ * Compute the extinction coefficient in V band (Av) and its error from the
+ * given distances and galactic latitude.
  *
  * @param av extinction coefficient to compute
  * @param e_av error on extinction coefficient to compute
  * @param distances distance array(nominal, min, max)
  * @param gLat galactic latitude value
- * @param gLon galactic longitude value
- *
- * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ * @param coeffs polynomial coefficients of the galactic longitude (used if |gLat| < 10 deg)
+ * @param Avs Av for each distance (not computed if |gLat| >= 50 deg)
  */
-mcsCOMPL_STAT alxComputeExtinctionCoefficientFromDistances(mcsDOUBLE* Av,
-                                                           mcsDOUBLE* e_Av,
-                                                           mcsDOUBLE distances[3],
-                                                           mcsDOUBLE gLat,
-                                                           mcsDOUBLE gLon)
+static void alxComputeAvFromDistances(mcsDOUBLE* Av,
+                                      mcsDOUBLE* e_Av,
+                                      const mcsDOUBLE distances[3],
+                                      mcsDOUBLE gLat,
+                                      const mcsDOUBLE* coeffs,
+                                      mcsDOUBLE Avs[3])
 {
-    /** minimum uncertainty on Av set to 0.1 */
-    static mcsDOUBLE MIN_AV_ERROR = 0.1;
-
-    /*
-     * Compute the extinction coefficient in V band according to the galactic latitude.
-     */
+    mcsUINT32 n;
 
     /* If the latitude is greater than 50 degrees */
     if (fabs(gLat) >= 50.0)
     {
         /* Set extinction coefficient to 0 and error to 0.2 */
         *Av = 0.0;
-        *e_Av = MIN_AV_ERROR;
+        *e_Av = alxMIN_AV_ERROR;
+        return;
     }
-    else
+
+    /* If the latitude is between 10 and 50 degrees */
+    if (fabs(gLat) >= 10.0)
     {
-        mcsDOUBLE Avs[3];
-        mcsUINT32 n;
+        mcsDOUBLE ho = 0.120;
+        mcsDOUBLE tanGLat = fabs(tan(gLat * alxDEG_IN_RAD));
+        mcsDOUBLE sinGLat = fabs(sin(gLat * alxDEG_IN_RAD));
 
-        /* If the latitude is between 10 and 50 degrees */
-        if ((fabs(gLat) >= 10.0) && (fabs(gLat) < 50.0))
+        for (n = 0; n < 3; n++)
         {
-            mcsDOUBLE ho = 0.120;
-            mcsDOUBLE tanGLat = fabs(tan(gLat * alxDEG_IN_RAD));
-            mcsDOUBLE sinGLat = fabs(sin(gLat * alxDEG_IN_RAD));
-
-            for (n = 0; n < 3; n++)
-            {
-                /* ensure Av >= 0 */
-                Avs[n] = alxMax(0.0, (0.165 * (1.192 - tanGLat)) / sinGLat * (1.0 - exp(-distances[n] * sinGLat / ho)));
-            }
+            /* ensure Av >= 0 */
+            Avs[n] = alxMax(0.0, (0.165 * (1.192 - tanGLat)) / sinGLat * (1.0 - exp(-distances[n] * sinGLat / ho)));
         }
-        else
+    }
+    else
+    {
+        /* If the latitude is less than 10 degrees */
+        mcsDOUBLE distance;
+
+        for (n = 0; n < 3; n++)
         {
-            /* If the latitude is less than 10 degrees */
+            distance = distances[n];
+
+            /* ensure Av >= 0 */
+            Avs[n] = alxMax(0.0,
+                            coeffs[0] * distance
+                            + coeffs[1] * distance * distance
+                            + coeffs[2] * distance * distance * distance
+                            + coeffs[3] * distance * distance * distance * distance);
+        }
+    }
 
-            /* Get polynomial for interstellar extinction computation */
-            alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial;
-            polynomial = alxGetPolynomialForInterstellarAbsorption();
-            FAIL_NULL(polynomial);
+    *Av = Avs[0];
 
-            /* Find longitude in polynomial table */
-            mcsINT32 i = 0;
-            mcsLOGICAL found = mcsFALSE;
+    /* Uncertainty should encompass Avmin and Avmax (asymetric distribution)
+     * because distance = distance +/- 1 error_distance */
+    /* Fix minimum uncertainty on Av */
+    *e_Av = alxMax(alxMIN_AV_ERROR, alxMax(fabs(Avs[0] - Avs[1]), fabs(Avs[0] - Avs[2])));
+}
 
-            while (IS_FALSE(found) && (i < polynomial->nbLines))
-            {
-                /* If longitude belongs to the range */
-                if ((gLon >= polynomial->gLonMin[i]) && (gLon < polynomial->gLonMax[i]))
-                {
-                    /* Stop search */
-                    found = mcsTRUE;
-                }
-                    /* Else */
-                else
-                {
-                    /* Go to the next line */
-                    i++;
-                }
-            }
-            /* if not found add error */
-            FAIL_FALSE_DO(found, 
-                          errAdd(alxERR_LONGITUDE_NOT_FOUND, gLon));
+/**
+ * Compute the extinction coefficient in V band (Av) according to the galactic
+ * latitude, longitude and distance.
+ *
+ * @param av extinction coefficient to compute
+ * @param e_av error on extinction coefficient to compute
+ * @param distances distance array(nominal, min, max)
+ * @param gLat galactic latitude value
+ * @param gLon galactic longitude value
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxComputeExtinctionCoefficientFromDistances(mcsDOUBLE* Av,
+                                                           mcsDOUBLE* e_Av,
+                                                           mcsDOUBLE distances[3],
+                                                           mcsDOUBLE gLat,
+                                                           mcsDOUBLE gLon)
+{
+    const mcsDOUBLE* coeffs = NULL;
+    mcsDOUBLE Avs[3];
 
-            mcsDOUBLE* coeffs = polynomial->coeff[i];
-            mcsDOUBLE distance;
+    /* If the latitude is less than 10 degrees */
+    if (fabs(gLat) < 10.0)
+    {
+        /* Get polynomial for interstellar extinction computation */
+        alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial;
+        polynomial = alxGetPolynomialForInterstellarAbsorption();
+        FAIL_NULL(polynomial);
 
-            for (n = 0; n < 3; n++)
-            {
-                distance = distances[n];
-
-                /* ensure Av >= 0 */
-                Avs[n] = alxMax(0.0,
-                                coeffs[0] * distance
-                                + coeffs[1] * distance * distance
-                                + coeffs[2] * distance * distance * distance
-                                + coeffs[3] * distance * distance * distance * distance);
-            }
-        }
+        /* Find longitude in polynomial table */
+        mcsINT32 i = alxGetLineFromLongitude(polynomial, gLon);
 
-        *Av = Avs[0];
+        /* if not found add error */
+        FAIL_COND_DO((i == alxNOT_FOUND),
+                     errAdd(alxERR_LONGITUDE_NOT_FOUND, gLon));
 
-        /* Uncertainty should encompass Avmin and Avmax (asymetric distribution)
-         * because distance = distance +/- 1 error_distance */
-        *e_Av = alxMax(fabs(Avs[0] - Avs[1]), fabs(Avs[0] - Avs[2]));
+        coeffs = polynomial->coeff[i];
+    }
 
-        logDebug("AVs=%.3lf [%.3lf - %.3lf] err=%.4lf", Avs[0], Avs[1], Avs[2], *e_Av);
+    /*
+     * Compute the extinction coefficient in V band according to the galactic latitude.
+     */
+    alxComputeAvFromDistances(Av, e_Av, distances, gLat, coeffs, Avs);
 
-        /* Fix minimum uncertainty on Av */
-        *e_Av = alxMax(MIN_AV_ERROR, *e_Av);
+    if (fabs(gLat) < 50.0)
+    {
+        logDebug("AVs=%.3lf [%.3lf - %.3lf] err=%.4lf", Avs[0], Avs[1], Avs[2], *e_Av);
     }
 
     /* Display results */
@@ -474,31 +613,81 @@ mcsCOMPL_STAT alxComputeExtinctionCoefficient(mcsDOUBLE *Av,
     FAIL_COND_DO((plx == 0.0), 
                  errAdd(alxERR_INVALID_PARALAX_VALUE, plx));
 
-    mcsDOUBLE distance, error;
-    /*
-     * Compute distance and its error in parsecs
-     * dist = 1 / plx
-     * var(dist) = dist^4 x var(plx) = e_plx^2 / plx^4
-     */
-    *dist   = distance = 1000.0         / plx;            /* pc */
-    *e_dist = error    = 1000.0 * e_plx / alxSquare(plx); /* pc */
+    mcsDOUBLE distances[3];
+    alxGetDistancesFromParallax(distances, dist, e_dist, plx, e_plx);
 
-    /* convert into kpc */
-    distance *= 1e-3;
-    error    *= 1e-3;
+    return alxComputeExtinctionCoefficientFromDistances(Av, e_Av, distances, gLat, gLon);
+}
 
-    /* ensure 0 < distance < 1 kpc */
-#define checkDistance(dist) \
-    ((dist > 0.0) && (dist < 1.0))
+/**
+ * Compute the extinction coefficients in V band (Av) of several stars
+ * according to their parallax and galactic coordinates.
+ *
+ * The polynomial table is fetched once and the longitude lines are given by
+ * the longitude step of the table; no log is done per star. Stars with an
+ * invalid parallax (0) or a longitude out of the table get NaN values.
+ *
+ * @param nbStars number of stars
+ * @param Av extinction coefficients to compute [nbStars]
+ * @param e_Av errors on extinction coefficients to compute [nbStars]
+ * @param dist distances to compute (pc) [nbStars]
+ * @param e_dist errors on distances to compute (pc) [nbStars]
+ * @param plx parallax values [nbStars]
+ * @param e_plx errors on parallax values [nbStars]
+ * @param gLat galactic latitude values [nbStars]
+ * @param gLon galactic longitude values [nbStars]
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxComputeExtinctionCoefficients(mcsUINT32 nbStars,
+                                               mcsDOUBLE *Av,
+                                               mcsDOUBLE *e_Av,
+                                               mcsDOUBLE *dist,
+                                               mcsDOUBLE *e_dist,
+                                               const mcsDOUBLE *plx,
+                                               const mcsDOUBLE *e_plx,
+                                               const mcsDOUBLE *gLat,
+                                               const mcsDOUBLE *gLon)
+{
+    /* Get polynomial for interstellar extinction computation */
+    alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial;
+    polynomial = alxGetPolynomialForInterstellarAbsorption();
+    FAIL_NULL(polynomial);
 
-    /* Compute distances (kpc) */
-    /* see CheckParallaxes(): plx > 1.0 for polynomial approximations ie distance < 1 kpc */
-    mcsDOUBLE distances[3];
-    distances[0] = (checkDistance(distance)) ? distance : 0.0;
-    distances[1] = (checkDistance(distance - error)) ? (distance - error) : 0.0; /* min */
-    distances[2] = (checkDistance(distance + error)) ? (distance + error) : 1.0; /* max 1 kpc */
+    mcsUINT32 s;
+    mcsINT32 i;
+    mcsDOUBLE distances[3], Avs[3];
+    const mcsDOUBLE* coeffs;
 
-    return alxComputeExtinctionCoefficientFromDistances(Av, e_Av, distances, gLat, gLon);
+    for (s = 0; s < nbStars; s++)
+    {
+        if (plx[s] == 0.0)
+        {
+            Av[s] = e_Av[s] = dist[s] = e_dist[s] = NAN;
+            continue;
+        }
+
+        alxGetDistancesFromParallax(distances, &dist[s], &e_dist[s], plx[s], e_plx[s]);
+
+        coeffs = NULL;
+
+        if (fabs(gLat[s]) < 10.0)
+        {
+            /* Find longitude in polynomial table */
+            i = alxGetLineFromLongitude(polynomial, gLon[s]);
+
+            if (i == alxNOT_FOUND)
+            {
+                Av[s] = e_Av[s] = NAN;
+                continue;
+            }
+            coeffs = polynomial->coeff[i];
+        }
+
+        alxComputeAvFromDistances(&Av[s], &e_Av[s], distances, gLat[s], coeffs, Avs);
+    }
+
+    return mcsSUCCESS;
 }
 
 /**
@@ -59,7 +59,7 @@ mcsUINT32 alxGetLineForUd(alxUD_CORRECTION_TABLE *udTable,
  * Private functions definition
  */
 
-alxUD_CORRECTION_TABLE* alxGetUDTable()
+static void* alxLoadUDTable(void* arg)
 {
     static alxUD_CORRECTION_TABLE udTable = {mcsFALSE, "alxTableUDCoefficientCorrection.cfg", 0,
                                              {0.0},
@@ -74,6 +74,13 @@ alxUD_CORRECTION_TABLE* alxGetUDTable()
         return &udTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(udTable.fileName, &udTable, sizeof (alxUD_CORRECTION_TABLE), offsetof(alxUD_CORRECTION_TABLE, nbLines))))
+    {
+        udTable.loaded = mcsTRUE;
+        return &udTable;
+    }
+
     /* Find the location of the file */
     char* fileName = miscLocateFile(udTable.fileName);
     if (IS_NULL(fileName))
@@ -150,6 +157,9 @@ alxUD_CORRECTION_TABLE* alxGetUDTable()
     /* Set the total number of lines in the ud table */
     udTable.nbLines = lineNum;
 
+    /* Register the table for table images */
+    alxTableImageRegister(udTable.fileName, &udTable, sizeof (alxUD_CORRECTION_TABLE), offsetof(alxUD_CORRECTION_TABLE, nbLines));
+
     /* Mark the ud table as "loaded" */
     udTable.loaded = mcsTRUE;
 
@@ -161,7 +171,20 @@ alxUD_CORRECTION_TABLE* alxGetUDTable()
     return &udTable;
 }
 
-alxUD_NEW_CORRECTION_TABLE* alxGetNewUDTable()
+/** once-cell of the UD correction table */
+static alxTABLE_ONCE udTableOnce = {"alxTableUDCoefficientCorrection.cfg", alxLoadUDTable, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the UD correction table (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+alxUD_CORRECTION_TABLE* alxGetUDTable()
+{
+    return (alxUD_CORRECTION_TABLE*) alxTableOnce(&udTableOnce);
+}
+
+static void* alxLoadNewUDTable(void* arg)
 {
     static alxUD_NEW_CORRECTION_TABLE udTable = {mcsFALSE, "alxNewTableUDCoefficientCorrection.cfg", 0,
                                                  {
@@ -189,6 +212,13 @@ alxUD_NEW_CORRECTION_TABLE* alxGetNewUDTable()
         return &udTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(udTable.fileName, &udTable, sizeof (alxUD_NEW_CORRECTION_TABLE), offsetof(alxUD_NEW_CORRECTION_TABLE, nbLines))))
+    {
+        udTable.loaded = mcsTRUE;
+        return &udTable;
+    }
+
     /* Find the location of the file */
     char* fileName = miscLocateFile(udTable.fileName);
     if (IS_NULL(fileName))
@@ -305,6 +335,9 @@ alxUD_NEW_CORRECTION_TABLE* alxGetNewUDTable()
     /* Set the total number of lines in the ud table */
     udTable.nbLines = lineNum;
 
+    /* Register the table for table images */
+    alxTableImageRegister(udTable.fileName, &udTable, sizeof (alxUD_NEW_CORRECTION_TABLE), offsetof(alxUD_NEW_CORRECTION_TABLE, nbLines));
+
     /* Mark the ud table as "loaded" */
     udTable.loaded = mcsTRUE;
 
@@ -316,6 +349,19 @@ alxUD_NEW_CORRECTION_TABLE* alxGetNewUDTable()
     return &udTable;
 }
 
+/** once-cell of the new UD correction table */
+static alxTABLE_ONCE newUdTableOnce = {"alxNewTableUDCoefficientCorrection.cfg", alxLoadNewUDTable, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the new UD correction table (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+alxUD_NEW_CORRECTION_TABLE* alxGetNewUDTable()
+{
+    return (alxUD_NEW_CORRECTION_TABLE*) alxTableOnce(&newUdTableOnce);
+}
+
 mcsUINT32 alxGetLineForUd(alxUD_CORRECTION_TABLE *udTable,
                           mcsDOUBLE teff,
                           mcsDOUBLE logg)
@@ -146,18 +146,10 @@ static alxCOLOR_TABLE colorTables[alxNB_TABLE_STAR_TYPES] = {
 
 static alxCOLOR_TABLE* alxGetColorTableForStar(alxSPECTRAL_TYPE* spectralType);
 static alxCOLOR_TABLE* alxGetColorTableForStarType(alxSTAR_TYPE starType);
-static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE tableStarType);
+static void alxBuildColorTableIndexes(alxCOLOR_TABLE* colorTable);
 
 static alxSTAR_TYPE alxGetLuminosityClass(alxSPECTRAL_TYPE* spectralType);
 
-static mcsINT32 alxGetLineFromSpectralType(alxCOLOR_TABLE *colorTable,
-                                           alxSPECTRAL_TYPE *spectralType,
-                                           mcsLOGICAL checkMissing);
-
-static mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
-                                    mcsDOUBLE diffMag,
-                                    mcsINT32 diffMagId);
-
 static mcsCOMPL_STAT alxComputeMagnitude(mcsDOUBLE firstMag,
                                          alxDATA diffMag,
                                          mcsDOUBLE factor,
@@ -374,7 +366,7 @@ static alxCOLOR_TABLE* alxGetColorTableForStarType(alxSTAR_TYPE starType)
  * type of a bright star, and reads (if not yet done) this table from
  * the configuration file.
  *
- * @param starType table star type
+ * @param arg color table to load
  *
  * @return pointer to structure containing color table, or NULL if an error
  * occurred.
@@ -385,13 +377,9 @@ static alxCOLOR_TABLE* alxGetColorTableForStarType(alxSTAR_TYPE starType)
  *  - alxColorTableForDwarfStar.cfg : dwarf star
  *  - see code for other tables!
  */
-static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE tableStarType)
+static void* alxLoadColorTable(void* arg)
 {
-    if ((tableStarType < alxTABLE_DWARF) || (tableStarType > alxTABLE_SUPER_GIANT))
-    {
-        return NULL;
-    }
-    alxCOLOR_TABLE* colorTable = &colorTables[tableStarType];
+    alxCOLOR_TABLE* colorTable = (alxCOLOR_TABLE*) arg;
 
     /* Check if the structure is loaded into memory. If not load it. */
     if (IS_TRUE(colorTable->loaded))
@@ -399,6 +387,13 @@ static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE table
         return colorTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(colorTable->fileName, colorTable, sizeof (alxCOLOR_TABLE), offsetof(alxCOLOR_TABLE, nbLines))))
+    {
+        colorTable->loaded = mcsTRUE;
+        return colorTable;
+    }
+
     /* Find the location of the file */
     char* fileName = miscLocateFile(colorTable->fileName);
     if (IS_NULL(fileName))
@@ -652,6 +647,12 @@ static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE table
     /** Set the quantity step between lines (supposing a regular sampling) using the first two lines */
     colorTable->step = (lineNum > 0) ? (colorTable->spectralType[1].quantity - colorTable->spectralType[0].quantity) : 0.0;
 
+    /* Build lookup indexes */
+    alxBuildColorTableIndexes(colorTable);
+
+    /* Register the table for table images */
+    alxTableImageRegister(colorTable->fileName, colorTable, sizeof (alxCOLOR_TABLE), offsetof(alxCOLOR_TABLE, nbLines));
+
     /* Mark the color table as "loaded" */
     colorTable->loaded = mcsTRUE;
 
@@ -681,13 +682,104 @@ static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE table
     return colorTable;
 }
 
+/** once-cells of the color tables */
+static alxTABLE_ONCE colorTableOnces[alxNB_TABLE_STAR_TYPES] = {
+    {"alxColorTableForDwarfStar.cfg",      alxLoadColorTable, &colorTables[alxTABLE_DWARF],       NULL, mcsFALSE, 0.0},
+    {"alxColorTableForGiantStar.cfg",      alxLoadColorTable, &colorTables[alxTABLE_GIANT],       NULL, mcsFALSE, 0.0},
+    {"alxColorTableForSuperGiantStar.cfg", alxLoadColorTable, &colorTables[alxTABLE_SUPER_GIANT], NULL, mcsFALSE, 0.0}
+};
+
+/**
+ * Return the color table corresponding to a given table star type (loaded
+ * once, thread-safe).
+ *
+ * @param tableStarType table star type
+ *
+ * @return pointer to structure containing color table, or NULL if an error
+ * occurred.
+ */
+alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE tableStarType)
+{
+    if ((tableStarType < alxTABLE_DWARF) || (tableStarType > alxTABLE_SUPER_GIANT))
+    {
+        return NULL;
+    }
+    return (alxCOLOR_TABLE*) alxTableOnce(&colorTableOnces[tableStarType]);
+}
+
+/**
+ * Build the lookup indexes of the given color table:
+ * - the sorted index of each color (blanking values ignored),
+ * - the spectral type code map (first line and line after the code lines),
+ * - the max quantity of each line from the first line of its code.
+ *
+ * @param colorTable color table
+ */
+static void alxBuildColorTableIndexes(alxCOLOR_TABLE* colorTable)
+{
+    mcsUINT32 line, i, code;
+    alxCOLOR_TABLE_VALUE_INDEX* valueIndex;
+
+    /* sorted index of each color: only keep values greater than all previous values */
+    for (i = 0; i < alxNB_COLOR_INDEXES; i++)
+    {
+        valueIndex = &colorTable->valueIndex[i];
+        valueIndex->nbValues = 0;
+
+        for (line = 0; line < colorTable->nbLines; line++)
+        {
+            if (alxIsSet(colorTable->index[line][i])
+                    && ((valueIndex->nbValues == 0)
+                        || (colorTable->index[line][i].value > valueIndex->value[valueIndex->nbValues - 1])))
+            {
+                valueIndex->value[valueIndex->nbValues] = colorTable->index[line][i].value;
+                valueIndex->line [valueIndex->nbValues] = line;
+                valueIndex->nbValues++;
+            }
+        }
+    }
+
+    /* spectral type code map (first lines given by the line index, first occurrence wins) */
+    for (code = 0; code < alxNB_CODES; code++)
+    {
+        colorTable->codeLineFirst[code] = -1;
+        colorTable->codeLineEnd[code] = 0;
+    }
+    for (i = alxNB_SPECTRAL_TYPE_CODES; i > 0; i--)
+    {
+        if (colorTable->lineIndex[i - 1].code != '\0')
+        {
+            code = (unsigned char) colorTable->lineIndex[i - 1].code;
+            colorTable->codeLineFirst[code] = colorTable->lineIndex[i - 1].firstLine;
+        }
+    }
+    for (code = 0; code < alxNB_CODES; code++)
+    {
+        if (colorTable->codeLineFirst[code] != -1)
+        {
+            line = colorTable->codeLineFirst[code];
+
+            colorTable->quantityMax[line] = colorTable->spectralType[line].quantity;
+
+            for (line++; (line < colorTable->nbLines) && (colorTable->spectralType[line].code == (char) code); line++)
+            {
+                colorTable->quantityMax[line] = alxMax(colorTable->quantityMax[line - 1],
+                                                       colorTable->spectralType[line].quantity);
+            }
+            colorTable->codeLineEnd[code] = line;
+        }
+    }
+}
+
 /**
  * Get the line in the color table which matches the spectral type
  * (if provided) or the magnitude difference. Return the line
  * just after if interpolation is need.
  *
+ * The line is found by binary search in the sorted index of the color
+ * (first line whose value is greater or equal to diffMag).
+ *
  * @param colorTable color table
- * @param spectralType (optional) spectral type structure
  * @param diffMag differential magnitude
  * @param diffMagId id of the differential mag in colorTable
  *
@@ -695,45 +787,38 @@ static alxCOLOR_TABLE* alxGetColorTableForTableStarType(alxTABLE_STAR_TYPE table
  * star magnitude difference or the line just after or -1 if
  * no match is found or interpolation is impossible
  */
-static mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
-                                    mcsDOUBLE diffMag,
-                                    mcsINT32 diffMagId)
+mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
+                             mcsDOUBLE diffMag,
+                             mcsINT32 diffMagId)
 {
-    mcsUINT32 line = 0;
-    mcsLOGICAL found = mcsFALSE;
+    const alxCOLOR_TABLE_VALUE_INDEX* valueIndex = &colorTable->valueIndex[diffMagId];
+
+    /* find the first value >= diffMag (none if diffMag is NaN) */
+    mcsUINT32 low = 0, high = valueIndex->nbValues, mid;
 
-    while (IS_FALSE(found) && (line < colorTable->nbLines))
+    while (low < high)
     {
-        /* check blanking values */
-        if (alxIsSet(colorTable->index[line][diffMagId]))
+        mid = (low + high) / 2;
+
+        if (valueIndex->value[mid] >= diffMag)
         {
-            if (colorTable->index[line][diffMagId].value == diffMag) /* If diffMag in table == diffMag */
-            {
-                found = mcsTRUE;
-            }
-            else if (colorTable->index[line][diffMagId].value > diffMag) /* If diffMag in table > diffMag */
-            {
-                if (line == 0)
-                {
-                    return alxNOT_FOUND;
-                }
-                else
-                {
-                    found = mcsTRUE;
-                }
-            }
-            else
-            {
-                line++;
-            }
+            high = mid;
         }
         else
         {
-            line++;
+            low = mid + 1;
         }
     }
 
-    if (IS_FALSE(found))
+    if ((low == valueIndex->nbValues) || !(valueIndex->value[low] >= diffMag))
+    {
+        return alxNOT_FOUND;
+    }
+
+    const mcsUINT32 line = valueIndex->line[low];
+
+    /* diffMag lower than the value of the first line: no interpolation */
+    if ((line == 0) && (valueIndex->value[low] != diffMag))
     {
         return alxNOT_FOUND;
     }
@@ -746,6 +831,9 @@ static mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
  * Get the line in the color table which matches the spectral type.
  * Return the line equal or just after.
  *
+ * The lines of the spectral type code are given by the code map and the line
+ * is found by binary search on their quantities.
+ *
  * @param colorTable color table
  * @param spectralType spectral type structure
  * @param checkMissing true to return -1 if missing spectral type; false to return 0 or last line
@@ -753,9 +841,9 @@ static mcsINT32 alxGetLineFromValue(alxCOLOR_TABLE *colorTable,
  * @return a line number that matches the spectral type or the line just after
  * or -1 if no match is found
  */
-static mcsINT32 alxGetLineFromSpectralType(alxCOLOR_TABLE *colorTable,
-                                           alxSPECTRAL_TYPE *spectralType,
-                                           mcsLOGICAL checkMissing)
+mcsINT32 alxGetLineFromSpectralType(alxCOLOR_TABLE *colorTable,
+                                    alxSPECTRAL_TYPE *spectralType,
+                                    mcsLOGICAL checkMissing)
 {
     /* If spectral type is unknown, return not found */
     if (IS_NULL(spectralType) || IS_FALSE(spectralType->isSet))
@@ -763,57 +851,37 @@ static mcsINT32 alxGetLineFromSpectralType(alxCOLOR_TABLE *colorTable,
         return alxNOT_FOUND;
     }
 
-    mcsUINT32 lineIndexNum, line = 0;
+    const mcsUINT32 code = (unsigned char) spectralType->code;
 
-    /* Use line index to find first line matching spectral type's code */
-    for (lineIndexNum = 0; lineIndexNum < alxNB_SPECTRAL_TYPE_CODES; lineIndexNum++)
+    mcsUINT32 line;
+    mcsLOGICAL found;
+
+    if (colorTable->codeLineFirst[code] == -1)
     {
-        if (colorTable->lineIndex[lineIndexNum].code == spectralType->code)
-        {
-            line = colorTable->lineIndex[lineIndexNum].firstLine;
-            break;
-        }
+        /* spectral type code not in the table */
+        line  = colorTable->nbLines;
+        found = mcsFALSE;
     }
-
-    mcsLOGICAL codeFound = mcsFALSE;
-    mcsLOGICAL found     = mcsFALSE;
-
-    while (IS_FALSE(found) && (line < colorTable->nbLines))
+    else
     {
-        /* If the spectral type code match */
-        if (colorTable->spectralType[line].code == spectralType->code)
-        {
-            /*
-             * And quantities match or star quantity is lower than the one
-             * of the current line -> stop search
-             */
-            if (colorTable->spectralType[line].quantity >= spectralType->quantity)
-            {
-                found = mcsTRUE;
-            }
-            else /* Else go to the next line */
-            {
-                line++;
-            }
+        /* find the first line (of this code) whose quantity >= star quantity or the line just after */
+        mcsUINT32 low = colorTable->codeLineFirst[code], high = colorTable->codeLineEnd[code], mid;
 
-            /* the code of the spectral type had been found */
-            codeFound = mcsTRUE;
-        }
-        else /* Spectral type code doesn't match */
+        while (low < high)
         {
-            /*
-             * If the lines corresponding to the star spectral type code
-             * have been scanned -> stop
-             */
-            if (IS_TRUE(codeFound))
+            mid = (low + high) / 2;
+
+            if (colorTable->quantityMax[mid] >= spectralType->quantity)
             {
-                found = mcsTRUE;
+                high = mid;
             }
-            else /* Else go to the next line */
+            else
             {
-                line++;
+                low = mid + 1;
             }
         }
+        line  = low;
+        found = (line < colorTable->nbLines) ? mcsTRUE : mcsFALSE;
     }
 
     /*
@@ -2143,7 +2211,7 @@ static mcsDOUBLE alxBlackBodyFluxRatio(mcsDOUBLE Teff1,
     return ratio;
 }
 
-static alxAKARI_TABLE* alxLoadAkariTable()
+static void* alxLoadAkariTableOnce(void* arg)
 {
     /* To know if it was loaded already */
     static alxAKARI_TABLE akariTable = {mcsFALSE, "alxAkariBlackBodyCorrectionTable.cfg", 0,
@@ -2158,6 +2226,13 @@ static alxAKARI_TABLE* alxLoadAkariTable()
         return &akariTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(akariTable.fileName, &akariTable, sizeof (alxAKARI_TABLE), offsetof(alxAKARI_TABLE, nbLines))))
+    {
+        akariTable.loaded = mcsTRUE;
+        return &akariTable;
+    }
+
     /* Find the location of the file */
     char* fileName = miscLocateFile(akariTable.fileName);
     if (IS_NULL(fileName))
@@ -2228,6 +2303,9 @@ static alxAKARI_TABLE* alxLoadAkariTable()
     /* Set the total number of lines in the akari table */
     akariTable.nbLines = lineNum;
 
+    /* Register the table for table images */
+    alxTableImageRegister(akariTable.fileName, &akariTable, sizeof (alxAKARI_TABLE), offsetof(alxAKARI_TABLE, nbLines));
+
     /* Mark the akari table as "loaded" */
     akariTable.loaded = mcsTRUE;
 
@@ -2239,6 +2317,19 @@ static alxAKARI_TABLE* alxLoadAkariTable()
     return &akariTable;
 }
 
+/** once-cell of the Akari black body correction table */
+static alxTABLE_ONCE akariTableOnce = {"alxAkariBlackBodyCorrectionTable.cfg", alxLoadAkariTableOnce, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the Akari black body correction table (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+static alxAKARI_TABLE* alxLoadAkariTable()
+{
+    return (alxAKARI_TABLE*) alxTableOnce(&akariTableOnce);
+}
+
 static mcsINT32 alxGetLineForAkari(alxAKARI_TABLE *akariTable,
                                    mcsDOUBLE Teff)
 {
@@ -2406,7 +2497,7 @@ mcsCOMPL_STAT alxComputeFluxesFromAkari09(mcsDOUBLE Teff,
     return mcsSUCCESS;
 }
 
-static alxTEFFLOGG_TABLE* alxGetTeffLoggTable()
+static void* alxLoadTeffLoggTable(void* arg)
 {
     /* Existing ColorTables */
     static alxTEFFLOGG_TABLE teffloggTable = {mcsFALSE, "alxTableTeffLogg.cfg", 0,
@@ -2425,6 +2516,13 @@ static alxTEFFLOGG_TABLE* alxGetTeffLoggTable()
         return &teffloggTable;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(teffloggTable.fileName, &teffloggTable, sizeof (alxTEFFLOGG_TABLE), offsetof(alxTEFFLOGG_TABLE, nbLines))))
+    {
+        teffloggTable.loaded = mcsTRUE;
+        return &teffloggTable;
+    }
+
     /* Find the location of the file */
     char* fileName = miscLocateFile(teffloggTable.fileName);
     if (IS_NULL(fileName))
@@ -2498,6 +2596,9 @@ static alxTEFFLOGG_TABLE* alxGetTeffLoggTable()
     /* Set the total number of lines in the Teff/Logg table */
     teffloggTable.nbLines = lineNum;
 
+    /* Register the table for table images */
+    alxTableImageRegister(teffloggTable.fileName, &teffloggTable, sizeof (alxTEFFLOGG_TABLE), offsetof(alxTEFFLOGG_TABLE, nbLines));
+
     /* Mark the Teff/Logg table as "loaded" */
     teffloggTable.loaded = mcsTRUE;
 
@@ -2509,6 +2610,19 @@ static alxTEFFLOGG_TABLE* alxGetTeffLoggTable()
     return &teffloggTable;
 }
 
+/** once-cell of the Teff/Logg table */
+static alxTABLE_ONCE teffloggTableOnce = {"alxTableTeffLogg.cfg", alxLoadTeffLoggTable, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the Teff/Logg table (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+static alxTEFFLOGG_TABLE* alxGetTeffLoggTable()
+{
+    return (alxTEFFLOGG_TABLE*) alxTableOnce(&teffloggTableOnce);
+}
+
 static mcsINT32 alxGetLineForTeffLogg(alxTEFFLOGG_TABLE *teffloggTable,
                                       alxSPECTRAL_TYPE *spectralType)
 {
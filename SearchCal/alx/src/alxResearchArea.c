@@ -61,7 +61,7 @@ static mcsCOMPL_STAT alxGetNbOfStars(mcsDOUBLE gLon,
  *
  * @usedfiles alxStarPopulationInKBand.cfg : file containing the star population
  */
-static alxSTAR_POPULATION *alxGetStarPopulation(void)
+static void* alxLoadStarPopulation(void* arg)
 {
     /*
      * Check if the structure, where will be stored star population information,
@@ -84,6 +84,13 @@ static alxSTAR_POPULATION *alxGetStarPopulation(void)
         return &starPopulation;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(starPopulation.fileName, &starPopulation, sizeof (alxSTAR_POPULATION), offsetof(alxSTAR_POPULATION, gLonList))))
+    {
+        starPopulation.loaded = mcsTRUE;
+        return &starPopulation;
+    }
+
     /*
      * Build the dynamic buffer which will contain the file of coefficient
      * of angular diameter
@@ -186,11 +193,27 @@ static alxSTAR_POPULATION *alxGetStarPopulation(void)
     miscDynBufDestroy(&dynBuf);
     free(fileName);
 
+    /* Register the table for table images */
+    alxTableImageRegister(starPopulation.fileName, &starPopulation, sizeof (alxSTAR_POPULATION), offsetof(alxSTAR_POPULATION, gLonList));
+
     starPopulation.loaded = mcsTRUE;
 
     return &starPopulation;
 }
 
+/** once-cell of the star population */
+static alxTABLE_ONCE starPopulationOnce = {"alxStarPopulationInKBand.cfg", alxLoadStarPopulation, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the star population in terms of magnitude and galactic coordinates (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+static alxSTAR_POPULATION *alxGetStarPopulation(void)
+{
+    return (alxSTAR_POPULATION*) alxTableOnce(&starPopulationOnce);
+}
+
 /**
  * Return the number of stars in the given sky area.
  *
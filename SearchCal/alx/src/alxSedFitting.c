@@ -41,7 +41,20 @@
 #define alxNB_SED_MODEL 180600
 
 /*
- * Structure of the an coefficient table for compute angular diameter
+ * SIMD sweep: number of models per vector and per chunk
+ */
+#define alxSED_SIMD     4
+#define alxSED_CHUNK    1024
+
+#if ((alxNB_SED_MODEL % alxSED_SIMD) != 0) || ((alxSED_CHUNK % alxSED_SIMD) != 0)
+#error "alxNB_SED_MODEL and alxSED_CHUNK must be multiples of alxSED_SIMD"
+#endif
+
+/** vector of alxSED_SIMD doubles (GCC vector extension, unaligned loads allowed) */
+typedef mcsDOUBLE alxSED_VECTOR __attribute__ ((vector_size (alxSED_SIMD * sizeof (mcsDOUBLE)), aligned (sizeof (mcsDOUBLE))));
+
+/*
+ * Structure of the SED models (band-major fluxes for the model sweep)
  */
 typedef struct
 {
@@ -50,7 +63,7 @@ typedef struct
     mcsDOUBLE Teff[alxNB_SED_MODEL];
     mcsDOUBLE Logg[alxNB_SED_MODEL];
     mcsDOUBLE Av[alxNB_SED_MODEL];
-    mcsDOUBLE Flux[alxNB_SED_MODEL][alxNB_SED_BAND];
+    mcsDOUBLE Flux[alxNB_SED_BAND][alxNB_SED_MODEL];
 } alxSED_MODEL;
 
 /*
@@ -58,6 +71,13 @@ typedef struct
  */
 static alxSED_MODEL *alxGetSedModel(void);
 
+static void alxSedFittingSweep(const mcsDOUBLE** bandFlux, const mcsDOUBLE* avModel,
+                               const mcsDOUBLE* mag, const mcsDOUBLE* invMagErr,
+                               mcsUINT32 nbFree, mcsDOUBLE fluxData,
+                               mcsLOGICAL hasAv, mcsDOUBLE Av, mcsDOUBLE invAvErr,
+                               mcsUINT32 start, mcsUINT32 nbModels,
+                               mcsDOUBLE* chi2, mcsDOUBLE* fluxRatio);
+
 /*
  * Public Functions Definition
  */
@@ -141,8 +161,7 @@ mcsCOMPL_STAT alxSedFitting(alxDATA *magnitudes, mcsDOUBLE Av, mcsDOUBLE e_Av,
 
     /* Build the map of chi2. (large arrays but only small part used) */
     mcsDOUBLE mapChi2[alxNB_SED_MODEL], mapFluxRatio[alxNB_SED_MODEL];
-    mcsDOUBLE fluxModel, fluxRatio, diffDataModel, chi2, best_chi2, chi2Threshold;
-    mcsDOUBLE *ptrFlux;
+    mcsDOUBLE chi2, best_chi2, chi2Threshold;
 
     const mcsLOGICAL hasAv   = (e_Av > 0.0) ? mcsTRUE : mcsFALSE;
     const mcsDOUBLE invAvErr = (IS_TRUE(hasAv)) ? 1.0 / e_Av : NAN;
@@ -151,54 +170,52 @@ mcsCOMPL_STAT alxSedFitting(alxDATA *magnitudes, mcsDOUBLE Av, mcsDOUBLE e_Av,
     /* Optimization: only keep data (chi2, flux ratio) which chi2 < best(chi2) + 2 */
     chi2Threshold = best_chi2 + 2.0; /* moving threshold */
 
-    /* Loop on models */
-    for (n = 0, i = 0; i < alxNB_SED_MODEL; i++)
+    /* fluxes of the available bands (band-major) */
+    const mcsDOUBLE* bandFlux[alxNB_SED_BAND];
+
+    for (b = 0; b < nbFree; b++)
     {
-        ptrFlux = sedModel->Flux[i];
+        bandFlux[b] = sedModel->Flux[bandIdx[b]];
+    }
 
-        /* Compute the flux of the model weighted by the variance */
-        fluxModel = 0.0;
-        for (b = 0; b < nbFree; b++)
-        {
-            fluxModel += ptrFlux[bandIdx[b]] * invMagErr[b];
-        }
-        /* adjust flux model with data */
-        fluxRatio = fluxData / fluxModel;
+    /* chi2 and flux ratio of the models in the current chunk */
+    mcsDOUBLE chunkChi2[alxSED_CHUNK], chunkFluxRatio[alxSED_CHUNK];
+    mcsUINT32 start, nbModels;
 
-        /* Compute chi2 for the photometry */
-        chi2 = 0.0;
-        for (b = 0; b < nbFree; b++)
-        {
-            diffDataModel = mag[b] - (fluxRatio * ptrFlux[bandIdx[b]]);
-            chi2 += diffDataModel * diffDataModel * invMagErr[b];
-        }
+    /* Loop on model chunks */
+    for (n = 0, start = 0; start < alxNB_SED_MODEL; start += alxSED_CHUNK)
+    {
+        nbModels = (alxNB_SED_MODEL - start < alxSED_CHUNK) ? alxNB_SED_MODEL - start : alxSED_CHUNK;
 
-        if (IS_TRUE(hasAv))
-        {
-            /* Add the chi2 contribution of the Av */
-            diffDataModel = (Av - sedModel->Av[i]) * invAvErr;
-            chi2 += diffDataModel * diffDataModel;
-        }
+        /* Compute chi2 and flux ratio of all models in the chunk (SIMD) */
+        alxSedFittingSweep(bandFlux, sedModel->Av, mag, invMagErr, nbFree, fluxData,
+                           hasAv, Av, invAvErr, start, nbModels, chunkChi2, chunkFluxRatio);
 
-        /* Look for the best chi2 */
-        if (chi2 <= best_chi2)
+        /* Keep models in order (moving threshold) */
+        for (i = start; i < start + nbModels; i++)
         {
-            bestModelIndex = i;
-            best_chi2      = chi2;
-            chi2Threshold  = best_chi2 + 2.0; /* moving threshold */
-
-            /* Keep chi2 and flux ratio and not the diameter (faster because less amount of data) */
-            bestResultIndex = n;
-            mapChi2[n]      = chi2;
-            mapFluxRatio[n] = fluxRatio;
-            n++;
-        }
-        else if (chi2 <= chi2Threshold)
-        {
-            /* Keep chi2 and flux ratio and not the diameter (faster because less amount of data) */
-            mapChi2[n]      = chi2;
-            mapFluxRatio[n] = fluxRatio;
-            n++;
+            chi2 = chunkChi2[i - start];
+
+            /* Look for the best chi2 */
+            if (chi2 <= best_chi2)
+            {
+                bestModelIndex = i;
+                best_chi2      = chi2;
+                chi2Threshold  = best_chi2 + 2.0; /* moving threshold */
+
+                /* Keep chi2 and flux ratio and not the diameter (faster because less amount of data) */
+                bestResultIndex = n;
+                mapChi2[n]      = chi2;
+                mapFluxRatio[n] = chunkFluxRatio[i - start];
+                n++;
+            }
+            else if (chi2 <= chi2Threshold)
+            {
+                /* Keep chi2 and flux ratio and not the diameter (faster because less amount of data) */
+                mapChi2[n]      = chi2;
+                mapFluxRatio[n] = chunkFluxRatio[i - start];
+                n++;
+            }
         }
     }
     /* End loop on models */
@@ -248,7 +265,89 @@ mcsCOMPL_STAT alxSedFitting(alxDATA *magnitudes, mcsDOUBLE Av, mcsDOUBLE e_Av,
  * Private Functions Definition
  */
 
-static alxSED_MODEL * alxGetSedModel(void)
+/**
+ * Compute the chi2 and the flux ratio of the models [start .. start + nbModels[
+ * (chunk), alxSED_SIMD models at a time.
+ *
+ * Per model, operations are done in the same order as the scalar loop so the
+ * results are identical.
+ *
+ * @param bandFlux model fluxes of the available bands (band-major)
+ * @param avModel model Av
+ * @param mag fluxes of the available bands
+ * @param invMagErr inverse variance of the fluxes
+ * @param nbFree number of available bands
+ * @param fluxData total flux weighted by variance
+ * @param hasAv true to add the chi2 contribution of the Av
+ * @param Av Av
+ * @param invAvErr inverse of the Av error
+ * @param start first model
+ * @param nbModels number of models (multiple of alxSED_SIMD)
+ * @param chi2 chi2 per model in the chunk
+ * @param fluxRatio flux ratio per model in the chunk
+ */
+static void alxSedFittingSweep(const mcsDOUBLE** bandFlux, const mcsDOUBLE* avModel,
+                               const mcsDOUBLE* mag, const mcsDOUBLE* invMagErr,
+                               mcsUINT32 nbFree, mcsDOUBLE fluxData,
+                               mcsLOGICAL hasAv, mcsDOUBLE Av, mcsDOUBLE invAvErr,
+                               mcsUINT32 start, mcsUINT32 nbModels,
+                               mcsDOUBLE* chi2, mcsDOUBLE* fluxRatio)
+{
+    mcsUINT32 i, j, b;
+
+    /* broadcast constants */
+    alxSED_VECTOR vMag[alxNB_SED_BAND], vInvMagErr[alxNB_SED_BAND];
+    alxSED_VECTOR vFluxData, vAv, vInvAvErr, vZero;
+
+    for (j = 0; j < alxSED_SIMD; j++)
+    {
+        for (b = 0; b < nbFree; b++)
+        {
+            vMag[b][j]       = mag[b];
+            vInvMagErr[b][j] = invMagErr[b];
+        }
+        vFluxData[j] = fluxData;
+        vAv[j]       = Av;
+        vInvAvErr[j] = invAvErr;
+        vZero[j]     = 0.0;
+    }
+
+    alxSED_VECTOR vFluxModel, vFluxRatio, vChi2, vDiff;
+
+    for (i = 0; i < nbModels; i += alxSED_SIMD)
+    {
+        const mcsUINT32 m = start + i;
+
+        /* Compute the flux of the model weighted by the variance */
+        vFluxModel = vZero;
+        for (b = 0; b < nbFree; b++)
+        {
+            vFluxModel += *(const alxSED_VECTOR*) &bandFlux[b][m] * vInvMagErr[b];
+        }
+        /* adjust flux model with data */
+        vFluxRatio = vFluxData / vFluxModel;
+
+        /* Compute chi2 for the photometry */
+        vChi2 = vZero;
+        for (b = 0; b < nbFree; b++)
+        {
+            vDiff = vMag[b] - (vFluxRatio * *(const alxSED_VECTOR*) &bandFlux[b][m]);
+            vChi2 += vDiff * vDiff * vInvMagErr[b];
+        }
+
+        if (IS_TRUE(hasAv))
+        {
+            /* Add the chi2 contribution of the Av */
+            vDiff = (vAv - *(const alxSED_VECTOR*) &avModel[m]) * vInvAvErr;
+            vChi2 += vDiff * vDiff;
+        }
+
+        *(alxSED_VECTOR*) &chi2[i]      = vChi2;
+        *(alxSED_VECTOR*) &fluxRatio[i] = vFluxRatio;
+    }
+}
+
+static void* alxLoadSedModel(void* arg)
 {
     static alxSED_MODEL sedModel = {mcsFALSE, "alxSedModel.cfg",
         {0.0},
@@ -264,6 +363,13 @@ static alxSED_MODEL * alxGetSedModel(void)
         return &sedModel;
     }
 
+    /* Use the embedded table image if available */
+    if (IS_TRUE(alxTableImageLoad(sedModel.fileName, &sedModel, sizeof (alxSED_MODEL), offsetof(alxSED_MODEL, Teff))))
+    {
+        sedModel.loaded = mcsTRUE;
+        return &sedModel;
+    }
+
     /* Find the location of the file */
     char* fileName;
     fileName = miscLocateFile(sedModel.fileName);
@@ -309,11 +415,11 @@ static alxSED_MODEL * alxGetSedModel(void)
                        &sedModel.Logg[lineNum],
                        &sedModel.Teff[lineNum],
                        &sedModel.Av[lineNum],
-                       &sedModel.Flux[lineNum][0],
-                       &sedModel.Flux[lineNum][1],
-                       &sedModel.Flux[lineNum][2],
-                       &sedModel.Flux[lineNum][3],
-                       &sedModel.Flux[lineNum][4]
+                       &sedModel.Flux[0][lineNum],
+                       &sedModel.Flux[1][lineNum],
+                       &sedModel.Flux[2][lineNum],
+                       &sedModel.Flux[3][lineNum],
+                       &sedModel.Flux[4][lineNum]
                        ) != (alxNB_SED_BAND + 3))
             {
                 miscDynBufDestroy(&dynBuf);
@@ -325,11 +431,11 @@ static alxSED_MODEL * alxGetSedModel(void)
             /* Log what has been read */
             logDebug("%lf %lf %lf - %lf %lf %lf %lf %lf",
                      sedModel.Logg[lineNum], sedModel.Teff[lineNum], sedModel.Av[lineNum],
-                     sedModel.Flux[lineNum][0],
-                     sedModel.Flux[lineNum][1],
-                     sedModel.Flux[lineNum][2],
-                     sedModel.Flux[lineNum][3],
-                     sedModel.Flux[lineNum][4]);
+                     sedModel.Flux[0][lineNum],
+                     sedModel.Flux[1][lineNum],
+                     sedModel.Flux[2][lineNum],
+                     sedModel.Flux[3][lineNum],
+                     sedModel.Flux[4][lineNum]);
 
             /* Next line */
             lineNum++;
@@ -341,12 +447,28 @@ static alxSED_MODEL * alxGetSedModel(void)
 
     free(fileName);
 
+    /* Register the table for table images */
+    alxTableImageRegister(sedModel.fileName, &sedModel, sizeof (alxSED_MODEL), offsetof(alxSED_MODEL, Teff));
+
     /* Specify that the models have been loaded */
     sedModel.loaded = mcsTRUE;
 
     return &sedModel;
 }
 
+/** once-cell of the SED models */
+static alxTABLE_ONCE sedModelOnce = {"alxSedModel.cfg", alxLoadSedModel, NULL, NULL, mcsFALSE, 0.0};
+
+/**
+ * Return the SED models (loaded once, thread-safe).
+ *
+ * @return pointer onto the table, or NULL if an error occurred.
+ */
+static alxSED_MODEL * alxGetSedModel(void)
+{
+    return (alxSED_MODEL*) alxTableOnce(&sedModelOnce);
+}
+
 /**
  * Initialize this file
  */
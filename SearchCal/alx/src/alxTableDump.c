@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Load all alx tables from their configuration files and dump them as binary
+ * images embedded by the generated C source (see alxTableImage.c).
+ *
+ * @synopsis
+ * alxTableDump \<source file\> \<image directory\>
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "alx.h"
+#include "alxPrivate.h"
+
+
+/*
+ * Main
+ */
+int main (int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <source file> <image directory>\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
+    /* Configure logging service */
+    logSetStdoutLogLevel(logINFO);
+    logSetPrintDate(mcsFALSE);
+    logSetPrintFileLine(mcsFALSE);
+
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit (EXIT_FAILURE);
+    }
+
+    /* load all tables from their files */
+    alxTableImageUseFiles();
+    alxInit();
+
+    mcsCOMPL_STAT status = mcsSUCCESS;
+
+    if (IS_FALSE(errStackIsEmpty()))
+    {
+        status = mcsFAILURE;
+    }
+    else
+    {
+        status = alxTableImageDump(argv[1], argv[2]);
+    }
+
+    if (status == mcsFAILURE)
+    {
+        errCloseStack();
+    }
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application */
+    exit ((status == mcsSUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/*___oOo___*/
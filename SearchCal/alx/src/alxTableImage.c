@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Embedded table images: alx tables loaded from their configuration files can
+ * be dumped (alxTableDump) into binary images and a generated C source
+ * (alxTableImages.c) embedding them at build time (ALX_EMBEDDED_TABLES=1), so
+ * tables are then copied from memory without any file I/O nor parsing.
+ *
+ * Each image records the layout version (alxTABLE_IMAGE_VERSION) and size of
+ * its table structure: images not matching the current structure are ignored
+ * and the table is loaded from its file.
+ *
+ * The environment variable ALX_TABLE_FILES=1 forces loading tables from their
+ * configuration files (updated tables).
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+#include "misc.h"
+
+
+/*
+ * Local Headers
+ */
+#include "alx.h"
+#include "alxPrivate.h"
+#include "alxErrors.h"
+
+
+/** environment variable to force loading tables from files */
+#define alxTABLE_FILES_ENV_VAR "ALX_TABLE_FILES"
+
+/** maximum number of registered tables */
+#define alxNB_TABLE_IMAGES 16
+
+#ifdef alxEMBEDDED_TABLES
+/** embedded table images (generated alxTableImages.c) */
+extern const alxTABLE_IMAGE alxTableImages[];
+#endif
+
+/*
+ * Local Variables
+ */
+
+/** flag to use table files (-1 means undefined) */
+static mcsINT32 alxTableFiles = -1;
+
+/** tables loaded from files (dump) */
+static alxTABLE_IMAGE alxRegisteredTables[alxNB_TABLE_IMAGES];
+static mcsUINT32 alxNbRegisteredTables = 0;
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX alxTableImageMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+
+/*
+ * Local Functions
+ */
+
+/* return mcsTRUE if tables must be loaded from their files */
+static mcsLOGICAL alxTableImageIsFileMode(void)
+{
+    if (alxTableFiles == -1)
+    {
+        mcsSTRING32 envFlag = "";
+        mcsINT32 flag = 0;
+
+        if ((miscGetEnvVarValue2(alxTABLE_FILES_ENV_VAR, envFlag, sizeof (envFlag), mcsTRUE) == mcsSUCCESS)
+                && ((strcmp("1", envFlag) == 0) || (strcmp("true", envFlag) == 0)))
+        {
+            logInfo("'%s' environment variable set: load alx tables from files", alxTABLE_FILES_ENV_VAR);
+            flag = 1;
+        }
+        alxTableFiles = flag;
+    }
+    return (alxTableFiles == 1) ? mcsTRUE : mcsFALSE;
+}
+
+
+/*
+ * Public functions definition
+ */
+
+/**
+ * Force loading tables from their configuration files (ignore embedded images).
+ */
+void alxTableImageUseFiles(void)
+{
+    alxTableFiles = 1;
+}
+
+/**
+ * Copy the embedded image of the given table (if available) into the given
+ * table structure, except its header (loaded flag, file names).
+ *
+ * @param fileName table file name
+ * @param table table structure to fill
+ * @param size size of the table structure
+ * @param headerSize size of the header (not copied)
+ *
+ * @return mcsTRUE if the table was copied from its embedded image; mcsFALSE
+ * otherwise (table must be loaded from its file)
+ */
+mcsLOGICAL alxTableImageLoad(const char* fileName, void* table,
+                             mcsUINT32 size, mcsUINT32 headerSize)
+{
+#ifdef alxEMBEDDED_TABLES
+    if (IS_TRUE(alxTableImageIsFileMode()))
+    {
+        return mcsFALSE;
+    }
+
+    const alxTABLE_IMAGE* image;
+
+    for (image = alxTableImages; IS_NOT_NULL(image->fileName); image++)
+    {
+        if (strcmp(image->fileName, fileName) == 0)
+        {
+            if (image->version != alxTABLE_IMAGE_VERSION)
+            {
+                logWarning("Embedded table '%s' has an outdated layout (version %u instead of %u); load file",
+                           fileName, image->version, alxTABLE_IMAGE_VERSION);
+                return mcsFALSE;
+            }
+            if ((image->size != size) || (image->headerSize != headerSize))
+            {
+                logWarning("Embedded table '%s' does not match its structure (%u bytes instead of %u); load file",
+                           fileName, image->size, size);
+                return mcsFALSE;
+            }
+
+            logInfo("Loading %s (embedded) ...", fileName);
+
+            memcpy((char*) table + headerSize, (const char*) image->data + headerSize, size - headerSize);
+
+            return mcsTRUE;
+        }
+    }
+#endif
+    return mcsFALSE;
+}
+
+/**
+ * Register the given table loaded from its file (used by alxTableImageDump).
+ *
+ * @param fileName table file name
+ * @param table loaded table structure
+ * @param size size of the table structure
+ * @param headerSize size of the header (loaded flag, file names)
+ */
+void alxTableImageRegister(const char* fileName, const void* table,
+                           mcsUINT32 size, mcsUINT32 headerSize)
+{
+    mcsMutexLock(&alxTableImageMutex);
+
+    if (alxNbRegisteredTables < alxNB_TABLE_IMAGES)
+    {
+        alxTABLE_IMAGE* image = &alxRegisteredTables[alxNbRegisteredTables++];
+
+        image->fileName   = fileName;
+        image->version    = alxTABLE_IMAGE_VERSION;
+        image->size       = size;
+        image->headerSize = headerSize;
+        image->data       = table;
+    }
+
+    mcsMutexUnlock(&alxTableImageMutex);
+}
+
+/**
+ * Dump all tables loaded from their files: write one binary image per table
+ * in the given directory and the C source embedding them.
+ *
+ * @param sourceFile generated C source file
+ * @param imageDir directory of binary images (also used in .incbin directives)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT alxTableImageDump(const char* sourceFile, const char* imageDir)
+{
+    mcsSTRING1024 imageFile;
+    FILE* file;
+    mcsUINT32 i;
+
+    /* binary images */
+    for (i = 0; i < alxNbRegisteredTables; i++)
+    {
+        const alxTABLE_IMAGE* image = &alxRegisteredTables[i];
+
+        snprintf(imageFile, sizeof (imageFile) - 1, "%s/%s.img", imageDir, image->fileName);
+
+        file = fopen(imageFile, "wb");
+        FAIL_NULL_DO(file, errAdd(alxERR_FILE_WRITE, imageFile));
+
+        const mcsLOGICAL written = (fwrite(image->data, image->size, 1, file) == 1) ? mcsTRUE : mcsFALSE;
+
+        FAIL_COND_DO((fclose(file) != 0) || IS_FALSE(written), errAdd(alxERR_FILE_WRITE, imageFile));
+
+        logInfo("Table image '%s': %u bytes", imageFile, image->size);
+    }
+
+    /* C source */
+    file = fopen(sourceFile, "w");
+    FAIL_NULL_DO(file, errAdd(alxERR_FILE_WRITE, sourceFile));
+
+    fprintf(file, "/*\n * Embedded alx table images\n *\n");
+    fprintf(file, " * This file has been generated by alxTableDump utility\n *\n");
+    fprintf(file, " * !!!!!!!!!!!  DO NOT MANUALLY EDIT THIS FILE  !!!!!!!!!!!\n */\n\n");
+    fprintf(file, "#include <stdio.h>\n\n#include \"mcs.h\"\n#include \"log.h\"\n#include \"misc.h\"\n\n");
+    fprintf(file, "#include \"alx.h\"\n#include \"alxPrivate.h\"\n\n");
+
+    fprintf(file, "__asm__(\"    .section .rodata\\n\"\n");
+    for (i = 0; i < alxNbRegisteredTables; i++)
+    {
+        fprintf(file, "        \"    .balign 64\\n\"\n");
+        fprintf(file, "        \"    .globl alxTableImageData%u\\n\"\n", i);
+        fprintf(file, "        \"    .hidden alxTableImageData%u\\n\"\n", i);
+        fprintf(file, "        \"alxTableImageData%u:\\n\"\n", i);
+        fprintf(file, "        \"    .incbin \\\"%s/%s.img\\\"\\n\"\n", imageDir, alxRegisteredTables[i].fileName);
+    }
+    fprintf(file, "        \"    .previous\\n\");\n\n");
+
+    for (i = 0; i < alxNbRegisteredTables; i++)
+    {
+        fprintf(file, "extern const char alxTableImageData%u[] __attribute__ ((visibility(\"hidden\")));\n", i);
+    }
+
+    fprintf(file, "\nconst alxTABLE_IMAGE alxTableImages[] = {\n");
+    for (i = 0; i < alxNbRegisteredTables; i++)
+    {
+        fprintf(file, "    {\"%s\", %u, %u, %u, alxTableImageData%u},\n", alxRegisteredTables[i].fileName,
+                alxRegisteredTables[i].version, alxRegisteredTables[i].size, alxRegisteredTables[i].headerSize, i);
+    }
+    fprintf(file, "    {NULL, 0, 0, 0, NULL}\n};\n\n/*___oOo___*/\n");
+
+    FAIL_COND_DO(fclose(file) != 0, errAdd(alxERR_FILE_WRITE, sourceFile));
+
+    logInfo("Table images: %u tables written in '%s'", alxNbRegisteredTables, sourceFile);
+
+    return mcsSUCCESS;
+}
+
+/*___oOo___*/
@@ -86,5 +86,102 @@ mcsCOMPL_STAT alxComputeVisibility(mcsDOUBLE angDiam,
     return mcsSUCCESS;
 }
 
+/**
+ * Compute the visibilities of several stars for several (baseline,
+ * wavelength) samples (uniform disk model).
+ *
+ * The spatial frequency factor is computed once per sample and the Bessel
+ * functions J0 and J1 once per (star, sample): J2 (visibility error) is given
+ * by the recurrence J2(x) = 2 J1(x) / x - J0(x), or by its power series for
+ * small x (cancellation).
+ *
+ * @param nbStars number of stars
+ * @param angDiam angular diameters of the stars (mas) [nbStars]
+ * @param angDiamError errors on the angular diameters (mas) [nbStars]
+ * @param nbSamples number of (baseline, wavelength) samples
+ * @param baseline baseline lengths (m) [nbSamples]
+ * @param wlen wavelengths (um) [nbSamples]
+ * @param visibilities the computed visibilities [nbStars x nbSamples]
+ * (visibilities of the star i for the sample j at index i * nbSamples + j)
+ *
+ * @return Always mcsSUCCESS
+ */
+mcsCOMPL_STAT alxComputeVisibilities(mcsUINT32 nbStars,
+                                     const mcsDOUBLE* angDiam,
+                                     const mcsDOUBLE* angDiamError,
+                                     mcsUINT32 nbSamples,
+                                     const mcsDOUBLE* baseline,
+                                     const mcsDOUBLE* wlen,
+                                     alxVISIBILITIES* visibilities)
+{
+    mcsUINT32 first, nb, i, j, k;
+    mcsDOUBLE freq[alxNB_VIS_SAMPLES_CHUNK];
+    mcsDOUBLE x, relError, bJ0, bJ1, bJ2, term, halfX2;
+    alxVISIBILITIES* vis;
+
+    /* process samples by chunks to keep the frequency factors in a local array */
+    for (first = 0; first < nbSamples; first += alxNB_VIS_SAMPLES_CHUNK)
+    {
+        nb = alxMin(alxNB_VIS_SAMPLES_CHUNK, nbSamples - first);
+
+        /* spatial frequency factor of each sample */
+        for (j = 0; j < nb; j++)
+        {
+            freq[j] = 15.23 * baseline[first + j] / (1000.0 * wlen[first + j]);
+        }
+
+        for (i = 0; i < nbStars; i++)
+        {
+            relError = angDiamError[i] / angDiam[i];
+            vis = &visibilities[i * nbSamples + first];
+
+            for (j = 0; j < nb; j++)
+            {
+                x = freq[j] * angDiam[i];
+
+                if (x == 0.0)
+                {
+                    /* unresolved */
+                    bJ1 = 0.5;
+                    bJ2 = 0.0;
+                }
+                else
+                {
+                    bJ1 = j1(x) / x;
+
+                    if (x < 2.0)
+                    {
+                        /* J2(x) = sum (-1)^k (x/2)^(2k+2) / (k! (k+2)!) */
+                        halfX2 = 0.25 * x * x;
+                        term = 0.5 * halfX2;
+                        bJ2 = term;
+
+                        for (k = 1; k < 12; k++)
+                        {
+                            term *= -halfX2 / (k * (k + 2.0));
+                            bJ2 += term;
+                        }
+                    }
+                    else
+                    {
+                        bJ0 = j0(x);
+                        bJ2 = 2.0 * bJ1 - bJ0;
+                    }
+                }
+
+                /* Compute V and its associated error for Diameter Uniform Disc */
+                vis[j].vis = 2.0 * fabs(bJ1);
+                vis[j].visError = 2.0 * fabs(bJ2 * relError);
+
+                /* Compute V2 and its associated error: d(Vis2) = 2 x V x dV */
+                vis[j].vis2 = vis[j].vis * vis[j].vis;
+                vis[j].vis2Error = 2.0 * vis[j].vis * vis[j].visError;
+            }
+        }
+    }
+
+    return mcsSUCCESS;
+}
+
 
 /*___oOo___*/
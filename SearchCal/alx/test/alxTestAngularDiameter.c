@@ -13,6 +13,7 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 /*
@@ -796,6 +797,62 @@ int main (int argc, char *argv[])
         }
         logInfo("check %u diameters: done : %u diffs.", NS, NB);
 
+    /* check sampled diameters (spectral type range) vs diameters computed for each spectral type index */
+    {
+        static const mcsUINT32 idxMin = 42, idxMax = 272;
+
+        alxDIAMETERS diamsSp[idxMax - idxMin + 1];
+        alxDATA meanDiamSp[idxMax - idxMin + 1], chi2DiamSp[idxMax - idxMin + 1];
+        mcsUINT32 nbDiametersSp[idxMax - idxMin + 1];
+        mcsUINT32 n, nbDiffs = 0;
+
+        /* only log differences */
+        logSetStdoutLogLevel(logINFO);
+
+        for (i = 0; i < NS; i += 11)
+        {
+            /* keep magnitudes of the last star, change V and K (some colors) */
+            mags[alxV_BAND].value = datas[i][IDL_COL_MAG + 1];
+            mags[alxK_BAND].value = datas[i][IDL_COL_MAG + 5];
+            mags[alxK_BAND].isSet = (i % 3 == 0) ? mcsFALSE : mcsTRUE;
+
+            if (alxComputeAngularDiametersSampled(mags, idxMin, idxMax, nbRequiredDiameters,
+                                                  diamsSp, meanDiamSp, chi2DiamSp, nbDiametersSp) == mcsFAILURE)
+            {
+                logInfo("alxComputeAngularDiametersSampled : fail");
+                exit(EXIT_FAILURE);
+            }
+
+            for (n = 0; n <= idxMax - idxMin; n++)
+            {
+                alxComputeAngularDiameters("(SP)   ", mags, idxMin + n, diameters, diametersCov, logDEBUG);
+                alxComputeMeanAngularDiameter(diameters, diametersCov, nbRequiredDiameters, &weightedMeanDiam,
+                                              &chi2Diam, &nbDiameters, NULL, logDEBUG);
+
+                bad = (memcmp(&weightedMeanDiam, &meanDiamSp[n], sizeof (alxDATA)) != 0)
+                        || (memcmp(&chi2Diam, &chi2DiamSp[n], sizeof (alxDATA)) != 0)
+                        || (nbDiameters != nbDiametersSp[n]);
+
+                for (j = 0; j < alxNB_DIAMS; j++)
+                {
+                    bad |= (memcmp(&diameters[j], &diamsSp[n][j], sizeof (alxDATA)) != 0);
+                }
+                if (bad == 1)
+                {
+                    logInfo("Sampled diameter (star %u SP=%u): %.9lf %.9lf", i, idxMin + n,
+                            weightedMeanDiam.value, meanDiamSp[n].value);
+                    nbDiffs++;
+                }
+            }
+        }
+        if (nbDiffs != 0)
+        {
+            logInfo("check sampled diameters: %u diffs.", nbDiffs);
+            exit(EXIT_FAILURE);
+        }
+        logSetStdoutLogLevel(logTEST);
+    }
+
     /* Close MCS services */
     mcsExit();
 
@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Test program of the color table and longitude lookups: compares the indexed
+ * lookups (binary search) with the linear scans over the full table domain.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+
+/*
+ * Local Headers
+ */
+#include "alx.h"
+#include "alxPrivate.h"
+
+
+/* sweep samples between the table bounds */
+#define NB_SAMPLES 20000
+
+/* linear scan on color values (reference) */
+static mcsINT32 getLineFromValueScan(alxCOLOR_TABLE *colorTable, mcsDOUBLE diffMag, mcsINT32 diffMagId)
+{
+    mcsUINT32 line;
+
+    for (line = 0; line < colorTable->nbLines; line++)
+    {
+        if (alxIsSet(colorTable->index[line][diffMagId]) && (colorTable->index[line][diffMagId].value >= diffMag))
+        {
+            if ((line == 0) && (colorTable->index[line][diffMagId].value != diffMag))
+            {
+                return alxNOT_FOUND;
+            }
+            return line;
+        }
+    }
+    return alxNOT_FOUND;
+}
+
+/* linear scan on spectral types (reference, without the missing line fix) */
+static mcsINT32 getLineFromSpectralTypeScan(alxCOLOR_TABLE *colorTable, alxSPECTRAL_TYPE *spectralType, mcsLOGICAL checkMissing)
+{
+    mcsUINT32 i, line = 0;
+    mcsLOGICAL codeFound = mcsFALSE, found = mcsFALSE;
+
+    for (i = 0; i < alxNB_SPECTRAL_TYPE_CODES; i++)
+    {
+        if (colorTable->lineIndex[i].code == spectralType->code)
+        {
+            line = colorTable->lineIndex[i].firstLine;
+            break;
+        }
+    }
+    while (IS_FALSE(found) && (line < colorTable->nbLines))
+    {
+        if (colorTable->spectralType[line].code == spectralType->code)
+        {
+            if (colorTable->spectralType[line].quantity >= spectralType->quantity)
+            {
+                found = mcsTRUE;
+            }
+            else
+            {
+                line++;
+            }
+            codeFound = mcsTRUE;
+        }
+        else if (IS_TRUE(codeFound))
+        {
+            found = mcsTRUE;
+        }
+        else
+        {
+            line++;
+        }
+    }
+    if ((line == 0) && (colorTable->spectralType[line].quantity > spectralType->quantity))
+    {
+        found = mcsFALSE;
+    }
+    if (IS_FALSE(found))
+    {
+        if (IS_TRUE(checkMissing))
+        {
+            return alxNOT_FOUND;
+        }
+        if (line >= colorTable->nbLines)
+        {
+            line = colorTable->nbLines - 1;
+        }
+    }
+    return line;
+}
+
+/* linear scan on longitude ranges (reference) */
+static mcsINT32 getLineFromLongitudeScan(alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION *polynomial, mcsDOUBLE gLon)
+{
+    mcsINT32 i;
+
+    for (i = 0; i < polynomial->nbLines; i++)
+    {
+        if ((gLon >= polynomial->gLonMin[i]) && (gLon < polynomial->gLonMax[i]))
+        {
+            return i;
+        }
+    }
+    return alxNOT_FOUND;
+}
+
+
+/*
+ * Main
+ */
+int main (int argc, char *argv[])
+{
+    /* Configure logging service (missing spectral types are logged as warnings) */
+    logSetStdoutLogLevel(logERROR);
+    logSetPrintDate(mcsFALSE);
+    logSetPrintFileLine(mcsFALSE);
+
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit (EXIT_FAILURE);
+    }
+
+    static const char codes[] = "OBAFGKMLTZ";
+
+    alxCOLOR_TABLE* colorTable;
+    alxSPECTRAL_TYPE spectralType;
+    mcsUINT32 t, c, k, i, nbTests = 0, nbDiffs = 0;
+    mcsINT32 line, lineRef;
+    mcsDOUBLE value, minValue, maxValue;
+
+    for (t = 0; t < alxNB_TABLE_STAR_TYPES; t++)
+    {
+        colorTable = alxGetColorTableForTableStarType((alxTABLE_STAR_TYPE) t);
+        if (colorTable == NULL)
+        {
+            errCloseStack();
+            exit (EXIT_FAILURE);
+        }
+
+        /* colors: sweep table values, mid-points and out of range values */
+        for (c = 0; c < alxNB_COLOR_INDEXES; c++)
+        {
+            minValue = 1e99;
+            maxValue = -1e99;
+            for (k = 0; k < colorTable->nbLines; k++)
+            {
+                if (alxIsSet(colorTable->index[k][c]))
+                {
+                    value = colorTable->index[k][c].value;
+                    minValue = alxMin(minValue, value);
+                    maxValue = alxMax(maxValue, value);
+
+                    nbTests++;
+                    if (alxGetLineFromValue(colorTable, value, c) != getLineFromValueScan(colorTable, value, c))
+                    {
+                        logError("%s: color %u value=%lf differs", colorTable->fileName, c, value);
+                        nbDiffs++;
+                    }
+                }
+            }
+            for (i = 0; i <= NB_SAMPLES + 1; i++)
+            {
+                value = (i == NB_SAMPLES + 1) ? NAN : minValue - 1.0 + (maxValue - minValue + 2.0) * i / NB_SAMPLES;
+
+                nbTests++;
+                line    = alxGetLineFromValue(colorTable, value, c);
+                lineRef = getLineFromValueScan(colorTable, value, c);
+                if (line != lineRef)
+                {
+                    logError("%s: color %u value=%lf: line=%d (scan: %d)", colorTable->fileName, c, value, line, lineRef);
+                    nbDiffs++;
+                }
+            }
+        }
+
+        /* spectral types: every code (and missing ones) over the quantity range */
+        spectralType.isSet = mcsTRUE;
+        for (k = 0; codes[k] != '\0'; k++)
+        {
+            spectralType.code = codes[k];
+            for (i = 0; i <= 480; i++)
+            {
+                spectralType.quantity = -1.0 + 0.025 * i;
+                sprintf(spectralType.origSpType, "%c%.3lf", spectralType.code, spectralType.quantity);
+
+                for (c = 0; c < 2; c++)
+                {
+                    nbTests++;
+                    line    = alxGetLineFromSpectralType(colorTable, &spectralType, (c == 0) ? mcsTRUE : mcsFALSE);
+                    lineRef = getLineFromSpectralTypeScan(colorTable, &spectralType, (c == 0) ? mcsTRUE : mcsFALSE);
+                    if (line != lineRef)
+                    {
+                        logError("%s: spectral type %s (checkMissing=%u): line=%d (scan: %d)", colorTable->fileName,
+                                 spectralType.origSpType, (c == 0), line, lineRef);
+                        nbDiffs++;
+                    }
+                }
+            }
+        }
+    }
+
+    /* longitudes: sweep [-10, 370] including range bounds */
+    alxPOLYNOMIAL_INTERSTELLAR_ABSORPTION* polynomial = alxGetPolynomialForInterstellarAbsorption();
+    if (polynomial == NULL)
+    {
+        errCloseStack();
+        exit (EXIT_FAILURE);
+    }
+    for (i = 0; i <= 2 * NB_SAMPLES + polynomial->nbLines; i++)
+    {
+        value = (i <= 2 * NB_SAMPLES) ? -10.0 + 380.0 * i / (2 * NB_SAMPLES) : polynomial->gLonMin[i - 2 * NB_SAMPLES - 1];
+
+        nbTests++;
+        line    = alxGetLineFromLongitude(polynomial, value);
+        lineRef = getLineFromLongitudeScan(polynomial, value);
+        if (line != lineRef)
+        {
+            logError("longitude %lf: line=%d (scan: %d)", value, line, lineRef);
+            nbDiffs++;
+        }
+    }
+
+    printf("Color table lookups: %u tests: %u diffs\n", nbTests, nbDiffs);
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application */
+    exit ((nbDiffs == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/*___oOo___*/
@@ -13,6 +13,7 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 
 /*
@@ -66,6 +67,9 @@ int main (int argc, char *argv[])
 
     mcsDOUBLE ra, dec, gLat, gLon;
     mcsINT32 i;
+
+    /* batch inputs and scalar results */
+    mcsDOUBLE ras[11], decs[11], gLats[11], gLons[11];
     
     /*
      * Input data set
@@ -138,6 +142,37 @@ int main (int argc, char *argv[])
         {
             return mcsFAILURE;
         }
+        ras[i]   = ra;
+        decs[i]  = dec;
+        gLats[i] = gLat;
+        gLons[i] = gLon;
+    }
+
+    /*
+     * batch computation (compared to scalar results)
+     * ----------------------------------------------
+     */
+    mcsDOUBLE batchLats[11], batchLons[11];
+    mcsINT32 nbDiffs = 0;
+
+    if (alxComputeGalacticCoordinatesBatch(11, ras, decs, batchLats, batchLons) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    for (i = 0; i < 11; i++)
+    {
+        if ((fabs(batchLats[i] - gLats[i]) > 1e-9) || (fabs(batchLons[i] - gLons[i]) > 1e-9))
+        {
+            logError("%s: batch GLat/GLon= %.9lf / %.9lf deg (scalar: %.9lf / %.9lf deg)",
+                     starNameTable[i][0], batchLats[i], batchLons[i], gLats[i], gLons[i]);
+            nbDiffs++;
+        }
+    }
+
+    if (nbDiffs != 0)
+    {
+        exit (EXIT_FAILURE);
     }
     
     logInfo("Exiting...");
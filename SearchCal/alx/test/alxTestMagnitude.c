@@ -13,6 +13,7 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 
 /*
@@ -301,6 +302,44 @@ int main (int argc, char *argv[])
         return mcsFAILURE;
     }
 
+    /* extinction of several stars (compared to the scalar computation) */
+    mcsDOUBLE plxs[6]  = {10.0, 9.10, 1.20, 4.0, 2.5, 0.0};
+    mcsDOUBLE e_plxs[6] = {0.2, 0.2, 0.2, 1.0, 0.5, 0.2};
+    mcsDOUBLE gLats[6] = {5.0, -23.45, -23.58, 65.0, -2.0, 5.0};
+    mcsDOUBLE gLons[6] = {165.0, 166.61, 166.37, 30.0, 359.5, 165.0};
+    mcsDOUBLE avs[6], e_avs[6], dists[6], e_dists[6];
+    mcsUINT32 i, nbDiffs = 0;
+
+    if (alxComputeExtinctionCoefficients(6, avs, e_avs, dists, e_dists, plxs, e_plxs, gLats, gLons) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+    for (i = 0; i < 6; i++)
+    {
+        if (plxs[i] == 0.0)
+        {
+            /* invalid parallax */
+            if (!isnan(avs[i]))
+            {
+                nbDiffs++;
+            }
+            continue;
+        }
+        if (alxComputeExtinctionCoefficient(&av, &e_Av, &dist, &e_dist, plxs[i], e_plxs[i], gLats[i], gLons[i]) == mcsFAILURE)
+        {
+            return mcsFAILURE;
+        }
+        if ((av != avs[i]) || (e_Av != e_avs[i]) || (dist != dists[i]) || (e_dist != e_dists[i]))
+        {
+            logError("star %u: batch Av=%.6lf (%.6lf) (scalar: %.6lf (%.6lf))", i, avs[i], e_avs[i], av, e_Av);
+            nbDiffs++;
+        }
+    }
+    if (nbDiffs != 0)
+    {
+        exit (EXIT_FAILURE);
+    }
+
 
     /* Close MCS services */
     mcsExit();
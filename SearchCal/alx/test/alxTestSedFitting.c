@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Test program (and benchmark) of the SED fitting: compares alxSedFitting()
+ * with the scalar model loop and reports the number of models per second.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <sys/time.h>
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+#include "misc.h"
+
+
+/*
+ * Local Headers
+ */
+#include "alx.h"
+#include "alxPrivate.h"
+
+
+/* SED models (see alxSedFitting.c) */
+#define NB_MODEL 180600
+
+/* number of fitted stars */
+#define NB_STARS 40
+
+/* relative tolerance */
+#define TOLERANCE 1e-12
+
+static mcsDOUBLE modelTeff[NB_MODEL];
+static mcsDOUBLE modelAv[NB_MODEL];
+static mcsDOUBLE modelFlux[NB_MODEL][alxNB_SED_BAND];
+
+static const mcsDOUBLE zeroPoint[alxNB_SED_BAND] = {0.0630823, 0.0361871, 0.00313311, 0.00111137, 0.000428856};
+
+/* load models (model-major like the original implementation) */
+static mcsCOMPL_STAT loadModels(void)
+{
+    char* fileName = miscLocateFile("alxSedModel.cfg");
+    FAIL_NULL(fileName);
+
+    FILE* file = fopen(fileName, "r");
+    free(fileName);
+    FAIL_NULL(file);
+
+    mcsSTRING1024 line;
+    mcsDOUBLE logg;
+    mcsUINT32 n = 0;
+
+    while ((n < NB_MODEL) && (fgets(line, sizeof (line), file) != NULL))
+    {
+        if ((line[0] != '#') && (sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf", &logg, &modelTeff[n], &modelAv[n],
+                                        &modelFlux[n][0], &modelFlux[n][1], &modelFlux[n][2],
+                                        &modelFlux[n][3], &modelFlux[n][4]) == 8))
+        {
+            n++;
+        }
+    }
+    fclose(file);
+
+    return (n == NB_MODEL) ? mcsSUCCESS : mcsFAILURE;
+}
+
+/* scalar model loop (reference) */
+static void sedFittingScalar(alxDATA *magnitudes, mcsDOUBLE Av, mcsDOUBLE e_Av,
+                             mcsDOUBLE *bestDiam, mcsDOUBLE *bestDiamError,
+                             mcsDOUBLE *bestChi2, mcsDOUBLE *bestTeff, mcsDOUBLE *bestAv)
+{
+    static mcsDOUBLE mapChi2[NB_MODEL], mapFluxRatio[NB_MODEL];
+    static const mcsDOUBLE fluxRef = 2.06265e+08;
+
+    mcsDOUBLE fluxData = 0.0, fluxErr;
+    mcsDOUBLE mag[alxNB_SED_BAND], invMagErr[alxNB_SED_BAND];
+    mcsUINT32 bandIdx[alxNB_SED_BAND];
+    mcsUINT32 i, n, b, bestModelIndex = 0, bestResultIndex = 0, nbFree = 0;
+
+    for (b = 0; b < alxNB_SED_BAND; b++)
+    {
+        if (alxIsSet(magnitudes[b]))
+        {
+            mag[nbFree] = zeroPoint[b] * alxPow10(-0.4 * magnitudes[b].value);
+            fluxErr = 1.0 - alxPow10(-0.4 * magnitudes[b].error);
+            invMagErr[nbFree] = fluxErr * mag[nbFree];
+            invMagErr[nbFree] = 1.0 / (invMagErr[nbFree] * invMagErr[nbFree]);
+            fluxData += mag[nbFree] * invMagErr[nbFree];
+            bandIdx[nbFree] = b;
+            nbFree++;
+        }
+    }
+
+    mcsDOUBLE fluxModel, fluxRatio, diffDataModel, chi2, best_chi2 = 1e99, chi2Threshold = 1e99 + 2.0;
+    const mcsLOGICAL hasAv   = (e_Av > 0.0) ? mcsTRUE : mcsFALSE;
+    const mcsDOUBLE invAvErr = (IS_TRUE(hasAv)) ? 1.0 / e_Av : NAN;
+
+    for (n = 0, i = 0; i < NB_MODEL; i++)
+    {
+        fluxModel = 0.0;
+        for (b = 0; b < nbFree; b++)
+        {
+            fluxModel += modelFlux[i][bandIdx[b]] * invMagErr[b];
+        }
+        fluxRatio = fluxData / fluxModel;
+
+        chi2 = 0.0;
+        for (b = 0; b < nbFree; b++)
+        {
+            diffDataModel = mag[b] - (fluxRatio * modelFlux[i][bandIdx[b]]);
+            chi2 += diffDataModel * diffDataModel * invMagErr[b];
+        }
+        if (IS_TRUE(hasAv))
+        {
+            diffDataModel = (Av - modelAv[i]) * invAvErr;
+            chi2 += diffDataModel * diffDataModel;
+        }
+
+        if (chi2 <= best_chi2)
+        {
+            bestModelIndex = i;
+            best_chi2      = chi2;
+            chi2Threshold  = best_chi2 + 2.0;
+            bestResultIndex = n;
+            mapChi2[n]      = chi2;
+            mapFluxRatio[n] = fluxRatio;
+            n++;
+        }
+        else if (chi2 <= chi2Threshold)
+        {
+            mapChi2[n]      = chi2;
+            mapFluxRatio[n] = fluxRatio;
+            n++;
+        }
+    }
+
+    *bestTeff = modelTeff[bestModelIndex];
+    *bestAv   = modelAv[bestModelIndex];
+
+    mcsDOUBLE minFluxRatio = 1e99, maxFluxRatio = 0.0;
+    for (i = 0; i < n; i++)
+    {
+        if (mapChi2[i] <= chi2Threshold)
+        {
+            maxFluxRatio = alxMax(maxFluxRatio, mapFluxRatio[i]);
+            minFluxRatio = alxMin(minFluxRatio, mapFluxRatio[i]);
+        }
+    }
+
+    *bestDiam = fluxRef * sqrt(mapFluxRatio[bestResultIndex]);
+    *bestDiamError = alxMax(fabs(fluxRef * sqrt(maxFluxRatio) - *bestDiam), fabs(*bestDiam - fluxRef * sqrt(minFluxRatio)));
+    *bestChi2 = best_chi2 / (nbFree - 2.0);
+}
+
+static mcsDOUBLE now(void)
+{
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + 1e-6 * time.tv_usec;
+}
+
+static mcsLOGICAL differs(mcsDOUBLE a, mcsDOUBLE b)
+{
+    return (fabs(a - b) > TOLERANCE * alxMax(fabs(a), fabs(b))) ? mcsTRUE : mcsFALSE;
+}
+
+
+/*
+ * Main
+ */
+int main (int argc, char *argv[])
+{
+    /* Configure logging service */
+    logSetStdoutLogLevel(logWARNING);
+    logSetPrintDate(mcsFALSE);
+    logSetPrintFileLine(mcsFALSE);
+
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit (EXIT_FAILURE);
+    }
+
+    if (loadModels() == mcsFAILURE)
+    {
+        logError("Unable to load SED models (alxSedModel.cfg)");
+        exit (EXIT_FAILURE);
+    }
+
+    /* load SED models */
+    alxSedFittingInit();
+
+    /* stars: model fluxes scaled and perturbed (B may be missing, Av given or not) */
+    alxDATA mags[NB_STARS][alxNB_SED_BAND];
+    mcsDOUBLE avs[NB_STARS], eAvs[NB_STARS];
+    mcsUINT32 s, b, nbDiffs = 0;
+
+    srand(1);
+    for (s = 0; s < NB_STARS; s++)
+    {
+        const mcsUINT32 model = (mcsUINT32) ((NB_MODEL - 1.0) * rand() / RAND_MAX);
+        const mcsDOUBLE scale = 1e-17 * (1.0 + 9.0 * rand() / RAND_MAX);
+
+        for (b = 0; b < alxNB_SED_BAND; b++)
+        {
+            mags[s][b].isSet = ((b == 0) && (s % 4 == 0)) ? mcsFALSE : mcsTRUE;
+            mags[s][b].confIndex = alxCONFIDENCE_HIGH;
+            mags[s][b].value = -2.5 * log10(scale * modelFlux[model][b] / zeroPoint[b]) + 0.05 * (2.0 * rand() / RAND_MAX - 1.0);
+            mags[s][b].error = 0.02 + 0.03 * rand() / RAND_MAX;
+        }
+        avs[s]  = modelAv[model];
+        eAvs[s] = (s % 3 == 0) ? 0.0 : 0.1;
+    }
+
+    mcsDOUBLE diam[2], diamError[2], chi2[2], teff[2], av[2];
+    mcsDOUBLE start, time, timeRef = 0.0, timeSed = 0.0;
+
+    for (s = 0; s < NB_STARS; s++)
+    {
+        start = now();
+        sedFittingScalar(mags[s], avs[s], eAvs[s], &diam[0], &diamError[0], &chi2[0], &teff[0], &av[0]);
+        time = now();
+        timeRef += time - start;
+
+        if (alxSedFitting(mags[s], avs[s], eAvs[s], &diam[1], &diamError[1], &chi2[1], &teff[1], &av[1]) == mcsFAILURE)
+        {
+            errCloseStack();
+            exit (EXIT_FAILURE);
+        }
+        timeSed += now() - time;
+
+        if (IS_TRUE(differs(diam[0], diam[1])) || IS_TRUE(differs(diamError[0], diamError[1]))
+                || IS_TRUE(differs(chi2[0], chi2[1])) || (teff[0] != teff[1]) || (av[0] != av[1]))
+        {
+            logError("star %u: diam=%.9lf(%.9lf) chi2=%.9lf teff=%.0lf av=%.3lf (scalar: diam=%.9lf(%.9lf) chi2=%.9lf teff=%.0lf av=%.3lf)",
+                     s, diam[1], diamError[1], chi2[1], teff[1], av[1], diam[0], diamError[0], chi2[0], teff[0], av[0]);
+            nbDiffs++;
+        }
+    }
+
+    printf("SED fitting: %u stars x %u models: %u diffs\n", NB_STARS, NB_MODEL, nbDiffs);
+    printf("scalar loop   : %.1lf Mmodels/s\n", 1e-6 * NB_STARS * NB_MODEL / timeRef);
+    printf("alxSedFitting : %.1lf Mmodels/s\n", 1e-6 * NB_STARS * NB_MODEL / timeSed);
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application */
+    exit ((nbDiffs == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/*___oOo___*/
@@ -271,6 +271,52 @@ int main (int argc, char *argv[])
     printf("\t V²  = %f\n", visibilities.vis2);
     printf("\tdV²  = %f\n", visibilities.vis2Error);
     
+     /****************************/
+    /* batched visibilities (stars x samples) compared with alxComputeVisibility() */
+    mcsDOUBLE diams[4]      = {1.35, 0.452, 0.331, 8.5};
+    mcsDOUBLE diamErrors[4] = {0.13, 0.031, 0.066, 0.4};
+    mcsDOUBLE baselines[24], wlens[24];
+    mcsDOUBLE sampleBaselines[6] = {10.0, 50.0, 100.0, 102.45, 200.0, 330.0};
+    mcsDOUBLE sampleWlens[4]     = {0.6, 1.65, 2.2, 10.0};
+    alxVISIBILITIES batch[4 * 24];
+    mcsUINT32 i, j, nbDiffs = 0;
+
+    for (j = 0; j < 24; j++)
+    {
+        baselines[j] = sampleBaselines[j % 6];
+        wlens[j]     = sampleWlens[j / 6];
+    }
+
+    logSetStdoutLogLevel(logWARNING);
+
+    if (alxComputeVisibilities(4, diams, diamErrors, 24, baselines, wlens, batch) == mcsFAILURE)
+    {
+        return mcsFAILURE;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 24; j++)
+        {
+            if (alxComputeVisibility(diams[i], diamErrors[i], baselines[j], wlens[j], &visibilities) == mcsFAILURE)
+            {
+                return mcsFAILURE;
+            }
+            if ((fabs(visibilities.vis2 - batch[i * 24 + j].vis2) > 1e-6)
+                    || (fabs(visibilities.vis2Error - batch[i * 24 + j].vis2Error) > 1e-6))
+            {
+                logError("diam=%.3lf base=%.2lf wlen=%.2lf: V2=%.9lf (%.9lf) batch: V2=%.9lf (%.9lf)",
+                         diams[i], baselines[j], wlens[j], visibilities.vis2, visibilities.vis2Error,
+                         batch[i * 24 + j].vis2, batch[i * 24 + j].vis2Error);
+                nbDiffs++;
+            }
+        }
+    }
+
+    if (nbDiffs != 0)
+    {
+        exit (EXIT_FAILURE);
+    }
     
     logInfo("Exiting...");
     
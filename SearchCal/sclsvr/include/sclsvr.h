@@ -23,7 +23,9 @@
 #include "sclsvrErrors.h"
 #include "sclsvrGETCAL_CMD.h"
 #include "sclsvrGETSTAR_CMD.h"
+#include "sclsvrJSDC_DATA.h"
 #include "sclsvrSERVER.h"
+#include "sclsvrSERVER_POOL.h"
 #include "sclsvrVersion.h"
 
 
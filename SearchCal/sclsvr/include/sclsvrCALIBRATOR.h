@@ -24,6 +24,7 @@
  * Local header
  */
 #include "sclsvrREQUEST.h"
+#include "sclsvrSPECTRAL_TYPE_CACHE.h"
 
 
 /*
@@ -101,6 +102,9 @@
 /* distance to the science object */
 #define sclsvrCALIBRATOR_DIST               "DIST"
 
+/* squared visibilities of the visibility grid (baselines x wavelengths) */
+#define sclsvrCALIBRATOR_VIS2_GRID          "VIS2_GRID"
+
 /* corrected spectral type */
 #define sclsvrCALIBRATOR_SP_TYPE_JMMC       "SPECTRAL_TYPE"
 
@@ -166,6 +170,9 @@ public:
     // Complete calibrator properties
     mcsCOMPL_STAT Complete(const sclsvrREQUEST &request, miscoDYN_BUF &msgInfo);
 
+    // Complete properties depending on observing parameters
+    mcsCOMPL_STAT CompleteObservability(const sclsvrREQUEST &request);
+
     // Return whether the calibrator has a coherent diameter or not
     mcsLOGICAL IsDiameterOk() const;
 
@@ -188,9 +195,9 @@ private:
     mcsCOMPL_STAT ComputeUDFromLDAndSP();
     mcsCOMPL_STAT ComputeVisibility(const sclsvrREQUEST &request);
     mcsCOMPL_STAT ComputeDistance(const sclsvrREQUEST &request);
-    mcsCOMPL_STAT ComputeTeffLogg();
-    mcsCOMPL_STAT ParseSpectralType();
-    mcsCOMPL_STAT DefineSpectralTypeIndexes();
+    mcsCOMPL_STAT ComputeTeffLogg(const sclsvrSPECTRAL_TYPE_INFO &spTypeInfo);
+    mcsCOMPL_STAT ParseSpectralType(sclsvrSPECTRAL_TYPE_INFO &spTypeInfo);
+    mcsCOMPL_STAT DefineSpectralTypeIndexes(const sclsvrSPECTRAL_TYPE_INFO &spTypeInfo);
     mcsCOMPL_STAT ComputeSedFitting();
 
     mcsCOMPL_STAT ComputeExtinctionCoefficient();
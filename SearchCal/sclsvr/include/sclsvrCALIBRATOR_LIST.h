@@ -45,6 +45,12 @@ public:
 
     virtual mcsCOMPL_STAT Complete(const sclsvrREQUEST &request);
 
+    /** Complete the properties depending on observing parameters of completed calibrators */
+    virtual mcsCOMPL_STAT CompleteObservability(const sclsvrREQUEST &request);
+
+    /** Compute the visibility grid of the request for all calibrators at once */
+    virtual mcsCOMPL_STAT ComputeVisibilityGrid(const sclsvrREQUEST &request);
+
     virtual mcsCOMPL_STAT Pack(miscoDYN_BUF *buffer);
     virtual mcsCOMPL_STAT UnPack(const char *buffer);
 
@@ -75,6 +81,12 @@ protected:
 
 
 private:
+    // Complete calibrators using worker threads
+    mcsCOMPL_STAT CompleteParallel(const sclsvrREQUEST &request, const mcsUINT32 nbThreads);
+
+    // Sort calibrators by distance to the science object
+    mcsCOMPL_STAT SortByDistance(const sclsvrREQUEST &request);
+
     // Declaration assignment operator as private
     // methods, in order to hide them from the users.
     sclsvrCALIBRATOR_LIST& operator=(const sclsvrCALIBRATOR_LIST&) ;
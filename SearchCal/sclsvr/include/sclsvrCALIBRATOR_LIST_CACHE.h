@@ -0,0 +1,79 @@
+#ifndef sclsvrCALIBRATOR_LIST_CACHE_H
+#define sclsvrCALIBRATOR_LIST_CACHE_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of sclsvrCALIBRATOR_LIST_CACHE class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * System header
+ */
+#include <string>
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+/*
+ * Local header
+ */
+#include "sclsvrCALIBRATOR_LIST.h"
+
+/** Maximum number of cached calibrator lists */
+#define sclsvrCALIBRATOR_LIST_CACHE_MAX_ENTRIES 32
+
+/** Maximum number of calibrators in the cache (least recently used lists are evicted first) */
+#define sclsvrCALIBRATOR_LIST_CACHE_MAX_STARS   20000
+
+/** Time to live (seconds) of cached calibrator lists (remote catalogs change over time) */
+#define sclsvrCALIBRATOR_LIST_CACHE_TTL         3600
+
+/*
+ * Class declaration
+ */
+
+/**
+ * sclsvrCALIBRATOR_LIST_CACHE is a process-wide and thread-safe cache of
+ * completed calibrator lists keyed by the search key of the request (science
+ * target, search area, band and bright/faint scenario): a GETCAL request
+ * differing only by its observing parameters (wavelength, baseline) reuses
+ * the completed calibrators and only computes the visibilities and distances.
+ * Cached lists expire after sclsvrCALIBRATOR_LIST_CACHE_TTL.
+ */
+class sclsvrCALIBRATOR_LIST_CACHE
+{
+public:
+    // Copy the cached calibrators of the given key (if any) at the end of the given list
+    static bool Get(const std::string &key, sclsvrCALIBRATOR_LIST &list);
+
+    // Store a copy of the completed calibrators of the given key
+    static void Put(const std::string &key, const sclsvrCALIBRATOR_LIST &list);
+
+    // Return the cache statistics
+    static void GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions,
+                         mcsUINT32 &nbEntries, mcsUINT32 &nbStars);
+
+    // Free all cached entries
+    static void Clear(void);
+
+private:
+    // Declaration of constructors and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrCALIBRATOR_LIST_CACHE();
+    sclsvrCALIBRATOR_LIST_CACHE(const sclsvrCALIBRATOR_LIST_CACHE&);
+    sclsvrCALIBRATOR_LIST_CACHE& operator=(const sclsvrCALIBRATOR_LIST_CACHE&) ;
+} ;
+
+#endif /*!sclsvrCALIBRATOR_LIST_CACHE_H*/
+
+
+/*___oOo___*/
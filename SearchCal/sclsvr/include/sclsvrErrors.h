@@ -22,3 +22,6 @@
 #define sclsvrERR_UNKNOWN_BRIGHT_BAND 14   /**<  Invalid band '%80s' for the BRIGHT scenario: should be V, I, J, H, K or N */
 #define sclsvrERR_UNSUPPORTED_OUTPUT_FORMAT 15   /**<  Unsupported output format '%.1lf' ('%.1lf' expected); please download the latest SearchCal GUI at http://www.jmmc.fr/searchcal */
 #define sclsvrERR_CATALOG_LOAD_JSDC 16   /**<  Could not load JSDC catalog from '%80s' */
+#define sclsvrERR_INVALID_VIS_GRID 17   /**<  Invalid visibility grid: %80s (positive baselines and wavelengths, at most %d samples) */
+#define sclsvrERR_JSDC_RELOAD 18   /**<  Could not reload JSDC data: %80s */
+#define sclsvrERR_JSDC_IMAGE 19   /**<  Invalid JSDC image '%80s': %80s */
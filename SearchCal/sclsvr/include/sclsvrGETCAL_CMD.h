@@ -94,6 +94,12 @@ public:
     virtual mcsLOGICAL IsDefinedDiagnose(void);
     virtual mcsLOGICAL HasDefaultDiagnose(void);
     virtual mcsCOMPL_STAT GetDefaultDiagnose(mcsLOGICAL *_diagnose_);
+    virtual mcsCOMPL_STAT GetVisBaselines(char **_visBaselines_);
+    virtual mcsLOGICAL IsDefinedVisBaselines(void);
+    virtual mcsCOMPL_STAT GetVisWlens(char **_visWlens_);
+    virtual mcsLOGICAL IsDefinedVisWlens(void);
+    virtual mcsCOMPL_STAT GetTimeout(mcsINT32 *_timeout_);
+    virtual mcsLOGICAL IsDefinedTimeout(void);
 
 protected:
 
@@ -0,0 +1,146 @@
+#ifndef sclsvrJSDC_DATA_H
+#define sclsvrJSDC_DATA_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of sclsvrJSDC_DATA class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+#include "vobs.h"
+#include "sclsvrJSDC_IMAGE.h"
+
+/*
+ * Type declaration
+ */
+
+/**
+ * JSDC dataset status
+ */
+typedef struct
+{
+    mcsUINT32   version;            /** current dataset version (0 if none) */
+    mcsUINT32   nbStars;            /** number of stars in the current dataset */
+    mcsDOUBLE   loadTime;           /** load duration of the current dataset (ms) */
+    mcsSTRING32 loadDate;           /** load date of the current dataset */
+    mcsUINT32   nbDatasets;         /** number of datasets in memory (old versions used by pending queries included) */
+    mcsUINT32   nbReloads;          /** number of completed reloads */
+    mcsUINT32   nbFailedReloads;    /** number of failed reloads */
+    bool        reloading;          /** true if a reload is in progress */
+    bool        shared;             /** true if the current dataset is the shared JSDC image */
+} sclsvrJSDC_DATA_STATUS;
+
+/*
+ * Class declaration
+ */
+
+/**
+ * sclsvrJSDC_DATA is one version of the JSDC dataset (bright, faint and
+ * complete star lists with their indexes) shared by all JSDC queries.
+ *
+ * By default (SCLSVR_JSDC_SHARED_FLAG environment variable), the dataset is
+ * the JSDC image file mapped by all server processes (see sclsvrJSDC_IMAGE)
+ * instead of star lists loaded by each process.
+ *
+ * The current version is given by Acquire() with one more reference and must
+ * be given back using Release(): Reload() loads a new version in a background
+ * thread then swaps it with the current one, so pending queries finish on the
+ * old version freed by its last Release().
+ */
+class sclsvrJSDC_DATA
+{
+public:
+    // Load the JSDC dataset (startup)
+    static bool Load(void);
+
+    // Load a new JSDC dataset in background then replace the current one
+    static mcsCOMPL_STAT Reload(void);
+
+    // Free the current JSDC dataset (shutdown)
+    static void Free(void);
+
+    // Return the current JSDC dataset (one more reference) or NULL
+    static sclsvrJSDC_DATA* Acquire(void);
+
+    // Give back the given JSDC dataset
+    static void Release(sclsvrJSDC_DATA* data);
+
+    // Return the JSDC dataset status
+    static void GetStatus(sclsvrJSDC_DATA_STATUS* status);
+
+    // Return the version of the current JSDC dataset (0 if none)
+    static mcsUINT32 GetCurrentVersion(void);
+
+    inline mcsUINT32 GetVersion(void) const __attribute__ ((always_inline))
+    {
+        return _version;
+    }
+
+    inline vobsSTAR_LIST* GetStarListBright(void) const __attribute__ ((always_inline))
+    {
+        return _starListBright;
+    }
+
+    inline vobsSTAR_LIST* GetStarListComplete(void) const __attribute__ ((always_inline))
+    {
+        return _starListComplete;
+    }
+
+    inline sclsvrJSDC_IMAGE* GetImage(void) const __attribute__ ((always_inline))
+    {
+        return _image;
+    }
+
+private:
+    // Use Load(), Reload() and Release() instead
+    sclsvrJSDC_DATA();
+    ~sclsvrJSDC_DATA();
+
+    // Declaration of copy constructor and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrJSDC_DATA(const sclsvrJSDC_DATA&);
+    sclsvrJSDC_DATA& operator=(const sclsvrJSDC_DATA&) ;
+
+    // Load the star lists of this dataset
+    bool LoadData(void);
+
+    // Attach (or build) the shared JSDC image of this dataset
+    bool LoadImage(void);
+
+    // Load a new JSDC dataset and replace the current one (reload thread)
+    static void* ReloadTask(void* arg);
+
+    /** references (current version + pending queries) */
+    volatile mcsUINT32 _refCount;
+
+    /** dataset version */
+    mcsUINT32 _version;
+
+    /** load duration (ms) */
+    mcsDOUBLE _loadTime;
+
+    /** load date */
+    mcsSTRING32 _loadDate;
+
+    vobsSTAR_LIST* _starListBright;
+    vobsSTAR_LIST* _starListFaint;
+    vobsSTAR_LIST* _starListComplete;
+
+    /** shared JSDC image (star lists are not loaded) or NULL */
+    sclsvrJSDC_IMAGE* _image;
+} ;
+
+#endif /*!sclsvrJSDC_DATA_H*/
+
+
+/*___oOo___*/
@@ -0,0 +1,111 @@
+#ifndef sclsvrJSDC_IMAGE_H
+#define sclsvrJSDC_IMAGE_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of sclsvrJSDC_IMAGE class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * System header
+ */
+#include <stddef.h>
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+#include "vobs.h"
+
+/*
+ * Class declaration
+ */
+
+/**
+ * sclsvrJSDC_IMAGE is a read-only memory mapping of the JSDC image file: a
+ * relocatable copy (offsets only, no pointers) of the JSDC stars sorted by
+ * declination with its declination zone index.
+ *
+ * The image file is written once by Build() from the loaded JSDC star lists
+ * then mapped by every server process (MAP_SHARED): the system page cache
+ * holds a single copy of the JSDC whatever the number of processes. Queries
+ * only convert the stars found in the search area into vobsSTAR instances.
+ */
+class sclsvrJSDC_IMAGE
+{
+public:
+    // Class constructor
+    sclsvrJSDC_IMAGE();
+
+    // Class destructor
+    ~sclsvrJSDC_IMAGE();
+
+    // Write the image file of the given star lists
+    static mcsCOMPL_STAT Build(const char* fileName,
+                               const char* fileNameBright,
+                               const char* fileNameFaint,
+                               vobsSTAR_LIST* starListBright,
+                               vobsSTAR_LIST* starListFaint);
+
+    // Map the given image file if it is up to date with the given data files
+    mcsCOMPL_STAT Attach(const char* fileName,
+                         const char* fileNameBright,
+                         const char* fileNameFaint);
+
+    // Search stars matching the given criteria (owned by the output list)
+    mcsCOMPL_STAT Search(vobsSTAR* referenceStar,
+                         vobsSTAR_COMP_CRITERIA_LIST* criteriaList,
+                         bool brightOnly,
+                         vobsSTAR_LIST &outputList,
+                         mcsUINT32 maxMatches) const;
+
+    inline bool IsAttached(void) const __attribute__ ((always_inline))
+    {
+        return IS_NOT_NULL(_base);
+    }
+
+    inline mcsUINT32 GetNbStars(void) const __attribute__ ((always_inline))
+    {
+        return _nbStars;
+    }
+
+    inline mcsUINT32 GetNbBrightStars(void) const __attribute__ ((always_inline))
+    {
+        return _nbBrightStars;
+    }
+
+    inline size_t GetSize(void) const __attribute__ ((always_inline))
+    {
+        return _size;
+    }
+
+private:
+    // Declaration of copy constructor and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrJSDC_IMAGE(const sclsvrJSDC_IMAGE&);
+    sclsvrJSDC_IMAGE& operator=(const sclsvrJSDC_IMAGE&) ;
+
+    // Set the properties of the given star from the image star at the given position
+    mcsCOMPL_STAT GetStar(mcsUINT32 index, vobsSTAR &star) const;
+
+    /** mapped image (read-only) or NULL */
+    const mcsUINT8* _base;
+
+    /** mapped size (bytes) */
+    size_t _size;
+
+    mcsUINT32 _nbStars;
+    mcsUINT32 _nbBrightStars;
+} ;
+
+#endif /*!sclsvrJSDC_IMAGE_H*/
+
+
+/*___oOo___*/
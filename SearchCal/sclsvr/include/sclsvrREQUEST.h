@@ -31,6 +31,9 @@
  */
 #include "sclsvrGETCAL_CMD.h"
 
+/** Maximum number of (baseline, wavelength) samples of the visibility grid */
+#define sclsvrREQUEST_VIS_GRID_MAX_SAMPLES 64
+
 
 /*
  * Class declaration
@@ -55,6 +58,9 @@ public:
     virtual mcsCOMPL_STAT Parse(const char *cmdParamLine);
     virtual mcsCOMPL_STAT GetCmdParamLine(mcsSTRING16384* cmdParamLine) const;
 
+    // Search key (observing parameters excluded)
+    virtual mcsCOMPL_STAT GetSearchKey(string &key) const;
+
     // Set search band (overriden)
     virtual mcsCOMPL_STAT SetSearchBand(const char* searchBand);
 
@@ -86,6 +92,16 @@ public:
     virtual mcsCOMPL_STAT SetDiagnose(mcsLOGICAL diagnose);
     virtual mcsLOGICAL IsDiagnose() const;
 
+    // Visibility grid (baselines x wavelengths)
+    virtual mcsCOMPL_STAT SetVisGrid(const char* baselines, const char* wlens);
+    virtual mcsUINT32 GetVisGridNbSamples(void) const;
+    virtual const mcsDOUBLE* GetVisGridBaselines(void) const;
+    virtual const mcsDOUBLE* GetVisGridWlens(void) const;
+
+    // Maximum duration of the catalog queries
+    virtual mcsCOMPL_STAT SetTimeout(mcsUINT32 timeout);
+    virtual mcsUINT32 GetTimeout(void) const;
+
     virtual mcsCOMPL_STAT AppendParamsToVOTable(string& voTable);
 
     virtual mcsCOMPL_STAT SetJSDCMode(mcsLOGICAL mode);
@@ -107,6 +123,10 @@ private:
     mcsLOGICAL   _noScienceObject;
     mcsDOUBLE    _outputFormat;
     mcsLOGICAL   _diagnose;
+    mcsUINT32    _visGridNbSamples;
+    mcsDOUBLE    _visGridBaselines[sclsvrREQUEST_VIS_GRID_MAX_SAMPLES];
+    mcsDOUBLE    _visGridWlens[sclsvrREQUEST_VIS_GRID_MAX_SAMPLES];
+    mcsUINT32    _timeout;
 
     // Special flags
     // JSDC mode indicates JSDC scenario (ie skip several useless computation steps)
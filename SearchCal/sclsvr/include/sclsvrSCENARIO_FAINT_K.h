@@ -39,6 +39,8 @@ public:
 
     virtual const char* GetScenarioName() const;
 
+    virtual void ReleaseData(void);
+
 protected:
 
 private:
@@ -41,6 +41,8 @@ public:
 
     virtual const char* GetScenarioName() const;
 
+    virtual void ReleaseData(void);
+
 protected:
 
 private:
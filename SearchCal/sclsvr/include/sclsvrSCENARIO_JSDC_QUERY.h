@@ -20,6 +20,11 @@
 #include "mcs.h"
 #include "vobs.h"
 
+/*
+ * Local header
+ */
+#include "sclsvrJSDC_DATA.h"
+
 /*
  * Class declaration
  */
@@ -43,10 +48,8 @@ public:
 
     virtual const char* GetScenarioName() const;
 
-    /** preload the JSDC catalog at startup */
-    static bool loadData();
-    /** free the JSDC catalog at shutdown */
-    static void freeData();
+    // Give back the JSDC dataset used by the last request
+    virtual void ReleaseData(void);
 
 protected:
 
@@ -68,10 +71,8 @@ private:
     // criteria list: RA/DEC within radius (arcsec) + magnitude range
     vobsSTAR_COMP_CRITERIA_LIST _criteriaListRaDecMagRange;
 
-    static bool JSDC_Initialized;
-    static vobsSTAR_LIST* JSDC_StarList_Bright;
-    static vobsSTAR_LIST* JSDC_StarList_Faint;
-    static vobsSTAR_LIST* JSDC_StarList_Complete;
+    // JSDC dataset used by the current request (shared star pointers) or NULL
+    sclsvrJSDC_DATA* _data;
 } ;
 
 #endif /*!sclsvrSCENARIO_JSDC_QUERY*/
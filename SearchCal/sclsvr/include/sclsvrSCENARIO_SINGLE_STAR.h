@@ -39,6 +39,8 @@ public:
 
     virtual const char* GetScenarioName() const;
 
+    virtual void ReleaseData(void);
+
     virtual mcsCOMPL_STAT Init(vobsSCENARIO_RUNTIME &ctx, vobsREQUEST* request, vobsSTAR_LIST* starList);
 
 protected:
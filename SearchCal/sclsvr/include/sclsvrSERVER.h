@@ -19,6 +19,7 @@
  */
 #include "evh.h"
 #include "sdb.h"
+#include "thrd.h"
 
 
 /*
@@ -32,6 +33,7 @@
 #include "sclsvrSCENARIO_FAINT_K.h"
 #include "sclsvrSCENARIO_SINGLE_STAR.h"
 #include "sclsvrSCENARIO_JSDC_QUERY.h"
+#include "sclsvrREQUEST.h"
 
 /* initialize sclsvr module (vobsSTAR meta data) */
 void sclsvrInit(bool loadJSDC);
@@ -73,9 +75,15 @@ public:
     // Get request execution status
     virtual mcsCOMPL_STAT GetStatus(mcsSTRING256* buffer, mcsINT32 timeoutInSec = 300);
 
+    // Get the next request execution status given by the reader cursor (concurrent readers)
+    virtual mcsCOMPL_STAT ReadStatus(mcsSTRING256* buffer, mcsUINT32* cursor, mcsINT32 timeoutInSec = 300);
+
     // Dump the configuration as xml files
     mcsCOMPL_STAT DumpConfigAsXML();
 
+    // Reset the server state to process a new request
+    mcsCOMPL_STAT Reset();
+
     inline bool* GetCancelFlag(void) const __attribute__ ((always_inline))
     {
         return _cancelFlag;
@@ -91,6 +99,15 @@ public:
         return _working;
     }
 
+    /**
+     * Return true if the results of the last request are partial (optional
+     * catalogs skipped at the deadline)
+     */
+    inline bool IsPartial(void) const __attribute__ ((always_inline))
+    {
+        return _virtualObservatory.IsPartial();
+    }
+
     static void SetBuildJSDC(bool flag)
     {
         sclsvrSERVER_buildJSDC = flag;
@@ -121,6 +138,9 @@ public:
         return sclsvrSERVER_queryJSDC_Faint;
     }
 
+    // Priority class of the given GetCal request (scheduling)
+    static thrdPRIORITY GetPriority(const sclsvrREQUEST &request);
+
 
 protected:
     virtual mcsCOMPL_STAT ProcessGetCalCmd(const char* query,
@@ -130,6 +150,9 @@ protected:
                                             miscoDYN_BUF* dynBuf,
                                             msgMESSAGE* msg);
 
+    // Append the partial result PARAMs (deadline reached) to the VOTable
+    void AppendPartialParamsToVOTable(string& voTable) const;
+
 private:
     // Declaration of copy constructor and assignment operator as private
     // methods, in order to hide them from the users.
@@ -0,0 +1,69 @@
+#ifndef sclsvrSERVER_POOL_H
+#define sclsvrSERVER_POOL_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of sclsvrSERVER_POOL class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+/*
+ * Local header
+ */
+#include "sclsvrSERVER.h"
+
+/** Maximum number of idle server instances kept in the pool */
+#define sclsvrSERVER_POOL_MAX_IDLE 16
+
+/*
+ * Class declaration
+ */
+
+/**
+ * sclsvrSERVER_POOL is a process-wide and thread-safe pool of sclsvrSERVER
+ * instances: released servers are reset and reused by the next requests so
+ * their virtual observatory (catalogs, runtime buffers) and scenarios
+ * (criteria lists, filters, star lists) are only built once.
+ */
+class sclsvrSERVER_POOL
+{
+public:
+    // Create the given number of idle server instances
+    static void Init(const mcsUINT32 nbServers);
+
+    // Return an idle server instance (or a new one)
+    static sclsvrSERVER* Acquire(void);
+
+    // Give back the given server instance
+    static void Release(sclsvrSERVER* server);
+
+    // Return the pool statistics
+    static void GetStats(mcsUINT64 &created, mcsUINT64 &reused, mcsUINT64 &deleted,
+                         mcsUINT32 &nbIdle, mcsDOUBLE &createTime, mcsDOUBLE &acquireTime);
+
+    // Free all idle server instances
+    static void Clear(void);
+
+private:
+    // Declaration of constructors and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrSERVER_POOL();
+    sclsvrSERVER_POOL(const sclsvrSERVER_POOL&);
+    sclsvrSERVER_POOL& operator=(const sclsvrSERVER_POOL&) ;
+} ;
+
+#endif /*!sclsvrSERVER_POOL_H*/
+
+
+/*___oOo___*/
@@ -0,0 +1,82 @@
+#ifndef sclsvrSPECTRAL_TYPE_CACHE_H
+#define sclsvrSPECTRAL_TYPE_CACHE_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of sclsvrSPECTRAL_TYPE_CACHE class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+/*
+ * SCALIB header
+ */
+#include "alx.h"
+
+/** Maximum number of decoded spectral types kept in the cache (least recently used are evicted first) */
+#define sclsvrSPECTRAL_TYPE_CACHE_MAX_ENTRIES 65536
+
+/*
+ * Type declaration
+ */
+
+/**
+ * Decoded spectral type and the quantities derived from it (color table
+ * indexes, Teff and LogG), given by the raw spectral type string only.
+ */
+typedef struct
+{
+    alxSPECTRAL_TYPE spectralType; /** decoded spectral type (initialized if not parsed) */
+    mcsLOGICAL parsed;             /** mcsTRUE if alxString2SpectralType() succeeded */
+    mcsINT32 colorTableIndex;      /** index in color tables */
+    mcsINT32 colorTableDelta;      /** delta in color tables */
+    mcsINT32 lumClass;             /** luminosity class */
+    mcsINT32 lumClassDelta;        /** delta in luminosity class */
+    mcsLOGICAL hasTeffLogg;        /** mcsTRUE if Teff and LogG are computed */
+    mcsDOUBLE teff;                /** Teff from the spectral type */
+    mcsDOUBLE logg;                /** LogG from the spectral type */
+} sclsvrSPECTRAL_TYPE_INFO;
+
+/*
+ * Class declaration
+ */
+
+/**
+ * sclsvrSPECTRAL_TYPE_CACHE is a process-wide and thread-safe memo cache of
+ * decoded spectral types keyed by the raw spectral type string: the same
+ * spectral types are shared by many stars (JSDC).
+ */
+class sclsvrSPECTRAL_TYPE_CACHE
+{
+public:
+    // Decode the given spectral type (or get it from the cache)
+    static void Decode(const char* spType, sclsvrSPECTRAL_TYPE_INFO &info);
+
+    // Return the cache statistics
+    static void GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions, mcsUINT32 &nbEntries);
+
+    // Free all cached entries
+    static void Clear(void);
+
+private:
+    // Declaration of constructors and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrSPECTRAL_TYPE_CACHE();
+    sclsvrSPECTRAL_TYPE_CACHE(const sclsvrSPECTRAL_TYPE_CACHE&);
+    sclsvrSPECTRAL_TYPE_CACHE& operator=(const sclsvrSPECTRAL_TYPE_CACHE&) ;
+} ;
+
+#endif /*!sclsvrSPECTRAL_TYPE_CACHE_H*/
+
+
+/*___oOo___*/
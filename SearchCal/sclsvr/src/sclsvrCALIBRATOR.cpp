@@ -14,6 +14,7 @@
 using namespace std;
 
 #include <math.h>
+#include <string.h>
 
 /*
  * MCS Headers
@@ -42,7 +43,7 @@ using namespace std;
 
 /* maximum number of properties (147 max) */
 #define sclsvrCALIBRATOR_MAX_PROPERTIES \
-    ( vobsSTAR_MAX_PROPERTIES + ( (alxIsDeprecatedFlag() ? 43 : 35) ) )
+    ( vobsSTAR_MAX_PROPERTIES + ( (alxIsDeprecatedFlag() ? 44 : 36) ) )
 
 /* Error identifiers */
 #define sclsvrCALIBRATOR_PHOT_COUS_J_ERROR  "PHOT_COUS_J_ERROR"
@@ -202,11 +203,12 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::Complete(const sclsvrREQUEST &request, miscoDYN_
     logTest("----- Complete: star '%s'", starId);
 
     // Parse spectral type.
-    FAIL(ParseSpectralType());
-    FAIL(DefineSpectralTypeIndexes());
+    sclsvrSPECTRAL_TYPE_INFO spTypeInfo;
+    FAIL(ParseSpectralType(spTypeInfo));
+    FAIL(DefineSpectralTypeIndexes(spTypeInfo));
 
     // Fill in the Teff and LogG entries using the spectral type (bright)
-    FAIL(ComputeTeffLogg());
+    FAIL(ComputeTeffLogg(spTypeInfo));
 
     // Fix missing V mag with SIMBAD or GAIA information:
     FAIL(UpdateMissingMagV());
@@ -251,11 +253,8 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::Complete(const sclsvrREQUEST &request, miscoDYN_
 
     if (IS_FALSE(request.IsJSDCMode()))
     {
-        // Compute visibility and visibility error only if diameter OK
-        FAIL(ComputeVisibility(request));
-
-        // Compute distance
-        FAIL(ComputeDistance(request));
+        // Compute visibility and distance (observing parameters)
+        FAIL(CompleteObservability(request));
 
         // Final clean up:
         CleanProperties();
@@ -268,6 +267,29 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::Complete(const sclsvrREQUEST &request, miscoDYN_
     return mcsSUCCESS;
 }
 
+/**
+ * Complete the properties depending on the observing parameters of the
+ * request (wavelength, baseline and science object) of an already completed
+ * calibrator: values computed for a previous request are cleared first.
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrCALIBRATOR::CompleteObservability(const sclsvrREQUEST &request)
+{
+    // Clear values given by a previous request (reused calibrator)
+    FAIL(ClearPropertyValue(sclsvrCALIBRATOR_VIS2));
+    FAIL(ClearPropertyValue(sclsvrCALIBRATOR_DIST));
+    FAIL(ClearPropertyValue(sclsvrCALIBRATOR_VIS2_GRID));
+
+    // Compute visibility and visibility error only if diameter OK
+    FAIL(ComputeVisibility(request));
+
+    // Compute distance
+    FAIL(ComputeDistance(request));
+
+    return mcsSUCCESS;
+}
+
 
 /*
  * Private methods
@@ -1073,27 +1095,28 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::ComputeAngularDiameter(miscoDYN_BUF &msgInfo)
 
             logTest("Sampling spectral type range [%u .. %u]", idxMin, idxMax);
 
+            // Compute diameters for all spectral type indexes at once:
+            FAIL(alxComputeAngularDiametersSampled(mags, idxMin, idxMax, nbRequiredDiameters,
+                                                   diamsSp, meanDiamSp, chi2DiamSp, nbDiametersSp));
+
             mcsUINT32 index;
 
             for (index = idxMin; index <= idxMax; index++)
             {
-                sprintf(msg, "SP=%u", index);
-
-                // Associate color table index to the current sample:
-                sampleSpTypeIndex[nSample] = index;
-
-                // convert as double:
-                spTypeIndex = index;
+                const mcsUINT32 sample = index - idxMin;
 
-                // Compute diameters for spectral type index:
-                FAIL(alxComputeAngularDiameters   (msg, mags, spTypeIndex, diamsSp[nSample], diametersCov, logDEBUG));
-
-                FAIL(alxComputeMeanAngularDiameter(diamsSp[nSample], diametersCov, nbRequiredDiameters, &meanDiamSp[nSample],
-                                                   &chi2DiamSp[nSample], &nbDiametersSp[nSample], NULL, logDEBUG));
-
-                if (alxIsSet(meanDiamSp[nSample]))
+                if (alxIsSet(meanDiamSp[sample]))
                 {
-                    // keep that sample:
+                    // keep that sample (compact arrays):
+                    if (nSample != sample)
+                    {
+                        memcpy(diamsSp[nSample], diamsSp[sample], sizeof (alxDIAMETERS));
+                        meanDiamSp[nSample] = meanDiamSp[sample];
+                        chi2DiamSp[nSample] = chi2DiamSp[sample];
+                        nbDiametersSp[nSample] = nbDiametersSp[sample];
+                    }
+                    // Associate color table index to the current sample:
+                    sampleSpTypeIndex[nSample] = index;
                     nSample++;
                 }
             }
@@ -1575,31 +1598,39 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::ComputeDistance(const sclsvrREQUEST &request)
 /**
  * Parse spectral type if available.
  *
+ * The decoded spectral type and its derived quantities (color table indexes,
+ * Teff and LogG) are given by the spectral type cache.
+ *
+ * @param spTypeInfo decoded spectral type to use in DefineSpectralTypeIndexes() and ComputeTeffLogg()
+ *
  * @return mcsSUCCESS on successful parsing, mcsFAILURE otherwise.
  */
-mcsCOMPL_STAT sclsvrCALIBRATOR::ParseSpectralType()
+mcsCOMPL_STAT sclsvrCALIBRATOR::ParseSpectralType(sclsvrSPECTRAL_TYPE_INFO &spTypeInfo)
 {
-    // initialize the spectral type structure anyway:
-    FAIL(alxInitializeSpectralType(&_spectralType));
+    mcsSTRING32 spType;
+    memset(spType, '\0', sizeof (spType));
 
     vobsSTAR_PROPERTY* property = GetProperty(vobsSTAR_SPECT_TYPE_MK);
+    if (IsPropertySet(property))
+    {
+        strncpy(spType, GetPropertyValue(property), sizeof (spType) - 1);
+    }
+
+    // Decode the spectral type anyway (initialized if not available):
+    sclsvrSPECTRAL_TYPE_CACHE::Decode(spType, spTypeInfo);
+
+    _spectralType = spTypeInfo.spectralType;
+
     SUCCESS_FALSE_DO(IsPropertySet(property),
                      logTest("Spectral Type - Skipping (no SpType available)."));
 
-    mcsSTRING32 spType;
-    strncpy(spType, GetPropertyValue(property), sizeof (spType) - 1);
     SUCCESS_COND_DO(IS_STR_EMPTY(spType),
                     logTest("Spectral Type - Skipping (SpType unknown)."));
 
     logDebug("Parsing Spectral Type '%s'.", spType);
 
-    /*
-     * Get each part of the spectral type XN.NLLL where X is a letter, N.N a
-     * number between 0 and 9 and LLL is the light class
-     */
-    SUCCESS_DO(alxString2SpectralType(spType, &_spectralType),
-               errCloseStack();
-               logTest("Spectral Type - Skipping (could not parse SpType '%s').", spType));
+    SUCCESS_FALSE_DO(spTypeInfo.parsed,
+                     logTest("Spectral Type - Skipping (could not parse SpType '%s').", spType));
 
     if (IS_TRUE(_spectralType.isSpectralBinary))
     {
@@ -1626,23 +1657,20 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::ParseSpectralType()
 /**
  * Define color table indexes based on the original spectral type if available.
  *
+ * @param spTypeInfo decoded spectral type
+ *
  * @return mcsSUCCESS on successful parsing, mcsFAILURE otherwise.
  */
-mcsCOMPL_STAT sclsvrCALIBRATOR::DefineSpectralTypeIndexes()
+mcsCOMPL_STAT sclsvrCALIBRATOR::DefineSpectralTypeIndexes(const sclsvrSPECTRAL_TYPE_INFO &spTypeInfo)
 {
-    mcsINT32 colorTableIndex, colorTableDelta, lumClass, deltaLumClass;
-
-    alxGiveIndexInTableOfSpectralCodes(_spectralType,
-                                       &colorTableIndex, &colorTableDelta, &lumClass, &deltaLumClass);
-
     // Set index in color tables
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_COLOR_TABLE_INDEX, colorTableIndex, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_COLOR_TABLE_INDEX, spTypeInfo.colorTableIndex, vobsORIG_COMPUTED));
     // Set delta in color tables
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_COLOR_TABLE_DELTA, colorTableDelta, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_COLOR_TABLE_DELTA, spTypeInfo.colorTableDelta, vobsORIG_COMPUTED));
     // Set luminosity class
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LUM_CLASS, lumClass, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LUM_CLASS, spTypeInfo.lumClass, vobsORIG_COMPUTED));
     // Set delta in luminosity class
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LUM_CLASS_DELTA, deltaLumClass, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LUM_CLASS_DELTA, spTypeInfo.lumClassDelta, vobsORIG_COMPUTED));
 
     return mcsSUCCESS;
 }
@@ -1650,23 +1678,22 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::DefineSpectralTypeIndexes()
 /**
  * Compute Teff and Log(g) from the SpType and Tables
  *
+ * @param spTypeInfo decoded spectral type
+ *
  * @return Always mcsSUCCESS.
  */
-mcsCOMPL_STAT sclsvrCALIBRATOR::ComputeTeffLogg()
+mcsCOMPL_STAT sclsvrCALIBRATOR::ComputeTeffLogg(const sclsvrSPECTRAL_TYPE_INFO &spTypeInfo)
 {
     SUCCESS_FALSE_DO(_spectralType.isSet,
                      logTest("Teff and LogG - Skipping (SpType unknown)."));
 
-    mcsDOUBLE Teff = NAN;
-    mcsDOUBLE LogG = NAN;
-
     //Get Teff
-    SUCCESS_DO(alxComputeTeffAndLoggFromSptype(&_spectralType, &Teff, &LogG),
-               logTest("Teff and LogG - Skipping (alxComputeTeffAndLoggFromSptype() failed on this spectral type: '%s').", _spectralType.origSpType));
+    SUCCESS_FALSE_DO(spTypeInfo.hasTeffLogg,
+                     logTest("Teff and LogG - Skipping (alxComputeTeffAndLoggFromSptype() failed on this spectral type: '%s').", _spectralType.origSpType));
 
     // Set Teff eand LogG properties
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_TEFF_SPTYP, Teff, vobsORIG_COMPUTED));
-    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LOGG_SPTYP, LogG, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_TEFF_SPTYP, spTypeInfo.teff, vobsORIG_COMPUTED));
+    FAIL(SetPropertyValue(sclsvrCALIBRATOR_LOGG_SPTYP, spTypeInfo.logg, vobsORIG_COMPUTED));
 
     return mcsSUCCESS;
 }
@@ -2311,6 +2338,11 @@ mcsCOMPL_STAT sclsvrCALIBRATOR::AddProperties(void)
         /* RA/DEC coordinates in degrees */
         AddPropertyMeta(sclsvrCALIBRATOR_POS_EQ_RA, "RA", vobsFLOAT_PROPERTY, "deg", "Right Ascension in degrees - J2000");
         AddPropertyMeta(sclsvrCALIBRATOR_POS_EQ_DE, "DEC", vobsFLOAT_PROPERTY, "deg", "Declination in degrees - J2000");
+
+        /* squared visibilities of the visibility grid (last property: only set if a grid is requested) */
+        AddPropertyMeta(sclsvrCALIBRATOR_VIS2_GRID, "vis2Grid", vobsSTRING_PROPERTY, NULL,
+                        "Squared Visibility and its error (vis2,vis2Err;...) for each (visWlens, visBaselines) sample, wavelength major");
+        SetPropertyMetaOptional();
         
         // End of Meta data
         sclsvrCALIBRATOR::sclsvrCALIBRATOR_PropertyMetaEnd = vobsSTAR_PROPERTY_META::vobsStar_PropertyMetaList.size();
@@ -11,6 +11,8 @@
  * System Headers
  */
 #include <iostream>
+#include <vector>
+#include <unistd.h>
 using namespace std;
 
 
@@ -20,6 +22,8 @@ using namespace std;
 #include "mcs.h"
 #include "log.h"
 #include "err.h"
+#include "misc.h"
+#include "thrd.h"
 
 
 /*
@@ -31,6 +35,263 @@ using namespace std;
 #include "sclsvrErrors.h"
 #include "sclsvrCALIBRATOR_LIST.h"
 
+/** Minimum number of calibrators to complete them in parallel */
+#define sclsvrCOMPLETE_PARALLEL_MIN     200
+
+/** Number of calibrators taken at once by a worker */
+#define sclsvrCOMPLETE_CHUNK            16
+
+/** Maximum number of worker threads */
+#define sclsvrCOMPLETE_MAX_THREADS      16
+
+/** environment variable giving the number of worker threads (1 = sequential) */
+#define sclsvrCOMPLETE_THREADS_ENVVAR_NAME  "SCLSVR_COMPLETE_THREADS"
+
+/*
+ * Local Types
+ */
+
+struct sclsvrCOMPLETE_TASK;
+
+/**
+ * Worker completing calibrators: the calibrator range [begin, end[ is packed
+ * in one 64 bits word (begin << 32 | end) so the owner takes chunks from the
+ * front and idle workers steal the back half with compare and swap.
+ */
+typedef struct
+{
+    volatile mcsUINT64   range;         /** packed calibrator range */
+    sclsvrCOMPLETE_TASK* task;          /** shared task */
+    thrdTHREAD_STRUCT    thread;        /** worker thread */
+} sclsvrCOMPLETE_WORKER;
+
+/**
+ * Parallel Complete task shared by all workers
+ */
+struct sclsvrCOMPLETE_TASK
+{
+    const sclsvrREQUEST*    request;    /** user request */
+    sclsvrCALIBRATOR**      calibrators;/** calibrators (list order) */
+    sclsvrCOMPLETE_WORKER*  workers;    /** workers */
+    mcsUINT32               nbWorkers;  /** number of workers */
+    bool*                   cancelFlag; /** cancel flag of the calling thread */
+    volatile bool           failed;     /** true if one calibrator failed */
+    volatile bool           cancelled;  /** true if the request was cancelled */
+} ;
+
+/*
+ * Local functions
+ */
+
+/**
+ * Return the number of worker threads used to complete calibrators
+ * (SCLSVR_COMPLETE_THREADS or the number of online processors).
+ * @return number of worker threads (1 = sequential)
+ */
+static mcsUINT32 sclsvrGetCompleteThreads(void)
+{
+    static mcsINT32 nbThreads = -1;
+
+    if (nbThreads == -1)
+    {
+        mcsINT32 value;
+        if (miscGetEnvVarIntValue(sclsvrCOMPLETE_THREADS_ENVVAR_NAME, &value) == mcsFAILURE)
+        {
+            errResetStack();
+            value = (mcsINT32) sysconf(_SC_NPROCESSORS_ONLN);
+        }
+        nbThreads = alxMax(1, alxMin(value, sclsvrCOMPLETE_MAX_THREADS));
+
+        logInfo("Complete: %d worker thread(s)", nbThreads);
+    }
+    return nbThreads;
+}
+
+/**
+ * Create the priority gate of the Complete phases: one slot per Complete
+ * thread (calling threads and parallel workers) so concurrent Complete
+ * phases never use more threads than sclsvrGetCompleteThreads(), one of them
+ * reserved to interactive requests.
+ * @return priority gate or NULL if unavailable
+ */
+static thrdPRIORITY_GATE* sclsvrCreateCompleteGate(void)
+{
+    const mcsUINT32 nbSlots = sclsvrGetCompleteThreads();
+
+    thrdPRIORITY_GATE* gate = thrdPriorityGateGet("complete", nbSlots, (nbSlots > 1) ? 1 : 0);
+    if (IS_NULL(gate))
+    {
+        // Complete phases are not limited:
+        errCloseStack();
+    }
+    return gate;
+}
+
+/**
+ * Return the priority gate of the Complete phases
+ * @return priority gate or NULL if unavailable
+ */
+static thrdPRIORITY_GATE* sclsvrGetCompleteGate(void)
+{
+    static thrdPRIORITY_GATE* completeGate = sclsvrCreateCompleteGate();
+
+    return completeGate;
+}
+
+/**
+ * Slot of the Complete priority gate held by the calling thread during its
+ * scope (none if the gate is unavailable): CPU-heavy Complete phases are served
+ * by the priority of the current request (see thrdPrioritySet) so interactive
+ * requests are not delayed by batch ones.
+ */
+class sclsvrCOMPLETE_SLOT
+{
+public:
+
+    sclsvrCOMPLETE_SLOT()
+    {
+        _gate = sclsvrGetCompleteGate();
+
+        if (IS_NOT_NULL(_gate) && (thrdPriorityGateAcquire(_gate, thrdPriorityGet()) == mcsFAILURE))
+        {
+            errCloseStack();
+            _gate = NULL;
+        }
+    }
+
+    ~sclsvrCOMPLETE_SLOT()
+    {
+        if (IS_NOT_NULL(_gate))
+        {
+            thrdPriorityGateRelease(_gate);
+        }
+    }
+
+private:
+    // Declaration of copy constructor and assignment operator as private
+    // methods, in order to hide them from the users.
+    sclsvrCOMPLETE_SLOT(const sclsvrCOMPLETE_SLOT&);
+    sclsvrCOMPLETE_SLOT& operator=(const sclsvrCOMPLETE_SLOT&) ;
+
+    /** acquired gate or NULL */
+    thrdPRIORITY_GATE* _gate;
+} ;
+
+/**
+ * Take the next chunk of the given range (owner side)
+ * @return true if a chunk was taken
+ */
+static bool sclsvrCompletePop(volatile mcsUINT64* range, mcsUINT32 &begin, mcsUINT32 &end)
+{
+    for (;;)
+    {
+        const mcsUINT64 old = *range;
+        const mcsUINT32 b = (mcsUINT32) (old >> 32);
+        const mcsUINT32 e = (mcsUINT32) old;
+
+        if (b >= e)
+        {
+            return false;
+        }
+        const mcsUINT32 next = alxMin(b + sclsvrCOMPLETE_CHUNK, e);
+
+        if (__sync_bool_compare_and_swap(range, old, ((mcsUINT64) next << 32) | e))
+        {
+            begin = b;
+            end = next;
+            return true;
+        }
+    }
+}
+
+/**
+ * Steal the back half of the given range (thief side)
+ * @return true if calibrators were stolen
+ */
+static bool sclsvrCompleteSteal(volatile mcsUINT64* range, mcsUINT32 &begin, mcsUINT32 &end)
+{
+    for (;;)
+    {
+        const mcsUINT64 old = *range;
+        const mcsUINT32 b = (mcsUINT32) (old >> 32);
+        const mcsUINT32 e = (mcsUINT32) old;
+
+        if (b >= e)
+        {
+            return false;
+        }
+        const mcsUINT32 mid = b + (e - b) / 2;
+
+        if (__sync_bool_compare_and_swap(range, old, ((mcsUINT64) b << 32) | mid))
+        {
+            begin = mid;
+            end = e;
+            return true;
+        }
+    }
+}
+
+/**
+ * Worker thread: complete calibrators of its own range then steal work from
+ * other workers until no calibrator is left.
+ */
+static thrdFCT_RET sclsvrCompleteWorker(thrdFCT_ARG param)
+{
+    sclsvrCOMPLETE_WORKER* worker = (sclsvrCOMPLETE_WORKER*) param;
+    sclsvrCOMPLETE_TASK* task = worker->task;
+
+    // Share the cancel flag of the calling thread:
+    vobsSetCancelFlag(task->cancelFlag);
+
+    // Prepare information buffer (per worker):
+    miscoDYN_BUF infoMsg;
+    infoMsg.Reserve(1024);
+
+    mcsUINT32 begin, end;
+
+    while (!task->failed && !task->cancelled)
+    {
+        if (!sclsvrCompletePop(&worker->range, begin, end))
+        {
+            // steal work from other workers:
+            bool stolen = false;
+            for (mcsUINT32 i = 0; (i < task->nbWorkers) && !stolen; i++)
+            {
+                sclsvrCOMPLETE_WORKER* victim = &task->workers[i];
+                if (victim != worker)
+                {
+                    stolen = sclsvrCompleteSteal(&victim->range, begin, end);
+                }
+            }
+            if (!stolen)
+            {
+                // no calibrator left
+                break;
+            }
+            // own the stolen range:
+            worker->range = ((mcsUINT64) begin << 32) | end;
+            continue;
+        }
+
+        for (mcsUINT32 el = begin; el < end; el++)
+        {
+            if (task->calibrators[el]->Complete(*task->request, infoMsg) == mcsFAILURE)
+            {
+                errCloseStack();
+                task->failed = true;
+                break;
+            }
+        }
+
+        // Check cancellation every chunk:
+        if (vobsIsCancelled())
+        {
+            task->cancelled = true;
+        }
+    }
+    return NULL;
+}
+
 /**
  * Class constructor
  */
@@ -153,36 +414,293 @@ mcsCOMPL_STAT sclsvrCALIBRATOR_LIST::Complete(const sclsvrREQUEST &request)
     }
     logTest("Complete: start [%d stars]", nbStars);
 
-    // Prepare information buffer:
-    miscoDYN_BUF infoMsg;
-    infoMsg.Reserve(1024);
+    mcsUINT64 spTypeHits, spTypeMisses, spTypeEvictions;
+    mcsUINT32 spTypeEntries;
+    sclsvrSPECTRAL_TYPE_CACHE::GetStats(spTypeHits, spTypeMisses, spTypeEvictions, spTypeEntries);
+
+    // Worker threads do not log into the request thread log (diagnose / dev mode): complete sequentially then
+    const mcsUINT32 nbThreads = ((nbStars >= sclsvrCOMPLETE_PARALLEL_MIN) && IS_FALSE(logIsThreadContextEnabled()))
+            ? sclsvrGetCompleteThreads() : 1;
+
+    // Wait for a Complete slot (by request priority) released at the end of this method:
+    sclsvrCOMPLETE_SLOT completeSlot;
+
+    if (nbThreads > 1)
+    {
+        FAIL(CompleteParallel(request, nbThreads));
+    }
+    else
+    {
+        // Prepare information buffer:
+        miscoDYN_BUF infoMsg;
+        infoMsg.Reserve(1024);
+
+        sclsvrCALIBRATOR* calibrator;
+
+        // For each calibrator of the list
+        for (mcsUINT32 el = 0; el < nbStars; el++)
+        {
+            // Complete the calibrator
+            calibrator = (sclsvrCALIBRATOR*) GetNextStar((mcsLOGICAL) (el == 0));
+
+            FAIL(calibrator->Complete(request, infoMsg));
+
+            // Check cancellation every 100 stars:
+            if (el % 100 == 0)
+            {
+                FAIL_COND(vobsIsCancelled());
+            }
+        }
+    }
+
+    if (IS_FALSE(request.IsJSDCMode()))
+    {
+        FAIL(SortByDistance(request));
+    }
+
+    logTest("Complete: done [%d stars]", nbStars);
+
+    if (nbStars != 0)
+    {
+        mcsUINT64 hits, misses, evictions;
+        sclsvrSPECTRAL_TYPE_CACHE::GetStats(hits, misses, evictions, spTypeEntries);
+
+        // global counters: lookups of concurrent requests are included
+        hits -= spTypeHits;
+        misses -= spTypeMisses;
+
+        logInfo("Spectral type cache (all requests during Complete): %llu hit(s), %llu miss(es) [global hit rate: %.1lf%%] - %u entries (%llu evicted in total)",
+                (unsigned long long) hits, (unsigned long long) misses, (100.0 * hits) / alxMax(1, hits + misses),
+                spTypeEntries, (unsigned long long) evictions);
+    }
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Complete the properties depending on the observing parameters of the given
+ * request (visibility, distance) of each calibrator of this already completed
+ * list (reused calibrators).
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrCALIBRATOR_LIST::CompleteObservability(const sclsvrREQUEST &request)
+{
+    const mcsUINT32 nbStars = Size();
+
+    logTest("CompleteObservability: start [%d stars]", nbStars);
 
     sclsvrCALIBRATOR* calibrator;
 
     // For each calibrator of the list
     for (mcsUINT32 el = 0; el < nbStars; el++)
     {
-        // Complete the calibrator
         calibrator = (sclsvrCALIBRATOR*) GetNextStar((mcsLOGICAL) (el == 0));
 
-        FAIL(calibrator->Complete(request, infoMsg));
+        FAIL(calibrator->CompleteObservability(request));
+    }
+
+    FAIL(SortByDistance(request));
+
+    logTest("CompleteObservability: done [%d stars]", nbStars);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Compute the squared visibilities of the visibility grid of the given request
+ * (baselines x wavelengths) for all calibrators having a valid LD diameter in
+ * one batch (alxComputeVisibilities).
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrCALIBRATOR_LIST::ComputeVisibilityGrid(const sclsvrREQUEST &request)
+{
+    const mcsUINT32 nbSamples = request.GetVisGridNbSamples();
+    const mcsUINT32 nbStars = Size();
+
+    SUCCESS_COND((nbSamples == 0) || (nbStars == 0));
+
+    // Calibrators having a valid LD diameter:
+    vector<sclsvrCALIBRATOR*> calibrators;
+    vector<mcsDOUBLE> diams, diamErrors;
+    calibrators.reserve(nbStars);
+    diams.reserve(nbStars);
+    diamErrors.reserve(nbStars);
 
-        // Check cancellation every 100 stars:
-        if (el % 100 == 0)
+    sclsvrCALIBRATOR* calibrator;
+    vobsSTAR_PROPERTY* property;
+    mcsDOUBLE diam, diamError;
+
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        calibrator = (sclsvrCALIBRATOR*) GetNextStar((mcsLOGICAL) (el == 0));
+
+        property = calibrator->GetProperty(sclsvrCALIBRATOR_LD_DIAM);
+
+        if (IS_TRUE(calibrator->IsDiameterOk()) && isPropSet(property))
         {
-            FAIL_COND(vobsIsCancelled());
+            FAIL(calibrator->GetPropertyValueAndError(property, &diam, &diamError));
+
+            calibrators.push_back(calibrator);
+            diams.push_back(diam);
+            diamErrors.push_back(diamError);
         }
     }
 
-    if (IS_FALSE(request.IsJSDCMode()) && IS_TRUE(request.hasObjectRaDec()))
+    const mcsUINT32 nbCalibrators = calibrators.size();
+
+    logTest("ComputeVisibilityGrid: %d calibrators x %d samples", nbCalibrators, nbSamples);
+
+    SUCCESS_COND(nbCalibrators == 0);
+
+    vector<alxVISIBILITIES> visibilities(nbCalibrators * nbSamples);
+
+    FAIL(alxComputeVisibilities(nbCalibrators, &diams[0], &diamErrors[0],
+                                nbSamples, request.GetVisGridBaselines(), request.GetVisGridWlens(), &visibilities[0]));
+
+    string value;
+    value.reserve(24 * nbSamples);
+    mcsSTRING32 sample;
+
+    for (mcsUINT32 i = 0; i < nbCalibrators; i++)
     {
-        // Sort calibrators according to their distance from the science object in
-        // ascending order, i.e. the closest first.
-        Sort(sclsvrCALIBRATOR_DIST);
+        const alxVISIBILITIES* vis = &visibilities[i * nbSamples];
+
+        value.clear();
+        for (mcsUINT32 j = 0; j < nbSamples; j++)
+        {
+            snprintf(sample, sizeof (sample) - 1, (j == 0) ? "%.6lf,%.6lf" : ";%.6lf,%.6lf", vis[j].vis2, vis[j].vis2Error);
+            value.append(sample);
+        }
+
+        // Use the confidence index of the LD diameter
+        property = calibrators[i]->GetProperty(sclsvrCALIBRATOR_LD_DIAM);
+
+        FAIL(calibrators[i]->SetPropertyValue(sclsvrCALIBRATOR_VIS2_GRID, value.c_str(), vobsORIG_COMPUTED, property->GetConfidenceIndex()));
     }
 
-    logTest("Complete: done [%d stars]", nbStars);
+    return mcsSUCCESS;
+}
+
+/**
+ * Sort calibrators according to their distance from the science object in
+ * ascending order, i.e. the closest first (if the science object coordinates
+ * are given).
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrCALIBRATOR_LIST::SortByDistance(const sclsvrREQUEST &request)
+{
+    if (IS_TRUE(request.hasObjectRaDec()))
+    {
+        FAIL(Sort(sclsvrCALIBRATOR_DIST));
+    }
+    return mcsSUCCESS;
+}
+
+/**
+ * Complete each calibrator of the list using several worker threads: the
+ * list is split in contiguous ranges (one per worker) and idle workers steal
+ * work from the others. Calibrators are completed in place so the list
+ * order is preserved.
+ *
+ * @param request the user request
+ * @param nbThreads maximum number of worker threads (including the calling
+ * thread): additional workers are only started on free Complete slots
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrCALIBRATOR_LIST::CompleteParallel(const sclsvrREQUEST &request, const mcsUINT32 nbThreads)
+{
+    const mcsUINT32 nbStars = Size();
+
+    // Ensure all alx tables are loaded before concurrent use:
+    alxInit();
+
+    // Calibrators in list order:
+    vector<sclsvrCALIBRATOR*> calibrators;
+    calibrators.reserve(nbStars);
+
+    for (vobsSTAR_PTR_LIST::const_iterator iter = _starList.begin(); iter != _starList.end(); iter++)
+    {
+        calibrators.push_back((sclsvrCALIBRATOR*) *iter);
+    }
+
+    // One Complete slot per additional worker (the calling thread holds one),
+    // taken only if free so that parallel phases use idle threads only:
+    thrdPRIORITY_GATE* gate = sclsvrGetCompleteGate();
+    const thrdPRIORITY priority = thrdPriorityGet();
 
+    mcsUINT32 nbWorkers = 1;
+    while ((nbWorkers < nbThreads) && (IS_NULL(gate) || IS_TRUE(thrdPriorityGateTryAcquire(gate, priority))))
+    {
+        nbWorkers++;
+    }
+
+    vector<sclsvrCOMPLETE_WORKER> workers(nbWorkers);
+
+    sclsvrCOMPLETE_TASK task;
+    task.request = &request;
+    task.calibrators = &calibrators[0];
+    task.workers = &workers[0];
+    task.nbWorkers = nbWorkers;
+    task.cancelFlag = vobsGetCancelFlag();
+    task.failed = false;
+    task.cancelled = false;
+
+    // Initial ranges:
+    for (mcsUINT32 i = 0; i < nbWorkers; i++)
+    {
+        const mcsUINT64 begin = ((mcsUINT64) nbStars * i) / nbWorkers;
+        const mcsUINT64 end = ((mcsUINT64) nbStars * (i + 1)) / nbWorkers;
+
+        workers[i].range = (begin << 32) | end;
+        workers[i].task = &task;
+        workers[i].thread.function = sclsvrCompleteWorker;
+        workers[i].thread.parameter = &workers[i];
+    }
+
+    // Start workers (the calling thread is the first worker):
+    mcsUINT32 nbStarted = 1;
+    for (; nbStarted < nbWorkers; nbStarted++)
+    {
+        if (thrdThreadCreate(&workers[nbStarted].thread) == mcsFAILURE)
+        {
+            // remaining ranges will be stolen by started workers:
+            errCloseStack();
+            break;
+        }
+    }
+
+    sclsvrCompleteWorker(&workers[0]);
+
+    for (mcsUINT32 i = 1; i < nbStarted; i++)
+    {
+        if (thrdThreadWait(&workers[i].thread) == mcsFAILURE)
+        {
+            errCloseStack();
+        }
+    }
+
+    // Release the slots of additional workers:
+    if (IS_NOT_NULL(gate))
+    {
+        for (mcsUINT32 i = 1; i < nbWorkers; i++)
+        {
+            thrdPriorityGateRelease(gate);
+        }
+    }
+
+    logTest("Complete: %d calibrators completed by %d workers", nbStars, nbStarted);
+
+    FAIL_COND(task.cancelled || vobsIsCancelled());
+
+    if (task.failed)
+    {
+        logError("Complete: failed to complete calibrators");
+        return mcsFAILURE;
+    }
     return mcsSUCCESS;
 }
 
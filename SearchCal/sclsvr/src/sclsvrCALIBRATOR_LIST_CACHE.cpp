@@ -0,0 +1,259 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of sclsvrCALIBRATOR_LIST_CACHE class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <time.h>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * Local Headers
+ */
+#include "sclsvrCALIBRATOR_LIST_CACHE.h"
+#include "sclsvrPrivate.h"
+
+/*
+ * Local Types
+ */
+
+/** completed calibrators (owned copies) */
+typedef vector<sclsvrCALIBRATOR*> sclsvrCALIBRATOR_PTR_VECTOR;
+
+/** cached entry: completed calibrators + position in the LRU list */
+typedef struct
+{
+    sclsvrCALIBRATOR_PTR_VECTOR* calibrators;
+    list<string>::iterator lruPos;
+    time_t time;    /** storage time */
+} sclsvrCALIBRATOR_LIST_ENTRY;
+
+/** entry map keyed by the search key */
+typedef map<string, sclsvrCALIBRATOR_LIST_ENTRY> sclsvrCALIBRATOR_LIST_ENTRY_MAP;
+
+/*
+ * Local Variables
+ */
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX sclsvrListCacheMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** cached entries */
+static sclsvrCALIBRATOR_LIST_ENTRY_MAP sclsvrListCacheMap;
+/** search keys ordered by last access (most recent first) */
+static list<string> sclsvrListCacheLru;
+/** number of cached calibrators */
+static mcsUINT32 sclsvrListCacheNbStars = 0;
+
+/* statistics */
+static mcsUINT64 sclsvrListCacheHits = 0;
+static mcsUINT64 sclsvrListCacheMisses = 0;
+static mcsUINT64 sclsvrListCacheEvictions = 0;
+
+/*
+ * Local Functions
+ */
+
+/* free the given calibrators */
+static void sclsvrListCacheFree(sclsvrCALIBRATOR_PTR_VECTOR* calibrators)
+{
+    for (sclsvrCALIBRATOR_PTR_VECTOR::iterator iter = calibrators->begin(); iter != calibrators->end(); iter++)
+    {
+        delete(*iter);
+    }
+    delete(calibrators);
+}
+
+/* remove the given entry (within lock) */
+static void sclsvrListCacheRemove(sclsvrCALIBRATOR_LIST_ENTRY_MAP::iterator iter)
+{
+    sclsvrListCacheNbStars -= iter->second.calibrators->size();
+    sclsvrListCacheFree(iter->second.calibrators);
+
+    sclsvrListCacheLru.erase(iter->second.lruPos);
+    sclsvrListCacheMap.erase(iter);
+    sclsvrListCacheEvictions++;
+}
+
+/* remove the least recently used entry (within lock) */
+static void sclsvrListCacheEvict(void)
+{
+    sclsvrListCacheRemove(sclsvrListCacheMap.find(sclsvrListCacheLru.back()));
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Copy the cached calibrators of the given search key (if any and not
+ * expired) at the end of the given list.
+ *
+ * @param key search key (see sclsvrREQUEST::GetSearchKey())
+ * @param list calibrator list to fill
+ *
+ * @return true if the calibrators were found in the cache
+ */
+bool sclsvrCALIBRATOR_LIST_CACHE::Get(const string &key, sclsvrCALIBRATOR_LIST &list)
+{
+    mcsMutexLock(&sclsvrListCacheMutex);
+
+    sclsvrCALIBRATOR_LIST_ENTRY_MAP::iterator iter = sclsvrListCacheMap.find(key);
+
+    if ((iter != sclsvrListCacheMap.end()) && (time(NULL) - iter->second.time >= sclsvrCALIBRATOR_LIST_CACHE_TTL))
+    {
+        // expired list:
+        sclsvrListCacheRemove(iter);
+        iter = sclsvrListCacheMap.end();
+    }
+
+    if (iter == sclsvrListCacheMap.end())
+    {
+        sclsvrListCacheMisses++;
+
+        mcsMutexUnlock(&sclsvrListCacheMutex);
+        return false;
+    }
+    sclsvrListCacheHits++;
+
+    // move to the front (most recently used):
+    sclsvrListCacheLru.splice(sclsvrListCacheLru.begin(), sclsvrListCacheLru, iter->second.lruPos);
+
+    // copy within lock as the entry may be evicted by another thread:
+    const sclsvrCALIBRATOR_PTR_VECTOR* calibrators = iter->second.calibrators;
+
+    for (sclsvrCALIBRATOR_PTR_VECTOR::const_iterator calIter = calibrators->begin(); calIter != calibrators->end(); calIter++)
+    {
+        list.AddAtTail(**calIter);
+    }
+
+    mcsMutexUnlock(&sclsvrListCacheMutex);
+
+    return true;
+}
+
+/**
+ * Store a copy of the given completed calibrators for the given search key
+ * (least recently used lists are evicted beyond the cache capacity). Lists
+ * larger than the cache capacity are not stored.
+ *
+ * @param key search key (see sclsvrREQUEST::GetSearchKey())
+ * @param list completed calibrator list
+ */
+void sclsvrCALIBRATOR_LIST_CACHE::Put(const string &key, const sclsvrCALIBRATOR_LIST &list)
+{
+    const mcsUINT32 nbStars = list.Size();
+
+    if ((nbStars == 0) || (nbStars > sclsvrCALIBRATOR_LIST_CACHE_MAX_STARS))
+    {
+        return;
+    }
+
+    // copy calibrators outside the lock (kept between requests in the heap):
+    vobsARENA_SCOPE heapScope(false);
+
+    sclsvrCALIBRATOR_PTR_VECTOR* calibrators = new sclsvrCALIBRATOR_PTR_VECTOR();
+    calibrators->reserve(nbStars);
+
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        calibrators->push_back(new sclsvrCALIBRATOR(*((sclsvrCALIBRATOR*) list.GetNextStar((mcsLOGICAL) (el == 0)))));
+    }
+
+    mcsMutexLock(&sclsvrListCacheMutex);
+
+    if (sclsvrListCacheMap.find(key) == sclsvrListCacheMap.end())
+    {
+        // evict least recently used entries:
+        while ((sclsvrListCacheMap.size() >= sclsvrCALIBRATOR_LIST_CACHE_MAX_ENTRIES)
+               || (sclsvrListCacheNbStars + nbStars > sclsvrCALIBRATOR_LIST_CACHE_MAX_STARS))
+        {
+            sclsvrListCacheEvict();
+        }
+
+        sclsvrListCacheLru.push_front(key);
+
+        sclsvrCALIBRATOR_LIST_ENTRY &entry = sclsvrListCacheMap[key];
+        entry.calibrators = calibrators;
+        entry.lruPos = sclsvrListCacheLru.begin();
+        entry.time = time(NULL);
+
+        sclsvrListCacheNbStars += nbStars;
+
+        // given to the cache:
+        calibrators = NULL;
+    }
+
+    mcsMutexUnlock(&sclsvrListCacheMutex);
+
+    if (calibrators != NULL)
+    {
+        // already stored by another thread:
+        sclsvrListCacheFree(calibrators);
+    }
+}
+
+/**
+ * Return the cache statistics
+ *
+ * @param hits number of calibrator lists served from the cache
+ * @param misses number of calibrator lists not found in the cache
+ * @param evictions number of evicted lists
+ * @param nbEntries number of cached lists
+ * @param nbStars number of cached calibrators
+ */
+void sclsvrCALIBRATOR_LIST_CACHE::GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions,
+                                           mcsUINT32 &nbEntries, mcsUINT32 &nbStars)
+{
+    mcsMutexLock(&sclsvrListCacheMutex);
+
+    hits = sclsvrListCacheHits;
+    misses = sclsvrListCacheMisses;
+    evictions = sclsvrListCacheEvictions;
+    nbEntries = sclsvrListCacheMap.size();
+    nbStars = sclsvrListCacheNbStars;
+
+    mcsMutexUnlock(&sclsvrListCacheMutex);
+}
+
+/**
+ * Free all cached entries (statistics are kept)
+ */
+void sclsvrCALIBRATOR_LIST_CACHE::Clear(void)
+{
+    mcsMutexLock(&sclsvrListCacheMutex);
+
+    for (sclsvrCALIBRATOR_LIST_ENTRY_MAP::iterator iter = sclsvrListCacheMap.begin(); iter != sclsvrListCacheMap.end(); iter++)
+    {
+        sclsvrListCacheFree(iter->second.calibrators);
+    }
+    sclsvrListCacheMap.clear();
+    sclsvrListCacheLru.clear();
+    sclsvrListCacheNbStars = 0;
+
+    mcsMutexUnlock(&sclsvrListCacheMutex);
+}
+
+
+/*___oOo___*/
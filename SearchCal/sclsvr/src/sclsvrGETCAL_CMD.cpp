@@ -519,5 +519,71 @@ mcsCOMPL_STAT sclsvrGETCAL_CMD::GetDefaultDiagnose(mcsLOGICAL *_diagnose_)
     return GetDefaultParamValue("diagnose", _diagnose_);
 }
 
+/**
+ * Get the value of the parameter visBaselines.
+ *
+ * \param _visBaselines_ a pointer where to store the parameter.
+ * 
+ * \return mcsSUCCESS on successful completion, mcsFAILURE otherwise.
+ */ 
+mcsCOMPL_STAT sclsvrGETCAL_CMD::GetVisBaselines(char **_visBaselines_)
+{
+    return GetParamValue("visBaselines", _visBaselines_);
+}
+
+/**
+ * Check if the optional parameter visBaselines is defined. 
+ * 
+ * \return mcsTRUE or mcsFALSE if it is not defined.
+ */ 
+ mcsLOGICAL sclsvrGETCAL_CMD::IsDefinedVisBaselines()
+{
+    return IsDefined("visBaselines");
+}
+
+/**
+ * Get the value of the parameter visWlens.
+ *
+ * \param _visWlens_ a pointer where to store the parameter.
+ * 
+ * \return mcsSUCCESS on successful completion, mcsFAILURE otherwise.
+ */ 
+mcsCOMPL_STAT sclsvrGETCAL_CMD::GetVisWlens(char **_visWlens_)
+{
+    return GetParamValue("visWlens", _visWlens_);
+}
+
+/**
+ * Check if the optional parameter visWlens is defined. 
+ * 
+ * \return mcsTRUE or mcsFALSE if it is not defined.
+ */ 
+ mcsLOGICAL sclsvrGETCAL_CMD::IsDefinedVisWlens()
+{
+    return IsDefined("visWlens");
+}
+
+/**
+ * Get the value of the parameter timeout.
+ *
+ * \param _timeout_ a pointer where to store the parameter.
+ * 
+ * \return mcsSUCCESS on successful completion, mcsFAILURE otherwise.
+ */ 
+mcsCOMPL_STAT sclsvrGETCAL_CMD::GetTimeout(mcsINT32 *_timeout_)
+{
+    return GetParamValue("timeout", _timeout_);
+}
+
+/**
+ * Check if the optional parameter timeout is defined. 
+ * 
+ * \return mcsTRUE or mcsFALSE if it is not defined.
+ */ 
+ mcsLOGICAL sclsvrGETCAL_CMD::IsDefinedTimeout()
+{
+    return IsDefined("timeout");
+}
+
 
 /*___oOo___*/
@@ -23,6 +23,7 @@ using namespace std;
 #include "timlog.h"
 #include "thrd.h"
 #include "sdb.h"
+#include "sdbErrors.h"
 
 
 /*
@@ -40,6 +41,8 @@ using namespace std;
 #include "sclsvrSERVER.h"
 #include "sclsvrPrivate.h"
 #include "sclsvrCALIBRATOR_LIST.h"
+#include "sclsvrCALIBRATOR_LIST_CACHE.h"
+#include "sclsvrJSDC_DATA.h"
 #include "sclsvrSCENARIO_BRIGHT_K.h"
 #include "sclsvrSCENARIO_JSDC.h"
 #include "sclsvrSCENARIO_BRIGHT_V.h"
@@ -64,13 +67,54 @@ bool sclsvrSERVER::sclsvrSERVER_queryJSDC_Faint = false;
  * Return the current index of the catalog being queried.
  *
  * @param buffer will an already allocated buffer to contain the catalog name.
+ * @param timeoutInSec maximum time to wait for a status update (-1 means
+ * forever, 0 means no wait); the current status is returned on timeout.
  *
  * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
  */
 mcsCOMPL_STAT sclsvrSERVER::GetStatus(mcsSTRING256* buffer, mcsINT32 timeoutInSec)
 {
     // Wait for an updated status
-    FAIL(_status.Read(buffer, mcsTRUE, timeoutInSec));
+    if (timeoutInSec != 0)
+    {
+        if (_status.Read(buffer, mcsTRUE, timeoutInSec) == mcsSUCCESS)
+        {
+            return mcsSUCCESS;
+        }
+        FAIL_COND(IS_FALSE(errIsInStack("sdb", sdbERR_TIMEOUT_EXPIRED)));
+        errResetStack();
+    }
+
+    // Current status (not consumed):
+    mcsUINT32 nbWrites;
+    FAIL(_status.Peek(buffer, &nbWrites));
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the next request execution status given by the reader cursor,
+ * waiting for it if needed. Each reader owns its cursor so that several
+ * clients (coalesced queries) follow every status update of the same request.
+ *
+ * @param buffer an already allocated buffer to contain the status.
+ * @param cursor reader cursor (0 initially, updated).
+ * @param timeoutInSec maximum time to wait for a status update (-1 means forever);
+ * the current status is returned on timeout (cursor unchanged).
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrSERVER::ReadStatus(mcsSTRING256* buffer, mcsUINT32* cursor, mcsINT32 timeoutInSec)
+{
+    if (_status.ReadNext(buffer, cursor, timeoutInSec) == mcsFAILURE)
+    {
+        FAIL_COND(IS_FALSE(errIsInStack("sdb", sdbERR_TIMEOUT_EXPIRED)));
+        errResetStack();
+
+        // Current status (not consumed):
+        mcsUINT32 nbWrites;
+        FAIL(_status.Peek(buffer, &nbWrites));
+    }
 
     return mcsSUCCESS;
 }
@@ -157,6 +201,37 @@ mcsCOMPL_STAT sclsvrSERVER::GetCal(const char* query, miscoDYN_BUF* dynBuf)
     return complStatus;
 }
 
+/**
+ * Return the priority class of the given GetCal request (scheduling of worker
+ * slots, CDS queries and Complete phases):
+ * @li JSDC builds (band '0') are batch requests,
+ * @li searches in the JSDC (in memory, no CDS query) are interactive requests,
+ * @li other searches (CDS queries) are normal requests.
+ *
+ * @param request parsed GetCal request
+ *
+ * @return priority class
+ */
+thrdPRIORITY sclsvrSERVER::GetPriority(const sclsvrREQUEST &request)
+{
+    if (request.GetSearchBand()[0] == '0')
+    {
+        return thrdPRIORITY_BATCH;
+    }
+    if (IS_TRUE(request.IsBright()))
+    {
+        if (sclsvrSERVER_queryJSDC && (request.GetSearchAreaGeometry() == vobsBOX))
+        {
+            return thrdPRIORITY_INTERACTIVE;
+        }
+    }
+    else if (IsQueryJSDCFaint())
+    {
+        return thrdPRIORITY_INTERACTIVE;
+    }
+    return thrdPRIORITY_NORMAL;
+}
+
 /**
  * GETCAL command processing method.
  *
@@ -182,6 +257,11 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetCalCmd(const char* query,
     sclsvrREQUEST request;
     FAIL(request.Parse(query));
 
+    // Define the priority of this request (CDS queries and Complete phases):
+    const thrdPRIORITY priority = GetPriority(request);
+    thrdPrioritySet(priority);
+    logTest("Request priority: %s", thrdPriorityGetName(priority));
+
     // Get the request as a string for the case of Save in VOTable
     mcsSTRING1024 requestString;
     strncpy(requestString, query, sizeof (requestString) - 1);
@@ -411,9 +491,33 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetCalCmd(const char* query,
     vobsSetCancelFlag(_cancelFlag);
 
 
+    /* Define the deadline of the catalog queries (optional catalogs skipped once reached) */
+    _virtualObservatory.SetDeadline(request.GetTimeout());
+
     // Build the list of calibrator (final output)
     sclsvrCALIBRATOR_LIST calibratorList("Calibrators");
 
+    // Reuse the completed calibrators of a previous request having the same
+    // search key (only observing parameters differ) except for JSDC and
+    // diagnose requests (all stars kept, not in the search key):
+    const bool useListCache = IS_FALSE(request.IsJSDCMode()) && IS_FALSE(request.IsDiagnose()) && !_useVOStarListBackup;
+    bool isReused = false;
+    string searchKey;
+
+    if (useListCache)
+    {
+        FAIL_TIMLOG_CANCEL(request.GetSearchKey(searchKey), cmdName);
+
+        // the completed calibrators depend on the scenario and the JSDC dataset (reloads):
+        mcsSTRING32 jsdcVersion;
+        snprintf(jsdcVersion, sizeof (jsdcVersion) - 1, " JSDC:%u ", sclsvrJSDC_DATA::GetCurrentVersion());
+        searchKey.insert(0, jsdcVersion);
+        searchKey.insert(0, scenario->GetScenarioName());
+
+        isReused = sclsvrCALIBRATOR_LIST_CACHE::Get(searchKey, calibratorList);
+    }
+
+    if (!isReused)
     {
         // encapsulate the star list in one block to destroy it asap
         mcsSTRING512 fileName;
@@ -501,8 +605,31 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetCalCmd(const char* query,
     }
 
 
-    // Complete the calibrators list
-    FAIL_TIMLOG_CANCEL(calibratorList.Complete(request), cmdName);
+    if (isReused)
+    {
+        logInfo("Reusing %d completed calibrators of a previous request (same search, other observing parameters)",
+                calibratorList.Size());
+
+        // Only compute visibilities and distances
+        FAIL_TIMLOG_CANCEL(calibratorList.CompleteObservability(request), cmdName);
+    }
+    else
+    {
+        // Complete the calibrators list
+        FAIL_TIMLOG_CANCEL(calibratorList.Complete(request), cmdName);
+
+        // partial results (deadline reached) are not cached:
+        if (useListCache && !IsCancelled() && !IsPartial())
+        {
+            sclsvrCALIBRATOR_LIST_CACHE::Put(searchKey, calibratorList);
+        }
+    }
+
+    // Compute the visibility grid (if requested) for all calibrators at once
+    if (IS_FALSE(request.IsJSDCMode()))
+    {
+        FAIL_TIMLOG_CANCEL(calibratorList.ComputeVisibilityGrid(request), cmdName);
+    }
 
     // Check cancellation:
     if (IsCancelled())
@@ -578,6 +705,7 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetCalCmd(const char* query,
         string xmlOutput;
         xmlOutput.reserve(2048);
         request.AppendParamsToVOTable(xmlOutput);
+        AppendPartialParamsToVOTable(xmlOutput);
 
         const char* command  = "SearchCal";
         const char* voHeader = "SearchCal software: http://www.jmmc.fr/searchcal (In case of problem, please report to jmmc-user-support@jmmc.fr)";
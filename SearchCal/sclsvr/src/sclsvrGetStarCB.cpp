@@ -11,6 +11,7 @@
  * System Headers
  */
 #include <iostream>
+#include <vector>
 using namespace std;
 #include <time.h>
 #include <sys/time.h>
@@ -250,6 +251,9 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetStarCmd(const char* query,
     /* may fail: too many identifiers */
     FAIL_TIMLOG_CANCEL(miscSplitString(objectNames, delimiter, objectIds, MAX_OBJECT_IDS, &nbObjects), cmdName);
 
+    // one star (GUI) requests are interactive; multiple stars are normal requests:
+    thrdPrioritySet((nbObjects <= 1) ? thrdPRIORITY_INTERACTIVE : thrdPRIORITY_NORMAL);
+
 
     const bool isRegressionTest = IS_FALSE(logGetPrintFileLine());
     /* if multiple objects, disable log */
@@ -378,6 +382,9 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetStarCmd(const char* query,
     _useVOStarListBackup = (FORCE_NO_CACHE) ? false : true;
     mcsSTRING512 fileName;
 
+    /* Define the deadline of the catalog queries (optional catalogs skipped once reached) */
+    _virtualObservatory.SetDeadline(vobsDEADLINE_DEFAULT);
+
 
     vobsSTAR_LIST starList("GetStar");
 
@@ -385,6 +392,10 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetStarCmd(const char* query,
     sclsvrCALIBRATOR_LIST calibratorList("Calibrators");
 
 
+    // Resolve all identifiers at once (batched SIMBAD queries):
+    vector<simcliOBJECT_INFO> objectInfos(nbObjects);
+    vector<mcsUINT32> objectIndexes;
+
     for (mcsUINT32 i = 0; i < nbObjects; i++)
     {
         char* objectId = objectIds[i];
@@ -392,27 +403,41 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetStarCmd(const char* query,
         // Remove each token trailing and leading white spaces
         miscTrimString(objectId, " \t\n");
 
-        logDebug("objectId: %s", objectId);
-
-        if (strlen(objectId) == 0)
+        if (strlen(objectId) != 0)
         {
-            // skip empty identifier
-            continue;
+            strncpy(objectInfos[objectIndexes.size()].name, objectId, sizeof (mcsSTRING256) - 1);
+            objectIndexes.push_back(i);
         }
+    }
+
+    // TODO: skip simbad = cone search (ra/dec, pmRa/pmDe, mainId), plx ?
+
+    if (!objectIndexes.empty())
+    {
+        FAIL_TIMLOG_CANCEL(simcliGetCoordinatesBatch(&objectInfos[0], objectIndexes.size()), cmdName);
+    }
+
+    for (mcsUINT32 n = 0; n < objectIndexes.size(); n++)
+    {
+        char* objectId = objectIds[objectIndexes[n]];
+
+        logDebug("objectId: %s", objectId);
 
         // Get the star position from SIMBAD
-        mcsSTRING32 ra, dec;
-        mcsDOUBLE pmRa, pmDec;
-        mcsDOUBLE plx, ePlx;
-        mcsDOUBLE sMagV, sEMagV;
-        mcsSTRING64 spType, mainId;
-        mcsSTRING256 objTypes;
-
-        // TODO: skip simbad = cone search (ra/dec, pmRa/pmDe, mainId), plx ?
-
-        if (simcliGetCoordinates(objectId, ra, dec, &pmRa, &pmDec,
-                                 &plx, &ePlx, &sMagV, &sEMagV,
-                                 spType, objTypes, mainId) == mcsFAILURE)
+        simcliOBJECT_INFO& objectInfo = objectInfos[n];
+        mcsSTRING32& ra = objectInfo.ra;
+        mcsSTRING32& dec = objectInfo.dec;
+        mcsDOUBLE& pmRa = objectInfo.pmRa;
+        mcsDOUBLE& pmDec = objectInfo.pmDec;
+        mcsDOUBLE& plx = objectInfo.plx;
+        mcsDOUBLE& ePlx = objectInfo.ePlx;
+        mcsDOUBLE& sMagV = objectInfo.magV;
+        mcsDOUBLE& sEMagV = objectInfo.eMagV;
+        mcsSTRING64& spType = objectInfo.spType;
+        mcsSTRING64& mainId = objectInfo.mainId;
+        mcsSTRING256& objTypes = objectInfo.objTypes;
+
+        if (IS_FALSE(objectInfo.found))
         {
             if (nbObjects == 1)
             {
@@ -810,6 +835,7 @@ mcsCOMPL_STAT sclsvrSERVER::ProcessGetStarCmd(const char* query,
 
         // use getStarCmd directly as GetCalCmd <> GetStarCmd:
         getStarCmd.AppendParamsToVOTable(xmlOutput);
+        AppendPartialParamsToVOTable(xmlOutput);
 
         const char* command  = "GetStar";
         const char* header = "GetStar software (In case of problem, please report to jmmc-user-support@jmmc.fr)";
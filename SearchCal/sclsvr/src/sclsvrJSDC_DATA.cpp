@@ -0,0 +1,681 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of sclsvrJSDC_DATA class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+#include "misc.h"
+#include "timlog.h"
+
+/*
+ * Local Headers
+ */
+#include "sclsvrJSDC_DATA.h"
+#include "sclsvrCALIBRATOR_LIST_CACHE.h"
+#include "sclsvrSPECTRAL_TYPE_CACHE.h"
+#include "sclsvrErrors.h"
+#include "sclsvrPrivate.h"
+
+/* JSDC data file (bright) */
+#define sclsvrJSDC_DATA_FILE_BRIGHT "$MCSDATA/tmp/GetCal/SearchListBackup_JSDC_BRIGHT.dat"
+/* JSDC data file (faint) */
+#define sclsvrJSDC_DATA_FILE_FAINT  "$MCSDATA/tmp/GetCal/SearchListBackup_JSDC_FAINT.dat"
+/* JSDC image file (shared by server processes) */
+#define sclsvrJSDC_DATA_FILE_IMAGE  "$MCSDATA/tmp/GetCal/JSDC_Data.img"
+
+/*
+ * Local Variables
+ */
+
+/* shared JSDC image flag */
+static const mcsSTRING32 sclsvrJsdcSharedFlagEnvVarName = "SCLSVR_JSDC_SHARED_FLAG";
+/* flag to use the shared JSDC image (enabled by default) */
+static mcsLOGICAL sclsvrJsdcSharedFlag = mcsTRUE;
+/* flag indicating if the shared JSDC image flag was initialized */
+static mcsLOGICAL sclsvrJsdcSharedFlagInitialized = mcsFALSE;
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX sclsvrJsdcMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** current dataset (one reference) or NULL */
+static sclsvrJSDC_DATA* sclsvrJsdcCurrent = NULL;
+/** last dataset version */
+static mcsUINT32 sclsvrJsdcVersion = 0;
+/** true if a reload is in progress */
+static bool sclsvrJsdcReloading = false;
+
+/* statistics */
+static volatile mcsUINT32 sclsvrJsdcNbDatasets = 0;
+static mcsUINT32 sclsvrJsdcNbReloads = 0;
+static mcsUINT32 sclsvrJsdcNbFailedReloads = 0;
+
+/*
+ * Local Functions
+ */
+
+/* return the monotonic time (ms) */
+static mcsDOUBLE sclsvrJsdcGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return 1e3 * time.tv_sec + 1e-6 * time.tv_nsec;
+}
+
+/* Return mcsTRUE if the shared JSDC image flag is enabled (env var); mcsFALSE otherwise */
+static mcsLOGICAL sclsvrJsdcGetSharedFlag(void)
+{
+    if (IS_TRUE(sclsvrJsdcSharedFlagInitialized))
+    {
+        return sclsvrJsdcSharedFlag;
+    }
+    // compute it once:
+    sclsvrJsdcSharedFlagInitialized = mcsTRUE;
+
+    mcsSTRING1024 envSharedFlag = "";
+    if (miscGetEnvVarValue2(sclsvrJsdcSharedFlagEnvVarName, envSharedFlag, sizeof (envSharedFlag), mcsTRUE) == mcsSUCCESS)
+    {
+        // Check the env. var. is not empty
+        if (strlen(envSharedFlag) != 0)
+        {
+            logDebug("Found '%s' environment variable content for the shared JSDC image flag.", sclsvrJsdcSharedFlagEnvVarName);
+
+            if ((strcmp("1", envSharedFlag) == 0) || (strcmp("true", envSharedFlag) == 0))
+            {
+                sclsvrJsdcSharedFlag = mcsTRUE;
+            }
+            else if ((strcmp("0", envSharedFlag) == 0) || (strcmp("false", envSharedFlag) == 0))
+            {
+                sclsvrJsdcSharedFlag = mcsFALSE;
+            }
+            else
+            {
+                logInfo("'%s' environment variable does not contain a valid shared JSDC image flag: %s", sclsvrJsdcSharedFlagEnvVarName, envSharedFlag);
+            }
+        }
+        else
+        {
+            logInfo("'%s' environment variable does not contain a valid shared JSDC image flag (empty).", sclsvrJsdcSharedFlagEnvVarName);
+        }
+    }
+
+    logQuiet("sclsvrJsdcSharedFlag: %s", IS_TRUE(sclsvrJsdcSharedFlag) ? "true" : "false");
+
+    return sclsvrJsdcSharedFlag;
+}
+
+/* resolve the given path (empty if failed) */
+static void sclsvrJsdcResolvePath(const char* inputFileName, mcsSTRING512 &fileName)
+{
+    char* resolvedPath = miscResolvePath(inputFileName);
+    if (IS_NOT_NULL(resolvedPath))
+    {
+        strncpy(fileName, resolvedPath, sizeof (fileName) - 1);
+        fileName[sizeof (fileName) - 1] = '\0';
+        free(resolvedPath);
+    }
+    else
+    {
+        fileName[0] = '\0';
+    }
+}
+
+/* load the given star list file (indexed) or return NULL */
+static vobsSTAR_LIST* sclsvrJsdcLoadStarList(const char* inputFileName, const char* listName)
+{
+    mcsSTRING512 fileName;
+
+    // Build the list of star which will come from the virtual observatory
+    vobsSTAR_LIST* starList = new vobsSTAR_LIST(listName);
+
+    // Resolve path
+    sclsvrJsdcResolvePath(inputFileName, fileName);
+
+    if (strlen(fileName) != 0)
+    {
+        logInfo("Loading VO StarList backup: %s", fileName);
+
+        static const char* cmdName = "Load_JSDC";
+
+        // Start timer log
+        timlogInfoStart(cmdName);
+
+        if (starList->Load(fileName, NULL, NULL, mcsTRUE) == mcsFAILURE)
+        {
+            timlogCancel(cmdName);
+
+            // Ignore error (for test only)
+            errCloseStack();
+
+            // clear anyway:
+            starList->Clear();
+        }
+        else
+        {
+            // Stop timer log
+            timlogStop(cmdName);
+        }
+    }
+    if (starList->IsEmpty())
+    {
+        delete starList;
+        starList = NULL;
+    }
+    else
+    {
+        // Prepare index
+        starList->PrepareIndex();
+    }
+    return starList;
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Load the JSDC dataset at startup (if not already loaded)
+ *
+ * @return true if the JSDC dataset is available
+ */
+bool sclsvrJSDC_DATA::Load(void)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    bool loaded = IS_NOT_NULL(sclsvrJsdcCurrent);
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    if (!loaded)
+    {
+        logInfo("Loading JSDC data ...");
+
+        sclsvrJSDC_DATA* data = new sclsvrJSDC_DATA();
+
+        if (data->LoadData())
+        {
+            mcsMutexLock(&sclsvrJsdcMutex);
+
+            data->_version = ++sclsvrJsdcVersion;
+
+            // note: no previous dataset (startup):
+            sclsvrJsdcCurrent = data;
+
+            mcsMutexUnlock(&sclsvrJsdcMutex);
+
+            loaded = true;
+        }
+        else
+        {
+            delete data;
+        }
+    }
+
+    logInfo("Loading JSDC data : %s", (loaded) ? "true" : "false");
+
+    return loaded;
+}
+
+/**
+ * Load a new JSDC dataset (same files) in a background thread then replace the
+ * current one: pending queries finish on the previous dataset, freed by its
+ * last Release().
+ *
+ * @return mcsSUCCESS if the reload is started. Otherwise mcsFAILURE is
+ * returned (reload in progress).
+ */
+mcsCOMPL_STAT sclsvrJSDC_DATA::Reload(void)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    const bool reloading = sclsvrJsdcReloading;
+    sclsvrJsdcReloading = true;
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    FAIL_COND_DO(reloading,
+                 errAdd(sclsvrERR_JSDC_RELOAD, "reload already in progress"));
+
+    logInfo("Reloading JSDC data in background ...");
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    pthread_t threadId;
+    const int status = pthread_create(&threadId, &attr, sclsvrJSDC_DATA::ReloadTask, NULL);
+
+    pthread_attr_destroy(&attr);
+
+    if (status != 0)
+    {
+        mcsMutexLock(&sclsvrJsdcMutex);
+
+        sclsvrJsdcReloading = false;
+
+        mcsMutexUnlock(&sclsvrJsdcMutex);
+
+        errAdd(sclsvrERR_JSDC_RELOAD, "thread creation failed");
+        return mcsFAILURE;
+    }
+    return mcsSUCCESS;
+}
+
+/**
+ * Free the current JSDC dataset at shutdown (pending queries keep their
+ * dataset until they release it)
+ */
+void sclsvrJSDC_DATA::Free(void)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    sclsvrJSDC_DATA* data = sclsvrJsdcCurrent;
+    sclsvrJsdcCurrent = NULL;
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    Release(data);
+}
+
+/**
+ * Return the current JSDC dataset with one more reference: it must be given
+ * back using Release() once its stars are no more used.
+ *
+ * @return current JSDC dataset or NULL if not loaded
+ */
+sclsvrJSDC_DATA* sclsvrJSDC_DATA::Acquire(void)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    sclsvrJSDC_DATA* data = sclsvrJsdcCurrent;
+
+    if (IS_NOT_NULL(data))
+    {
+        __sync_fetch_and_add(&data->_refCount, 1);
+    }
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    return data;
+}
+
+/**
+ * Give back the given JSDC dataset: the last reference frees it.
+ *
+ * @param data JSDC dataset (may be NULL)
+ */
+void sclsvrJSDC_DATA::Release(sclsvrJSDC_DATA* data)
+{
+    if (IS_NOT_NULL(data) && (__sync_sub_and_fetch(&data->_refCount, 1) == 0))
+    {
+        logInfo("Freeing JSDC data [version %u]", data->_version);
+
+        delete data;
+    }
+}
+
+/**
+ * Return the version of the current JSDC dataset: results depending on the
+ * JSDC stars are cached with it (new version on every reload).
+ *
+ * @return current dataset version or 0 if not loaded
+ */
+mcsUINT32 sclsvrJSDC_DATA::GetCurrentVersion(void)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    const mcsUINT32 version = IS_NOT_NULL(sclsvrJsdcCurrent) ? sclsvrJsdcCurrent->_version : 0;
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    return version;
+}
+
+/**
+ * Return the JSDC dataset status
+ *
+ * @param status status to fill
+ */
+void sclsvrJSDC_DATA::GetStatus(sclsvrJSDC_DATA_STATUS* status)
+{
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    const sclsvrJSDC_DATA* data = sclsvrJsdcCurrent;
+
+    if (IS_NOT_NULL(data))
+    {
+        status->version  = data->_version;
+        status->nbStars  = IS_NOT_NULL(data->_image) ? data->_image->GetNbStars()
+                : IS_NOT_NULL(data->_starListComplete) ? data->_starListComplete->Size() : 0;
+        status->loadTime = data->_loadTime;
+        strcpy(status->loadDate, data->_loadDate);
+        status->shared   = IS_NOT_NULL(data->_image);
+    }
+    else
+    {
+        status->version     = 0;
+        status->nbStars     = 0;
+        status->loadTime    = 0.0;
+        status->loadDate[0] = '\0';
+        status->shared      = false;
+    }
+    status->nbDatasets      = sclsvrJsdcNbDatasets;
+    status->nbReloads       = sclsvrJsdcNbReloads;
+    status->nbFailedReloads = sclsvrJsdcNbFailedReloads;
+    status->reloading       = sclsvrJsdcReloading;
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+}
+
+/*
+ * Private methods
+ */
+
+/**
+ * Class constructor (one reference given to the caller)
+ */
+sclsvrJSDC_DATA::sclsvrJSDC_DATA()
+{
+    _refCount         = 1;
+    _version          = 0;
+    _loadTime         = 0.0;
+    _loadDate[0]      = '\0';
+    _starListBright   = NULL;
+    _starListFaint    = NULL;
+    _starListComplete = NULL;
+    _image            = NULL;
+
+    __sync_fetch_and_add(&sclsvrJsdcNbDatasets, 1);
+}
+
+/**
+ * Class destructor
+ */
+sclsvrJSDC_DATA::~sclsvrJSDC_DATA()
+{
+    // the complete list only stores star pointers of the other lists:
+    if (IS_NOT_NULL(_starListComplete))
+    {
+        delete _starListComplete;
+    }
+    if (IS_NOT_NULL(_starListBright))
+    {
+        delete _starListBright;
+    }
+    if (IS_NOT_NULL(_starListFaint))
+    {
+        delete _starListFaint;
+    }
+    if (IS_NOT_NULL(_image))
+    {
+        delete _image;
+    }
+
+    __sync_fetch_and_sub(&sclsvrJsdcNbDatasets, 1);
+}
+
+/**
+ * Load the star lists (bright, faint and complete) of this dataset
+ *
+ * @return true if the complete list is not empty
+ */
+bool sclsvrJSDC_DATA::LoadData(void)
+{
+    const mcsDOUBLE start = sclsvrJsdcGetTime();
+
+    // the dataset outlives requests (heap):
+    vobsARENA_SCOPE heapScope(false);
+
+    if (IS_TRUE(sclsvrJsdcGetSharedFlag()) && LoadImage())
+    {
+        _loadTime = sclsvrJsdcGetTime() - start;
+
+        if (miscGetUtcTimeStr(0, &_loadDate) == mcsFAILURE)
+        {
+            errCloseStack();
+        }
+        return true;
+    }
+
+    /* must free this allocated star lists */
+    // note: the star lists may be already loaded to build the image:
+    if (IS_NULL(_starListBright) && IS_NULL(_starListFaint))
+    {
+        _starListBright = sclsvrJsdcLoadStarList(sclsvrJSDC_DATA_FILE_BRIGHT, "JSDC_Data_Bright");
+        _starListFaint  = sclsvrJsdcLoadStarList(sclsvrJSDC_DATA_FILE_FAINT, "JSDC_Data_Faint");
+    }
+
+    // Concatenate lists into the Complete list:
+    vobsSTAR_LIST* starList = new vobsSTAR_LIST("JSDC_Data_Complete");
+
+    // define the free pointer flag to avoid double frees (this list and the given list are storing same star pointers):
+    starList->SetFreeStarPointers(false);
+
+    if (IS_NOT_NULL(_starListBright))
+    {
+        starList->CopyRefs(*_starListBright, mcsFALSE);
+    }
+
+    if (IS_NOT_NULL(_starListFaint))
+    {
+        starList->CopyRefs(*_starListFaint, mcsFALSE);
+    }
+
+    if (starList->IsEmpty())
+    {
+        delete starList;
+        starList = NULL;
+    }
+    else
+    {
+        // Sort by declination to optimize JSDC queries
+        starList->Sort(vobsSTAR_POS_EQ_DEC_MAIN);
+
+        // Prepare index
+        starList->PrepareIndex();
+    }
+    _starListComplete = starList;
+
+    _loadTime = sclsvrJsdcGetTime() - start;
+
+    if (miscGetUtcTimeStr(0, &_loadDate) == mcsFAILURE)
+    {
+        errCloseStack();
+    }
+
+    if (IS_NOT_NULL(_starListBright))
+    {
+        logInfo("List[%s] size : %d", _starListBright->GetName(), _starListBright->Size());
+    }
+
+    if (IS_NOT_NULL(_starListFaint))
+    {
+        logInfo("List[%s] size : %d", _starListFaint->GetName(), _starListFaint->Size());
+    }
+
+    if (IS_NOT_NULL(_starListComplete))
+    {
+        logInfo("List[%s] size : %d", _starListComplete->GetName(), _starListComplete->Size());
+    }
+
+    return IS_NOT_NULL(_starListComplete);
+}
+
+/**
+ * Attach the shared JSDC image matching the JSDC data files: the first server
+ * process (or the first reload) after a data file change loads the star lists
+ * to write the image file; other processes only map it.
+ *
+ * @return true if the JSDC image is attached; false otherwise (star lists may
+ * be loaded if the image could not be written)
+ */
+bool sclsvrJSDC_DATA::LoadImage(void)
+{
+    mcsSTRING512 fileName, fileNameBright, fileNameFaint, lockFileName;
+
+    sclsvrJsdcResolvePath(sclsvrJSDC_DATA_FILE_IMAGE,  fileName);
+    sclsvrJsdcResolvePath(sclsvrJSDC_DATA_FILE_BRIGHT, fileNameBright);
+    sclsvrJsdcResolvePath(sclsvrJSDC_DATA_FILE_FAINT,  fileNameFaint);
+
+    if (strlen(fileName) == 0)
+    {
+        errCloseStack();
+        return false;
+    }
+
+    // Serialize image builds between server processes:
+    snprintf(lockFileName, sizeof (lockFileName) - 1, "%s.lock", fileName);
+
+    const int lockFd = open(lockFileName, O_RDWR | O_CREAT, 0644);
+
+    if ((lockFd == -1) || (flock(lockFd, LOCK_EX) != 0))
+    {
+        logWarning("Could not lock JSDC image '%s': %s", lockFileName, strerror(errno));
+
+        if (lockFd != -1)
+        {
+            close(lockFd);
+        }
+        return false;
+    }
+
+    sclsvrJSDC_IMAGE* image = new sclsvrJSDC_IMAGE();
+
+    if (image->Attach(fileName, fileNameBright, fileNameFaint) == mcsFAILURE)
+    {
+        // missing or outdated image:
+        errResetStack();
+
+        logInfo("Building JSDC image: %s", fileName);
+
+        _starListBright = sclsvrJsdcLoadStarList(sclsvrJSDC_DATA_FILE_BRIGHT, "JSDC_Data_Bright");
+        _starListFaint  = sclsvrJsdcLoadStarList(sclsvrJSDC_DATA_FILE_FAINT, "JSDC_Data_Faint");
+
+        if ((IS_NOT_NULL(_starListBright) || IS_NOT_NULL(_starListFaint))
+                && (sclsvrJSDC_IMAGE::Build(fileName, fileNameBright, fileNameFaint, _starListBright, _starListFaint) == mcsSUCCESS)
+                && (image->Attach(fileName, fileNameBright, fileNameFaint) == mcsSUCCESS))
+        {
+            // star lists are useless once the image is attached:
+            if (IS_NOT_NULL(_starListBright))
+            {
+                delete _starListBright;
+                _starListBright = NULL;
+            }
+            if (IS_NOT_NULL(_starListFaint))
+            {
+                delete _starListFaint;
+                _starListFaint = NULL;
+            }
+        }
+        else
+        {
+            // logs any error (star lists are used instead):
+            errCloseStack();
+        }
+    }
+
+    flock(lockFd, LOCK_UN);
+    close(lockFd);
+
+    if (!image->IsAttached())
+    {
+        logWarning("JSDC image not available: star lists used instead");
+
+        delete image;
+        return false;
+    }
+    _image = image;
+
+    logInfo("List[JSDC_Image] size : %u (%u bright)", _image->GetNbStars(), _image->GetNbBrightStars());
+
+    return true;
+}
+
+/**
+ * Load a new JSDC dataset and replace the current one (reload thread)
+ *
+ * @return NULL
+ */
+void* sclsvrJSDC_DATA::ReloadTask(void* arg)
+{
+    // block all signals for this thread:
+    sigset_t my_set;
+    sigfillset(&my_set);
+    pthread_sigmask(SIG_SETMASK, &my_set, NULL);
+
+    sclsvrJSDC_DATA* data = new sclsvrJSDC_DATA();
+    sclsvrJSDC_DATA* previous = NULL;
+
+    const bool loaded = data->LoadData();
+
+    mcsMutexLock(&sclsvrJsdcMutex);
+
+    if (loaded)
+    {
+        data->_version = ++sclsvrJsdcVersion;
+
+        // swap datasets (the current reference is given to the new one):
+        previous = sclsvrJsdcCurrent;
+        sclsvrJsdcCurrent = data;
+
+        sclsvrJsdcNbReloads++;
+    }
+    else
+    {
+        sclsvrJsdcNbFailedReloads++;
+    }
+    sclsvrJsdcReloading = false;
+
+    mcsMutexUnlock(&sclsvrJsdcMutex);
+
+    if (loaded)
+    {
+        logInfo("Reloading JSDC data : done [version %u, %.1lf ms]", data->_version, data->_loadTime);
+
+        // freed once pending queries released it:
+        Release(previous);
+
+        // free the cached results of the previous dataset (keyed by version):
+        sclsvrCALIBRATOR_LIST_CACHE::Clear();
+        sclsvrSPECTRAL_TYPE_CACHE::Clear();
+    }
+    else
+    {
+        logWarning("Reloading JSDC data : failed (current data kept)");
+
+        delete data;
+    }
+
+    // logs any error and reset the error stack of this thread:
+    errCloseStack();
+
+    return NULL;
+}
+
+
+/*___oOo___*/
@@ -0,0 +1,716 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of sclsvrJSDC_IMAGE class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+#include "alx.h"
+
+/*
+ * Local Headers
+ */
+#include "sclsvrJSDC_IMAGE.h"
+#include "sclsvrErrors.h"
+#include "sclsvrPrivate.h"
+
+/* image file identifier (format version) */
+#define sclsvrJSDC_IMAGE_MAGIC "JSDCIMG1"
+/* number of declination zones (1 degree) */
+#define sclsvrJSDC_IMAGE_NB_ZONES 180
+
+/* align the given file offset on 8 bytes */
+#define sclsvrJSDC_IMAGE_ALIGN(offset) \
+    (((offset) + 7) & ~((mcsUINT64) 7))
+
+/*
+ * Local Types
+ */
+
+/** image header (file offset 0) */
+typedef struct
+{
+    char      magic[8];         /** sclsvrJSDC_IMAGE_MAGIC */
+    mcsUINT32 layout;           /** vobsSTAR property layout signature */
+    mcsUINT32 nbStars;          /** number of stars */
+    mcsUINT32 nbBrightStars;    /** number of stars of the bright list */
+    mcsUINT32 nbProperties;     /** number of property records */
+    mcsINT64  sourceSize[2];    /** size of the bright / faint data files */
+    mcsINT64  sourceTime[2];    /** modification time of the bright / faint data files */
+    mcsUINT64 starOffset;       /** star records (sorted by declination) */
+    mcsUINT64 zoneOffset;       /** first star of each declination zone (nbZones + 1) */
+    mcsUINT64 propertyOffset;   /** property records */
+    mcsUINT64 stringOffset;     /** string values ('\0' terminated) */
+    mcsUINT64 fileSize;         /** image size */
+} sclsvrJSDC_IMAGE_HEADER;
+
+/** star record (24 bytes) */
+typedef struct
+{
+    mcsDOUBLE ra;               /** RA (deg) */
+    mcsDOUBLE dec;              /** DEC (deg) */
+    mcsUINT32 firstProperty;    /** first property record */
+    mcsUINT8  nbProperties;     /** number of property records */
+    mcsUINT8  bright;           /** 1 if the star belongs to the bright list */
+    mcsUINT16 reserved;
+} sclsvrJSDC_IMAGE_STAR;
+
+/** property record (12 bytes like vobsSTAR_PROPERTY) */
+typedef struct
+{
+    mcsUINT8  index;            /** property index in vobsSTAR */
+    mcsUINT8  origin;           /** vobsORIGIN_INDEX */
+    mcsUINT8  confidence;       /** vobsCONFIDENCE_INDEX */
+    mcsUINT8  reserved;
+    mcsUINT32 data[2];          /** float value and error, long value or string offset */
+} sclsvrJSDC_IMAGE_PROPERTY;
+
+/** star to store in the image */
+typedef struct
+{
+    mcsDOUBLE ra;
+    mcsDOUBLE dec;
+    vobsSTAR* star;
+    mcsUINT8  bright;
+} sclsvrJSDC_IMAGE_ENTRY;
+
+/*
+ * Local Functions
+ */
+
+/* return true if the first entry has a lower declination */
+static bool sclsvrJsdcImageCompare(const sclsvrJSDC_IMAGE_ENTRY &entry1, const sclsvrJSDC_IMAGE_ENTRY &entry2)
+{
+    return (entry1.dec < entry2.dec);
+}
+
+/* return true if the given star record has a lower declination */
+static bool sclsvrJsdcImageCompareDec(const sclsvrJSDC_IMAGE_STAR &star, const mcsDOUBLE dec)
+{
+    return (star.dec < dec);
+}
+
+/* return the signature of the vobsSTAR property layout (FNV-1a hash of property ids and types) */
+static mcsUINT32 sclsvrJsdcImageGetLayout(void)
+{
+    vobsSTAR star;
+    mcsUINT32 hash = 2166136261u;
+
+    for (mcsUINT32 p = 0; p < star.NbProperties(); p++)
+    {
+        const vobsSTAR_PROPERTY* property = star.GetProperty(p);
+
+        for (const char* c = property->GetId(); *c != '\0'; c++)
+        {
+            hash = (hash ^ (mcsUINT8) * c) * 16777619u;
+        }
+        hash = (hash ^ (mcsUINT8) property->GetType()) * 16777619u;
+    }
+    return hash;
+}
+
+/* get the size and modification time of the given file (-1 if missing) */
+static void sclsvrJsdcImageGetSource(const char* fileName, mcsINT64 &size, mcsINT64 &time)
+{
+    struct stat fileStat;
+
+    if (IS_NOT_NULL(fileName) && (stat(fileName, &fileStat) == 0))
+    {
+        size = fileStat.st_size;
+        time = fileStat.st_mtime;
+    }
+    else
+    {
+        size = -1;
+        time = -1;
+    }
+}
+
+/* return the zone of the given declination */
+static mcsINT32 sclsvrJsdcImageGetZone(const mcsDOUBLE dec)
+{
+    const mcsINT32 zone = (mcsINT32) floor(dec + 90.0);
+
+    return (zone < 0) ? 0 : (zone >= sclsvrJSDC_IMAGE_NB_ZONES) ? (sclsvrJSDC_IMAGE_NB_ZONES - 1) : zone;
+}
+
+/* add the stars of the given list (with valid coordinates) */
+static void sclsvrJsdcImageAddStars(vector<sclsvrJSDC_IMAGE_ENTRY> &entries, vobsSTAR_LIST* starList, const mcsUINT8 bright)
+{
+    if (IS_NULL(starList))
+    {
+        return;
+    }
+
+    sclsvrJSDC_IMAGE_ENTRY entry;
+    entry.bright = bright;
+
+    const mcsUINT32 nbStars = starList->Size();
+
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        entry.star = starList->GetNextStar((mcsLOGICAL) (el == 0));
+
+        if (entry.star->GetRaDec(entry.ra, entry.dec) == mcsFAILURE)
+        {
+            // never matching RA/DEC criteria:
+            errResetStack();
+            continue;
+        }
+        entries.push_back(entry);
+    }
+}
+
+/*
+ * Class constructor
+ */
+sclsvrJSDC_IMAGE::sclsvrJSDC_IMAGE()
+{
+    _base          = NULL;
+    _size          = 0;
+    _nbStars       = 0;
+    _nbBrightStars = 0;
+}
+
+/*
+ * Class destructor
+ */
+sclsvrJSDC_IMAGE::~sclsvrJSDC_IMAGE()
+{
+    if (IS_NOT_NULL(_base))
+    {
+        munmap((void*) _base, _size);
+    }
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Write the image file of the given star lists: the file is written aside
+ * then renamed so processes still using the previous image keep it.
+ *
+ * @param fileName image file (resolved path)
+ * @param fileNameBright bright data file (resolved path) the lists come from
+ * @param fileNameFaint faint data file (resolved path) the lists come from
+ * @param starListBright bright star list (may be NULL)
+ * @param starListFaint faint star list (may be NULL)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrJSDC_IMAGE::Build(const char* fileName,
+                                      const char* fileNameBright,
+                                      const char* fileNameFaint,
+                                      vobsSTAR_LIST* starListBright,
+                                      vobsSTAR_LIST* starListFaint)
+{
+    // Sort stars by declination:
+    vector<sclsvrJSDC_IMAGE_ENTRY> entries;
+    entries.reserve((IS_NOT_NULL(starListBright) ? starListBright->Size() : 0)
+                    + (IS_NOT_NULL(starListFaint) ? starListFaint->Size() : 0));
+
+    sclsvrJsdcImageAddStars(entries, starListBright, 1);
+    sclsvrJsdcImageAddStars(entries, starListFaint, 0);
+
+    FAIL_COND_DO(entries.empty(),
+                 errAdd(sclsvrERR_JSDC_IMAGE, fileName, "no star"));
+
+    stable_sort(entries.begin(), entries.end(), sclsvrJsdcImageCompare);
+
+    const mcsUINT32 nbStars = entries.size();
+
+    sclsvrJSDC_IMAGE_HEADER header;
+    memset(&header, 0, sizeof (header));
+
+    memcpy(header.magic, sclsvrJSDC_IMAGE_MAGIC, sizeof (header.magic));
+    header.layout = sclsvrJsdcImageGetLayout();
+    header.nbStars = nbStars;
+    sclsvrJsdcImageGetSource(fileNameBright, header.sourceSize[0], header.sourceTime[0]);
+    sclsvrJsdcImageGetSource(fileNameFaint,  header.sourceSize[1], header.sourceTime[1]);
+
+    // Star records and zone index:
+    vector<sclsvrJSDC_IMAGE_STAR> stars(nbStars);
+    vector<mcsUINT32> zones(sclsvrJSDC_IMAGE_NB_ZONES + 1, nbStars);
+
+    mcsUINT32 nbProperties = 0;
+    mcsINT32 zone = -1;
+
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        const sclsvrJSDC_IMAGE_ENTRY &entry = entries[el];
+        sclsvrJSDC_IMAGE_STAR &star = stars[el];
+
+        star.ra = entry.ra;
+        star.dec = entry.dec;
+        star.firstProperty = nbProperties;
+        star.nbProperties = 0;
+        star.bright = entry.bright;
+        star.reserved = 0;
+
+        for (mcsUINT32 p = 0; p < entry.star->NbProperties(); p++)
+        {
+            if (IS_TRUE(entry.star->IsPropertySet(p)))
+            {
+                star.nbProperties++;
+            }
+        }
+        nbProperties += star.nbProperties;
+
+        if (entry.bright != 0)
+        {
+            header.nbBrightStars++;
+        }
+
+        // first star of the zones up to the star zone:
+        for (const mcsINT32 starZone = sclsvrJsdcImageGetZone(entry.dec); zone < starZone; )
+        {
+            zones[++zone] = el;
+        }
+    }
+    header.nbProperties = nbProperties;
+
+    header.starOffset     = sclsvrJSDC_IMAGE_ALIGN(sizeof (header));
+    header.zoneOffset     = sclsvrJSDC_IMAGE_ALIGN(header.starOffset + nbStars * sizeof (sclsvrJSDC_IMAGE_STAR));
+    header.propertyOffset = sclsvrJSDC_IMAGE_ALIGN(header.zoneOffset + zones.size() * sizeof (mcsUINT32));
+    header.stringOffset   = sclsvrJSDC_IMAGE_ALIGN(header.propertyOffset + nbProperties * sizeof (sclsvrJSDC_IMAGE_PROPERTY));
+
+    // Property records (distinct strings stored once):
+    vector<sclsvrJSDC_IMAGE_PROPERTY> properties(nbProperties);
+    map<string, mcsUINT32> stringOffsets;
+    string strings;
+
+    mcsUINT32 n = 0;
+
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        const vobsSTAR* star = entries[el].star;
+
+        for (mcsUINT32 p = 0; p < star->NbProperties(); p++)
+        {
+            const vobsSTAR_PROPERTY* property = star->GetProperty(p);
+
+            if (IS_FALSE(property->IsSet()))
+            {
+                continue;
+            }
+
+            sclsvrJSDC_IMAGE_PROPERTY &record = properties[n++];
+
+            record.index = p;
+            record.origin = property->GetOriginIndex();
+            record.confidence = property->GetConfidenceIndex();
+            record.reserved = 0;
+            record.data[0] = record.data[1] = 0;
+
+            mcsDOUBLE value, error;
+            mcsFLOAT floats[2];
+            mcsINT64 longValue;
+            mcsINT32 intValue;
+            mcsLOGICAL boolValue;
+
+            switch (property->GetType())
+            {
+                case vobsSTRING_PROPERTY:
+                {
+                    const string str(property->GetValueOrBlank());
+
+                    map<string, mcsUINT32>::iterator iter = stringOffsets.find(str);
+                    if (iter == stringOffsets.end())
+                    {
+                        iter = stringOffsets.insert(make_pair(str, (mcsUINT32) strings.size())).first;
+                        strings.append(str.c_str(), str.size() + 1);
+                    }
+                    record.data[0] = iter->second;
+                    break;
+                }
+                case vobsFLOAT_PROPERTY:
+                    FAIL(property->GetValue(&value));
+                    error = NAN;
+                    if (IS_TRUE(property->IsErrorSet()))
+                    {
+                        FAIL(property->GetError(&error));
+                    }
+                    floats[0] = (mcsFLOAT) value;
+                    floats[1] = (mcsFLOAT) error;
+                    memcpy(record.data, floats, sizeof (record.data));
+                    break;
+                case vobsINT_PROPERTY:
+                    FAIL(property->GetValue(&intValue));
+                    longValue = intValue;
+                    memcpy(record.data, &longValue, sizeof (record.data));
+                    break;
+                case vobsLONG_PROPERTY:
+                    FAIL(property->GetValue(&longValue));
+                    memcpy(record.data, &longValue, sizeof (record.data));
+                    break;
+                case vobsBOOL_PROPERTY:
+                    FAIL(property->GetValue(&boolValue));
+                    longValue = boolValue;
+                    memcpy(record.data, &longValue, sizeof (record.data));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    header.fileSize = header.stringOffset + strings.size();
+
+    // Write the image aside:
+    mcsSTRING512 tmpFileName;
+    snprintf(tmpFileName, sizeof (tmpFileName) - 1, "%s.%d.tmp", fileName, (int) getpid());
+
+    FILE* file = fopen(tmpFileName, "wb");
+    FAIL_NULL_DO(file,
+                 errAdd(sclsvrERR_JSDC_IMAGE, tmpFileName, strerror(errno)));
+
+    // note: sections are aligned on 8 bytes (gaps filled with zeros by fseek):
+    bool written = (fwrite(&header, sizeof (header), 1, file) == 1);
+
+    written = written && (fseek(file, header.starOffset, SEEK_SET) == 0)
+            && (fwrite(&stars[0], sizeof (sclsvrJSDC_IMAGE_STAR), nbStars, file) == nbStars);
+
+    written = written && (fseek(file, header.zoneOffset, SEEK_SET) == 0)
+            && (fwrite(&zones[0], sizeof (mcsUINT32), zones.size(), file) == zones.size());
+
+    written = written && (fseek(file, header.propertyOffset, SEEK_SET) == 0)
+            && ((nbProperties == 0) || (fwrite(&properties[0], sizeof (sclsvrJSDC_IMAGE_PROPERTY), nbProperties, file) == nbProperties));
+
+    written = written && (fseek(file, header.stringOffset, SEEK_SET) == 0)
+            && (strings.empty() || (fwrite(strings.data(), strings.size(), 1, file) == 1));
+
+    written = written && (fflush(file) == 0) && (fsync(fileno(file)) == 0);
+
+    if ((fclose(file) != 0) || !written || (rename(tmpFileName, fileName) != 0))
+    {
+        errAdd(sclsvrERR_JSDC_IMAGE, fileName, strerror(errno));
+
+        unlink(tmpFileName);
+        return mcsFAILURE;
+    }
+
+    logInfo("JSDC image written: %s [%u stars, %u properties, %.1lf MB]",
+            fileName, nbStars, nbProperties, header.fileSize / (1024.0 * 1024.0));
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Map the given image file (read-only, shared with other processes) if it was
+ * built from the current data files with the same vobsSTAR properties.
+ *
+ * @param fileName image file (resolved path)
+ * @param fileNameBright bright data file (resolved path)
+ * @param fileNameFaint faint data file (resolved path)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned
+ * (missing, outdated or invalid image).
+ */
+mcsCOMPL_STAT sclsvrJSDC_IMAGE::Attach(const char* fileName,
+                                       const char* fileNameBright,
+                                       const char* fileNameFaint)
+{
+    FAIL_COND_DO(IsAttached(),
+                 errAdd(sclsvrERR_JSDC_IMAGE, fileName, "already attached"));
+
+    const int fd = open(fileName, O_RDONLY);
+    FAIL_COND_DO((fd == -1),
+                 errAdd(sclsvrERR_JSDC_IMAGE, fileName, strerror(errno)));
+
+    struct stat fileStat;
+    if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size < (off_t) sizeof (sclsvrJSDC_IMAGE_HEADER)))
+    {
+        close(fd);
+
+        errAdd(sclsvrERR_JSDC_IMAGE, fileName, "truncated file");
+        return mcsFAILURE;
+    }
+
+    const size_t size = fileStat.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // the mapping remains valid once closed:
+    close(fd);
+
+    FAIL_COND_DO((base == MAP_FAILED),
+                 errAdd(sclsvrERR_JSDC_IMAGE, fileName, strerror(errno)));
+
+    const sclsvrJSDC_IMAGE_HEADER* header = (const sclsvrJSDC_IMAGE_HEADER*) base;
+
+    mcsINT64 sourceSize[2], sourceTime[2];
+    sclsvrJsdcImageGetSource(fileNameBright, sourceSize[0], sourceTime[0]);
+    sclsvrJsdcImageGetSource(fileNameFaint,  sourceSize[1], sourceTime[1]);
+
+    const char* reason = NULL;
+
+    if ((memcmp(header->magic, sclsvrJSDC_IMAGE_MAGIC, sizeof (header->magic)) != 0)
+            || (header->layout != sclsvrJsdcImageGetLayout()))
+    {
+        reason = "incompatible format";
+    }
+    else if ((header->sourceSize[0] != sourceSize[0]) || (header->sourceTime[0] != sourceTime[0])
+             || (header->sourceSize[1] != sourceSize[1]) || (header->sourceTime[1] != sourceTime[1]))
+    {
+        reason = "outdated";
+    }
+    else if ((header->fileSize != size)
+             || (header->starOffset + header->nbStars * sizeof (sclsvrJSDC_IMAGE_STAR) > header->zoneOffset)
+             || (header->zoneOffset + (sclsvrJSDC_IMAGE_NB_ZONES + 1) * sizeof (mcsUINT32) > header->propertyOffset)
+             || (header->propertyOffset + header->nbProperties * sizeof (sclsvrJSDC_IMAGE_PROPERTY) > header->stringOffset)
+             || (header->stringOffset > size))
+    {
+        reason = "truncated file";
+    }
+
+    if (IS_NOT_NULL(reason))
+    {
+        munmap(base, size);
+
+        errAdd(sclsvrERR_JSDC_IMAGE, fileName, reason);
+        return mcsFAILURE;
+    }
+
+    _base          = (const mcsUINT8*) base;
+    _size          = size;
+    _nbStars       = header->nbStars;
+    _nbBrightStars = header->nbBrightStars;
+
+    logInfo("JSDC image attached: %s [%u stars, %.1lf MB]",
+            fileName, _nbStars, _size / (1024.0 * 1024.0));
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Search the image stars matching the given criteria (RA/DEC first) like
+ * vobsSTAR_LIST::Search(): matching stars are created in the output list
+ * (owned), ordered by distance to the reference star.
+ *
+ * @param referenceStar reference star
+ * @param criteriaList criteria list (RA/DEC criteria first)
+ * @param brightOnly true to only search the stars of the bright list
+ * @param outputList star list to fill
+ * @param maxMatches maximum number of matches
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrJSDC_IMAGE::Search(vobsSTAR* referenceStar,
+                                       vobsSTAR_COMP_CRITERIA_LIST* criteriaList,
+                                       bool brightOnly,
+                                       vobsSTAR_LIST &outputList,
+                                       mcsUINT32 maxMatches) const
+{
+    FAIL_FALSE_DO(IsAttached(),
+                  logWarning("Search: JSDC image is not attached"));
+    FAIL_NULL_DO(referenceStar,
+                 logWarning("Reference star is NULL"));
+    FAIL_NULL_DO(criteriaList,
+                 logWarning("Search: criteria are undefined !"));
+
+    // log criterias:
+    criteriaList->log(logTEST, "Search: ");
+
+    mcsINT32 nCriteria = 0;
+    vobsSTAR_CRITERIA_INFO* criterias = NULL;
+
+    FAIL(criteriaList->GetCriterias(criterias, nCriteria));
+
+    // note: RA_DEC criteria is always the first one
+    FAIL_COND_DO((nCriteria == 0) || (criterias[0].propCompType != vobsPROPERTY_COMP_RA_DEC),
+                 logWarning("Search: unsupported matcher !"));
+
+    const vobsSTAR_CRITERIA_INFO* criteria = &criterias[0];
+
+    mcsDOUBLE ra, dec;
+    FAIL_DO(referenceStar->GetRaDec(ra, dec),
+            logWarning("Invalid RA/Dec coordinates for the given star !"));
+
+    const sclsvrJSDC_IMAGE_HEADER* header = (const sclsvrJSDC_IMAGE_HEADER*) _base;
+    const sclsvrJSDC_IMAGE_STAR* stars = (const sclsvrJSDC_IMAGE_STAR*) (_base + header->starOffset);
+    const mcsUINT32* zones = (const mcsUINT32*) (_base + header->zoneOffset);
+
+    // note: add +/- COORDS_PRECISION for floating point precision:
+    const mcsDOUBLE decMin = dec - criteria->rangeDEC - COORDS_PRECISION;
+    const mcsDOUBLE decMax = dec + criteria->rangeDEC + COORDS_PRECISION;
+
+    // Find the first star in the declination range using the zone index:
+    const sclsvrJSDC_IMAGE_STAR* first = stars + zones[sclsvrJsdcImageGetZone(decMin)];
+    const sclsvrJSDC_IMAGE_STAR* last  = stars + zones[sclsvrJsdcImageGetZone(decMax) + 1];
+
+    first = lower_bound(first, last, decMin, sclsvrJsdcImageCompareDec);
+
+    // As several stars can be present in the declination range,
+    // an ordered distance map is used to select the closest stars matching criteria:
+    vobsSTAR_PTR_MATCH_MAP distMap;
+
+    mcsINT32 nStars = 0;
+    mcsDOUBLE delta, distAng;
+
+    for (const sclsvrJSDC_IMAGE_STAR* star = first; (star != last) && (star->dec <= decMax); star++)
+    {
+        if (brightOnly && (star->bright == 0))
+        {
+            continue;
+        }
+        nStars++;
+
+        // Check the RA/DEC criteria on stored coordinates (see vobsSTAR::IsMatchingCriteria):
+        if (criteria->isRadius)
+        {
+            if ((alxComputeDistanceInDegrees(ra, dec, star->ra, star->dec, &distAng) == mcsFAILURE)
+                    || (distAng > criteria->rangeRA))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            if (fabs(dec - star->dec) > criteria->rangeDEC)
+            {
+                continue;
+            }
+            // boundary problem [-180; 180]
+            delta = fabs(ra - star->ra);
+            if (delta > 180.0)
+            {
+                delta = 360.0 - delta; // complementary angle in [0;180[
+            }
+            if (delta > criteria->rangeRA)
+            {
+                continue;
+            }
+        }
+
+        // Create the candidate star to check all criteria:
+        vobsSTAR* starPtr = new vobsSTAR();
+
+        const mcsCOMPL_STAT status = GetStar(star - stars, *starPtr);
+
+        // reset distance:
+        distAng = NAN;
+
+        if ((status == mcsSUCCESS) && IS_TRUE(referenceStar->IsMatchingCriteria(starPtr, criterias, nCriteria, &distAng)))
+        {
+            // add candidate in distance map:
+            vobsSTAR_PTR_MATCH_ENTRY entry = vobsSTAR_PTR_MATCH_ENTRY(distAng, starPtr);
+            distMap.insert(vobsSTAR_PTR_MATCH_PAIR(entry.score, entry));
+        }
+        else
+        {
+            delete starPtr;
+
+            if (status == mcsFAILURE)
+            {
+                for (vobsSTAR_PTR_MATCH_MAP::const_iterator iter = distMap.begin(); iter != distMap.end(); iter++)
+                {
+                    delete iter->second.starPtr;
+                }
+                return mcsFAILURE;
+            }
+        }
+    }
+
+    logTest("Search(image): %d candidates - %d matches", nStars, (mcsINT32) distMap.size());
+
+    // Give stars (up to maxMatches) to the output list:
+    mcsUINT32 i = 0;
+
+    for (vobsSTAR_PTR_MATCH_MAP::const_iterator iter = distMap.begin(); iter != distMap.end(); iter++)
+    {
+        if (i++ < maxMatches)
+        {
+            outputList.AddRefAtTail(iter->second.starPtr);
+        }
+        else
+        {
+            delete iter->second.starPtr;
+        }
+    }
+
+    logTest("Search: done: %d stars found.", outputList.Size());
+
+    return mcsSUCCESS;
+}
+
+/*
+ * Private methods
+ */
+
+/**
+ * Set the properties of the given star from the image star at the given
+ * position (values, errors, origins and confidences).
+ *
+ * @param index star position in the image
+ * @param star star to fill (empty)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrJSDC_IMAGE::GetStar(mcsUINT32 index, vobsSTAR &star) const
+{
+    const sclsvrJSDC_IMAGE_HEADER* header = (const sclsvrJSDC_IMAGE_HEADER*) _base;
+    const sclsvrJSDC_IMAGE_STAR* record = ((const sclsvrJSDC_IMAGE_STAR*) (_base + header->starOffset)) + index;
+    const sclsvrJSDC_IMAGE_PROPERTY* properties = ((const sclsvrJSDC_IMAGE_PROPERTY*) (_base + header->propertyOffset)) + record->firstProperty;
+    const char* strings = (const char*) (_base + header->stringOffset);
+
+    mcsFLOAT floats[2];
+    mcsINT64 longValue;
+
+    for (mcsUINT32 p = 0; p < record->nbProperties; p++)
+    {
+        const sclsvrJSDC_IMAGE_PROPERTY* prop = &properties[p];
+
+        vobsSTAR_PROPERTY* property = star.GetProperty(prop->index);
+        FAIL_NULL(property);
+
+        const vobsORIGIN_INDEX originIndex = (vobsORIGIN_INDEX) prop->origin;
+        const vobsCONFIDENCE_INDEX confidenceIndex = (vobsCONFIDENCE_INDEX) prop->confidence;
+
+        switch (property->GetType())
+        {
+            case vobsSTRING_PROPERTY:
+                FAIL(property->SetValue(strings + prop->data[0], originIndex, confidenceIndex));
+                break;
+            case vobsFLOAT_PROPERTY:
+                memcpy(floats, prop->data, sizeof (floats));
+                FAIL(property->SetValue((mcsDOUBLE) floats[0], originIndex, confidenceIndex));
+                property->SetError((mcsDOUBLE) floats[1]);
+                break;
+            default:
+                memcpy(&longValue, prop->data, sizeof (longValue));
+                FAIL(property->SetValue(longValue, originIndex, confidenceIndex));
+                break;
+        }
+    }
+    return mcsSUCCESS;
+}
+
+
+/*___oOo___*/
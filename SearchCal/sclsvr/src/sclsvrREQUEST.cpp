@@ -12,6 +12,7 @@
 /*
  * System Headers
  */
+#include <stdlib.h>
 #include <iostream>
 using namespace std;
 
@@ -24,6 +25,12 @@ using namespace std;
 #include "err.h"
 
 
+/*
+ * SCALIB Headers
+ */
+#include "vobs.h"
+
+
 /*
  * Local Headers
  */
@@ -44,6 +51,8 @@ sclsvrREQUEST::sclsvrREQUEST()
     _fileName[0]       = '\0';
     _outputFormat      = 0.0;
     _diagnose          = mcsFALSE;
+    _visGridNbSamples  = 0;
+    _timeout           = vobsDEADLINE_DEFAULT;
     _jsdcMode          = mcsFALSE;
 }
 
@@ -172,6 +181,25 @@ mcsCOMPL_STAT sclsvrREQUEST::Parse(const char *cmdParamLine)
     mcsLOGICAL diagnose = mcsFALSE;
     FAIL(_getCalCmd->GetDiagnose(&diagnose));
 
+    // Visibility grid
+    char* visBaselines = NULL;
+    if (IS_TRUE(_getCalCmd->IsDefinedVisBaselines()))
+    {
+        FAIL(_getCalCmd->GetVisBaselines(&visBaselines));
+    }
+    char* visWlens = NULL;
+    if (IS_TRUE(_getCalCmd->IsDefinedVisWlens()))
+    {
+        FAIL(_getCalCmd->GetVisWlens(&visWlens));
+    }
+
+    // Maximum duration of the catalog queries
+    mcsINT32 timeout = vobsDEADLINE_DEFAULT;
+    if (IS_TRUE(_getCalCmd->IsDefinedTimeout()))
+    {
+        FAIL(_getCalCmd->GetTimeout(&timeout));
+    }
+
 
     // Build the request object from the parameters of the command
     // Affect the reference object name
@@ -231,6 +259,15 @@ mcsCOMPL_STAT sclsvrREQUEST::Parse(const char *cmdParamLine)
     // Affect the diagnose flag
     FAIL(SetDiagnose(diagnose));
 
+    // Affect the visibility grid
+    if (IS_NOT_NULL(visBaselines) || IS_NOT_NULL(visWlens))
+    {
+        FAIL(SetVisGrid(visBaselines, visWlens));
+    }
+
+    // Affect the maximum duration of the catalog queries
+    FAIL(SetTimeout(timeout));
+
     return mcsSUCCESS;
 }
 
@@ -258,6 +295,46 @@ mcsCOMPL_STAT sclsvrREQUEST::GetCmdParamLine(mcsSTRING16384* cmdParamLine) const
     return mcsSUCCESS;
 }
 
+/**
+ * Return the search key of this request: the canonical string of the
+ * parameters defining the completed calibrators (science object, search area,
+ * band, magnitude range and bright/faint scenario) excluding the observing
+ * parameters (wavelength, baseline) and output options.
+ *
+ * @param key search key
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrREQUEST::GetSearchKey(string &key) const
+{
+    mcsSTRING1024 buffer;
+
+    if (GetSearchAreaGeometry() == vobsCIRCLE)
+    {
+        mcsDOUBLE radius;
+        FAIL(GetSearchArea(radius));
+
+        snprintf(buffer, sizeof (buffer) - 1, "radius=%.9lf", radius);
+    }
+    else
+    {
+        mcsDOUBLE deltaRa, deltaDec;
+        FAIL(GetSearchArea(deltaRa, deltaDec));
+
+        snprintf(buffer, sizeof (buffer) - 1, "diffRa=%.9lf diffDec=%.9lf", deltaRa, deltaDec);
+    }
+    key = buffer;
+
+    snprintf(buffer, sizeof (buffer) - 1, " objectName=%s ra=%s dec=%s pmRa=%.9lf pmDec=%.9lf mag=%.9lf"
+             " band=%s minMagRange=%.9lf maxMagRange=%.9lf bright=%s jsdc=%s",
+             GetObjectName(), GetObjectRa(), GetObjectDec(), GetPmRa(), GetPmDec(), GetObjectMag(),
+             GetSearchBand(), GetMinMagRange(), GetMaxMagRange(),
+             IS_TRUE(IsBright()) ? "true" : "false", IS_TRUE(IsJSDCMode()) ? "true" : "false");
+    key.append(buffer);
+
+    return mcsSUCCESS;
+}
+
 /**
  * Set search band (overridden) and update the GETCAL command
  *
@@ -451,6 +528,31 @@ mcsLOGICAL sclsvrREQUEST::IsDiagnose() const
     return _diagnose;
 }
 
+/**
+ * Set the maximum duration of the catalog queries: once reached, optional
+ * catalogs are skipped and the results are partial.
+ *
+ * @param timeout maximum duration in seconds
+ *
+ * @return Always mcsSUCCESS.
+ */
+mcsCOMPL_STAT sclsvrREQUEST::SetTimeout(mcsUINT32 timeout)
+{
+    _timeout = timeout;
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the maximum duration of the catalog queries.
+ *
+ * @return maximum duration in seconds.
+ */
+mcsUINT32 sclsvrREQUEST::GetTimeout(void) const
+{
+    return _timeout;
+}
+
 /**
  * Append a VOTable serailization of the request and its parameters.
  *
@@ -463,6 +565,109 @@ mcsCOMPL_STAT sclsvrREQUEST::AppendParamsToVOTable(string& voTable)
     return _getCalCmd->AppendParamsToVOTable(voTable);
 }
 
+/**
+ * Parse a comma-separated list of positive values.
+ *
+ * @param list comma-separated values
+ * @param values parsed values
+ * @param nbValues number of parsed values
+ * @param maxValues maximum number of values
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT sclsvrParseValueList(const char* list, mcsDOUBLE* values, mcsUINT32 &nbValues, mcsUINT32 maxValues)
+{
+    const char* ptr = list;
+    char* end;
+
+    nbValues = 0;
+
+    FAIL_NULL_DO(list, errAdd(sclsvrERR_INVALID_VIS_GRID, "missing baselines or wavelengths", sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+
+    while (*ptr != '\0')
+    {
+        const mcsDOUBLE value = strtod(ptr, &end);
+
+        FAIL_COND_DO((end == ptr) || !(value > 0.0) || (nbValues == maxValues),
+                     errAdd(sclsvrERR_INVALID_VIS_GRID, list, sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+
+        values[nbValues++] = value;
+
+        // skip blanks and separator:
+        for (ptr = end; (*ptr == ' ') || (*ptr == ','); ptr++);
+    }
+
+    FAIL_COND_DO(nbValues == 0, errAdd(sclsvrERR_INVALID_VIS_GRID, list, sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Set the visibility grid: every combination of the given baselines and
+ * wavelengths (wavelength major order).
+ *
+ * @param baselines comma-separated baseline lengths (m)
+ * @param wlens comma-separated wavelengths (um)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrREQUEST::SetVisGrid(const char* baselines, const char* wlens)
+{
+    mcsDOUBLE baselineValues[sclsvrREQUEST_VIS_GRID_MAX_SAMPLES];
+    mcsDOUBLE wlenValues[sclsvrREQUEST_VIS_GRID_MAX_SAMPLES];
+    mcsUINT32 nbBaselines, nbWlens;
+
+    _visGridNbSamples = 0;
+
+    FAIL(sclsvrParseValueList(baselines, baselineValues, nbBaselines, sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+    FAIL(sclsvrParseValueList(wlens, wlenValues, nbWlens, sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+
+    FAIL_COND_DO(nbBaselines * nbWlens > sclsvrREQUEST_VIS_GRID_MAX_SAMPLES,
+                 errAdd(sclsvrERR_INVALID_VIS_GRID, "too many samples", sclsvrREQUEST_VIS_GRID_MAX_SAMPLES));
+
+    for (mcsUINT32 w = 0; w < nbWlens; w++)
+    {
+        for (mcsUINT32 b = 0; b < nbBaselines; b++)
+        {
+            _visGridBaselines[_visGridNbSamples] = baselineValues[b];
+            _visGridWlens[_visGridNbSamples] = wlenValues[w];
+            _visGridNbSamples++;
+        }
+    }
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the number of samples of the visibility grid.
+ *
+ * @return number of (baseline, wavelength) samples (0 if no grid)
+ */
+mcsUINT32 sclsvrREQUEST::GetVisGridNbSamples(void) const
+{
+    return _visGridNbSamples;
+}
+
+/**
+ * Return the baselines of the visibility grid samples.
+ *
+ * @return baseline lengths (m)
+ */
+const mcsDOUBLE* sclsvrREQUEST::GetVisGridBaselines(void) const
+{
+    return _visGridBaselines;
+}
+
+/**
+ * Return the wavelengths of the visibility grid samples.
+ *
+ * @return wavelengths (um)
+ */
+const mcsDOUBLE* sclsvrREQUEST::GetVisGridWlens(void) const
+{
+    return _visGridWlens;
+}
+
 /**
  * Specify whether the JSDC mode is enabled.
  *
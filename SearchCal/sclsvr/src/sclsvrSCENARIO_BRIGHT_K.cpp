@@ -58,6 +58,14 @@ const char* sclsvrSCENARIO_BRIGHT_K::GetScenarioName() const
     return "BRIGHT_K";
 }
 
+/**
+ * Free the star list of the last request
+ */
+void sclsvrSCENARIO_BRIGHT_K::ReleaseData(void)
+{
+    _starList.Clear();
+}
+
 /**
  * Initialize the BRIGHT K scenario
  *
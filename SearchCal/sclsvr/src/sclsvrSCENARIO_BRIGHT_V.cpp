@@ -55,6 +55,14 @@ const char* sclsvrSCENARIO_BRIGHT_V::GetScenarioName() const
     return "BRIGHT_V";
 }
 
+/**
+ * Free the star list of the last request
+ */
+void sclsvrSCENARIO_BRIGHT_V::ReleaseData(void)
+{
+    _starList.Clear();
+}
+
 /**
  * Initialize the BRIGHT V scenario
  *
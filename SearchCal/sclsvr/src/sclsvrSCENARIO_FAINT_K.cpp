@@ -61,6 +61,16 @@ const char* sclsvrSCENARIO_FAINT_K::GetScenarioName() const
     return "FAINT_K";
 }
 
+/**
+ * Free the star lists of the last request
+ */
+void sclsvrSCENARIO_FAINT_K::ReleaseData(void)
+{
+    _starListP.Clear();
+    _starListS1.Clear();
+    _starListS2.Clear();
+}
+
 /**
  * Initialize the FAINT K scenario
  *
@@ -63,6 +63,14 @@ const char* sclsvrSCENARIO_JSDC::GetScenarioName() const
     return "JSDC_BRIGHT";
 }
 
+/**
+ * Free the star list of the last request
+ */
+void sclsvrSCENARIO_JSDC::ReleaseData(void)
+{
+    _starList.Clear();
+}
+
 /**
  * Initialize the JSDC scenario
  *
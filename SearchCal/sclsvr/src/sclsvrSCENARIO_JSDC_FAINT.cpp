@@ -63,6 +63,14 @@ const char* sclsvrSCENARIO_JSDC_FAINT::GetScenarioName() const
     return "JSDC_FAINT";
 }
 
+/**
+ * Free the star list of the last request
+ */
+void sclsvrSCENARIO_JSDC_FAINT::ReleaseData(void)
+{
+    _starList.Clear();
+}
+
 /**
  * Initialize the JSDC FAINT scenario
  *
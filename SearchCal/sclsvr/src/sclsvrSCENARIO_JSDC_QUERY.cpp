@@ -30,28 +30,17 @@ using namespace std;
 #include "sclsvrPrivate.h"
 #include "sclsvrREQUEST.h"
 
-/** Initialize static members */
-bool sclsvrSCENARIO_JSDC_QUERY::JSDC_Initialized = false;
-vobsSTAR_LIST* sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright = NULL;
-vobsSTAR_LIST* sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint = NULL;
-vobsSTAR_LIST* sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete = NULL;
-
-
 /* catalog name */
 #define sclsvrSCENARIO_JSDC_NAME "JSDC_2020.12"
 /** max returned results */
 #define sclsvrSCENARIO_JSDC_MAX_SIZE 5000
 
-/* JSDC data file (bright) */
-#define sclsvrSCENARIO_JSDC_FILE_BRIGHT "$MCSDATA/tmp/GetCal/SearchListBackup_JSDC_BRIGHT.dat"
-/* JSDC data file (faint) */
-#define sclsvrSCENARIO_JSDC_FILE_FAINT  "$MCSDATA/tmp/GetCal/SearchListBackup_JSDC_FAINT.dat"
-
 /**
  * Class constructor
  */
 sclsvrSCENARIO_JSDC_QUERY::sclsvrSCENARIO_JSDC_QUERY(sdbENTRY* progress) : vobsSCENARIO(progress)
 {
+    _data = NULL;
 }
 
 /**
@@ -59,6 +48,7 @@ sclsvrSCENARIO_JSDC_QUERY::sclsvrSCENARIO_JSDC_QUERY(sdbENTRY* progress) : vobsS
  */
 sclsvrSCENARIO_JSDC_QUERY::~sclsvrSCENARIO_JSDC_QUERY()
 {
+    ReleaseData();
 }
 
 /*
@@ -74,158 +64,14 @@ const char* sclsvrSCENARIO_JSDC_QUERY::GetScenarioName() const
     return "JSDC_QUERY";
 }
 
-vobsSTAR_LIST* loadStarList(const char* inputFileName, const char* listName)
-{
-    mcsSTRING512 fileName;
-
-    // Build the list of star which will come from the virtual observatory
-    vobsSTAR_LIST* starList = new vobsSTAR_LIST(listName);
-
-    strcpy(fileName, inputFileName);
-
-    // Resolve path
-    char* resolvedPath = miscResolvePath(fileName);
-    if (IS_NOT_NULL(resolvedPath))
-    {
-        strcpy(fileName, resolvedPath);
-        free(resolvedPath);
-    }
-    else
-    {
-        fileName[0] = '\0';
-    }
-    if (strlen(fileName) != 0)
-    {
-        logInfo("Loading VO StarList backup: %s", fileName);
-
-        static const char* cmdName = "Load_JSDC";
-
-        // Start timer log
-        timlogInfoStart(cmdName);
-
-        if (starList->Load(fileName, NULL, NULL, mcsTRUE) == mcsFAILURE)
-        {
-            timlogCancel(cmdName);
-
-            // Ignore error (for test only)
-            errCloseStack();
-
-            // clear anyway:
-            starList->Clear();
-        }
-        else
-        {
-            // Stop timer log
-            timlogStop(cmdName);
-        }
-    }
-    if (starList->IsEmpty())
-    {
-        delete starList;
-        starList = NULL;
-    }
-    else
-    {
-        // Prepare index
-        starList->PrepareIndex();
-    }
-    return starList;
-}
-
-/** preload the JSDC catalog at startup */
-bool sclsvrSCENARIO_JSDC_QUERY::loadData()
-{
-    if (!sclsvrSCENARIO_JSDC_QUERY::JSDC_Initialized)
-    {
-        sclsvrSCENARIO_JSDC_QUERY::JSDC_Initialized = true;
-
-        logInfo("Loading JSDC data ...")
-
-        /* must free this allocated star lists */
-        sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright = loadStarList(sclsvrSCENARIO_JSDC_FILE_BRIGHT, "JSDC_Data_Bright");
-        sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint  = loadStarList(sclsvrSCENARIO_JSDC_FILE_FAINT, "JSDC_Data_Faint");
-
-        // Concatenate lists into the Complete list:
-        vobsSTAR_LIST* starList = new vobsSTAR_LIST("JSDC_Data_Complete");
-
-        // define the free pointer flag to avoid double frees (this list and the given list are storing same star pointers):
-        starList->SetFreeStarPointers(false);
-
-        if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright))
-        {
-            starList->CopyRefs(*sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright, mcsFALSE);
-        }
-
-        if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint))
-        {
-            starList->CopyRefs(*sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint, mcsFALSE);
-        }
-
-        if (starList->IsEmpty())
-        {
-            delete starList;
-            starList = NULL;
-        }
-        else
-        {
-            // Sort by declination to optimize JSDC queries
-            starList->Sort(vobsSTAR_POS_EQ_DEC_MAIN);
-
-            // Prepare index
-            starList->PrepareIndex();
-        }
-        sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete = starList;
-    }
-
-    if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright))
-    {
-        logInfo("List[%s] size : %d", sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright->GetName(),
-                sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright->Size());
-    }
-
-    if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint))
-    {
-        logInfo("List[%s] size : %d", sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint->GetName(),
-                sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint->Size());
-    }
-
-    if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete))
-    {
-        logInfo("List[%s] size : %d", sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete->GetName(),
-                sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete->Size());
-    }
-
-    logInfo("Loading JSDC data : %s",
-            (sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete) ? "true" : "false");
-
-    return IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete);
-}
-
-/** free the JSDC catalog at shutdown */
-void sclsvrSCENARIO_JSDC_QUERY::freeData()
+/**
+ * Give back the JSDC dataset used by the last request: its stars must not be
+ * used anymore (end of request)
+ */
+void sclsvrSCENARIO_JSDC_QUERY::ReleaseData(void)
 {
-    if (sclsvrSCENARIO_JSDC_QUERY::JSDC_Initialized)
-    {
-        sclsvrSCENARIO_JSDC_QUERY::JSDC_Initialized = false;
-
-        if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright))
-        {
-            delete sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright;
-            sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright = NULL;
-        }
-
-        if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint))
-        {
-            delete sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint;
-            sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Faint = NULL;
-        }
-
-        if (IS_NOT_NULL(sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete))
-        {
-            delete sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete;
-            sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete = NULL;
-        }
-    }
+    sclsvrJSDC_DATA::Release(_data);
+    _data = NULL;
 }
 
 /**
@@ -346,15 +192,27 @@ mcsCOMPL_STAT sclsvrSCENARIO_JSDC_QUERY::Execute(vobsSCENARIO_RUNTIME &ctx, vobs
 {
     logInfo("Scenario[%s] Execute() start", GetScenarioName());
 
+    // Use the same JSDC dataset during the whole request (reloads):
+    if (IS_NULL(_data))
+    {
+        _data = sclsvrJSDC_DATA::Acquire();
+    }
+
+    FAIL_NULL_DO(_data,
+                 errUserAdd(sclsvrERR_CATALOG_LOAD_JSDC, sclsvrSCENARIO_JSDC_NAME));
+
+    const sclsvrJSDC_IMAGE* catalogImage = _data->GetImage();
+
     vobsSTAR_LIST* catalogStarList = (IS_TRUE(_brightFlag)) ?
-            sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Bright :
-            sclsvrSCENARIO_JSDC_QUERY::JSDC_StarList_Complete;
+            _data->GetStarListBright() :
+            _data->GetStarListComplete();
 
-    FAIL_NULL_DO(catalogStarList,
-                 errUserAdd(sclsvrERR_CATALOG_LOAD_JSDC, sclsvrSCENARIO_JSDC_FILE_BRIGHT));
+    FAIL_COND_DO(IS_NULL(catalogImage) && IS_NULL(catalogStarList),
+                 errUserAdd(sclsvrERR_CATALOG_LOAD_JSDC, sclsvrSCENARIO_JSDC_NAME));
 
-    // define the free pointer flag to avoid double frees (this list and the given list are storing same star pointers):
-    starList.SetFreeStarPointers(false);
+    // define the free pointer flag to avoid double frees (this list and the given list are storing same star pointers)
+    // unless stars are created from the shared JSDC image:
+    starList.SetFreeStarPointers(IS_NOT_NULL(catalogImage));
 
     static const char* catalogName = sclsvrSCENARIO_JSDC_NAME;
 
@@ -388,14 +246,22 @@ mcsCOMPL_STAT sclsvrSCENARIO_JSDC_QUERY::Execute(vobsSCENARIO_RUNTIME &ctx, vobs
     FAIL(_progress->Write(message));
 
     // Start research in entry's catalog
-    logTest("Execute: Step %d - Querying %s [%s] ...", nStep, catalogName, catalogName);
+    logTest("Execute: Step %d - Querying %s [version %u] ...", nStep, catalogName, _data->GetVersion());
     
     // Start time counter
     timlogInfoStart(timLogActionName);
 
     // if research failed, return mcsFAILURE and tempList is empty
-    FAIL_DO(catalogStarList->Search(&_referenceStar, &_criteriaListRaDecMagRange, starList, sclsvrSCENARIO_JSDC_MAX_SIZE),
-            timlogCancel(timLogActionName));
+    if (IS_NOT_NULL(catalogImage))
+    {
+        FAIL_DO(catalogImage->Search(&_referenceStar, &_criteriaListRaDecMagRange, IS_TRUE(_brightFlag), starList, sclsvrSCENARIO_JSDC_MAX_SIZE),
+                timlogCancel(timLogActionName));
+    }
+    else
+    {
+        FAIL_DO(catalogStarList->Search(&_referenceStar, &_criteriaListRaDecMagRange, starList, sclsvrSCENARIO_JSDC_MAX_SIZE),
+                timlogCancel(timLogActionName));
+    }
 
     // Stop time counter
     timlogStopTime(timLogActionName, &elapsedTime);
@@ -55,6 +55,14 @@ const char* sclsvrSCENARIO_SINGLE_STAR::GetScenarioName() const
     return "SINGLE_STAR";
 }
 
+/**
+ * Free the star list of the last request
+ */
+void sclsvrSCENARIO_SINGLE_STAR::ReleaseData(void)
+{
+    _starList.Clear();
+}
+
 mcsCOMPL_STAT sclsvrSCENARIO_SINGLE_STAR::Init(vobsSCENARIO_RUNTIME &ctx, vobsREQUEST* request, vobsSTAR_LIST* starList)
 {
     // Clear the list input and list output which will be used
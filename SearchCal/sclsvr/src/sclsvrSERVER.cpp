@@ -37,6 +37,9 @@ using namespace std;
 /* initialize sclsvr module (vobsSTAR meta data) */
 void sclsvrInit(bool loadJSDC)
 {
+    // initialize alx module (preload tables):
+    alxInit();
+
     vobsPreInit();
     
     // first build star property index:
@@ -51,7 +54,7 @@ void sclsvrInit(bool loadJSDC)
     /* load JSDC for web server */
     if (loadJSDC)
     {
-        doQueryJSDC = sclsvrSCENARIO_JSDC_QUERY::loadData();
+        doQueryJSDC = sclsvrJSDC_DATA::Load();
         
         if (!doQueryJSDC)
         {
@@ -78,7 +81,7 @@ void sclsvrExit()
     sclsvrCALIBRATOR::FreePropertyIndex();
 
     // Free JSDC data:
-    sclsvrSCENARIO_JSDC_QUERY::freeData();
+    sclsvrJSDC_DATA::Free();
 }
 
 /**
@@ -187,6 +190,59 @@ sclsvrSERVER::~sclsvrSERVER()
 /*
  * Public methods
  */
+
+/**
+ * Reset the server state (working and cancellation flags, request status) to
+ * process a new request; scenarios and the virtual observatory are kept
+ * (see sclsvrSERVER_POOL) but the data of the last request (scenario star
+ * lists, runtime buffers) is freed while the server is idle.
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT sclsvrSERVER::Reset()
+{
+    _working = false;
+    *_cancelFlag = false;
+
+    // no deadline:
+    _virtualObservatory.SetDeadline(0);
+
+    // free the star lists of the last request:
+    _scenarioBrightK.ReleaseData();
+    _scenarioJSDC.ReleaseData();
+    _scenarioJSDC_Faint.ReleaseData();
+    _scenarioBrightV.ReleaseData();
+    _scenarioFaintK.ReleaseData();
+    _scenarioSingleStar.ReleaseData();
+
+    // give back the JSDC dataset (reloads):
+    _scenarioJSDC_Query.ReleaseData();
+
+    // free the query / response buffers (reserved again by the next request):
+    _virtualObservatory.ReleaseBuffers();
+
+    return _status.Clear();
+}
+
+/**
+ * Append the partial result PARAMs to the given VOTable if optional catalogs
+ * were skipped or truncated at the deadline (complete results are unchanged).
+ *
+ * @param voTable the string in which the PARAMs will be appent
+ */
+void sclsvrSERVER::AppendPartialParamsToVOTable(string& voTable) const
+{
+    if (IsPartial())
+    {
+        logWarning("Partial results: skipped catalogs [%s]", _virtualObservatory.GetSkippedCatalogs());
+
+        voTable.append("<PARAM name=\"partial\" datatype=\"boolean\" value=\"true\"/>");
+        voTable.append("<PARAM name=\"skippedCatalogs\" datatype=\"char\" arraysize=\"*\" value=\"");
+        voTable.append(_virtualObservatory.GetSkippedCatalogs());
+        voTable.append("\"/>");
+    }
+}
+
 mcsCOMPL_STAT sclsvrSERVER::AppInit()
 {
     evhCMD_KEY key(sclsvrGETCAL_CMD_NAME, sclsvrGETCAL_CDF_NAME);
@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of sclsvrSERVER_POOL class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <vector>
+#include <time.h>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * Local Headers
+ */
+#include "sclsvrSERVER_POOL.h"
+#include "sclsvrPrivate.h"
+
+/*
+ * Local Variables
+ */
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX sclsvrServerPoolMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** idle server instances (last released first) */
+static vector<sclsvrSERVER*> sclsvrServerPoolIdle;
+
+/* statistics */
+static mcsUINT64 sclsvrServerPoolCreated = 0;
+static mcsUINT64 sclsvrServerPoolAcquired = 0;
+static mcsUINT64 sclsvrServerPoolReused = 0;
+static mcsUINT64 sclsvrServerPoolDeleted = 0;
+/** total time spent in server construction (ms) */
+static mcsDOUBLE sclsvrServerPoolCreateTime = 0.0;
+/** total time spent in Acquire() (ms) */
+static mcsDOUBLE sclsvrServerPoolAcquireTime = 0.0;
+
+/*
+ * Local Functions
+ */
+
+/* return the monotonic time (ms) */
+static mcsDOUBLE sclsvrServerPoolGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return 1e3 * time.tv_sec + 1e-6 * time.tv_nsec;
+}
+
+/* create a new server instance (outside lock) */
+static sclsvrSERVER* sclsvrServerPoolCreate(void)
+{
+    const mcsDOUBLE start = sclsvrServerPoolGetTime();
+
+    // pooled servers outlive the request creating them: allocate them in the heap
+    // (a block left in the request arena keeps its whole chunk alive):
+    vobsARENA_SCOPE heapScope(false);
+
+    sclsvrSERVER* server = new sclsvrSERVER(mcsFALSE);
+
+    const mcsDOUBLE elapsed = sclsvrServerPoolGetTime() - start;
+
+    mcsMutexLock(&sclsvrServerPoolMutex);
+
+    sclsvrServerPoolCreated++;
+    sclsvrServerPoolCreateTime += elapsed;
+
+    mcsMutexUnlock(&sclsvrServerPoolMutex);
+
+    return server;
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Create the given number of idle server instances (warm-up at startup)
+ *
+ * @param nbServers number of server instances (limited to sclsvrSERVER_POOL_MAX_IDLE)
+ */
+void sclsvrSERVER_POOL::Init(const mcsUINT32 nbServers)
+{
+    for (mcsUINT32 i = 0; (i < nbServers) && (i < sclsvrSERVER_POOL_MAX_IDLE); i++)
+    {
+        Release(sclsvrServerPoolCreate());
+    }
+
+    logInfo("Server pool: %u idle server instances.", sclsvrServerPoolIdle.size());
+}
+
+/**
+ * Return an idle server instance (reset) or a new one if the pool is empty.
+ * The server must be given back using Release().
+ *
+ * @return server instance
+ */
+sclsvrSERVER* sclsvrSERVER_POOL::Acquire(void)
+{
+    const mcsDOUBLE start = sclsvrServerPoolGetTime();
+
+    sclsvrSERVER* server = NULL;
+
+    mcsMutexLock(&sclsvrServerPoolMutex);
+
+    if (!sclsvrServerPoolIdle.empty())
+    {
+        server = sclsvrServerPoolIdle.back();
+        sclsvrServerPoolIdle.pop_back();
+
+        sclsvrServerPoolReused++;
+    }
+
+    mcsMutexUnlock(&sclsvrServerPoolMutex);
+
+    if (IS_NULL(server))
+    {
+        server = sclsvrServerPoolCreate();
+    }
+
+    const mcsDOUBLE elapsed = sclsvrServerPoolGetTime() - start;
+
+    mcsMutexLock(&sclsvrServerPoolMutex);
+
+    sclsvrServerPoolAcquired++;
+    sclsvrServerPoolAcquireTime += elapsed;
+
+    mcsMutexUnlock(&sclsvrServerPoolMutex);
+
+    return server;
+}
+
+/**
+ * Give back the given server instance: it is reset and kept for the next
+ * requests (or deleted if the pool is full or the server can not be reset).
+ * The server must not be used anymore by the caller.
+ *
+ * @param server server instance (may be NULL)
+ */
+void sclsvrSERVER_POOL::Release(sclsvrSERVER* server)
+{
+    if (IS_NULL(server))
+    {
+        return;
+    }
+
+    // reset outside the lock (in the heap as the server is kept in the pool):
+    vobsARENA_SCOPE heapScope(false);
+
+    if (server->Reset() == mcsFAILURE)
+    {
+        errCloseStack();
+    }
+    else
+    {
+        mcsMutexLock(&sclsvrServerPoolMutex);
+
+        if (sclsvrServerPoolIdle.size() < sclsvrSERVER_POOL_MAX_IDLE)
+        {
+            sclsvrServerPoolIdle.push_back(server);
+
+            // given to the pool:
+            server = NULL;
+        }
+
+        mcsMutexUnlock(&sclsvrServerPoolMutex);
+    }
+
+    if (IS_NOT_NULL(server))
+    {
+        delete(server);
+
+        mcsMutexLock(&sclsvrServerPoolMutex);
+
+        sclsvrServerPoolDeleted++;
+
+        mcsMutexUnlock(&sclsvrServerPoolMutex);
+    }
+}
+
+/**
+ * Return the pool statistics
+ *
+ * @param created number of created server instances
+ * @param reused number of reused server instances
+ * @param deleted number of deleted server instances
+ * @param nbIdle number of idle server instances
+ * @param createTime average construction time of one server instance (ms)
+ * @param acquireTime average time to acquire one server instance (ms)
+ */
+void sclsvrSERVER_POOL::GetStats(mcsUINT64 &created, mcsUINT64 &reused, mcsUINT64 &deleted,
+                                 mcsUINT32 &nbIdle, mcsDOUBLE &createTime, mcsDOUBLE &acquireTime)
+{
+    mcsMutexLock(&sclsvrServerPoolMutex);
+
+    created = sclsvrServerPoolCreated;
+    reused = sclsvrServerPoolReused;
+    deleted = sclsvrServerPoolDeleted;
+    nbIdle = sclsvrServerPoolIdle.size();
+    createTime = (created != 0) ? sclsvrServerPoolCreateTime / created : 0.0;
+    acquireTime = (sclsvrServerPoolAcquired != 0) ? sclsvrServerPoolAcquireTime / sclsvrServerPoolAcquired : 0.0;
+
+    mcsMutexUnlock(&sclsvrServerPoolMutex);
+}
+
+/**
+ * Free all idle server instances (statistics are kept)
+ */
+void sclsvrSERVER_POOL::Clear(void)
+{
+    mcsMutexLock(&sclsvrServerPoolMutex);
+
+    for (vector<sclsvrSERVER*>::iterator iter = sclsvrServerPoolIdle.begin(); iter != sclsvrServerPoolIdle.end(); iter++)
+    {
+        delete(*iter);
+        sclsvrServerPoolDeleted++;
+    }
+    sclsvrServerPoolIdle.clear();
+
+    mcsMutexUnlock(&sclsvrServerPoolMutex);
+}
+
+
+/*___oOo___*/
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of sclsvrSPECTRAL_TYPE_CACHE class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <map>
+#include <list>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * Local Headers
+ */
+#include "sclsvrSPECTRAL_TYPE_CACHE.h"
+#include "sclsvrPrivate.h"
+
+/*
+ * Local Types
+ */
+
+/** cached entry: decoded spectral type + position in the LRU list */
+typedef struct
+{
+    sclsvrSPECTRAL_TYPE_INFO info;
+    list<string>::iterator lruPos;
+} sclsvrSPECTRAL_TYPE_ENTRY;
+
+/** entry map keyed by the raw spectral type */
+typedef map<string, sclsvrSPECTRAL_TYPE_ENTRY> sclsvrSPECTRAL_TYPE_ENTRY_MAP;
+
+/*
+ * Local Variables
+ */
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX sclsvrSpTypeCacheMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** cached entries */
+static sclsvrSPECTRAL_TYPE_ENTRY_MAP sclsvrSpTypeCacheMap;
+/** spectral types ordered by last access (most recent first) */
+static list<string> sclsvrSpTypeCacheLru;
+
+/* statistics */
+static mcsUINT64 sclsvrSpTypeCacheHits = 0;
+static mcsUINT64 sclsvrSpTypeCacheMisses = 0;
+static mcsUINT64 sclsvrSpTypeCacheEvictions = 0;
+
+/*
+ * Local Functions
+ */
+
+/* decode the given spectral type and compute its derived quantities */
+static void sclsvrSpTypeDecode(const char* spType, sclsvrSPECTRAL_TYPE_INFO &info)
+{
+    // initialize the spectral type structure anyway:
+    alxInitializeSpectralType(&info.spectralType);
+
+    info.parsed = mcsFALSE;
+
+    if (strlen(spType) != 0)
+    {
+        /*
+         * Get each part of the spectral type XN.NLLL where X is a letter, N.N a
+         * number between 0 and 9 and LLL is the light class
+         */
+        if (alxString2SpectralType(spType, &info.spectralType) == mcsSUCCESS)
+        {
+            info.parsed = mcsTRUE;
+        }
+        else
+        {
+            errCloseStack();
+        }
+    }
+
+    alxGiveIndexInTableOfSpectralCodes(info.spectralType,
+                                       &info.colorTableIndex, &info.colorTableDelta, &info.lumClass, &info.lumClassDelta);
+
+    info.hasTeffLogg = mcsFALSE;
+    info.teff = NAN;
+    info.logg = NAN;
+
+    if (IS_TRUE(info.spectralType.isSet))
+    {
+        if (alxComputeTeffAndLoggFromSptype(&info.spectralType, &info.teff, &info.logg) == mcsSUCCESS)
+        {
+            info.hasTeffLogg = mcsTRUE;
+        }
+        else
+        {
+            errCloseStack();
+            info.teff = NAN;
+            info.logg = NAN;
+        }
+    }
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Decode the given spectral type: use the cached result if present or decode
+ * it (alxString2SpectralType, color table indexes, Teff / LogG) and cache it.
+ *
+ * @param spType raw spectral type (may be empty)
+ * @param info decoded spectral type and its derived quantities
+ */
+void sclsvrSPECTRAL_TYPE_CACHE::Decode(const char* spType, sclsvrSPECTRAL_TYPE_INFO &info)
+{
+    const string key(spType);
+
+    mcsMutexLock(&sclsvrSpTypeCacheMutex);
+
+    sclsvrSPECTRAL_TYPE_ENTRY_MAP::iterator iter = sclsvrSpTypeCacheMap.find(key);
+
+    if (iter != sclsvrSpTypeCacheMap.end())
+    {
+        sclsvrSpTypeCacheHits++;
+
+        // move to the front (most recently used):
+        sclsvrSpTypeCacheLru.splice(sclsvrSpTypeCacheLru.begin(), sclsvrSpTypeCacheLru, iter->second.lruPos);
+
+        info = iter->second.info;
+
+        mcsMutexUnlock(&sclsvrSpTypeCacheMutex);
+        return;
+    }
+    sclsvrSpTypeCacheMisses++;
+
+    mcsMutexUnlock(&sclsvrSpTypeCacheMutex);
+
+    // decode outside the lock (concurrent misses on the same spectral type give the same result):
+    sclsvrSpTypeDecode(spType, info);
+
+    mcsMutexLock(&sclsvrSpTypeCacheMutex);
+
+    if (sclsvrSpTypeCacheMap.find(key) == sclsvrSpTypeCacheMap.end())
+    {
+        // evict least recently used entries:
+        while (sclsvrSpTypeCacheMap.size() >= sclsvrSPECTRAL_TYPE_CACHE_MAX_ENTRIES)
+        {
+            sclsvrSpTypeCacheMap.erase(sclsvrSpTypeCacheLru.back());
+            sclsvrSpTypeCacheLru.pop_back();
+            sclsvrSpTypeCacheEvictions++;
+        }
+
+        sclsvrSpTypeCacheLru.push_front(key);
+
+        sclsvrSPECTRAL_TYPE_ENTRY &entry = sclsvrSpTypeCacheMap[key];
+        entry.info = info;
+        entry.lruPos = sclsvrSpTypeCacheLru.begin();
+    }
+
+    mcsMutexUnlock(&sclsvrSpTypeCacheMutex);
+}
+
+/**
+ * Return the cache statistics
+ *
+ * @param hits number of spectral types served from the cache
+ * @param misses number of decoded spectral types
+ * @param evictions number of evicted entries
+ * @param nbEntries number of cached entries
+ */
+void sclsvrSPECTRAL_TYPE_CACHE::GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions, mcsUINT32 &nbEntries)
+{
+    mcsMutexLock(&sclsvrSpTypeCacheMutex);
+
+    hits = sclsvrSpTypeCacheHits;
+    misses = sclsvrSpTypeCacheMisses;
+    evictions = sclsvrSpTypeCacheEvictions;
+    nbEntries = sclsvrSpTypeCacheMap.size();
+
+    mcsMutexUnlock(&sclsvrSpTypeCacheMutex);
+}
+
+/**
+ * Free all cached entries (statistics are kept)
+ */
+void sclsvrSPECTRAL_TYPE_CACHE::Clear(void)
+{
+    mcsMutexLock(&sclsvrSpTypeCacheMutex);
+
+    sclsvrSpTypeCacheMap.clear();
+    sclsvrSpTypeCacheLru.clear();
+
+    mcsMutexUnlock(&sclsvrSpTypeCacheMutex);
+}
+
+
+/*___oOo___*/
@@ -208,9 +208,6 @@ int main(int argc, char *argv[])
         logInit();
         errInit();
 
-        // initialize alx module (preload tables):
-        alxInit();
-
         // initialize sclsvr module but do not preload JSDC:
         sclsvrInit(false);
 
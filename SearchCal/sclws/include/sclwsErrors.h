@@ -21,3 +21,5 @@
 #define sclwsERR_STL_MUTEX 9   /**<  Could not use mutex that prevents concurrent access to STL shared objects */
 #define sclwsERR_UUID_MUTEX 10   /**<  Could not use mutex that prevents concurrent access to UUID generate function */
 #define sclwsERR_GETCAL_WORKING 11   /**<  GetCal Query already in progress */
+#define sclwsERR_QUERY_CANCELLED 12   /**<  Query cancelled */
+#define sclwsERR_SERVER_BUSY 13   /**<  Server busy (%80s queue full): please retry later */
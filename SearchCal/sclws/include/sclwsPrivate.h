@@ -12,6 +12,63 @@
 /* Server port number configuration */
 #define SCLWS_PORTNUMBER_ENVVAR_NAME "SCLWS_PORT_NB"
 
+/* GetCal result cache size (MB) configuration */
+#define SCLWS_CACHE_SIZE_ENVVAR_NAME "SCLWS_CACHE_SIZE_MB"
+
+/* Number of request workers configuration */
+#define SCLWS_WORKERS_ENVVAR_NAME "SCLWS_WORKERS"
+
+/* Number of search (GetCal) workers configuration */
+#define SCLWS_SEARCH_WORKERS_ENVVAR_NAME "SCLWS_SEARCH_WORKERS"
+
+/* Maximum number of pending requests per lane configuration */
+#define SCLWS_QUEUE_SIZE_ENVVAR_NAME "SCLWS_QUEUE_SIZE"
+
+/* Number of search workers reserved to interactive GetCal searches configuration */
+#define SCLWS_INTERACTIVE_WORKERS_ENVVAR_NAME "SCLWS_INTERACTIVE_WORKERS"
+
+/* Streamed responses (GetCal / GetStar results) configuration */
+#define SCLWS_STREAM_ENVVAR_NAME "SCLWS_STREAM"
+
+/** Request lanes */
+typedef enum
+{
+    sclwsLANE_REQUEST = 0,  /** reads requests and serves cheap requests (GetStar, status ...) */
+    sclwsLANE_SEARCH,       /** serves GetCal searches */
+    sclwsNB_LANES
+} sclwsLANE_ID;
+
+/**
+ * Statistics of one request lane
+ */
+typedef struct
+{
+    const char* name;               /**< lane name */
+    mcsUINT32   nbWorkers;          /**< number of workers */
+    mcsUINT32   nbReserved;         /**< number of workers reserved to interactive requests */
+    mcsUINT32   nbBusy;             /**< number of busy workers */
+    mcsUINT32   depth;              /**< number of pending requests */
+    mcsUINT32   maxDepth;           /**< max number of pending requests */
+    mcsUINT32   capacity;           /**< maximum number of pending requests */
+    mcsUINT64   nbQueued;           /**< number of queued requests */
+    mcsUINT64   nbRejected;         /**< number of rejected requests (queue full) */
+    mcsDOUBLE   waitTime;           /**< total wait time in queue (ms) */
+    mcsDOUBLE   maxWaitTime;        /**< max wait time in queue (ms) */
+} sclwsLANE_STATS;
+
+/**
+ * Request latency statistics of one priority class (GetCal searches and GetStar)
+ */
+typedef struct
+{
+    const char* name;               /**< priority class name */
+    mcsUINT64   nbRequests;         /**< number of served requests */
+    mcsDOUBLE   meanTime;           /**< mean latency (ms) */
+    mcsDOUBLE   p50Time;            /**< median latency (ms) */
+    mcsDOUBLE   p99Time;            /**< 99th percentile latency (ms) */
+    mcsDOUBLE   maxTime;            /**< max latency (ms) */
+} sclwsPRIORITY_STATS;
+
 /* Retrieve current server port */
 mcsUINT16 sclwsGetServerPortNumber(void);
 
@@ -32,6 +89,16 @@ mcsSTRING32* sclwsGetServerStart();
  */
 void sclwsThreadStats(mcsUINT32 *threadCreated, mcsUINT32 *threadJoined);
 
+/**
+ * Get request lane statistics
+ */
+mcsCOMPL_STAT sclwsLaneStats(const mcsUINT32 index, sclwsLANE_STATS *stats);
+
+/**
+ * Get request latency statistics of one priority class
+ */
+mcsCOMPL_STAT sclwsPriorityStats(const mcsUINT32 index, sclwsPRIORITY_STATS *stats);
+
 /**
  * GetCal statistics
  */
@@ -42,6 +109,22 @@ void sclwsGetCalStats(mcsUINT32 *serverCreated, mcsUINT32 *serverDeleted, mcsUIN
  */
 void sclwsGetStarStats(mcsUINT32 *serverCreated, mcsUINT32 *serverDeleted, mcsUINT32 *serverFailed);
 
+/**
+ * GetCal session statistics
+ */
+void sclwsSessionStats(mcsUINT32 *nbOpen, mcsUINT32 *nbCompleted);
+
+/**
+ * Coalescing statistics
+ */
+void sclwsCoalescingStats(mcsUINT32 *getCalCoalesced, mcsUINT32 *getStarCoalesced);
+
+/**
+ * GetCal result cache statistics
+ */
+void sclwsResultCacheStats(mcsUINT32 *nbEntries, mcsUINT64 *size, mcsUINT64 *maxSize,
+                           mcsUINT64 *hits, mcsUINT64 *misses, mcsUINT64 *evictions);
+
 /*
  * Constants definition
  */
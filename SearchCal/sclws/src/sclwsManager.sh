@@ -19,7 +19,7 @@ if [ "`uname`" = "Linux" ]; then enable -n echo; fi
 # SearchCal WebService Server Service management script.
 # 
 # @synopsis
-# sclwsInit {start|stop|status|restart}
+# sclwsInit {start|stop|status|restart|reload}
 #
 # @details
 # This script is used by the init system. You need to copy it under /etc/init.d
@@ -123,6 +123,12 @@ case "$1" in
     $0 start
     ;;
 
+  reload)
+    # reload the JSDC data in background (see GetServerStatus)
+    _log "Reloading JSDC data of $prog :"
+    kill -HUP $(cat "${PID_FILE}")
+    ;;
+
   verify)
     if curl localhost:${processSoapPort} 2>/dev/null |grep "method not implemented" &> /dev/null 
     then 
@@ -135,7 +141,7 @@ case "$1" in
     ;;
 
   *)
-    _log "Usage: %s {start|stop|status|restart|verify}\n" "$prog"
+    _log "Usage: %s {start|stop|status|restart|reload|verify}\n" "$prog"
     exit 1
 esac
 
@@ -17,6 +17,15 @@
  *
  * \env
  * \envvar SCLWS_PORT_NB : socket port number the server should bind on (must be greater than 1024, less than 65536).
+ * \envvar SCLWS_WORKERS : number of workers serving requests (8 by default).
+ * \envvar SCLWS_SEARCH_WORKERS : number of workers running GetCal searches (4 by default).
+ * \envvar SCLWS_QUEUE_SIZE : maximum number of pending requests per lane (64 by default).
+ * \envvar SCLWS_INTERACTIVE_WORKERS : number of search workers reserved to interactive GetCal searches (1 by default).
+ * \envvar SCLWS_STREAM : 0 to disable streamed GetCal / GetStar responses (enabled by default).
+ *
+ * \b Signals: \n
+ * \li SIGHUP reloads the JSDC data in background (see GetServerStatus);
+ * \li SIGTERM stops the server.
  */
 
 /*
@@ -24,9 +33,11 @@
  */
 #include <stdlib.h>
 #include <iostream>
+#include <deque>
 #include <signal.h>
 #include <time.h>
 #include <malloc.h>
+#include <math.h>
 #include <execinfo.h>
 #include <unistd.h>
 
@@ -136,17 +147,27 @@ if (signal(num, sh) == SIG_ERR)                      \
 /** upper thread id before restarting to MIN_THREAD_ID */
 #define MAX_THREAD_ID 999
 
+/** default number of workers of the request lane */
+#define POOL_DEFAULT_WORKERS 8
+
+/** default number of workers of the search lane */
+#define POOL_DEFAULT_SEARCH_WORKERS 4
+
+/** default maximum number of pending requests per lane */
+#define POOL_DEFAULT_QUEUE_SIZE 64
+
+/** default number of search workers reserved to interactive searches */
+#define POOL_DEFAULT_INTERACTIVE_WORKERS 1
+
+/** number of latency histogram bins (4 per octave from 1 ms to 2^24 ms) */
+#define LATENCY_BINS 97
+
 /**
  * Shared mutex to circumvent un thread safe STL
  */
 static thrdMUTEX sclwsThreadStlMutex = MCS_MUTEX_STATIC_INITIALIZER;
 /**
- * Used to store each inactive threads
- * to ensure proper thread end using pthread_join
- */
-static std::list<pthread_t> sclwsInactiveThreadList;
-/**
- * Used to store each created threads
+ * Used to store each created worker threads
  * to ensure proper thread end using pthread_join
  */
 static std::list<pthread_t> sclwsActiveThreadList;
@@ -176,9 +197,74 @@ static mcsUINT32 sclwsThreadJoined  = 0;
 /** flag to avoid reentrant shutdown hook */
 static mcsLOGICAL sclwsShutdown = mcsFALSE;
 
+/** flag set by SIGHUP to reload the JSDC data (GC thread) */
+static volatile sig_atomic_t sclwsReloadJSDC = 0;
+
 /** thread creation counter */
 static mcsSTRING32 sclwsServerStart;
 
+/** pending request (forked soap context) */
+typedef struct
+{
+    struct soap* soapContext; /** forked soap context */
+    mcsINT64     acceptedAt;  /** connection time (us) */
+    mcsINT64     queuedAt;    /** enqueue time (us) */
+    thrdPRIORITY priority;    /** priority class */
+    char*        jobId;       /** GetCal search session (search lane) */
+    char*        query;       /** GetCal search query (search lane) */
+} sclwsJOB;
+
+/**
+ * Request lane: bounded queue of pending requests served by a fixed number of
+ * workers. The request lane reads every request and serves it except GetCal
+ * searches handed over to the search lane, so cheap requests (GetStar, status)
+ * are not starved by long searches.
+ * Pending requests are served by priority (interactive, normal then batch
+ * requests) and some workers are reserved to interactive requests.
+ */
+typedef struct
+{
+    const char*          name;        /** lane name */
+    std::deque<sclwsJOB> queue;       /** pending requests */
+    mcsUINT32            capacity;    /** maximum number of pending requests */
+    mcsUINT32            nbWorkers;   /** number of workers */
+    mcsUINT32            nbReserved;  /** number of workers reserved to interactive requests */
+    mcsUINT32            nbBusy;      /** number of busy workers */
+    pthread_cond_t       cond;        /** signaled when a request is queued or on shutdown */
+    mcsUINT64            nbQueued;    /** number of queued requests */
+    mcsUINT64            nbRejected;  /** number of rejected requests (queue full) */
+    mcsUINT32            maxDepth;    /** max number of pending requests */
+    mcsINT64             waitTime;    /** total wait time in queue (us) */
+    mcsINT64             maxWaitTime; /** max wait time in queue (us) */
+} sclwsLANE;
+
+/** request lanes */
+static sclwsLANE sclwsLanes[sclwsNB_LANES];
+
+/** mutex protecting the request lanes */
+static thrdMUTEX sclwsPoolMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** flag to stop workers */
+static bool sclwsPoolShutdown = false;
+
+/** request latency (connection to response) of one priority class */
+typedef struct
+{
+    mcsUINT64 nbRequests;                 /** number of served requests */
+    mcsINT64  totalTime;                  /** total latency (us) */
+    mcsINT64  maxTime;                    /** max latency (us) */
+    mcsUINT64 histogram[LATENCY_BINS];    /** latency histogram (see sclwsGetLatencyBin) */
+} sclwsLATENCY;
+
+/** request latencies per priority class (protected by sclwsPoolMutex) */
+static sclwsLATENCY sclwsLatencies[thrdNB_PRIORITIES];
+
+
+/*
+ * Local functions declaration
+ */
+void sclwsExit(int returnCode);
+
 /*
  * Local Functions
  */
@@ -323,6 +409,35 @@ void sclwsStats()
     sclwsThreadStats(&threadCreated, &threadJoined);
     logInfo("Thread  Statistics: %d created / %d terminated.", threadCreated, threadJoined);
 
+    // Request lane statistics
+    sclwsLANE_STATS laneStats;
+    for (mcsUINT32 i = 0; sclwsLaneStats(i, &laneStats) == mcsSUCCESS; i++)
+    {
+        logInfo("Lane[%s]: %u workers (%u reserved, %u busy) / queue %u (max %u) / %lu queued / %lu rejected / wait %.1lf ms max.",
+                laneStats.name, laneStats.nbWorkers, laneStats.nbReserved, laneStats.nbBusy, laneStats.depth, laneStats.maxDepth,
+                laneStats.nbQueued, laneStats.nbRejected, laneStats.maxWaitTime);
+    }
+
+    // Request latency statistics (per priority class)
+    sclwsPRIORITY_STATS priorityStats;
+    for (mcsUINT32 i = 0; sclwsPriorityStats(i, &priorityStats) == mcsSUCCESS; i++)
+    {
+        logInfo("Priority[%s]: %lu requests / latency %.1lf ms mean, %.1lf ms p50, %.1lf ms p99, %.1lf ms max.",
+                priorityStats.name, priorityStats.nbRequests, priorityStats.meanTime,
+                priorityStats.p50Time, priorityStats.p99Time, priorityStats.maxTime);
+    }
+
+    // Priority gate statistics (CDS queries, gdome, Complete phases)
+    thrdPRIORITY_GATE_STATS gateStats;
+    for (mcsUINT32 i = 0; thrdPriorityGateGetStats(i, &gateStats) == mcsSUCCESS; i++)
+    {
+        logInfo("Gate[%s]: %u slots (%u reserved, %u used) / waits: %lu interactive (%.1lf ms max), %lu normal (%.1lf ms max), %lu batch (%.1lf ms max).",
+                gateStats.name, gateStats.nbSlots, gateStats.nbReserved, gateStats.nbUsed,
+                gateStats.nbWaits[thrdPRIORITY_INTERACTIVE], gateStats.maxWaitTime[thrdPRIORITY_INTERACTIVE],
+                gateStats.nbWaits[thrdPRIORITY_NORMAL], gateStats.maxWaitTime[thrdPRIORITY_NORMAL],
+                gateStats.nbWaits[thrdPRIORITY_BATCH], gateStats.maxWaitTime[thrdPRIORITY_BATCH]);
+    }
+
     // GetCal statistics
     serverCreated = serverDeleted = serverCancelled = serverFailed = 0;
     sclwsGetCalStats(&serverCreated, &serverDeleted, &serverCancelled, &serverFailed);
@@ -462,11 +577,377 @@ void sclwsInitSoapThread(const pthread_t threadId, char* threadName)
 }
 
 /**
- * Main SOAP handler used by new pthread
- * @param soapContextPtr soap context
+ * Return the monotonic time (us).
+ * @return monotonic time (us)
+ */
+static mcsINT64 sclwsGetTime(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((mcsINT64) time.tv_sec) * 1000000LL + time.tv_nsec / 1000;
+}
+
+/**
+ * Return the value of the given environment variable (or its default value)
+ * @param envVarName environment variable name
+ * @param defaultValue default value (if undefined or less than the minimum value)
+ * @param minValue minimum value
+ * @return value
+ */
+static mcsUINT32 sclwsGetPoolConfig(const char* envVarName, const mcsINT32 defaultValue, const mcsINT32 minValue = 1)
+{
+    mcsINT32 value = defaultValue;
+
+    if ((miscGetEnvVarIntValue(envVarName, &value) == mcsFAILURE) || (value < minValue))
+    {
+        errResetStack();
+        value = defaultValue;
+    }
+    return value;
+}
+
+/**
+ * Free the given forked soap context (and close its socket)
+ * @param soapContext forked soap context
+ */
+static void sclwsFreeSoapContext(struct soap* soapContext)
+{
+    soap_destroy(soapContext); // Dealloc C++ data
+    soap_end(soapContext);     // Dealloc data and cleanup
+    soap_done(soapContext);    // Detach soap struct
+
+    free(soapContext);
+}
+
+/**
+ * Answer a SOAP fault to a rejected request (server busy)
+ * @param soapContext forked soap context
+ * @param laneName name of the full lane
+ */
+static void sclwsRejectRequest(struct soap* soapContext, const char* laneName)
+{
+    logWarning("Request rejected: %s queue is full.", laneName);
+
+    errAdd(sclwsERR_SERVER_BUSY, laneName);
+    sclwsDefineSoapError(soapContext);
+    soap_send_fault(soapContext);
+}
+
+/**
+ * Queue the given request in the given lane (backpressure: rejected if its queue is full)
+ * @param laneId lane identifier
+ * @param job request (forked soap context)
+ * @return true if queued; false if rejected
+ */
+static bool sclwsPoolSubmit(const sclwsLANE_ID laneId, sclwsJOB &job)
+{
+    sclwsLANE* lane = &sclwsLanes[laneId];
+    bool queued = false;
+
+    thrdMutexLock(&sclwsPoolMutex);
+
+    if (sclwsPoolShutdown || (lane->queue.size() >= lane->capacity))
+    {
+        lane->nbRejected++;
+    }
+    else
+    {
+        job.queuedAt = sclwsGetTime();
+
+        lane->queue.push_back(job);
+        lane->nbQueued++;
+
+        if (lane->queue.size() > lane->maxDepth)
+        {
+            lane->maxDepth = lane->queue.size();
+        }
+
+        pthread_cond_signal(&lane->cond);
+        queued = true;
+    }
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+
+    return queued;
+}
+
+/**
+ * Return the position of the next request to serve in the given lane: the
+ * oldest request of the highest priority class if a worker may serve it
+ * (workers reserved to interactive requests); lower classes never overtake it
+ * (pool mutex locked).
+ * @param lane request lane
+ * @return request position or -1 if none
+ */
+static mcsINT32 sclwsPoolNext(const sclwsLANE* lane)
+{
+    mcsINT32 next = -1;
+
+    for (mcsUINT32 i = 0; i < lane->queue.size(); i++)
+    {
+        if ((next == -1) || (lane->queue[i].priority < lane->queue[next].priority))
+        {
+            next = i;
+        }
+    }
+
+    if ((next != -1) && (lane->queue[next].priority != thrdPRIORITY_INTERACTIVE)
+            && (lane->nbBusy + lane->nbReserved >= lane->nbWorkers))
+    {
+        // only reserved workers are idle:
+        next = -1;
+    }
+    return next;
+}
+
+/**
+ * Wait for the next request of the given lane (by priority)
+ * @param lane request lane
+ * @param job next request
+ * @return true if a request was taken; false on shutdown
+ */
+static bool sclwsPoolTake(sclwsLANE* lane, sclwsJOB &job)
+{
+    mcsINT32 next = -1;
+
+    thrdMutexLock(&sclwsPoolMutex);
+
+    while (!sclwsPoolShutdown && ((next = sclwsPoolNext(lane)) == -1))
+    {
+        pthread_cond_wait(&lane->cond, &sclwsPoolMutex);
+    }
+
+    if (!sclwsPoolShutdown)
+    {
+        job = lane->queue[next];
+        lane->queue.erase(lane->queue.begin() + next);
+
+        const mcsINT64 waitTime = sclwsGetTime() - job.queuedAt;
+        lane->waitTime += waitTime;
+
+        if (waitTime > lane->maxWaitTime)
+        {
+            lane->maxWaitTime = waitTime;
+        }
+        lane->nbBusy++;
+    }
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+
+    return !sclwsPoolShutdown;
+}
+
+/**
+ * Return the latency histogram bin of the given latency (4 bins per octave):
+ * bin 0 is [0, 1 ms[ and bin b is [2^((b - 1) / 4), 2^(b / 4)[ ms
+ * @param latency latency (us)
+ * @return histogram bin
+ */
+static mcsUINT32 sclwsGetLatencyBin(const mcsINT64 latency)
+{
+    if (latency < 1000)
+    {
+        return 0;
+    }
+    const mcsUINT32 bin = 1 + (mcsUINT32) (4.0 * log2(1e-3 * latency));
+
+    return (bin < LATENCY_BINS) ? bin : LATENCY_BINS - 1;
+}
+
+/**
+ * Release the worker of the given lane (request served) and record the
+ * latency of the given request in its priority class
+ * @param lane request lane
+ * @param job served request
+ * @param record true to record the request latency
+ */
+static void sclwsPoolRelease(sclwsLANE* lane, const sclwsJOB &job, const bool record)
+{
+    const mcsINT64 latency = sclwsGetTime() - job.acceptedAt;
+
+    thrdMutexLock(&sclwsPoolMutex);
+
+    lane->nbBusy--;
+
+    // a pending request may wait for a non-reserved worker:
+    if (!lane->queue.empty())
+    {
+        pthread_cond_signal(&lane->cond);
+    }
+
+    if (record)
+    {
+        sclwsLATENCY* stats = &sclwsLatencies[job.priority];
+
+        stats->nbRequests++;
+        stats->totalTime += latency;
+
+        if (latency > stats->maxTime)
+        {
+            stats->maxTime = latency;
+        }
+        stats->histogram[sclwsGetLatencyBin(latency)]++;
+    }
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+}
+
+/**
+ * Return the priority class of the given GetCal search query (see
+ * sclsvrSERVER::GetPriority)
+ * @param query GetCal query
+ * @return priority class (normal if the query is invalid)
+ */
+static thrdPRIORITY sclwsGetSearchPriority(const char* query)
+{
+    sclsvrREQUEST request;
+
+    if (IS_NULL(query) || (request.Parse(query) == mcsFAILURE))
+    {
+        // invalid query: let the server report the error
+        errResetStack();
+        return thrdPRIORITY_NORMAL;
+    }
+    return sclsvrSERVER::GetPriority(request);
+}
+
+/**
+ * Serve the given GetCal search already read by the request lane.
+ * Same sequence as soap_serve_ns__GetCalSearchCal() after reading the request.
+ * @param soapContext forked soap context
+ * @param jobId GetCal session
+ * @param query GetCal query
+ * @return SOAP error code
+ */
+static int sclwsServeGetCalSearchCal(struct soap* soapContext, char* jobId, char* query)
+{
+    struct ns__GetCalSearchCalResponse response;
+    char* voTable = NULL;
+
+    soap_default_ns__GetCalSearchCalResponse(soapContext, &response);
+    response._param_4 = &voTable;
+
+    soapContext->error = ns__GetCalSearchCal(soapContext, jobId, query, &voTable);
+    if (soapContext->error)
+    {
+        return soapContext->error;
+    }
+    soap_serializeheader(soapContext);
+    soap_serialize_ns__GetCalSearchCalResponse(soapContext, &response);
+    if (soap_begin_count(soapContext))
+    {
+        return soapContext->error;
+    }
+    if (soapContext->mode & SOAP_IO_LENGTH)
+    {
+        if (soap_envelope_begin_out(soapContext)
+                || soap_putheader(soapContext)
+                || soap_body_begin_out(soapContext)
+                || soap_put_ns__GetCalSearchCalResponse(soapContext, &response, "ns:GetCalSearchCalResponse", "")
+                || soap_body_end_out(soapContext)
+                || soap_envelope_end_out(soapContext))
+        {
+            return soapContext->error;
+        }
+    }
+    if (soap_end_count(soapContext)
+            || soap_response(soapContext, SOAP_OK)
+            || soap_envelope_begin_out(soapContext)
+            || soap_putheader(soapContext)
+            || soap_body_begin_out(soapContext)
+            || soap_put_ns__GetCalSearchCalResponse(soapContext, &response, "ns:GetCalSearchCalResponse", "")
+            || soap_body_end_out(soapContext)
+            || soap_envelope_end_out(soapContext)
+            || soap_end_send(soapContext))
+    {
+        return soapContext->error;
+    }
+    return soap_closesock(soapContext);
+}
+
+/**
+ * Read the given request and serve it (request lane) or hand it over to the
+ * search lane (GetCal search classified by priority).
+ * Equivalent to soap_serve() without keep-alive.
+ * @param job request (forked soap context)
+ * @param record set to true if the request latency must be recorded (GetStar)
+ * @return true if the soap context must be freed
+ */
+static bool sclwsServeRequest(sclwsJOB &job, bool &record)
+{
+    struct soap* soapContext = job.soapContext;
+
+    soap_begin(soapContext);
+
+    if (soap_begin_recv(soapContext))
+    {
+        if (soapContext->error < SOAP_STOP)
+        {
+            soap_send_fault(soapContext);
+        }
+        return true;
+    }
+
+    if (soap_envelope_begin_in(soapContext)
+            || soap_recv_header(soapContext)
+            || soap_body_begin_in(soapContext))
+    {
+        soap_send_fault(soapContext);
+        return true;
+    }
+
+    // Get the operation:
+    soap_peek_element(soapContext);
+
+    if (!soap_match_tag(soapContext, soapContext->tag, "ns:GetCalSearchCal"))
+    {
+        // Read the GetCal search to get its priority before queuing it:
+        struct ns__GetCalSearchCal search;
+        soap_default_ns__GetCalSearchCal(soapContext, &search);
+        soapContext->encodingStyle = NULL;
+
+        if (!soap_get_ns__GetCalSearchCal(soapContext, &search, "ns:GetCalSearchCal", NULL)
+                || soap_body_end_in(soapContext)
+                || soap_envelope_end_in(soapContext)
+                || soap_end_recv(soapContext))
+        {
+            soap_send_fault(soapContext);
+            return true;
+        }
+
+        // parameters allocated in the soap context:
+        job.jobId    = search._param_2;
+        job.query    = search._param_3;
+        job.priority = sclwsGetSearchPriority(job.query);
+
+        if (sclwsPoolSubmit(sclwsLANE_SEARCH, job))
+        {
+            // given to the search lane:
+            return false;
+        }
+        sclwsRejectRequest(soapContext, sclwsLanes[sclwsLANE_SEARCH].name);
+        return true;
+    }
+
+    // GetStar priority is defined by the server (one or several stars):
+    record = !soap_match_tag(soapContext, soapContext->tag, "ns:GetStar");
+
+    // Fulfill the received remote call
+    if ((soap_serve_request(soapContext)
+            || (soapContext->fserveloop && soapContext->fserveloop(soapContext)))
+            && (soapContext->error != SOAP_STOP)) // streamed response already sent
+    {
+        soap_send_fault(soapContext);
+    }
+    return true;
+}
+
+/**
+ * Main SOAP handler used by worker pthreads
+ * @param laneIdPtr lane identifier
  * @return null
  */
-void* sclwsJobHandler(void* soapContextPtr)
+void* sclwsWorkerHandler(void* laneIdPtr)
 {
     // Use block to ensure C++ frees local variables before calling pthread_exit()
     {
@@ -475,44 +956,55 @@ void* sclwsJobHandler(void* soapContextPtr)
         sigfillset(& my_set);
         pthread_sigmask(SIG_SETMASK, &my_set, NULL);
 
-        const pthread_t threadId = pthread_self();
-
         mcsSTRING32 threadName;
-        sclwsInitSoapThread(threadId, threadName);
-
-        logDebug("adding Thread to activeThreadList : %s", threadName);
-
-        STL_LOCK(NULL);
+        sclwsInitSoapThread(pthread_self(), threadName);
 
-        sclwsThreadCreated++;
-        sclwsActiveThreadList.push_back(threadId);
+        sclwsLANE* lane = &sclwsLanes[(sclwsLANE_ID) (long) laneIdPtr];
 
-        STL_UNLOCK(NULL);
+        logDebug("worker started: %s (%s lane)", threadName, lane->name);
 
-        struct soap* soapContext = (struct soap*) soapContextPtr;
+        sclwsJOB job;
 
-        // Fulfill the received remote call
-        soap_serve(soapContext);
+        while (sclwsPoolTake(lane, job))
+        {
+            // request-scoped arena (stars, properties, star lists and crossmatch maps):
+            vobsARENA_SCOPE arenaScope;
 
-        soap_destroy(soapContext); // Dealloc C++ data
-        soap_end(soapContext);     // Dealloc data and cleanup
-        soap_done(soapContext);    // Detach soap struct
+            struct soap* soapContext = job.soapContext;
+            bool doFree = true;
+            bool record = false;
 
-        free(soapContext);
+            // Define the priority of the request served by this thread (CDS queries and Complete phases):
+            thrdPrioritySet(job.priority);
 
-        logDebug("moving Thread to inactiveThreadList : %s", threadName);
+            if (lane == &sclwsLanes[sclwsLANE_REQUEST])
+            {
+                doFree = sclwsServeRequest(job, record);
 
-        STL_LOCK(NULL);
+                // priority given by the server:
+                job.priority = thrdPriorityGet();
+            }
+            else
+            {
+                // Fulfill the GetCal search (already read)
+                if ((sclwsServeGetCalSearchCal(soapContext, job.jobId, job.query)
+                        || (soapContext->fserveloop && soapContext->fserveloop(soapContext)))
+                        && (soapContext->error != SOAP_STOP)) // streamed response already sent
+                {
+                    soap_send_fault(soapContext);
+                }
+                record = true;
+            }
 
-        sclwsActiveThreadList.remove(threadId);
+            if (doFree)
+            {
+                sclwsFreeSoapContext(soapContext);
+            }
 
-        /*
-         * Putting this pthread in sclwsInactiveThreadList
-         * to let GCThread terminates it (using pthread_join)
-         */
-        sclwsInactiveThreadList.push_back(threadId);
+            sclwsPoolRelease(lane, job, record);
+        }
 
-        STL_UNLOCK(NULL);
+        logDebug("worker stopped: %s", threadName);
     }
 
     pthread_exit(NULL);
@@ -520,6 +1012,172 @@ void* sclwsJobHandler(void* soapContextPtr)
     return NULL;
 }
 
+/**
+ * Create the request lanes and their workers
+ */
+static void sclwsPoolInit(void)
+{
+    const mcsUINT32 queueSize = sclwsGetPoolConfig(SCLWS_QUEUE_SIZE_ENVVAR_NAME, POOL_DEFAULT_QUEUE_SIZE);
+
+    sclwsLanes[sclwsLANE_REQUEST].name      = "request";
+    sclwsLanes[sclwsLANE_REQUEST].nbWorkers = sclwsGetPoolConfig(SCLWS_WORKERS_ENVVAR_NAME, POOL_DEFAULT_WORKERS);
+    sclwsLanes[sclwsLANE_SEARCH].name       = "search";
+    sclwsLanes[sclwsLANE_SEARCH].nbWorkers  = sclwsGetPoolConfig(SCLWS_SEARCH_WORKERS_ENVVAR_NAME, POOL_DEFAULT_SEARCH_WORKERS);
+
+    // at least one search worker for normal and batch searches:
+    const mcsUINT32 nbReserved = sclwsGetPoolConfig(SCLWS_INTERACTIVE_WORKERS_ENVVAR_NAME, POOL_DEFAULT_INTERACTIVE_WORKERS, 0);
+
+    sclwsLanes[sclwsLANE_REQUEST].nbReserved = 0;
+    sclwsLanes[sclwsLANE_SEARCH].nbReserved  = (nbReserved < sclwsLanes[sclwsLANE_SEARCH].nbWorkers) ?
+            nbReserved : sclwsLanes[sclwsLANE_SEARCH].nbWorkers - 1;
+
+    for (mcsUINT32 laneId = 0; laneId < sclwsNB_LANES; laneId++)
+    {
+        sclwsLANE* lane = &sclwsLanes[laneId];
+
+        lane->capacity    = queueSize;
+        lane->nbBusy      = 0;
+        lane->nbQueued    = 0;
+        lane->nbRejected  = 0;
+        lane->maxDepth    = 0;
+        lane->waitTime    = 0;
+        lane->maxWaitTime = 0;
+        pthread_cond_init(&lane->cond, NULL);
+
+        for (mcsUINT32 i = 0; i < lane->nbWorkers; i++)
+        {
+            pthread_t threadId;
+            if (pthread_create(&threadId, NULL, (void*(*)(void*) )sclwsWorkerHandler, (void*) (long) laneId) != 0)
+            {
+                // Error handling
+                errAdd(sclwsERR_THREAD_CREATION);
+                errCloseStack();
+                sclwsExit(EXIT_FAILURE);
+            }
+
+            thrdMutexLock(&sclwsThreadStlMutex);
+
+            sclwsThreadCreated++;
+            sclwsActiveThreadList.push_back(threadId);
+
+            thrdMutexUnlock(&sclwsThreadStlMutex);
+        }
+
+        logInfo("Request lane '%s': %u workers (%u reserved to interactive requests) / %u pending requests max.",
+                lane->name, lane->nbWorkers, lane->nbReserved, lane->capacity);
+    }
+
+    // warm-up server instances (one per worker at most):
+    sclsvrSERVER_POOL::Init(sclwsLanes[sclwsLANE_REQUEST].nbWorkers + sclwsLanes[sclwsLANE_SEARCH].nbWorkers);
+}
+
+/**
+ * Stop the workers (after their current request) and free pending requests
+ */
+static void sclwsPoolExit(void)
+{
+    thrdMutexLock(&sclwsPoolMutex);
+
+    sclwsPoolShutdown = true;
+
+    for (mcsUINT32 laneId = 0; laneId < sclwsNB_LANES; laneId++)
+    {
+        pthread_cond_broadcast(&sclwsLanes[laneId].cond);
+    }
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+
+    // wait for workers without cancellation:
+    bool doCancelActiveThreads = false;
+
+    sclwsJoinThreads("activeThreadList", sclwsActiveThreadList, doCancelActiveThreads);
+
+    // Now, no more worker is running: close pending requests
+    for (mcsUINT32 laneId = 0; laneId < sclwsNB_LANES; laneId++)
+    {
+        sclwsLANE* lane = &sclwsLanes[laneId];
+
+        while (!lane->queue.empty())
+        {
+            sclwsFreeSoapContext(lane->queue.front().soapContext);
+            lane->queue.pop_front();
+        }
+    }
+}
+
+/**
+ * Get the statistics of the given request lane
+ */
+mcsCOMPL_STAT sclwsLaneStats(const mcsUINT32 index, sclwsLANE_STATS *stats)
+{
+    if ((index >= sclwsNB_LANES) || IS_NULL(stats))
+    {
+        return mcsFAILURE;
+    }
+
+    thrdMutexLock(&sclwsPoolMutex);
+
+    const sclwsLANE* lane = &sclwsLanes[index];
+
+    stats->name        = lane->name;
+    stats->nbWorkers   = lane->nbWorkers;
+    stats->nbReserved  = lane->nbReserved;
+    stats->nbBusy      = lane->nbBusy;
+    stats->depth       = lane->queue.size();
+    stats->maxDepth    = lane->maxDepth;
+    stats->capacity    = lane->capacity;
+    stats->nbQueued    = lane->nbQueued;
+    stats->nbRejected  = lane->nbRejected;
+    stats->waitTime    = 1e-3 * lane->waitTime;
+    stats->maxWaitTime = 1e-3 * lane->maxWaitTime;
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Get the request latency statistics of the given priority class
+ */
+mcsCOMPL_STAT sclwsPriorityStats(const mcsUINT32 index, sclwsPRIORITY_STATS *stats)
+{
+    if ((index >= thrdNB_PRIORITIES) || IS_NULL(stats))
+    {
+        return mcsFAILURE;
+    }
+
+    thrdMutexLock(&sclwsPoolMutex);
+
+    const sclwsLATENCY* latency = &sclwsLatencies[index];
+
+    stats->name       = thrdPriorityGetName((thrdPRIORITY) index);
+    stats->nbRequests = latency->nbRequests;
+    stats->meanTime   = (latency->nbRequests != 0) ? 1e-3 * latency->totalTime / latency->nbRequests : 0.0;
+    stats->maxTime    = 1e-3 * latency->maxTime;
+
+    // percentiles given by the upper bound of their histogram bin:
+    const mcsDOUBLE percentiles[2] = {0.50, 0.99};
+    mcsDOUBLE* values[2] = {&stats->p50Time, &stats->p99Time};
+
+    for (mcsUINT32 i = 0; i < 2; i++)
+    {
+        const mcsUINT64 rank = (mcsUINT64) ceil(percentiles[i] * latency->nbRequests);
+        mcsUINT64 count = 0;
+        mcsUINT32 bin = 0;
+
+        while ((bin < LATENCY_BINS - 1) && (count + latency->histogram[bin] < rank))
+        {
+            count += latency->histogram[bin];
+            bin++;
+        }
+        *values[i] = (latency->nbRequests != 0) ? alxMin(pow(2.0, 0.25 * bin), stats->maxTime) : 0.0;
+    }
+
+    thrdMutexUnlock(&sclwsPoolMutex);
+
+    return mcsSUCCESS;
+}
+
 /**
  * Main GC handler used by dedicated pthread
  * @return null
@@ -566,10 +1224,15 @@ void* sclwsGCJobHandler(void* args)
             /* disable cancelation during cleanup */
             pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
 
-            // perform GC:
-            if (sclwsJoinThreads("inactiveThreadList", sclwsInactiveThreadList) == mcsTRUE)
+            // reload the JSDC data in background (SIGHUP):
+            if (sclwsReloadJSDC != 0)
             {
-                result = mcsTRUE;
+                sclwsReloadJSDC = 0;
+
+                if (sclsvrJSDC_DATA::Reload() == mcsFAILURE)
+                {
+                    errCloseStack();
+                }
             }
 
             // perform garbage collection (GC):
@@ -633,11 +1296,8 @@ void sclwsExit(int returnCode)
 
         logInfo("GC Thread terminated.");
 
-        // cleanup all threads (join all created threads) without cancellation :
-        bool doCancelActiveThreads = false;
-
-        sclwsJoinThreads("activeThreadList", sclwsActiveThreadList, doCancelActiveThreads);
-        sclwsJoinThreads("inactiveThreadList", sclwsInactiveThreadList);
+        // stop workers (join all created threads) without cancellation :
+        sclwsPoolExit();
 
         // Now, no more thread is running:
 
@@ -648,6 +1308,9 @@ void sclwsExit(int returnCode)
         // perform GC:
         sclwsFreeServerList(true);
 
+        // free pooled server instances:
+        sclsvrSERVER_POOL::Clear();
+
         // free thread id map:
         sclwsFreeThreadIdMap();
 
@@ -696,9 +1359,6 @@ void sclwsInit()
     /* Initialize the timlog module (hash table) */
     timlogInit();
 
-    // initialize alx module (preload tables):
-    alxInit();
-
     // initialize vobs module (vizier URI):
     vobsGetVizierURI();
 
@@ -773,6 +1433,8 @@ void sclwsSignalHandler(int signum)
             break;
         case SIGTERM: name = "SIGTERM";
             break;
+        case SIGHUP:  name = "SIGHUP";
+            break;
         default:      name = "[undefined]";
     }
 
@@ -786,6 +1448,12 @@ void sclwsSignalHandler(int signum)
         // just ignore such signal
         return;
     }
+    if (signum == SIGHUP)
+    {
+        // reload the JSDC data (GC thread):
+        sclwsReloadJSDC = 1;
+        return;
+    }
     if (signum == SIGTERM)
     {
         // Stop properly the service:
@@ -827,6 +1495,7 @@ int main(int argc, char *argv[])
     addSignalHandler(SIGSEGV, sclwsSignalHandler);
     addSignalHandler(SIGPIPE, sclwsSignalHandler);
     addSignalHandler(SIGTERM, sclwsSignalHandler);
+    addSignalHandler(SIGHUP,  sclwsSignalHandler);
 
     // Initialize MCS services
     if (mcsInit(argv[0]) == mcsFAILURE)
@@ -881,6 +1550,9 @@ int main(int argc, char *argv[])
     /* Initialize the log module (socket ...) */
     logQuiet("Server ready: Listening on port '%d'.", portNumber);
 
+    // Start workers:
+    sclwsPoolInit();
+
     // Infinite loop to receive requests
     for (uint nbOfConnection = 1; ; nbOfConnection++)
     {
@@ -895,15 +1567,24 @@ int main(int argc, char *argv[])
         // Fork the SOAP context
         struct soap* forkedSoapContext = soap_copy(&globalSoapContext);
 
-        // Start a new thread to handle the request
-        pthread_t threadId;
-        int status = pthread_create(&threadId, NULL, (void*(*)(void*) )sclwsJobHandler, (void*) forkedSoapContext);
-        if (status != 0)
+        if (IS_NULL(forkedSoapContext))
+        {
+            soap_closesock(&globalSoapContext);
+            continue; // retry
+        }
+
+        // Queue the request for workers (backpressure: answer a fault if the queue is full)
+        sclwsJOB job;
+        job.soapContext = forkedSoapContext;
+        job.acceptedAt  = sclwsGetTime();
+        job.priority    = thrdPRIORITY_INTERACTIVE; // cheap requests (GetStar, status)
+        job.jobId       = NULL;
+        job.query       = NULL;
+
+        if (!sclwsPoolSubmit(sclwsLANE_REQUEST, job))
         {
-            // Error handling
-            errAdd(sclwsERR_THREAD_CREATION);
-            errCloseStack();
-            sclwsExit(EXIT_FAILURE);
+            sclwsRejectRequest(forkedSoapContext, sclwsLanes[sclwsLANE_REQUEST].name);
+            sclwsFreeSoapContext(forkedSoapContext);
         }
     }
 
@@ -10,10 +10,12 @@
 /*
  * System Headers
  */
+#include <stdio.h>
 #include <iostream>
 #include <sstream>
 using namespace std;
 #include <map>
+#include <vector>
 #include <uuid/uuid.h>
 #include <pthread.h>
 #include <unistd.h>
@@ -87,27 +89,14 @@ using namespace std;
     }                                                   \
 }
 
-/* TODO: create GC_MUTEX error */
-#define GC_LOCK(error) {                                \
-    if (thrdMutexLock(&sclwsGCMutex) == mcsFAILURE)     \
-    {                                                   \
-        errAdd(sclwsERR_STL_MUTEX);                     \
-        return error;                                   \
-    }                                                   \
-}
-
-/* TODO: create GC_MUTEX error */
-#define GC_UNLOCK(error) {                              \
-    if (thrdMutexUnlock(&sclwsGCMutex) == mcsFAILURE)   \
-    {                                                   \
-        errAdd(sclwsERR_STL_MUTEX);                     \
-        return error;                                   \
-    }                                                   \
-}
+/** number of shards of the GetCal session table */
+#define SESSION_SHARDS 16
 
+/** delay (s) to remember completed sessions (pending GetCalStatus queries answer 0) */
+#define SESSION_COMPLETED_DELAY 60
 
-/** minimum delay (ms) before freeing server resources to let pending GetCalStatus queries run whereas GetCalQuery finished */
-#define DELAY_BEFORE_GC 10000
+/** delay (s) before closing sessions opened but never used to run a query */
+#define SESSION_IDLE_DELAY 3600
 
 /*
  * Local Variables
@@ -123,51 +112,178 @@ thrdMUTEX sclwsStlMutex = MCS_MUTEX_STATIC_INITIALIZER;
  */
 thrdMUTEX sclwsUuidMutex = MCS_MUTEX_STATIC_INITIALIZER;
 
-/**
- * Used to store each "Communication ID"-"sclsvSERVER instance" couples
- * to ensure multiple concurrent query handling.
- */
-map<string, sclsvrSERVER*> sclwsServerList;
-/**
- * Used to store each "Communication ID"-"thread ID" couples
- * to ensure proper thread cancellation on ns__GetCalCancel() call.
- */
-multimap<string, pthread_t> sclwsThreadList;
-typedef multimap<string, pthread_t>::iterator sclwsTHREAD_ITERATOR;
-typedef pair<sclwsTHREAD_ITERATOR, sclwsTHREAD_ITERATOR> sclwsTHREAD_RANGE;
+struct sclwsFlight;
 
-/* server information used by GC thread */
-struct sclwsServerInfo
+/*
+ * GetCal sessions: each session owns a (pooled) server instance and is
+ * reference counted: the session table holds one reference while the session
+ * is open and every running call (SearchCal, QueryStatus, Cancel or followed
+ * query execution) holds another one, so the server instance is given back to
+ * the pool by the last call (no delayed garbage collection).
+ */
+struct sclwsSession
 {
-    struct timeval lastUsedTime; /* last used time */
     string jobId;                /* job id */
     sclsvrSERVER* server;        /* server instance */
+    volatile mcsUINT32 refCount; /* number of references (session table + running calls) */
+    volatile mcsUINT32 searching;/* 1 while a GetCal query runs in this session */
+    volatile bool served;        /* true if the query was served without running the session server (coalesced or cached) */
+    time_t openTime;             /* session creation time */
+    /* coalesced query (guarded by sclwsStlMutex) */
+    sclwsFlight* volatile flight;/* query execution followed by the session or NULL */
+    bool cancelled;              /* true if the session was cancelled while waiting */
+    mcsUINT32 nbUpdates;         /* number of status updates seen by the session (status cursor) */
 } ;
 
-/**
- * Shared mutex to circumvent un thread safe STL
+/*
+ * Session table shard: open sessions keyed by job id and completed sessions
+ * (completion time) so that late GetCalStatus queries answer 0.
  */
-thrdMUTEX sclwsGCMutex = MCS_MUTEX_STATIC_INITIALIZER;
+struct sclwsSessionShard
+{
+    thrdMUTEX mutex;
+    map<string, sclwsSession*> sessions;
+    map<string, time_t> completed;
 
-/**
- * Used to store each inactive server instance to free
- */
-static std::list<sclwsServerInfo*> sclwsGCServerInfoList;
+    sclwsSessionShard()
+    {
+        thrdMutexInit(&mutex);
+    }
+} ;
+
+/** session table (sharded by job id to spread lock contention) */
+static sclwsSessionShard sclwsSessionTable[SESSION_SHARDS];
 
 /* server statistics */
 struct sclwsServerStats
 {
-    mcsUINT32 created;
-    mcsUINT32 deleted;
-    mcsUINT32 cancelled;
-    mcsUINT32 failed;
+    volatile mcsUINT32 created;
+    volatile mcsUINT32 deleted;
+    volatile mcsUINT32 cancelled;
+    volatile mcsUINT32 failed;
+    mcsUINT32 coalesced;
 } ;
 
 /** thread creation counter */
-static sclwsServerStats sclwsServerStatsGetCal = { 0, 0, 0, 0 };
+static sclwsServerStats sclwsServerStatsGetCal = { 0, 0, 0, 0, 0 };
 
 /** thread termination counter */
-static sclwsServerStats sclwsServerStatsGetStar = { 0, 0, 0, 0 };
+static sclwsServerStats sclwsServerStatsGetStar = { 0, 0, 0, 0, 0 };
+
+/*
+ * Request coalescing (single flight): identical concurrent GetCal / GetStar
+ * queries (same canonical request) are executed once by the first session
+ * (leader); other sessions (followers) wait for its result and follow its
+ * progress. All following structures are guarded by sclwsStlMutex.
+ */
+
+/* query execution shared by identical concurrent queries */
+struct sclwsFlight
+{
+    string key;                  /* canonical query */
+    sclwsSession* leader;        /* leader session (NULL for GetStar) */
+    sclsvrSERVER* server;        /* server instance executing the query */
+    mcsUINT32 nbWaiters;         /* number of sessions waiting for the result (leader included) */
+    mcsUINT32 nbCancelled;       /* number of cancelled waiting sessions */
+    bool done;                   /* true when the query is completed */
+    bool failed;                 /* true if the query failed */
+    string result;               /* serialized result (VOTable) */
+    string error;                /* error message (failure) */
+} ;
+
+/** query executions in progress keyed by canonical query */
+static map<string, sclwsFlight*> sclwsFlightList;
+
+/** condition signaled when a query execution completes or a session is cancelled */
+static pthread_cond_t sclwsFlightCond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * maximum delay (s) to wait for a status update of a running query: status
+ * requests are served by the request lane workers so they must not wait long
+ */
+#define STATUS_TIMEOUT 5
+
+/*
+ * GetCal result cache: serialized VOTable of completed GetCal queries keyed by
+ * server version and canonical query, evicted in LRU order beyond the memory cap
+ * and expired after RESULT_CACHE_TTL (results of CDS queries change over time).
+ */
+
+/** default result cache size (MB) */
+#define RESULT_CACHE_DEFAULT_SIZE 64
+
+/** time to live of cached results (1 hour) */
+#define RESULT_CACHE_TTL 3600
+
+/* cached result (LRU list element) */
+struct sclwsCachedResult
+{
+    string key;
+    string result;
+    time_t time;    /* storage time */
+} ;
+typedef list<sclwsCachedResult>::iterator sclwsCACHE_ITERATOR;
+
+/**
+ * Shared mutex to protect the result cache
+ */
+thrdMUTEX sclwsCacheMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** cached results (most recently used first) */
+static list<sclwsCachedResult> sclwsCacheLru;
+
+/** cached results keyed by cache key */
+static map<string, sclwsCACHE_ITERATOR> sclwsCacheMap;
+
+/* result cache statistics */
+struct sclwsCacheStats
+{
+    mcsUINT64 maxSize;  /* memory cap (bytes); -1 means not initialized */
+    mcsUINT64 size;     /* memory used by cached results (bytes) */
+    mcsUINT64 hits;
+    mcsUINT64 misses;
+    mcsUINT64 evictions;
+} ;
+
+/** result cache statistics */
+static sclwsCacheStats sclwsCacheStatsGetCal = { (mcsUINT64) - 1, 0, 0, 0, 0 };
+
+/*
+ * Streamed responses: the VOTable blocks flushed by the dynamic buffer while
+ * the result is formatted (see vobsVOTABLE::GetVotable()) are written to the
+ * SOAP response (chunked transfer encoding) instead of copying the whole
+ * result into SOAP-aware memory. The result is only kept if waiting followers
+ * or the result cache need it.
+ */
+
+/** streamed responses: -1 means not initialized */
+static mcsINT32 sclwsStreamEnabled = -1;
+
+/* streamed SOAP response (write-only stream given to the dynamic buffer) */
+struct sclwsStream
+{
+    struct soap* soapContext;    /* SOAP execution context */
+    const char* responseTag;     /* response element */
+    const char* resultTag;       /* result element (string) */
+    sclwsFlight* flight;         /* query execution or NULL */
+    mcsUINT64 maxCapture;        /* maximum result size to keep for the result cache (0 if not cacheable) */
+    bool shared;                 /* true if followers wait for the result */
+    bool capture;                /* true to keep a copy of the result */
+    bool started;                /* true once the SOAP response is started */
+    bool broken;                 /* true if the transport failed */
+    bool completed;              /* true if the query completed */
+    string result;               /* copy of the result (capture) */
+
+    sclwsStream()
+    {
+        soapContext = NULL;
+        responseTag = NULL;
+        resultTag = NULL;
+        flight = NULL;
+        maxCapture = 0;
+        shared = capture = started = broken = completed = false;
+    }
+} ;
 
 /**
  * Return the number of created and deleted server instances (GETCAL)
@@ -203,9 +319,925 @@ void sclwsGetStarStats(mcsUINT32 *serverCreated, mcsUINT32 *serverDeleted, mcsUI
     STL_UNLOCK();
 }
 
+/**
+ * Return the number of coalesced queries (followers)
+ * @param getCalCoalesced number of coalesced GetCal queries
+ * @param getStarCoalesced number of coalesced GetStar queries
+ */
+void sclwsCoalescingStats(mcsUINT32 *getCalCoalesced, mcsUINT32 *getStarCoalesced)
+{
+    STL_LOCK();
+
+    *getCalCoalesced  = sclwsServerStatsGetCal.coalesced;
+    *getStarCoalesced = sclwsServerStatsGetStar.coalesced;
+
+    STL_UNLOCK();
+}
+
+/**
+ * Return the GetCal result cache statistics
+ * @param nbEntries number of cached results
+ * @param size memory used by cached results (bytes)
+ * @param maxSize memory cap (bytes)
+ * @param hits number of queries served from the cache
+ * @param misses number of queries not found in the cache
+ * @param evictions number of evicted results
+ */
+void sclwsResultCacheStats(mcsUINT32 *nbEntries, mcsUINT64 *size, mcsUINT64 *maxSize,
+                           mcsUINT64 *hits, mcsUINT64 *misses, mcsUINT64 *evictions)
+{
+    if (thrdMutexLock(&sclwsCacheMutex) == mcsFAILURE)
+    {
+        return;
+    }
+
+    *nbEntries = sclwsCacheMap.size();
+    *size      = sclwsCacheStatsGetCal.size;
+    *maxSize   = (sclwsCacheStatsGetCal.maxSize == (mcsUINT64) - 1) ? 0 : sclwsCacheStatsGetCal.maxSize;
+    *hits      = sclwsCacheStatsGetCal.hits;
+    *misses    = sclwsCacheStatsGetCal.misses;
+    *evictions = sclwsCacheStatsGetCal.evictions;
+
+    thrdMutexUnlock(&sclwsCacheMutex);
+}
+
 /*
  * Local methods
  */
+
+/**
+ * Return the canonical form of the given query (parameters sorted by name,
+ * default values included) used to coalesce identical queries.
+ * @param cmdName command name (GETCAL or GETSTAR)
+ * @param query query to canonicalize
+ * @param key canonical query
+ * @param cacheable set to true if the query result can be cached
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT sclwsGetQueryKey(const char* cmdName, const char* query, string &key, bool &cacheable)
+{
+    string paramLine;
+
+    if (strcmp(cmdName, sclsvrGETCAL_CMD_NAME) == 0)
+    {
+        sclsvrREQUEST request;
+        FAIL(request.Parse(query));
+
+        mcsSTRING16384 cmdParamLine;
+        FAIL(request.GetCmdParamLine(&cmdParamLine));
+        paramLine = cmdParamLine;
+
+        // results saved in a file (side effect) or diagnose results (thread log) are not cached:
+        cacheable = (strlen(request.GetFileName()) == 0) && IS_FALSE(request.IsDiagnose());
+    }
+    else
+    {
+        sclsvrGETSTAR_CMD getStarCmd(cmdName, query);
+        FAIL(getStarCmd.GetCmdParamLine(paramLine));
+
+        cacheable = false;
+    }
+
+    key = cmdName;
+    key.append(" ");
+    key.append(paramLine);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the session table shard of the given job id (FNV-1a hash).
+ * @param jobId job id
+ * @return session table shard
+ */
+static sclwsSessionShard* sclwsGetSessionShard(const char* jobId)
+{
+    mcsUINT32 hash = 2166136261u;
+    for (const char* c = jobId; *c != '\0'; c++)
+    {
+        hash = (hash ^ (unsigned char) *c) * 16777619u;
+    }
+    return &sclwsSessionTable[hash % SESSION_SHARDS];
+}
+
+/**
+ * Release a reference on the given session; the last one gives back the
+ * server instance to the pool and frees the session.
+ * @param session GetCal session
+ */
+static void sclwsSessionRelease(sclwsSession* session)
+{
+    if (__sync_sub_and_fetch(&session->refCount, 1) == 0)
+    {
+        logInfo("Session '%s': releasing associated server.", session->jobId.c_str());
+
+        __sync_fetch_and_add(&sclwsServerStatsGetCal.deleted, 1);
+
+        // give back the server instance to the pool:
+        sclsvrSERVER_POOL::Release(session->server);
+
+        delete(session);
+    }
+}
+
+/**
+ * Register the given new session in the session table.
+ * @param session GetCal session (one reference given to the session table)
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT sclwsSessionOpen(sclwsSession* session)
+{
+    sclwsSessionShard* shard = sclwsGetSessionShard(session->jobId.c_str());
+
+    if (thrdMutexLock(&shard->mutex) == mcsFAILURE)
+    {
+        errAdd(sclwsERR_STL_MUTEX);
+        return mcsFAILURE;
+    }
+
+    shard->sessions[session->jobId] = session;
+
+    thrdMutexUnlock(&shard->mutex);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the open session of the given job id with a new reference (to be
+ * released by sclwsSessionRelease()).
+ * @param jobId job id
+ * @param completed set to true if the session is completed
+ * @return GetCal session or NULL if not found
+ */
+static sclwsSession* sclwsSessionGet(const char* jobId, bool &completed)
+{
+    sclwsSessionShard* shard = sclwsGetSessionShard(jobId);
+    sclwsSession* session = NULL;
+
+    completed = false;
+
+    if (thrdMutexLock(&shard->mutex) == mcsFAILURE)
+    {
+        errAdd(sclwsERR_STL_MUTEX);
+        return NULL;
+    }
+
+    map<string, sclwsSession*>::iterator iter = shard->sessions.find(jobId);
+    if (iter != shard->sessions.end())
+    {
+        session = iter->second;
+        __sync_add_and_fetch(&session->refCount, 1);
+    }
+    else
+    {
+        completed = (shard->completed.find(jobId) != shard->completed.end());
+    }
+
+    thrdMutexUnlock(&shard->mutex);
+
+    return session;
+}
+
+/**
+ * Close the given session: remove it from the session table (remembered as
+ * completed) and release the session table reference.
+ * @param session GetCal session
+ */
+static void sclwsSessionClose(sclwsSession* session)
+{
+    sclwsSessionShard* shard = sclwsGetSessionShard(session->jobId.c_str());
+    bool found = false;
+
+    if (thrdMutexLock(&shard->mutex) == mcsFAILURE)
+    {
+        errAdd(sclwsERR_STL_MUTEX);
+        return;
+    }
+
+    map<string, sclwsSession*>::iterator iter = shard->sessions.find(session->jobId);
+    if ((iter != shard->sessions.end()) && (iter->second == session))
+    {
+        shard->sessions.erase(iter);
+        shard->completed[session->jobId] = time(NULL);
+        found = true;
+    }
+
+    thrdMutexUnlock(&shard->mutex);
+
+    if (found)
+    {
+        sclwsSessionRelease(session);
+    }
+}
+
+/**
+ * Cancel the query execution if all waiting sessions were cancelled.
+ * Must be called within STL lock.
+ * @param flight query execution
+ */
+static void sclwsFlightCheckCancel(sclwsFlight* flight)
+{
+    if (!flight->done && (flight->nbWaiters != 0) && (flight->nbCancelled == flight->nbWaiters)
+            && IS_NOT_NULL(flight->server))
+    {
+        logInfo("Session '%s': all waiting sessions cancelled; cancelling query.", flight->leader->jobId.c_str());
+
+        // dirty write (see ns__GetCalCancelSession):
+        *flight->server->GetCancelFlag() = true;
+
+        // new identical queries must not join this cancelled execution:
+        map<string, sclwsFlight*>::iterator iter = sclwsFlightList.find(flight->key);
+        if ((iter != sclwsFlightList.end()) && (iter->second == flight))
+        {
+            sclwsFlightList.erase(iter);
+        }
+    }
+}
+
+/**
+ * Attach the given session to the execution of the given query: either a new
+ * one (leader) or the one already in progress (follower).
+ * Must be called within STL lock.
+ * @param key canonical query
+ * @param session GetCal session (NULL for GetStar)
+ * @param isLeader set to true if the session must execute the query
+ * @return query execution
+ */
+static sclwsFlight* sclwsFlightJoin(const string &key, sclwsSession* session, bool &isLeader)
+{
+    sclwsFlight* flight;
+
+    map<string, sclwsFlight*>::iterator iter = sclwsFlightList.find(key);
+    if (iter != sclwsFlightList.end())
+    {
+        flight = iter->second;
+        isLeader = false;
+    }
+    else
+    {
+        flight = new sclwsFlight;
+        flight->key = key;
+        flight->leader = session;
+        flight->server = IS_NULL(session) ? NULL : session->server;
+        flight->nbWaiters = 0;
+        flight->nbCancelled = 0;
+        flight->done = false;
+        flight->failed = false;
+
+        if (IS_NOT_NULL(session))
+        {
+            // followers read the leader status until the execution is freed:
+            __sync_add_and_fetch(&session->refCount, 1);
+        }
+
+        sclwsFlightList[key] = flight;
+        isLeader = true;
+    }
+
+    flight->nbWaiters++;
+
+    if (IS_NOT_NULL(session))
+    {
+        session->flight = flight;
+        session->nbUpdates = 0;
+        // cancelled before joining (follower) ?
+        session->cancelled = !isLeader && *session->server->GetCancelFlag();
+
+        if (session->cancelled)
+        {
+            flight->nbCancelled++;
+            sclwsFlightCheckCancel(flight);
+        }
+    }
+    return flight;
+}
+
+/**
+ * Publish the result of the query execution (leader) and wake up followers.
+ * @param flight query execution
+ * @param result serialized result or NULL if the query failed
+ * @param error error message if the query failed
+ */
+static void sclwsFlightComplete(sclwsFlight* flight, const char* result, const char* error)
+{
+    STL_LOCK();
+
+    flight->done = true;
+    flight->failed = IS_NULL(result);
+    flight->result = IS_NULL(result) ? "" : result;
+    flight->error = IS_NULL(error) ? "" : error;
+
+    map<string, sclwsFlight*>::iterator iter = sclwsFlightList.find(flight->key);
+    if ((iter != sclwsFlightList.end()) && (iter->second == flight))
+    {
+        sclwsFlightList.erase(iter);
+    }
+
+    pthread_cond_broadcast(&sclwsFlightCond);
+
+    STL_UNLOCK();
+}
+
+/**
+ * Detach the given session from the query execution; the last one frees it.
+ * @param flight query execution
+ * @param session GetCal session (NULL for GetStar)
+ */
+static void sclwsFlightLeave(sclwsFlight* flight, sclwsSession* session)
+{
+    sclwsSession* leader = NULL;
+
+    STL_LOCK();
+
+    if (IS_NOT_NULL(session))
+    {
+        if (session->cancelled)
+        {
+            flight->nbCancelled--;
+        }
+        if (flight->leader != session)
+        {
+            // follower server never runs the query: its status is completed
+            session->served = true;
+        }
+        session->flight = NULL;
+        session->cancelled = false;
+    }
+
+    flight->nbWaiters--;
+
+    if (flight->nbWaiters == 0)
+    {
+        if (flight->done)
+        {
+            leader = flight->leader;
+            delete(flight);
+        }
+    }
+    else
+    {
+        sclwsFlightCheckCancel(flight);
+    }
+
+    STL_UNLOCK();
+
+    if (IS_NOT_NULL(leader))
+    {
+        sclwsSessionRelease(leader);
+    }
+}
+
+/**
+ * Wait for the result of the query execution (follower).
+ * @param soapContext SOAP execution context.
+ * @param flight query execution
+ * @param session GetCal session (NULL for GetStar)
+ * @param output give-back pointer to return the result
+ * @return a SOAP error code.
+ */
+static int sclwsFlightWait(struct soap* soapContext, sclwsFlight* flight, sclwsSession* session, char** output)
+{
+    bool cancelled = false;
+
+    STL_LOCK_AND_SOAP_ERROR(soapContext);
+
+    while (!flight->done)
+    {
+        if (IS_NOT_NULL(session) && session->cancelled)
+        {
+            cancelled = true;
+            break;
+        }
+        pthread_cond_wait(&sclwsFlightCond, &sclwsStlMutex);
+    }
+
+    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+
+    // the flight is done (immutable) or cancelled for this session:
+    if (cancelled)
+    {
+        errAdd(sclwsERR_QUERY_CANCELLED);
+        sclwsReturnSoapError(soapContext);
+    }
+    if (flight->failed)
+    {
+        soap_fault(soapContext);
+        soapContext->fault->faultstring = soap_strdup(soapContext, flight->error.c_str());
+        return SOAP_ERR;
+    }
+
+    int resultSize = flight->result.length() + 1; // For the trailing '\0'
+    *output = (char*) soap_malloc(soapContext, resultSize);
+    if (*output == NULL)
+    {
+        errAdd(sclwsERR_ALLOC_MEM, resultSize);
+        sclwsReturnSoapError(soapContext);
+    }
+    memcpy(*output, flight->result.c_str(), resultSize);
+
+    return SOAP_OK;
+}
+
+/**
+ * Return the progress of the query execution followed by the given session.
+ * Like sclsvrSERVER::GetStatus(), it waits for a status update (or timeout)
+ * but does not consume the leader status (read by the leader session): each
+ * session follows every status update using its own cursor.
+ * @param session GetCal session
+ * @param buffer an already allocated buffer to contain the status
+ * @param isFollower set to false if the session does not follow another
+ * session (buffer unchanged)
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT sclwsFlightGetStatus(sclwsSession* session, mcsSTRING256* buffer, bool &isFollower)
+{
+    STL_LOCK(mcsFAILURE);
+
+    sclwsFlight* flight = session->flight;
+
+    isFollower = IS_NOT_NULL(flight) && (flight->leader != session);
+
+    if (!isFollower || flight->done)
+    {
+        STL_UNLOCK(mcsFAILURE);
+
+        if (isFollower)
+        {
+            // completed:
+            strcpy((char*) buffer, "0");
+        }
+        return mcsSUCCESS;
+    }
+
+    // the leader server is kept while reading its status:
+    sclwsSession* leader = flight->leader;
+    __sync_add_and_fetch(&leader->refCount, 1);
+
+    mcsUINT32 cursor = session->nbUpdates;
+
+    STL_UNLOCK(mcsFAILURE);
+
+    // wait for the next status update outside lock:
+    mcsCOMPL_STAT status = leader->server->ReadStatus(buffer, &cursor, STATUS_TIMEOUT);
+
+    sclwsSessionRelease(leader);
+
+    FAIL(status);
+
+    STL_LOCK(mcsFAILURE);
+
+    if (session->flight != flight)
+    {
+        // completed or cancelled meanwhile:
+        strcpy((char*) buffer, "0");
+    }
+    else
+    {
+        session->nbUpdates = cursor;
+    }
+
+    STL_UNLOCK(mcsFAILURE);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the GetCal result cache size (bytes) given by the
+ * SCLWS_CACHE_SIZE_MB environment variable (0 disables the cache).
+ * Must be called within cache lock.
+ */
+static mcsUINT64 sclwsGetResultCacheMaxSize(void)
+{
+    if (sclwsCacheStatsGetCal.maxSize == (mcsUINT64) - 1)
+    {
+        mcsINT32 sizeInMB = RESULT_CACHE_DEFAULT_SIZE;
+
+        if (miscGetEnvVarIntValue(SCLWS_CACHE_SIZE_ENVVAR_NAME, &sizeInMB) == mcsFAILURE)
+        {
+            errResetStack();
+            sizeInMB = RESULT_CACHE_DEFAULT_SIZE;
+        }
+        if (sizeInMB < 0)
+        {
+            sizeInMB = 0;
+        }
+        logInfo("GetCal result cache size: %d MB ('%s' environment variable).", sizeInMB, SCLWS_CACHE_SIZE_ENVVAR_NAME);
+
+        sclwsCacheStatsGetCal.maxSize = ((mcsUINT64) sizeInMB) * 1024 * 1024;
+    }
+    return sclwsCacheStatsGetCal.maxSize;
+}
+
+/**
+ * Copy the cached result of the given query (if any and not expired) into
+ * SOAP-aware memory.
+ * @param soapContext SOAP execution context.
+ * @param key cache key
+ * @param output give-back pointer to return the cached result
+ * @return true if the result was found in the cache
+ */
+static bool sclwsResultCacheGet(struct soap* soapContext, const string &key, char** output)
+{
+    bool found = false;
+
+    if (thrdMutexLock(&sclwsCacheMutex) == mcsFAILURE)
+    {
+        return false;
+    }
+
+    if (sclwsGetResultCacheMaxSize() != 0)
+    {
+        map<string, sclwsCACHE_ITERATOR>::iterator iter = sclwsCacheMap.find(key);
+        if ((iter != sclwsCacheMap.end()) && (time(NULL) - iter->second->time >= RESULT_CACHE_TTL))
+        {
+            // expired result:
+            sclwsCacheStatsGetCal.size -= key.length() + iter->second->result.length();
+            sclwsCacheStatsGetCal.evictions++;
+
+            sclwsCacheLru.erase(iter->second);
+            sclwsCacheMap.erase(iter);
+            iter = sclwsCacheMap.end();
+        }
+        if (iter != sclwsCacheMap.end())
+        {
+            // move to front (most recently used):
+            sclwsCacheLru.splice(sclwsCacheLru.begin(), sclwsCacheLru, iter->second);
+
+            const string& result = iter->second->result;
+
+            int resultSize = result.length() + 1; // For the trailing '\0'
+            *output = (char*) soap_malloc(soapContext, resultSize);
+            if (*output != NULL)
+            {
+                memcpy(*output, result.c_str(), resultSize);
+                found = true;
+            }
+        }
+
+        if (found)
+        {
+            sclwsCacheStatsGetCal.hits++;
+        }
+        else
+        {
+            sclwsCacheStatsGetCal.misses++;
+        }
+    }
+
+    thrdMutexUnlock(&sclwsCacheMutex);
+
+    return found;
+}
+
+/**
+ * Store the result of the given query in the cache (least recently used
+ * results are evicted beyond the memory cap).
+ * @param key cache key
+ * @param result serialized result (VOTable)
+ */
+static void sclwsResultCachePut(const string &key, const char* result)
+{
+    if (thrdMutexLock(&sclwsCacheMutex) == mcsFAILURE)
+    {
+        return;
+    }
+
+    const mcsUINT64 maxSize = sclwsGetResultCacheMaxSize();
+    const mcsUINT64 size = key.length() + strlen(result);
+
+    if ((size <= maxSize) && (sclwsCacheMap.find(key) == sclwsCacheMap.end()))
+    {
+        sclwsCachedResult entry;
+        entry.key = key;
+        entry.result = result;
+        entry.time = time(NULL);
+
+        sclwsCacheLru.push_front(entry);
+        sclwsCacheMap[key] = sclwsCacheLru.begin();
+        sclwsCacheStatsGetCal.size += size;
+
+        // evict least recently used results:
+        while (sclwsCacheStatsGetCal.size > maxSize)
+        {
+            sclwsCachedResult& last = sclwsCacheLru.back();
+
+            sclwsCacheStatsGetCal.size -= last.key.length() + last.result.length();
+            sclwsCacheStatsGetCal.evictions++;
+
+            sclwsCacheMap.erase(last.key);
+            sclwsCacheLru.pop_back();
+        }
+    }
+
+    thrdMutexUnlock(&sclwsCacheMutex);
+}
+
+/**
+ * Return the maximum size of results stored in the result cache (0 if the
+ * cache is disabled).
+ */
+static mcsUINT64 sclwsGetResultCacheCapacity(void)
+{
+    if (thrdMutexLock(&sclwsCacheMutex) == mcsFAILURE)
+    {
+        return 0;
+    }
+
+    const mcsUINT64 maxSize = sclwsGetResultCacheMaxSize();
+
+    thrdMutexUnlock(&sclwsCacheMutex);
+
+    return maxSize;
+}
+
+/**
+ * Return true if results are streamed; given by the SCLWS_STREAM environment
+ * variable (0 disables streamed responses).
+ */
+static bool sclwsIsStreamEnabled(void)
+{
+    if (sclwsStreamEnabled == -1)
+    {
+        mcsINT32 enabled = 1;
+
+        if (miscGetEnvVarIntValue(SCLWS_STREAM_ENVVAR_NAME, &enabled) == mcsFAILURE)
+        {
+            errResetStack();
+            enabled = 1;
+        }
+        logInfo("Streamed responses: %s ('%s' environment variable).",
+                (enabled != 0) ? "enabled" : "disabled", SCLWS_STREAM_ENVVAR_NAME);
+
+        sclwsStreamEnabled = (enabled != 0) ? 1 : 0;
+    }
+    return (sclwsStreamEnabled == 1);
+}
+
+/**
+ * Start the SOAP response (first written block): HTTP header (chunked transfer
+ * encoding), SOAP envelope and opening response and result elements.
+ * @param stream streamed response
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT sclwsStreamBegin(sclwsStream* stream)
+{
+    STL_LOCK(mcsFAILURE);
+
+    if (IS_NOT_NULL(stream->flight))
+    {
+        if (stream->flight->nbWaiters > 1)
+        {
+            stream->shared = true;
+        }
+        else
+        {
+            // no follower: next identical queries run on their own (result not kept)
+            map<string, sclwsFlight*>::iterator iter = sclwsFlightList.find(stream->flight->key);
+            if ((iter != sclwsFlightList.end()) && (iter->second == stream->flight))
+            {
+                sclwsFlightList.erase(iter);
+            }
+        }
+    }
+
+    STL_UNLOCK(mcsFAILURE);
+
+    stream->capture = stream->shared || (stream->maxCapture != 0);
+    stream->started = true;
+
+    struct soap* soapContext = stream->soapContext;
+
+    // chunked transfer encoding (no length counting pass):
+    soapContext->omode = (soapContext->omode & ~SOAP_IO) | SOAP_IO_CHUNK;
+#ifdef WITH_GZIP
+    // compress the response if accepted by the client:
+    if (soapContext->zlib_out == SOAP_ZLIB_GZIP)
+    {
+        soapContext->omode |= SOAP_ENC_ZLIB;
+    }
+#endif
+
+    // same sequence as soap_serve_ns__GetCalSearchCal() up to the result value:
+    soap_serializeheader(soapContext);
+
+    if (soap_begin_count(soapContext)
+            || soap_end_count(soapContext)
+            || soap_response(soapContext, SOAP_OK)
+            || soap_envelope_begin_out(soapContext)
+            || soap_putheader(soapContext)
+            || soap_body_begin_out(soapContext)
+            || soap_element_begin_out(soapContext, stream->responseTag, 0, "")
+            || soap_element_begin_out(soapContext, stream->resultTag, 0, ""))
+    {
+        return mcsFAILURE;
+    }
+    return mcsSUCCESS;
+}
+
+/**
+ * Send the given part of the result (XML escaped like soap_string_out()).
+ * @param soapContext SOAP execution context.
+ * @param buffer result part
+ * @param size result part length
+ * @return a SOAP error code.
+ */
+static int sclwsStreamSend(struct soap* soapContext, const char* buffer, size_t size)
+{
+    const char* start = buffer;
+    const char* end = buffer + size;
+
+    for (const char* ptr = buffer; ptr < end; ptr++)
+    {
+        const unsigned char ch = (unsigned char) *ptr;
+        const char* entity = NULL;
+
+        switch (ch)
+        {
+            case '&':
+                entity = "&amp;";
+                break;
+            case '<':
+                entity = "&lt;";
+                break;
+            case '>':
+                entity = "&gt;";
+                break;
+            case '\r':
+                entity = "&#xD;";
+                break;
+            default:
+                if ((ch < 0x80) || (soapContext->mode & SOAP_C_UTFSTRING))
+                {
+                    continue;
+                }
+        }
+
+        if (soap_send_raw(soapContext, start, ptr - start)
+                || (IS_NULL(entity) ? soap_pututf8(soapContext, ch) : soap_send(soapContext, entity)))
+        {
+            return soapContext->error;
+        }
+        start = ptr + 1;
+    }
+    return soap_send_raw(soapContext, start, end - start);
+}
+
+/**
+ * Write the given result block in the SOAP response (stream write function).
+ * @param cookie streamed response
+ * @param buffer result block
+ * @param size result block length
+ * @return number of written bytes or -1 to abort the query (transport failure)
+ */
+static ssize_t sclwsStreamWrite(void* cookie, const char* buffer, size_t size)
+{
+    sclwsStream* stream = (sclwsStream*) cookie;
+
+    if (!stream->started && (sclwsStreamBegin(stream) == mcsFAILURE))
+    {
+        stream->broken = true;
+    }
+
+    if (stream->capture)
+    {
+        if (!stream->shared && (stream->result.length() + size > stream->maxCapture))
+        {
+            // too large for the result cache:
+            stream->capture = false;
+            string().swap(stream->result);
+        }
+        else
+        {
+            stream->result.append(buffer, size);
+        }
+    }
+
+    if (!stream->broken && (sclwsStreamSend(stream->soapContext, buffer, size) != SOAP_OK))
+    {
+        stream->broken = true;
+    }
+
+    if (stream->broken && !stream->shared)
+    {
+        // nobody waits for the result:
+        return -1;
+    }
+    return size;
+}
+
+/**
+ * Give a stream to the given dynamic buffer so that the result is written in
+ * the SOAP response while it is formatted.
+ * @param stream streamed response to initialize
+ * @param soapContext SOAP execution context.
+ * @param responseTag response element
+ * @param resultTag result element
+ * @param flight query execution or NULL
+ * @param cacheable true if the result may be stored in the result cache
+ * @param dynBuf dynamic buffer given to the server
+ * @return stream (closed by sclwsStreamClose()) or NULL if the result is not
+ * streamed (disabled)
+ */
+static FILE* sclwsStreamOpen(sclwsStream* stream, struct soap* soapContext,
+                             const char* responseTag, const char* resultTag,
+                             sclwsFlight* flight, bool cacheable, miscoDYN_BUF* dynBuf)
+{
+    if (!sclwsIsStreamEnabled())
+    {
+        return NULL;
+    }
+
+    stream->soapContext = soapContext;
+    stream->responseTag = responseTag;
+    stream->resultTag = resultTag;
+    stream->flight = flight;
+    stream->maxCapture = cacheable ? sclwsGetResultCacheCapacity() : 0;
+
+    cookie_io_functions_t functions = { NULL, sclwsStreamWrite, NULL, NULL };
+
+    FILE* file = fopencookie(stream, "w", functions);
+    if (IS_NULL(file))
+    {
+        return NULL;
+    }
+    // blocks are already buffered by the dynamic buffer:
+    setvbuf(file, NULL, _IONBF, 0);
+
+    if (dynBuf->SaveBufferedToStream(file) == mcsFAILURE)
+    {
+        errResetStack();
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ * Flush the result remaining in the dynamic buffer and end the SOAP response.
+ * If the query failed once the response was started, the response is left
+ * incomplete (truncated chunked transfer) so that the client detects the
+ * failure.
+ * @param stream streamed response
+ * @param file stream given by sclwsStreamOpen() or NULL
+ * @param dynBuf dynamic buffer given to the server
+ * @param queryStatus query status
+ * @return true if the response was streamed (sent or aborted); false if the
+ * result must be returned as usual (not streamed, empty result or error)
+ */
+static bool sclwsStreamClose(sclwsStream* stream, FILE* file, miscoDYN_BUF* dynBuf, mcsCOMPL_STAT queryStatus)
+{
+    if (IS_NULL(file))
+    {
+        return false;
+    }
+
+    if (queryStatus == mcsFAILURE)
+    {
+        // do not send the partial result:
+        dynBuf->Reset();
+    }
+    // flush the remaining result (the stream is not closed):
+    dynBuf->CloseFile();
+    fclose(file);
+
+    if (!stream->started)
+    {
+        return false;
+    }
+
+    stream->completed = (queryStatus == mcsSUCCESS) && (!stream->broken || stream->shared);
+
+    if (stream->broken)
+    {
+        logWarning("Streamed response aborted (transport failure).");
+    }
+    else if (stream->completed)
+    {
+        struct soap* soapContext = stream->soapContext;
+
+        if (soap_element_end_out(soapContext, stream->resultTag)
+                || soap_element_end_out(soapContext, stream->responseTag)
+                || soap_body_end_out(soapContext)
+                || soap_envelope_end_out(soapContext)
+                || soap_end_send(soapContext))
+        {
+            stream->broken = true;
+            logWarning("Streamed response aborted (transport failure).");
+        }
+    }
+    return true;
+}
+
+/**
+ * Return the streamed result kept for followers or the result cache.
+ * @param stream streamed response
+ * @return result or NULL if not available
+ */
+static const char* sclwsStreamGetResult(const sclwsStream* stream)
+{
+    return (stream->completed && stream->capture) ? stream->result.c_str() : NULL;
+}
+
 mcsUINT16 sclwsGetServerPortNumber(void)
 {
     mcsUINT16 defaultPortNumber = 8079; // Default value for production purpose.
@@ -235,18 +1267,50 @@ int sclwsDumpServerList(struct soap* soapContext, const char* methodName, char*
 {
     if (doLog(logDEBUG))
     {
-        STL_LOCK_AND_SOAP_ERROR(soapContext);
+        logDebug("sclwsSessionTable[%s = %s] dump:", methodName, jobId);
+
+        for (mcsUINT32 i = 0; i < SESSION_SHARDS; i++)
+        {
+            sclwsSessionShard* shard = &sclwsSessionTable[i];
+
+            if (thrdMutexLock(&shard->mutex) == mcsFAILURE)
+            {
+                errAdd(sclwsERR_STL_MUTEX);
+                sclwsReturnSoapError(soapContext);
+            }
+
+            for (map<string, sclwsSession*>::iterator iter = shard->sessions.begin(); iter != shard->sessions.end(); iter++)
+            {
+                logDebug("ID: %s -> %p (%u references)", iter->first.c_str(), iter->second->server, iter->second->refCount);
+            }
+
+            thrdMutexUnlock(&shard->mutex);
+        }
+    }
+    return SOAP_OK;
+}
+
+/**
+ * Return the number of open and completed GetCal sessions
+ * @param nbOpen number of open sessions
+ * @param nbCompleted number of completed sessions (remembered for status queries)
+ */
+void sclwsSessionStats(mcsUINT32 *nbOpen, mcsUINT32 *nbCompleted)
+{
+    *nbOpen = *nbCompleted = 0;
 
-        logDebug("sclwsServerList[%s = %s] dump:", methodName, jobId);
+    for (mcsUINT32 i = 0; i < SESSION_SHARDS; i++)
+    {
+        sclwsSessionShard* shard = &sclwsSessionTable[i];
 
-        for (std::map<string, sclsvrSERVER*>::iterator iter = sclwsServerList.begin(); iter != sclwsServerList.end(); iter++)
+        if (thrdMutexLock(&shard->mutex) == mcsSUCCESS)
         {
-            logDebug("ID: %s -> %p", iter->first.c_str(), iter->second);
-        }
+            *nbOpen      += shard->sessions.size();
+            *nbCompleted += shard->completed.size();
 
-        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+            thrdMutexUnlock(&shard->mutex);
+        }
     }
-    return SOAP_OK;
 }
 
 /*
@@ -254,123 +1318,69 @@ int sclwsDumpServerList(struct soap* soapContext, const char* methodName, char*
  */
 
 /**
- * Free server instances (GC like)
- * @param forceCleanup flag to force cleanup
+ * Purge the session table (GC like): forget completed sessions after
+ * SESSION_COMPLETED_DELAY and close sessions opened but unused after
+ * SESSION_IDLE_DELAY; server instances are released with the last session
+ * reference (see sclwsSessionRelease()).
+ * @param forceCleanup flag to force cleanup (close all sessions)
+ * @return mcsTRUE if any session was purged
  */
 mcsLOGICAL sclwsFreeServerList(const bool forceCleanup)
 {
-    mcsLOGICAL result     = mcsFALSE;
-    const bool isLogDebug = doLog(logDEBUG);
-
-    /*
-     * Note/TODO : it waits for the known active GetCalStatus thread but if this query answers 1,
-     * another future GetCalStatus query will happen next, and it will then fail (no server associated to jobId) !!
-     *
-     * Workaround: wait few seconds (DELAY_BEFORE_GC) before freeing resources anc check if any thread is working at this time
-     */
+    mcsLOGICAL result = mcsFALSE;
+    const time_t now  = time(NULL);
 
-    GC_LOCK(result);
+    vector<sclwsSession*> closed;
 
-    if (!sclwsGCServerInfoList.empty())
+    for (mcsUINT32 i = 0; i < SESSION_SHARDS; i++)
     {
-        if (isLogDebug)
+        sclwsSessionShard* shard = &sclwsSessionTable[i];
+
+        if (thrdMutexLock(&shard->mutex) == mcsFAILURE)
         {
-            logDebug("freeServerList: enter");
+            errAdd(sclwsERR_STL_MUTEX);
+            continue;
         }
 
-        struct timeval now;
-        long deltaMillis;
-        sclwsServerInfo* info;
-        string jobId;
-        bool jobHasThread;
-
-        /* Get local time */
-        gettimeofday(&now, NULL);
-
-        std::list<sclwsServerInfo*>::iterator iter;
-        for (iter = sclwsGCServerInfoList.begin(); iter != sclwsGCServerInfoList.end(); iter++)
+        for (map<string, time_t>::iterator iter = shard->completed.begin(); iter != shard->completed.end(); )
         {
-            info = *iter;
-
-            jobId = info->jobId;
-
-            // skip too recent ones ...
-
-            deltaMillis  = (now.tv_sec  - info->lastUsedTime.tv_sec) * 1000;
-            deltaMillis += (now.tv_usec - info->lastUsedTime.tv_usec) / 1000;
-
-            if (forceCleanup || deltaMillis > DELAY_BEFORE_GC)
+            if (forceCleanup || (now - iter->second > SESSION_COMPLETED_DELAY))
             {
+                shard->completed.erase(iter++);
+                result = mcsTRUE;
+            }
+            else
+            {
+                iter++;
+            }
+        }
 
-                if (isLogDebug)
-                {
-                    logDebug("freeServerList: check Session '%s'", jobId.c_str());
-                }
-
-                jobHasThread = false;
-
-                STL_LOCK(result);
-
-                sclwsTHREAD_RANGE range = sclwsThreadList.equal_range(jobId);
-
-                // TODO: use a better solution to check if the range is empty
-                sclwsTHREAD_ITERATOR threadIterator;
-                for (threadIterator = range.first; threadIterator != range.second; ++threadIterator)
-                {
-                    jobHasThread = true;
-
-                    logInfo("freeServerList: Session '%s' has at least one thread : %d", jobId.c_str(), threadIterator->second);
-
-                    break;
-                }
-
-                STL_UNLOCK(result);
-
-                if (!jobHasThread)
-                {
-                    // do cleanup
-                    result = mcsTRUE;
-
-                    STL_LOCK(result);
-
-                    sclwsServerStatsGetCal.deleted++;
-
-                    sclwsServerList.erase(jobId);
-
-                    STL_UNLOCK(result);
-
-                    // Delete the server instance
-                    logInfo("freeServerList: Session '%s': deleting associated server.", jobId.c_str());
-
-                    // free Server resources:
-                    delete(info->server);
-
-                    // erase and get next correct position:
-                    iter = sclwsGCServerInfoList.erase(iter);
+        for (map<string, sclwsSession*>::iterator iter = shard->sessions.begin(); iter != shard->sessions.end(); )
+        {
+            sclwsSession* session = iter->second;
 
-                    // go backward as loop goes forward:
-                    iter--;
+            if (forceCleanup || ((session->refCount == 1) && (now - session->openTime > SESSION_IDLE_DELAY)))
+            {
+                logInfo("freeServerList: Session '%s': closing unused session.", session->jobId.c_str());
 
-                    // free server_info:
-                    delete(info);
-                }
+                closed.push_back(session);
+                shard->sessions.erase(iter++);
             }
             else
             {
-                if (isLogDebug)
-                {
-                    logDebug("Session '%s' terminated too recently = %d ms", jobId.c_str(), deltaMillis);
-                }
+                iter++;
             }
         }
 
-        if (isLogDebug)
-        {
-            logDebug("freeServerList: exit");
-        }
+        thrdMutexUnlock(&shard->mutex);
     }
 
-    GC_UNLOCK(result);
+    // release the session table references outside lock:
+    for (vector<sclwsSession*>::iterator iter = closed.begin(); iter != closed.end(); iter++)
+    {
+        sclwsSessionRelease(*iter);
+        result = mcsTRUE;
+    }
 
     return result;
 }
@@ -442,22 +1452,34 @@ int ns__GetCalOpenSession(struct soap* soapContext, char** jobId)
     uuid_unparse(uuidID, *jobId);
     logDebug("Session '%s': unique identifier generated.", *jobId);
 
-    // Create a new instance of sclsvrSERVER to perform the GETCAL query
-    sclsvrSERVER* server = new sclsvrSERVER(mcsFALSE);
+    // Get a (pooled) instance of sclsvrSERVER to perform the GETCAL query
+    sclsvrSERVER* server = sclsvrSERVER_POOL::Acquire();
     if (server == NULL)
     {
         errAdd(sclwsERR_SERVER_INSTANCIATION);
         sclwsReturnSoapError(soapContext);
     }
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    sclwsServerStatsGetCal.created++;
-
-    // Associate the new sclsvrSERVER instance with the generated UUID for later
-    sclwsServerList[*jobId] = server;
+    sclwsSession* session = new sclwsSession;
+    session->jobId = *jobId;
+    session->server = server;
+    session->refCount = 1; // session table
+    session->searching = 0;
+    session->served = false;
+    session->openTime = time(NULL);
+    session->flight = NULL;
+    session->cancelled = false;
+    session->nbUpdates = 0;
+
+    // Associate the new session with the generated UUID for later
+    if (sclwsSessionOpen(session) == mcsFAILURE)
+    {
+        sclsvrSERVER_POOL::Release(server);
+        delete(session);
+        sclwsReturnSoapError(soapContext);
+    }
 
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+    __sync_fetch_and_add(&sclwsServerStatsGetCal.created, 1);
 
     logWarning("Session '%s': server instanciated.", *jobId);
 
@@ -501,53 +1523,138 @@ int ns__GetCalSearchCal(struct soap* soapContext,
         sclwsReturnSoapError(soapContext);
     }
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    // Retrieve the sclsvrSERVER instance associated with the received UUID
-    sclsvrSERVER* server = sclwsServerList[jobId];
+    // Retrieve the session associated with the received UUID
+    bool completed;
+    sclwsSession* session = sclwsSessionGet(jobId, completed);
 
-    if (server == NULL)
+    if (session == NULL)
     {
-        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
         errAdd(sclwsERR_WRONG_SERVER_ID, jobId);
         sclwsReturnSoapError(soapContext);
     }
 
-    // Store the thread ID iterator (used in case a Cancel occurs while this is running)
-    // @TODO: this iterator may be inconsistent at erase time (concurrency)
-    sclwsTHREAD_ITERATOR threadIterator =
-            sclwsThreadList.insert(make_pair(jobId, pthread_self()));
-
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+    sclsvrSERVER* server = session->server;
 
     // check reentrance in case of http retry on the client side (curl or apache HttpClient)
     // to avoid concurrency issue with sclsvrSERVER object:
-    if (server->IsWorking())
+    if (!__sync_bool_compare_and_swap(&session->searching, 0, 1))
     {
         logWarning("Session '%s': query in progress: '%s'; aborting.", jobId, query);
 
         errAdd(sclwsERR_GETCAL_WORKING);
 
-        STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-        // Delete the thread ID
-        sclwsThreadList.erase(threadIterator);
-
-        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+        sclwsSessionRelease(session);
 
         sclwsReturnSoapError(soapContext);
     }
 
-    logWarning("Session '%s': launching query : '%s'", jobId, query);
-
     int status = SOAP_OK;
 
     const char* result = NULL;
     miscDynSIZE resultSize = 0;
+    miscoDYN_BUF dynBuf;
+    mcsCOMPL_STAT queryStatus;
+
+    // Streamed response:
+    sclwsStream stream;
+    FILE* streamFile = NULL;
+
+    // Coalesce identical concurrent queries:
+    string key, cacheKey;
+    sclwsFlight* flight = NULL;
+    bool isLeader = true;
+    bool cacheable = false;
+
+    if (sclwsGetQueryKey(sclsvrGETCAL_CMD_NAME, query, key, cacheable) == mcsSUCCESS)
+    {
+        if (cacheable)
+        {
+            // the result depends on the server version and the JSDC dataset (reloads):
+            mcsSTRING32 jsdcVersion;
+            snprintf(jsdcVersion, sizeof (jsdcVersion) - 1, " JSDC:%u ", sclsvrJSDC_DATA::GetCurrentVersion());
+
+            cacheKey = sclsvrVERSION;
+            cacheKey.append(jsdcVersion);
+            cacheKey.append(key);
+
+            if (sclwsResultCacheGet(soapContext, cacheKey, voTable))
+            {
+                logWarning("Session '%s': query result found in cache : '%s'", jobId, query);
+
+                // the server of this session does not run the query:
+                session->served = true;
+
+                goto cleanup;
+            }
+        }
+
+        // on mutex failure, go to cleanup to close the session (searching flag):
+        if (thrdMutexLock(&sclwsStlMutex) == mcsFAILURE)
+        {
+            errAdd(sclwsERR_STL_MUTEX);
+            sclwsDefineSoapError(soapContext);
+            status = SOAP_ERR;
+            goto cleanup;
+        }
+
+        flight = sclwsFlightJoin(key, session, isLeader);
+
+        if (!isLeader)
+        {
+            sclwsServerStatsGetCal.coalesced++;
+        }
+
+        if (thrdMutexUnlock(&sclwsStlMutex) == mcsFAILURE)
+        {
+            errAdd(sclwsERR_STL_MUTEX);
+            sclwsDefineSoapError(soapContext);
+            status = SOAP_ERR;
+            goto cleanup;
+        }
+    }
+    else
+    {
+        // invalid query: let the server report the error
+        errResetStack();
+    }
+
+    if (!isLeader)
+    {
+        logWarning("Session '%s': same query in progress in session '%s'; waiting for its result : '%s'",
+                   jobId, flight->leader->jobId.c_str(), query);
+
+        status = sclwsFlightWait(soapContext, flight, session, voTable);
+        goto cleanup;
+    }
+
+    logWarning("Session '%s': launching query : '%s'", jobId, query);
+
+    // Stream the resulting VO Table while it is formatted:
+    streamFile = sclwsStreamOpen(&stream, soapContext, "ns:GetCalSearchCalResponse", "param-4",
+                                 flight, cacheable, &dynBuf);
 
     // Launch the GETCAL query with the received parameters
-    miscoDYN_BUF dynBuf;
-    if (server->GetCal(query, &dynBuf) == mcsFAILURE)
+    queryStatus = server->GetCal(query, &dynBuf);
+
+    if (sclwsStreamClose(&stream, streamFile, &dynBuf, queryStatus))
+    {
+        logDebug("Session '%s': resulting VOTable streamed", jobId);
+
+        if (queryStatus == mcsFAILURE)
+        {
+            // error given to followers:
+            sclwsDefineSoapError(soapContext);
+        }
+        else if (cacheable && !server->IsPartial() && IS_NOT_NULL(sclwsStreamGetResult(&stream)))
+        {
+            sclwsResultCachePut(cacheKey, sclwsStreamGetResult(&stream));
+        }
+        // the response is already sent:
+        status = SOAP_STOP;
+        goto cleanup;
+    }
+
+    if (queryStatus == mcsFAILURE)
     {
         sclwsDefineSoapError(soapContext);
         status = SOAP_ERR;
@@ -571,36 +1678,44 @@ int ns__GetCalSearchCal(struct soap* soapContext,
     *voTable = (char*) soap_malloc(soapContext, resultSize);
     strncpy(*voTable, result, resultSize);
 
-cleanup:
-
-    logWarning("Session '%s': terminating query.", jobId);
-
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    // Delete the thread ID
-    sclwsThreadList.erase(threadIterator);
-
-    if (status == SOAP_ERR)
+    // partial results (deadline reached) are not cached:
+    if (cacheable && !server->IsPartial())
     {
-        sclwsServerStatsGetCal.failed++;
+        sclwsResultCachePut(cacheKey, *voTable);
     }
 
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
-
-    // add server information for GC thread:
-    sclwsServerInfo* info = new sclwsServerInfo;
-
-    /* Get local time */
-    gettimeofday(&info->lastUsedTime, NULL);
+cleanup:
 
-    info->jobId = string(jobId);
-    info->server = server;
+    if (IS_NOT_NULL(flight))
+    {
+        if (isLeader)
+        {
+            // share the result with followers:
+            if (status == SOAP_STOP)
+            {
+                sclwsFlightComplete(flight, sclwsStreamGetResult(&stream),
+                                    IS_NULL(soapContext->fault) ? NULL : soapContext->fault->faultstring);
+            }
+            else
+            {
+                sclwsFlightComplete(flight, (status == SOAP_OK) ? *voTable : NULL,
+                                    (status == SOAP_OK) ? NULL : soapContext->fault->faultstring);
+            }
+        }
+        sclwsFlightLeave(flight, session);
+    }
 
-    GC_LOCK(status);
+    logWarning("Session '%s': terminating query.", jobId);
 
-    sclwsGCServerInfoList.push_back(info);
+    if ((status == SOAP_ERR) || ((status == SOAP_STOP) && !stream.completed))
+    {
+        __sync_fetch_and_add(&sclwsServerStatsGetCal.failed, 1);
+    }
 
-    GC_UNLOCK(status);
+    // the query is completed: close the session (server released by the last pending call)
+    __sync_lock_release(&session->searching);
+    sclwsSessionClose(session);
+    sclwsSessionRelease(session);
 
     sclwsDumpServerList(soapContext, "GetCalSearchCal", jobId);
 
@@ -637,25 +1752,16 @@ int ns__GetCalQueryStatus(struct soap* soapContext,
         sclwsReturnSoapError(soapContext);
     }
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    // Retrieve the sclsvrSERVER instance associated with th received UUID
-    sclsvrSERVER* server = sclwsServerList[jobId];
+    // Retrieve the session associated with the received UUID
+    bool completed;
+    sclwsSession* session = sclwsSessionGet(jobId, completed);
 
-    if (server == NULL)
+    if ((session == NULL) && !completed)
     {
-        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
         errAdd(sclwsERR_WRONG_SERVER_ID, jobId);
         sclwsReturnSoapError(soapContext);
     }
 
-    // Store the thread ID iterator (used in case a Cancel occurs while this is running)
-    // @TODO: this iterator may be inconsistent at erase time (concurrency)
-    sclwsTHREAD_ITERATOR threadIterator =
-            sclwsThreadList.insert(make_pair(jobId, pthread_self()));
-
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
-
     // Allocate SOAP-aware memory to return the current catalog name
     int statusLength = 256; // Should be enough !
     *status = (char*) soap_malloc(soapContext, statusLength);
@@ -664,19 +1770,36 @@ int ns__GetCalQueryStatus(struct soap* soapContext,
         errAdd(sclwsERR_ALLOC_MEM, statusLength);
         goto errCond;
     }
-    if (server->GetStatus((mcsSTRING256*)*status) == mcsFAILURE)
+    if ((session == NULL) || session->served)
     {
-        goto errCond;
+        // query completed (session closed, coalesced or cached):
+        strcpy(*status, "0");
     }
+    else
+    {
+        // If this session follows a coalesced query, report the leader progress:
+        bool isFollower = false;
 
-    logInfo("Session '%s': query status = '%s'.", jobId, *status);
+        if (IS_NOT_NULL(session->flight)
+                && (sclwsFlightGetStatus(session, (mcsSTRING256*)*status, isFollower) == mcsFAILURE))
+        {
+            goto errCond;
+        }
+        // query not started yet: current status, otherwise wait (shortly) for an update:
+        const mcsINT32 timeout = (session->searching != 0) ? STATUS_TIMEOUT : 0;
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
+        if (!isFollower && (session->server->GetStatus((mcsSTRING256*)*status, timeout) == mcsFAILURE))
+        {
+            goto errCond;
+        }
+    }
 
-    // Delete the thread ID
-    sclwsThreadList.erase(threadIterator);
+    logInfo("Session '%s': query status = '%s'.", jobId, *status);
 
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+    if (session != NULL)
+    {
+        sclwsSessionRelease(session);
+    }
 
     return sclwsDumpServerList(soapContext, "GetCalQueryStatus", jobId);
 
@@ -684,12 +1807,10 @@ errCond:
 
     logWarning("Session '%s': query status failed.", jobId);
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    // Delete the thread ID
-    sclwsThreadList.erase(threadIterator);
-
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+    if (session != NULL)
+    {
+        sclwsSessionRelease(session);
+    }
 
     sclwsReturnSoapError(soapContext);
 }
@@ -729,33 +1850,56 @@ int ns__GetCalCancelSession(struct soap* soapContext,
     // Cancellation pending
     *isOK = false;
 
-    STL_LOCK_AND_SOAP_ERROR(soapContext);
-
-    // Retrieve the sclsvrSERVER instance associated with th received UUID
-    sclsvrSERVER* server = sclwsServerList[jobId];
+    // Retrieve the session associated with the received UUID
+    bool completed;
+    sclwsSession* session = sclwsSessionGet(jobId, completed);
 
-    if (server != NULL)
+    if (session != NULL)
     {
-        sclwsServerStatsGetCal.cancelled++;
+        __sync_fetch_and_add(&sclwsServerStatsGetCal.cancelled, 1);
+
+        // within STL lock as the session may join a coalesced query meanwhile:
+        STL_LOCK_AND_SOAP_ERROR(soapContext);
 
-        // define cancellation flag within LOCK
-        bool* cancelFlag = server->GetCancelFlag();
+        sclwsFlight* flight = session->flight;
 
-        logInfo("Setting cancel flag: true", cancelFlag);
+        if (IS_NOT_NULL(flight))
+        {
+            // coalesced query: only cancel the query execution if no other session is waiting for it
+            if (!session->cancelled)
+            {
+                session->cancelled = true;
+                flight->nbCancelled++;
 
-        // dirty write:
-        *cancelFlag = true;
+                sclwsFlightCheckCancel(flight);
+            }
 
-        /*
-         * Valgrind report:
-        ==12272== Possible data race during write of size 1 at 0x9681920 by thread #8
-        ==12272==    at 0x51362C5: ns__GetCalCancelSession(soap*, char*, bool*) (sclwsWS.cpp:720)
-        ==12272== Possible data race during read of size 1 at 0x9681920 by thread #5
-        ==12272==    at 0x55A521C: vobsIsCancelled() (vobsREMOTE_CATALOG.cpp:76)
-         */
-    }
+            // wake up the waiting session:
+            pthread_cond_broadcast(&sclwsFlightCond);
+        }
+        else
+        {
+            // define cancellation flag within LOCK
+            bool* cancelFlag = session->server->GetCancelFlag();
 
-    STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+            logInfo("Setting cancel flag: true", cancelFlag);
+
+            // dirty write:
+            *cancelFlag = true;
+
+            /*
+             * Valgrind report:
+            ==12272== Possible data race during write of size 1 at 0x9681920 by thread #8
+            ==12272==    at 0x51362C5: ns__GetCalCancelSession(soap*, char*, bool*) (sclwsWS.cpp:720)
+            ==12272== Possible data race during read of size 1 at 0x9681920 by thread #5
+            ==12272==    at 0x55A521C: vobsIsCancelled() (vobsREMOTE_CATALOG.cpp:76)
+             */
+        }
+
+        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+
+        sclwsSessionRelease(session);
+    }
 
     // Cancellation succesfull
     *isOK = true;
@@ -801,12 +1945,60 @@ int ns__GetStar(struct soap* soapContext, char *query, char **output)
         logInfo("GetStar: Accepted connection from IP address '%s'.", connectionIP);
     }
 
-    // Create a new instance of sclsvrSERVER to perform the GETSTAR query
-    sclsvrSERVER* server = new sclsvrSERVER(mcsFALSE);
+    int status = SOAP_OK;
+
+    const char* result = NULL;
+    miscDynSIZE resultSize = 0;
+    miscoDYN_BUF dynBuf;
+    sclsvrSERVER* server = NULL;
+    mcsCOMPL_STAT queryStatus;
+
+    // Streamed response:
+    sclwsStream stream;
+    FILE* streamFile = NULL;
+
+    // Coalesce identical concurrent queries:
+    string key;
+    sclwsFlight* flight = NULL;
+    bool isLeader = true;
+
+    bool cacheable = false;
+
+    if (sclwsGetQueryKey(sclsvrGETSTAR_CMD_NAME, query, key, cacheable) == mcsSUCCESS)
+    {
+        STL_LOCK_AND_SOAP_ERROR(soapContext);
+
+        flight = sclwsFlightJoin(key, NULL, isLeader);
+
+        if (!isLeader)
+        {
+            sclwsServerStatsGetStar.coalesced++;
+        }
+
+        STL_UNLOCK_AND_SOAP_ERROR(soapContext);
+    }
+    else
+    {
+        // invalid query: let the server report the error
+        errResetStack();
+    }
+
+    if (!isLeader)
+    {
+        logWarning("GetStar: same query in progress; waiting for its result : '%s'", query);
+
+        status = sclwsFlightWait(soapContext, flight, NULL, output);
+        goto cleanup;
+    }
+
+    // Get a (pooled) instance of sclsvrSERVER to perform the GETSTAR query
+    server = sclsvrSERVER_POOL::Acquire();
     if (server == NULL)
     {
         errAdd(sclwsERR_SERVER_INSTANCIATION);
-        sclwsReturnSoapError(soapContext);
+        sclwsDefineSoapError(soapContext);
+        status = SOAP_ERR;
+        goto cleanup;
     }
 
     STL_LOCK_AND_SOAP_ERROR(soapContext);
@@ -817,14 +2009,27 @@ int ns__GetStar(struct soap* soapContext, char *query, char **output)
 
     logWarning("GetStar: server instanciated; launching query : '%s'", query);
 
-    int status = SOAP_OK;
-
-    const char* result = NULL;
-    miscDynSIZE resultSize = 0;
+    // Stream the output while it is formatted:
+    streamFile = sclwsStreamOpen(&stream, soapContext, "ns:GetStarResponse", "output", flight, false, &dynBuf);
 
     // Launch the GETSTAR query with the received parameters
-    miscoDYN_BUF dynBuf;
-    if (server->GetStar(query, &dynBuf) == mcsFAILURE)
+    queryStatus = server->GetStar(query, &dynBuf);
+
+    if (sclwsStreamClose(&stream, streamFile, &dynBuf, queryStatus))
+    {
+        logDebug("GetStar: Output streamed");
+
+        if (queryStatus == mcsFAILURE)
+        {
+            // error given to followers:
+            sclwsDefineSoapError(soapContext);
+        }
+        // the response is already sent:
+        status = SOAP_STOP;
+        goto cleanup;
+    }
+
+    if (queryStatus == mcsFAILURE)
     {
         sclwsDefineSoapError(soapContext);
         status = SOAP_ERR;
@@ -850,21 +2055,43 @@ int ns__GetStar(struct soap* soapContext, char *query, char **output)
 
 cleanup:
 
+    if (IS_NOT_NULL(flight))
+    {
+        if (isLeader)
+        {
+            // share the result with followers:
+            if (status == SOAP_STOP)
+            {
+                sclwsFlightComplete(flight, sclwsStreamGetResult(&stream),
+                                    IS_NULL(soapContext->fault) ? NULL : soapContext->fault->faultstring);
+            }
+            else
+            {
+                sclwsFlightComplete(flight, (status == SOAP_OK) ? *output : NULL,
+                                    (status == SOAP_OK) ? NULL : soapContext->fault->faultstring);
+            }
+        }
+        sclwsFlightLeave(flight, NULL);
+    }
+
     logWarning("GetStar: terminating query.");
 
     STL_LOCK_AND_SOAP_ERROR(soapContext);
 
-    sclwsServerStatsGetStar.deleted++;
+    if (IS_NOT_NULL(server))
+    {
+        sclwsServerStatsGetStar.deleted++;
+    }
 
-    if (status == SOAP_ERR)
+    if ((status == SOAP_ERR) || ((status == SOAP_STOP) && !stream.completed))
     {
         sclwsServerStatsGetStar.failed++;
     }
 
     STL_UNLOCK_AND_SOAP_ERROR(soapContext);
 
-    // free Server resources:
-    delete(server);
+    // give back the server instance to the pool:
+    sclsvrSERVER_POOL::Release(server);
 
     return status;
 }
@@ -914,6 +2141,26 @@ int ns__GetServerStatus(struct soap* soapContext, char** status)
     sclwsThreadStats(&threadCreated, &threadJoined);
     out << "Thread  Statistics: " << threadCreated << " created / " << threadJoined << " terminated." << endl;
 
+    // Request lane statistics
+    sclwsLANE_STATS laneStats;
+    for (mcsUINT32 i = 0; sclwsLaneStats(i, &laneStats) == mcsSUCCESS; i++)
+    {
+        out << "Lane[" << laneStats.name << "]: " << laneStats.nbWorkers << " workers (" << laneStats.nbReserved << " reserved, "
+                << laneStats.nbBusy << " busy) / queue "
+                << laneStats.depth << " (max " << laneStats.maxDepth << ", capacity " << laneStats.capacity << ") / "
+                << laneStats.nbQueued << " queued / " << laneStats.nbRejected << " rejected / wait "
+                << laneStats.waitTime << " ms total, " << laneStats.maxWaitTime << " ms max." << endl;
+    }
+
+    // Request latency statistics (per priority class)
+    sclwsPRIORITY_STATS priorityStats;
+    for (mcsUINT32 i = 0; sclwsPriorityStats(i, &priorityStats) == mcsSUCCESS; i++)
+    {
+        out << "Priority[" << priorityStats.name << "]: " << priorityStats.nbRequests << " requests / latency "
+                << priorityStats.meanTime << " ms mean, " << priorityStats.p50Time << " ms p50, "
+                << priorityStats.p99Time << " ms p99, " << priorityStats.maxTime << " ms max." << endl;
+    }
+
     // GetCal statistics
     serverCreated = serverDeleted = serverCancelled = serverFailed = 0;
     sclwsGetCalStats(&serverCreated, &serverDeleted, &serverCancelled, &serverFailed);
@@ -924,6 +2171,86 @@ int ns__GetServerStatus(struct soap* soapContext, char** status)
     sclwsGetStarStats(&serverCreated, &serverDeleted, &serverFailed);
     out << "GetStar Statistics: " << serverCreated << " created / " << serverDeleted << " deleted / " << serverFailed << " failed." << endl;
 
+    // GetCal session statistics
+    mcsUINT32 sessionOpen = 0, sessionCompleted = 0;
+    sclwsSessionStats(&sessionOpen, &sessionCompleted);
+    out << "GetCal  Sessions:   " << sessionOpen << " open / " << sessionCompleted << " completed." << endl;
+
+    // Server pool statistics
+    mcsUINT64 poolCreated = 0, poolReused = 0, poolDeleted = 0;
+    mcsUINT32 poolIdle = 0;
+    mcsDOUBLE poolCreateTime = 0.0, poolAcquireTime = 0.0;
+    sclsvrSERVER_POOL::GetStats(poolCreated, poolReused, poolDeleted, poolIdle, poolCreateTime, poolAcquireTime);
+    out << "Server  Pool:       " << poolCreated << " created / " << poolReused << " reused / " << poolDeleted << " deleted / "
+            << poolIdle << " idle / setup " << poolAcquireTime << " ms avg (creation " << poolCreateTime << " ms avg)." << endl;
+
+    // Request arena statistics
+    vobsARENA_STATS arenaStats;
+    vobsARENA::GetStats(&arenaStats);
+    out << "Request Arena:      " << arenaStats.nbScopes << " requests / " << arenaStats.nbChunks << " chunks ("
+            << (arenaStats.nbChunks - arenaStats.nbFreedChunks) << " in use) / " << arenaStats.nbBlocks << " blocks / "
+            << arenaStats.nbHeapBlocks << " heap blocks." << endl;
+
+    // Coalescing statistics
+    mcsUINT32 getCalCoalesced = 0, getStarCoalesced = 0;
+    sclwsCoalescingStats(&getCalCoalesced, &getStarCoalesced);
+    out << "Coalesced queries:  " << getCalCoalesced << " GetCal / " << getStarCoalesced << " GetStar." << endl;
+
+    // GetCal result cache statistics
+    mcsUINT32 cacheEntries = 0;
+    mcsUINT64 cacheSize = 0, cacheMaxSize = 0, cacheHits = 0, cacheMisses = 0, cacheEvictions = 0;
+    sclwsResultCacheStats(&cacheEntries, &cacheSize, &cacheMaxSize, &cacheHits, &cacheMisses, &cacheEvictions);
+    out << "GetCal  Cache:      " << cacheEntries << " results / " << cacheSize << " bytes (max " << cacheMaxSize << " bytes) / "
+            << cacheHits << " hits / " << cacheMisses << " misses / " << cacheEvictions << " evictions." << endl;
+
+    // Tile cache statistics
+    mcsUINT64 tileHits = 0, tileMisses = 0, tileEvictions = 0, tileBypasses = 0;
+    mcsUINT32 tileStars = 0;
+    vobsTILE_CACHE::GetStats(tileHits, tileMisses, tileEvictions, tileBypasses, tileStars);
+    out << "Tile    Cache:      " << tileStars << " stars / " << tileHits << " hits / " << tileMisses << " misses / "
+            << tileEvictions << " evictions / " << tileBypasses << " bypasses." << endl;
+
+    // Rate limiter statistics (per host)
+    thrdRATE_LIMITER_STATS limiterStats;
+    for (mcsUINT32 i = 0; thrdRateLimiterGetStats(i, &limiterStats) == mcsSUCCESS; i++)
+    {
+        out << "Rate limiter[" << limiterStats.host << "]: " << limiterStats.rate << " queries/s (burst " << limiterStats.burst << ") / "
+                << limiterStats.nbAcquired << " acquired / " << limiterStats.nbRejected << " rejected / "
+                << limiterStats.nbWaits << " waits (" << limiterStats.waitTime << " ms total, " << limiterStats.maxWaitTime << " ms max)." << endl;
+    }
+
+    // Priority gate statistics (CDS queries, gdome, Complete phases)
+    thrdPRIORITY_GATE_STATS gateStats;
+    for (mcsUINT32 i = 0; thrdPriorityGateGetStats(i, &gateStats) == mcsSUCCESS; i++)
+    {
+        out << "Gate[" << gateStats.name << "]: " << gateStats.nbSlots << " slots (" << gateStats.nbReserved << " reserved, "
+                << gateStats.nbUsed << " used) / waits:";
+
+        for (mcsUINT32 p = 0; p < thrdNB_PRIORITIES; p++)
+        {
+            out << ((p == 0) ? " " : ", ") << gateStats.nbWaits[p] << " " << thrdPriorityGetName((thrdPRIORITY) p)
+                    << " (" << gateStats.waitTime[p] << " ms total, " << gateStats.maxWaitTime[p] << " ms max)";
+        }
+        out << "." << endl;
+    }
+
+    // JSDC dataset status
+    sclsvrJSDC_DATA_STATUS jsdcStatus;
+    sclsvrJSDC_DATA::GetStatus(&jsdcStatus);
+    out << "JSDC    Data:       version " << jsdcStatus.version << " / " << jsdcStatus.nbStars
+            << (jsdcStatus.shared ? " stars (shared image) loaded at " : " stars loaded at ")
+            << jsdcStatus.loadDate << " (" << jsdcStatus.loadTime << " ms) / " << jsdcStatus.nbDatasets << " datasets in memory / "
+            << jsdcStatus.nbReloads << " reloads (" << jsdcStatus.nbFailedReloads << " failed)"
+            << (jsdcStatus.reloading ? " / reloading." : ".") << endl;
+
+    // alx table status
+    alxTABLE_STATUS tableStatus;
+    for (mcsUINT32 i = 0; alxGetTableStatus(i, &tableStatus) == mcsSUCCESS; i++)
+    {
+        out << "Table[" << tableStatus.name << "]: " << (IS_TRUE(tableStatus.loaded) ? "loaded" : "not loaded")
+                << " (" << tableStatus.loadTime << " ms)." << endl;
+    }
+
     string content = out.str();
 
     // Return result:
@@ -25,6 +25,26 @@ extern "C"
 #include "mcs.h"
 #include "misc.h"
 
+/**
+ * Information on one object resolved by SIMBAD (see simcliGetCoordinates).
+ */
+typedef struct
+{
+    mcsSTRING256 name;      /** object identifier (input) */
+    mcsLOGICAL   found;     /** mcsTRUE if the object was resolved */
+    mcsSTRING32  ra;        /** RA (sexagesimal) */
+    mcsSTRING32  dec;       /** DEC (sexagesimal) */
+    mcsDOUBLE    pmRa;      /** proper motion in RA (mas/yr) */
+    mcsDOUBLE    pmDec;     /** proper motion in DEC (mas/yr) */
+    mcsDOUBLE    plx;       /** parallax (mas) */
+    mcsDOUBLE    ePlx;      /** parallax error (mas) */
+    mcsDOUBLE    magV;      /** V magnitude */
+    mcsDOUBLE    eMagV;     /** V magnitude error */
+    mcsSTRING64  spType;    /** spectral type */
+    mcsSTRING256 objTypes;  /** object types */
+    mcsSTRING64  mainId;    /** main identifier */
+} simcliOBJECT_INFO;
+
 mcsCOMPL_STAT simcliGetCoordinates(char *name,
                                    char *ra, char *dec,
                                    mcsDOUBLE *pmRa, mcsDOUBLE *pmDec,
@@ -32,6 +52,10 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
                                    mcsDOUBLE *magV, mcsDOUBLE *eMagV,
                                    char *spType, char *objTypes,
                                    char *mainId);
+
+mcsCOMPL_STAT simcliGetCoordinatesBatch(simcliOBJECT_INFO* objects,
+                                        mcsUINT32 nbObjects);
+
 #ifdef __cplusplus
 }
 #endif
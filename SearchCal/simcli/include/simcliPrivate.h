@@ -24,8 +24,39 @@ extern "C"
  */
 #define MODULE_ID "simcli"
 
+/** SIMBAD script service */
+#define simcliSCRIPT_URL    "http://simbad.cds.unistra.fr/simbad/sim-script?script="
+
+/** SIMBAD script header (output options and object format) */
+#define simcliSCRIPT_HEADER                                                 \
+    "output console=off script=off\n"                                       \
+    "format object form1 \""                                                \
+    "%COO(d;A);%COO(d;D);"  /* 0-1: RA and DEC coordinates as sexagesimal values */ \
+    "%PM(A;D);"             /* 2-3: Proper motion with error */             \
+    "%PLX(V;E);"            /* 4-5: Parallax with error */                  \
+    "%FLUXLIST(V;n=F E,) ;"  /* 6: Fluxes(V only) in 'Band=Value Error' format (extra space to avoid missing field ';;' => ';') */ \
+    "%SP(S);"               /* 7: Spectral types enumeration */             \
+    "%OTYPELIST;"           /* 8: Object types enumeration */               \
+    "%MAIN_ID;"             /* 9: Main identifier (display) */              \
+    "\"\n"
+
 
 /* Local functions */
+mcsCOMPL_STAT simcliWaitRateLimit(void);
+
+char* simcliGetDataBlock(char* response);
+
+mcsCOMPL_STAT simcliParseObject(char *response,
+                                char *ra, char *dec,
+                                mcsDOUBLE *pmRa, mcsDOUBLE *pmDec,
+                                mcsDOUBLE *plx, mcsDOUBLE *ePlx,
+                                mcsDOUBLE *magV, mcsDOUBLE *eMagV,
+                                char *spType, char *objTypes,
+                                char *mainId);
+
+mcsCOMPL_STAT simcliParseBatch(char* response,
+                               simcliOBJECT_INFO** objects,
+                               mcsUINT32 nbObjects);
 
 #ifdef __cplusplus
 }
@@ -16,9 +16,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <sys/time.h>
-#include <unistd.h>
+#include <pthread.h>
 
 /*
  * MCS Headers
@@ -39,11 +37,11 @@
 
 /* trace flag */
 #define TRACE               0
-#define TRACE_RATE_LIMIT    0
 
 /* Max request rate (nb / sec) */
 #define MAX_RATE        10
-#define MIN_INTERVAL    (1000 / MAX_RATE)
+/* Max burst (nb) */
+#define MAX_BURST       3
 
 /** simbad error block separator */
 #define MARKER_ERROR    "::error"
@@ -52,24 +50,15 @@
 
 #define MAX_ERROR_LEN   (16 * 1024)
 
-/**
- * Shared mutex to handle max requests to simbad
+/*
+ * Local variables
  */
-thrdMUTEX simcliMutex = MCS_MUTEX_STATIC_INITIALIZER;
 
-#define SIMCLI_LOCK() {                            \
-    if (thrdMutexLock(&simcliMutex) == mcsFAILURE) \
-    {                                              \
-        return mcsFAILURE;                         \
-    }                                              \
-}
+/** rate limiter shared by all SIMBAD clients */
+static thrdRATE_LIMITER* simcliRateLimiter = NULL;
 
-#define SIMCLI_UNLOCK() {                            \
-    if (thrdMutexUnlock(&simcliMutex) == mcsFAILURE) \
-    {                                                \
-        return mcsFAILURE;                           \
-    }                                                \
-}
+/** one-time initialization of the rate limiter */
+static pthread_once_t simcliRateLimiterOnce = PTHREAD_ONCE_INIT;
 
 /*
  * Public functions definition
@@ -100,6 +89,14 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
     strncpy(objTypes, "\0", mcsLEN256 - 1);
     strncpy(mainId, "\0",  mcsLEN64 - 1);
 
+    /* Reject line breaks (new script commands) */
+    if (strpbrk(name, "\r\n") != NULL)
+    {
+        miscDynBufDestroy(&url);
+        miscDynBufDestroy(&result);
+        return mcsFAILURE;
+    }
+
     /* Replace '_' by ' ' */
     char starName[256];
     char* p;
@@ -111,18 +108,9 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
         p = strchr(starName, '_');
     }
 
-    FAIL(miscDynBufAppendString(&url, "http://simbad.cds.unistra.fr/simbad/sim-script?script="));
-
-    char* script = miscUrlEncode("output console=off script=off\n"
-                                 "format object form1 \""
-                                 "%COO(d;A);%COO(d;D);"  /* 0-1: RA and DEC coordinates as sexagesimal values */
-                                 "%PM(A;D);"             /* 2-3: Proper motion with error */
-                                 "%PLX(V;E);"            /* 4-5: Parallax with error */
-                                 "%FLUXLIST(V;n=F E,) ;"  /* 6: Fluxes(V only) in 'Band=Value Error' format (extra space to avoid missing field ';;' => ';') */
-                                 "%SP(S);"               /* 7: Spectral types enumeration */
-                                 "%OTYPELIST;"           /* 8: Object types enumeration */
-                                 "%MAIN_ID;"             /* 9: Main identifier (display) */
-                                 "\"\n"
+    FAIL(miscDynBufAppendString(&url, simcliSCRIPT_URL));
+
+    char* script = miscUrlEncode(simcliSCRIPT_HEADER
                                  "query id ");
     FAIL(miscDynBufAppendString(&url, script));
     free(script);
@@ -134,33 +122,7 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
     if (TRACE) printf("querying SIMBAD ... (%s)\n", miscDynBufGetBuffer(&url));
 
     /* Call simbad but check rate limiter ~ 10 query/second */
-    static long lastTimeMs = 0L;
-    long timeMs = 0L;
-    struct timeval time;
-
-    /* may wait and block lock for other queries */
-    SIMCLI_LOCK();
-
-    /* Get local time */
-    gettimeofday(&time, NULL);
-    timeMs = time.tv_sec * 1000L + time.tv_usec / 1000L;
-
-    if (lastTimeMs != 0L)
-    {
-        long deltaMs = timeMs - lastTimeMs;
-        if (TRACE_RATE_LIMIT) printf("Rate limiter: deltaMs: %ld ms\n", deltaMs);
-
-        if (deltaMs < MIN_INTERVAL)
-        {
-            long timeToSleep = (MIN_INTERVAL - deltaMs);
-
-            if (TRACE_RATE_LIMIT) printf("Rate limiter: sleep: %ld ms\n", timeToSleep);
-            usleep(timeToSleep * 1000L);
-        }
-    }
-    lastTimeMs = timeMs;
-
-    SIMCLI_UNLOCK();
+    FAIL(simcliWaitRateLimit());
 
     /** TODO: retry (3) */
 
@@ -178,6 +140,63 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
     char* response = miscDynBufGetBuffer(&result);
     logDebug("SIMBAD Response:\n%s\n---\n", response);
 
+    /* Skip the error block (if any) */
+    response = simcliGetDataBlock(response);
+    if (response == NULL)
+    {
+        miscDynBufDestroy(&result);
+        return mcsFAILURE;
+    }
+
+    /* Parsing result: */
+    mcsCOMPL_STAT status = simcliParseObject(response, ra, dec, pmRa, pmDec, plx, ePlx,
+                                             magV, eMagV, spType, objTypes, mainId);
+
+    miscDynBufDestroy(&result);
+    return status;
+}
+
+/*
+ * Private functions definition
+ */
+
+/**
+ * Get the rate limiter shared by all SIMBAD clients (called once).
+ */
+static void simcliRateLimiterInit(void)
+{
+    simcliRateLimiter = thrdRateLimiterGet(simcliSCRIPT_URL, MAX_RATE, MAX_BURST);
+    if (simcliRateLimiter == NULL)
+    {
+        errCloseStack();
+    }
+}
+
+/**
+ * Wait until a new SIMBAD query is allowed by the rate limiter shared by all
+ * SIMBAD clients (MAX_RATE queries per second, MAX_BURST queries at once).
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT simcliWaitRateLimit(void)
+{
+    pthread_once(&simcliRateLimiterOnce, simcliRateLimiterInit);
+
+    FAIL_NULL(simcliRateLimiter);
+
+    return thrdRateLimiterAcquire(simcliRateLimiter);
+}
+
+/**
+ * Return the data block of the given SIMBAD script response; the error block
+ * (if any) is logged.
+ *
+ * @param response SIMBAD script response
+ *
+ * @return pointer to the data block or NULL if there is no data
+ */
+char* simcliGetDataBlock(char* response)
+{
     /* If there was an error during query */
     char* posStart = strstr(response, MARKER_ERROR);
     if (posStart != NULL)
@@ -218,21 +237,36 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
         /* try to get data block: */
         if (posEnd == responseEnd)
         {
-            miscDynBufDestroy(&result);
-            return mcsFAILURE;
+            return NULL;
         }
 
         posStart = strstr(posEnd, "\n");
         if (posStart == NULL)
         {
-            miscDynBufDestroy(&result);
-            return mcsFAILURE;
+            return NULL;
         }
         /* fix data stream: */
         response = posStart;
     }
+    return response;
+}
 
-    /* Parsing result: */
+/**
+ * Parse one SIMBAD record (simcliSCRIPT_HEADER format) into the given outputs.
+ *
+ * @param response record(s) to parse (modified)
+ *
+ * @return mcsSUCCESS on successful completion or mcsFAILURE if the response
+ * contains several records.
+ */
+mcsCOMPL_STAT simcliParseObject(char *response,
+                                char *ra, char *dec,
+                                mcsDOUBLE *pmRa, mcsDOUBLE *pmDec,
+                                mcsDOUBLE *plx, mcsDOUBLE *ePlx,
+                                mcsDOUBLE *magV, mcsDOUBLE *eMagV,
+                                char *spType, char *objTypes,
+                                char *mainId)
+{
     char *token;
     int fieldIndex = 0;
 
@@ -315,7 +349,6 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
                     }
                     break;
                 default:
-                    miscDynBufDestroy(&result);
                     return mcsSUCCESS;
             }
         }
@@ -325,11 +358,9 @@ mcsCOMPL_STAT simcliGetCoordinates(char *name,
         if ((token != NULL) && (token[0] == '\n') && (fieldIndex != 0))
         {
             logError("SIMBAD Response may have several entries:\n%s\n---\n", response);
-            miscDynBufDestroy(&result);
             return mcsFAILURE;
         }
     }
-    miscDynBufDestroy(&result);
     return mcsSUCCESS;
 }
 /*___oOo___*/
@@ -0,0 +1,533 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Batched SIMBAD name resolution (one script query for many identifiers)
+ * with an in-memory cache of resolved names (not persisted: filled again after
+ * a restart).
+ */
+
+
+/*
+ * System Headers
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "err.h"
+#include "log.h"
+#include "miscHash.h"
+#include "miscNetwork.h"
+#include "thrd.h"
+
+
+/*
+ * Local Headers
+ */
+#include "simcli.h"
+#include "simcliPrivate.h"
+
+
+/* trace flag */
+#define TRACE               0
+
+/** Max number of identifiers per SIMBAD script query */
+#define SIMCLI_BATCH_SIZE   50
+
+/** object marker echoed before each object in the SIMBAD data block */
+#define MARKER_OBJECT       "simcliObject="
+
+/** Time to live of resolved names in the cache (1 day) */
+#define CACHE_TTL           86400
+/** Max number of resolved names in the cache (oldest evicted first) */
+#define CACHE_MAX_SIZE      10000
+/** Hash table size */
+#define CACHE_TABLE_SIZE    4096
+
+/**
+ * Cached resolved name
+ */
+typedef struct
+{
+    simcliOBJECT_INFO info;
+    time_t            time;
+    mcsUINT32         slot;     /** slot of its key in the insertion ring */
+} simcliCACHE_ENTRY;
+
+/**
+ * Shared mutex to protect the resolved name cache
+ */
+thrdMUTEX simcliCacheMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+static miscHASH_TABLE simcliCache;
+static mcsLOGICAL simcliCacheCreated = mcsFALSE;
+static mcsUINT32 simcliCacheSize = 0;
+
+/** keys of the cached names in insertion order (ring) to evict the oldest ones */
+static char* simcliCacheKeys[CACHE_MAX_SIZE];
+static mcsUINT32 simcliCacheNextSlot = 0;
+
+#define SIMCLI_CACHE_LOCK() {                           \
+    if (thrdMutexLock(&simcliCacheMutex) == mcsFAILURE) \
+    {                                                   \
+        return mcsFAILURE;                              \
+    }                                                   \
+}
+
+#define SIMCLI_CACHE_UNLOCK() {                           \
+    if (thrdMutexUnlock(&simcliCacheMutex) == mcsFAILURE) \
+    {                                                     \
+        return mcsFAILURE;                                \
+    }                                                     \
+}
+
+/*
+ * Local functions declaration
+ */
+static void simcliResetObject(simcliOBJECT_INFO* object);
+static mcsLOGICAL simcliGetCacheKey(const char* name, mcsSTRING256 key);
+static mcsCOMPL_STAT simcliCacheGet(simcliOBJECT_INFO* object);
+static mcsCOMPL_STAT simcliCachePut(const simcliOBJECT_INFO* object);
+static mcsCOMPL_STAT simcliQueryBatch(simcliOBJECT_INFO** objects, mcsUINT32 nbObjects);
+
+
+/*
+ * Public functions definition
+ */
+
+/**
+ * Resolve the given objects using SIMBAD: identifiers not found in the cache
+ * are sent by chunks of SIMCLI_BATCH_SIZE in one SIMBAD script query; objects
+ * giving no or several records are not found (as simcliGetCoordinates).
+ * If a batched query fails (SIMBAD error or incomplete response), the
+ * unresolved objects of its chunk are resolved one by one using
+ * simcliGetCoordinates. Identifiers containing line breaks are not found.
+ *
+ * @param objects objects to resolve (name set by the caller)
+ * @param nbObjects number of objects
+ *
+ * @return mcsSUCCESS on successful completion (see the found flag of each
+ * object). Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT simcliGetCoordinatesBatch(simcliOBJECT_INFO* objects,
+                                        mcsUINT32 nbObjects)
+{
+    mcsUINT32 i, nbPending = 0;
+
+    simcliOBJECT_INFO** pending = (simcliOBJECT_INFO**) malloc(nbObjects * sizeof (simcliOBJECT_INFO*));
+    FAIL_NULL(pending);
+
+    /* 1. cached names */
+    for (i = 0; i < nbObjects; i++)
+    {
+        simcliResetObject(&objects[i]);
+
+        mcsSTRING256 key;
+        if (IS_FALSE(simcliGetCacheKey(objects[i].name, key)))
+        {
+            /* not found */
+            logWarning("Invalid SIMBAD identifier (line break): '%.80s'", objects[i].name);
+            continue;
+        }
+        if (simcliCacheGet(&objects[i]) == mcsFAILURE)
+        {
+            free(pending);
+            return mcsFAILURE;
+        }
+        if (IS_FALSE(objects[i].found))
+        {
+            pending[nbPending++] = &objects[i];
+        }
+    }
+
+    logDebug("simcliGetCoordinatesBatch: %u objects (%u cached)", nbObjects, nbObjects - nbPending);
+
+    /* 2. batched queries (chunks) */
+    for (i = 0; i < nbPending; i += SIMCLI_BATCH_SIZE)
+    {
+        mcsUINT32 j, nb = mcsMIN(SIMCLI_BATCH_SIZE, nbPending - i);
+
+        if (simcliQueryBatch(&pending[i], nb) == mcsFAILURE)
+        {
+            /* partial error: resolve the unresolved objects of this chunk one by one */
+            errCloseStack();
+
+            logWarning("SIMBAD batch query failed: resolving %u objects one by one", nb);
+
+            for (j = i; j < i + nb; j++)
+            {
+                simcliOBJECT_INFO* object = pending[j];
+
+                if (IS_FALSE(object->found))
+                {
+                    if (simcliGetCoordinates(object->name, object->ra, object->dec,
+                                             &object->pmRa, &object->pmDec,
+                                             &object->plx, &object->ePlx,
+                                             &object->magV, &object->eMagV,
+                                             object->spType, object->objTypes,
+                                             object->mainId) == mcsSUCCESS)
+                    {
+                        object->found = mcsTRUE;
+                    }
+                    else
+                    {
+                        /* not found */
+                        errResetStack();
+                        simcliResetObject(object);
+                    }
+                }
+            }
+        }
+
+        for (j = i; j < i + nb; j++)
+        {
+            if (IS_TRUE(pending[j]->found) && (simcliCachePut(pending[j]) == mcsFAILURE))
+            {
+                free(pending);
+                return mcsFAILURE;
+            }
+        }
+    }
+
+    free(pending);
+    return mcsSUCCESS;
+}
+
+
+/*
+ * Local functions definition
+ */
+
+/**
+ * Reset the outputs of the given object (like simcliGetCoordinates).
+ * @param object object to reset
+ */
+static void simcliResetObject(simcliOBJECT_INFO* object)
+{
+    object->found = mcsFALSE;
+    object->ra[0] = '\0';
+    object->dec[0] = '\0';
+    object->pmRa = NAN;
+    object->pmDec = NAN;
+    object->plx = NAN;
+    object->ePlx = NAN;
+    object->magV = NAN;
+    object->eMagV = NAN;
+    object->spType[0] = '\0';
+    object->objTypes[0] = '\0';
+    object->mainId[0] = '\0';
+}
+
+/**
+ * Return the cache key of the given name ('_' replaced by ' ' as SIMBAD does).
+ * @param name object identifier
+ * @param key cache key (also the identifier sent to SIMBAD)
+ * @return mcsFALSE if the name contains line breaks (new script commands),
+ * mcsTRUE otherwise
+ */
+static mcsLOGICAL simcliGetCacheKey(const char* name, mcsSTRING256 key)
+{
+    char* p;
+
+    if (strpbrk(name, "\r\n") != NULL)
+    {
+        key[0] = '\0';
+        return mcsFALSE;
+    }
+    strncpy(key, name, mcsLEN256 - 1);
+    key[mcsLEN256 - 1] = '\0';
+
+    p = strchr(key, '_');
+    while (p != NULL)
+    {
+        *p = ' ';
+        p = strchr(key, '_');
+    }
+    return mcsTRUE;
+}
+
+/**
+ * Get the given object from the cache (found flag set if cached).
+ * @param object object to look up
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT simcliCacheGet(simcliOBJECT_INFO* object)
+{
+    mcsSTRING256 key;
+    simcliGetCacheKey(object->name, key);
+
+    SIMCLI_CACHE_LOCK();
+
+    if (IS_TRUE(simcliCacheCreated))
+    {
+        simcliCACHE_ENTRY* entry = (simcliCACHE_ENTRY*) miscHashGetElement(&simcliCache, key);
+
+        if (entry != NULL)
+        {
+            if (time(NULL) - entry->time < CACHE_TTL)
+            {
+                mcsSTRING256 name;
+                strcpy(name, object->name);
+
+                *object = entry->info;
+                /* keep the given name */
+                strcpy(object->name, name);
+            }
+            else if (miscHashDeleteElement(&simcliCache, key) == mcsSUCCESS)
+            {
+                simcliCacheSize--;
+            }
+        }
+    }
+
+    SIMCLI_CACHE_UNLOCK();
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Put the given (resolved) object in the cache.
+ * @param object object to store
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT simcliCachePut(const simcliOBJECT_INFO* object)
+{
+    mcsSTRING256 key;
+    simcliGetCacheKey(object->name, key);
+
+    simcliCACHE_ENTRY* entry = (simcliCACHE_ENTRY*) malloc(sizeof (simcliCACHE_ENTRY));
+    FAIL_NULL(entry);
+    entry->info = *object;
+    entry->time = time(NULL);
+
+    SIMCLI_CACHE_LOCK();
+
+    mcsCOMPL_STAT status = mcsSUCCESS;
+
+    if (IS_FALSE(simcliCacheCreated))
+    {
+        status = miscHashCreate(&simcliCache, CACHE_TABLE_SIZE);
+        if (status == mcsSUCCESS)
+        {
+            simcliCacheCreated = mcsTRUE;
+            simcliCacheSize = 0;
+        }
+    }
+    if (status == mcsSUCCESS)
+    {
+        simcliCACHE_ENTRY* present = (simcliCACHE_ENTRY*) miscHashGetElement(&simcliCache, key);
+
+        if (present != NULL)
+        {
+            /* update the cached name (same slot) */
+            present->info = entry->info;
+            present->time = entry->time;
+            free(entry);
+        }
+        else
+        {
+            const mcsUINT32 slot = simcliCacheNextSlot;
+
+            /* evict the oldest name (if still cached in this slot) */
+            if (simcliCacheKeys[slot] != NULL)
+            {
+                simcliCACHE_ENTRY* oldest = (simcliCACHE_ENTRY*) miscHashGetElement(&simcliCache, simcliCacheKeys[slot]);
+
+                if ((oldest != NULL) && (oldest->slot == slot)
+                    && (miscHashDeleteElement(&simcliCache, simcliCacheKeys[slot]) == mcsSUCCESS))
+                {
+                    simcliCacheSize--;
+                }
+                free(simcliCacheKeys[slot]);
+                simcliCacheKeys[slot] = NULL;
+            }
+
+            simcliCacheNextSlot = (slot + 1) % CACHE_MAX_SIZE;
+
+            entry->slot = slot;
+            status = miscHashAddElement(&simcliCache, key, (void**) &entry, mcsTRUE);
+            if (status == mcsSUCCESS)
+            {
+                simcliCacheKeys[slot] = strdup(key);
+                simcliCacheSize++;
+            }
+            else
+            {
+                free(entry);
+            }
+        }
+    }
+    else
+    {
+        free(entry);
+    }
+
+    SIMCLI_CACHE_UNLOCK();
+
+    return status;
+}
+
+/**
+ * Resolve the given objects using one SIMBAD script query: each query is
+ * preceded by an echoed object marker to split the data block per object.
+ *
+ * @param objects objects to resolve
+ * @param nbObjects number of objects
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+static mcsCOMPL_STAT simcliQueryBatch(simcliOBJECT_INFO** objects, mcsUINT32 nbObjects)
+{
+    miscDYN_BUF script;
+    miscDYN_BUF url;
+    miscDYN_BUF result;
+    mcsSTRING256 starName;
+    mcsSTRING32 marker;
+    mcsUINT32 i;
+
+    FAIL(miscDynBufInit(&script));
+    FAIL(miscDynBufAppendString(&script, simcliSCRIPT_HEADER));
+
+    for (i = 0; i < nbObjects; i++)
+    {
+        simcliGetCacheKey(objects[i]->name, starName);
+
+        snprintf(marker, mcsLEN32 - 1, "echodata " MARKER_OBJECT "%u\n", i);
+        FAIL_DO(miscDynBufAppendString(&script, marker), miscDynBufDestroy(&script));
+        FAIL_DO(miscDynBufAppendString(&script, "query id "), miscDynBufDestroy(&script));
+        FAIL_DO(miscDynBufAppendString(&script, starName), miscDynBufDestroy(&script));
+        FAIL_DO(miscDynBufAppendString(&script, "\n"), miscDynBufDestroy(&script));
+    }
+
+    char* encoded = miscUrlEncode(miscDynBufGetBuffer(&script));
+    miscDynBufDestroy(&script);
+    FAIL_NULL(encoded);
+
+    FAIL_DO(miscDynBufInit(&url), free(encoded));
+    FAIL_DO(miscDynBufAppendString(&url, simcliSCRIPT_URL), free(encoded); miscDynBufDestroy(&url));
+    FAIL_DO(miscDynBufAppendString(&url, encoded), free(encoded); miscDynBufDestroy(&url));
+    free(encoded);
+
+    if (TRACE) printf("querying SIMBAD ... (%s)\n", miscDynBufGetBuffer(&url));
+
+    /* Call simbad but check rate limiter ~ 10 query/second */
+    FAIL_DO(simcliWaitRateLimit(), miscDynBufDestroy(&url));
+
+    FAIL_DO(miscDynBufInit(&result), miscDynBufDestroy(&url));
+
+    mcsINT8 executionStatus = miscPerformHttpGet(miscDynBufGetBuffer(&url), &result, 0);
+
+    miscDynBufDestroy(&url);
+
+    if (executionStatus != 0)
+    {
+        miscDynBufDestroy(&result);
+        return mcsFAILURE;
+    }
+
+    char* response = miscDynBufGetBuffer(&result);
+    logDebug("SIMBAD Response:\n%s\n---\n", response);
+
+    /* Skip the error block (if any) */
+    response = simcliGetDataBlock(response);
+
+    mcsCOMPL_STAT status = (response != NULL) ? simcliParseBatch(response, objects, nbObjects) : mcsFAILURE;
+
+    miscDynBufDestroy(&result);
+    return status;
+}
+
+/**
+ * Parse the data block of a batched SIMBAD script query: records following
+ * the object marker i belong to the object i; only objects having exactly
+ * one record are resolved.
+ *
+ * @param response data block (modified)
+ * @param objects objects to resolve
+ * @param nbObjects number of objects
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned
+ * (object markers missing i.e. incomplete response).
+ */
+mcsCOMPL_STAT simcliParseBatch(char* response, simcliOBJECT_INFO** objects, mcsUINT32 nbObjects)
+{
+    const mcsUINT32 markerLen = strlen(MARKER_OBJECT);
+    mcsINT32 index = -1;
+    mcsUINT32 nbMarkers = 0;
+    mcsUINT32 nbRecords = 0;
+    char* record = NULL;
+    char* line = response;
+    char* next;
+
+    /* loop on lines (and a final pass to flush the last object) */
+    do
+    {
+        next = NULL;
+        if (line != NULL)
+        {
+            next = strchr(line, '\n');
+            if (next != NULL)
+            {
+                *next++ = '\0';
+            }
+        }
+
+        if ((line == NULL) || (strncmp(line, MARKER_OBJECT, markerLen) == 0))
+        {
+            /* flush the current object */
+            if ((index >= 0) && (index < (mcsINT32) nbObjects) && (nbRecords == 1))
+            {
+                simcliOBJECT_INFO* object = objects[index];
+
+                if (simcliParseObject(record, object->ra, object->dec,
+                                      &object->pmRa, &object->pmDec,
+                                      &object->plx, &object->ePlx,
+                                      &object->magV, &object->eMagV,
+                                      object->spType, object->objTypes,
+                                      object->mainId) == mcsSUCCESS)
+                {
+                    object->found = mcsTRUE;
+                }
+                else
+                {
+                    simcliResetObject(object);
+                }
+            }
+            if (line == NULL)
+            {
+                break;
+            }
+            index = atoi(line + markerLen);
+            nbMarkers++;
+            nbRecords = 0;
+            record = NULL;
+        }
+        else if ((index >= 0) && (strspn(line, " \t\r") != strlen(line)))
+        {
+            /* record (non empty line) */
+            nbRecords++;
+            record = line;
+        }
+
+        line = next;
+    }
+    while (1);
+
+    if (nbMarkers != nbObjects)
+    {
+        logError("SIMBAD Response is incomplete: %u / %u objects", nbMarkers, nbObjects);
+        return mcsFAILURE;
+    }
+    return mcsSUCCESS;
+}
+
+/*___oOo___*/
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Test the parsing of a recorded batched SIMBAD script response.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * Local Headers
+ */
+#include "simcli.h"
+#include "simcliPrivate.h"
+
+/* Number of objects in the recorded response */
+#define NB_OBJECTS 4
+
+/*
+ * Recorded response of a batched query (vega, unknown name, ambiguous name,
+ * sirius); the unknown name gives an error and no record.
+ */
+static const char* RESPONSE =
+    "::error:::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::\n"
+    "\n"
+    "[8] Identifier not found in the database : NAME NOT A STAR\n"
+    "\n"
+    "::data::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::\n"
+    "\n"
+    "simcliObject=0\n"
+    "279.23473479;+38.78368896;200.94;286.23;130.23;0.36;V=0.03 0.01, ;A0Va;*,dS*,IR,UV,;* alf Lyr;\n"
+    "simcliObject=1\n"
+    "simcliObject=2\n"
+    "10.68470833;+41.26875000;~;~;~;~;V=3.44 ~, ;~;G,IR,;M  31;\n"
+    "10.67470833;+41.26875000;~;~;~;~;V=4.36 ~, ;~;G,;M  32;\n"
+    "simcliObject=3\n"
+    "101.28715533;-16.71611586;-546.01;-1223.07;379.21;1.58;V=-1.46 0.01, ;A1V+DA;*,SB*,IR,;* alf CMa;\n"
+    "\n";
+
+/*
+ * Local functions
+ */
+
+/* parse the given recorded response into the given objects */
+static mcsCOMPL_STAT parse(const char* recorded, simcliOBJECT_INFO* objects, mcsUINT32 nbObjects)
+{
+    simcliOBJECT_INFO* pointers[NB_OBJECTS];
+    mcsUINT32 i;
+
+    for (i = 0; i < nbObjects; i++)
+    {
+        memset(&objects[i], 0, sizeof (simcliOBJECT_INFO));
+        objects[i].found = mcsFALSE;
+        pointers[i] = &objects[i];
+    }
+
+    char* response = strdup(recorded);
+    char* data = simcliGetDataBlock(response);
+
+    mcsCOMPL_STAT status = (data != NULL) ? simcliParseBatch(data, pointers, nbObjects) : mcsFAILURE;
+
+    free(response);
+    return status;
+}
+
+
+/*
+ * Main
+ */
+
+int main(int argc, char *argv[])
+{
+    simcliOBJECT_INFO objects[NB_OBJECTS];
+
+    /* Initializes MCS services */
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        /* Exit from the application with FAILURE */
+        exit(EXIT_FAILURE);
+    }
+
+    /* 1. complete response */
+    if (parse(RESPONSE, objects, NB_OBJECTS) == mcsFAILURE)
+    {
+        printf("Recorded response not parsed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Object[0]: found=%d ra='%s' dec='%s' plx=%.2lf V=%.2lf spType='%s' mainId='%s'\n",
+           objects[0].found, objects[0].ra, objects[0].dec, objects[0].plx, objects[0].magV,
+           objects[0].spType, objects[0].mainId);
+    printf("Object[3]: found=%d ra='%s' dec='%s' plx=%.2lf V=%.2lf spType='%s' mainId='%s'\n",
+           objects[3].found, objects[3].ra, objects[3].dec, objects[3].plx, objects[3].magV,
+           objects[3].spType, objects[3].mainId);
+
+    if (IS_FALSE(objects[0].found) || (strcmp(objects[0].mainId, "* alf Lyr") != 0)
+        || (strcmp(objects[0].ra, "18 36 56.3363496") != 0) || (objects[0].magV != 0.03))
+    {
+        printf("Object[0] not resolved\n");
+        exit(EXIT_FAILURE);
+    }
+    if (IS_TRUE(objects[1].found))
+    {
+        printf("Object[1] (unknown) resolved\n");
+        exit(EXIT_FAILURE);
+    }
+    if (IS_TRUE(objects[2].found))
+    {
+        printf("Object[2] (several records) resolved\n");
+        exit(EXIT_FAILURE);
+    }
+    if (IS_FALSE(objects[3].found) || (strcmp(objects[3].mainId, "* alf CMa") != 0)
+        || (strcmp(objects[3].spType, "A1V+DA") != 0))
+    {
+        printf("Object[3] not resolved\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* 2. truncated response (last object missing): failure, not 'not found' */
+    char truncated[2048];
+    strcpy(truncated, RESPONSE);
+    *strstr(truncated, "simcliObject=3") = '\0';
+
+    if (parse(truncated, objects, NB_OBJECTS) == mcsSUCCESS)
+    {
+        printf("Truncated response accepted\n");
+        exit(EXIT_FAILURE);
+    }
+    errResetStack();
+
+    /* 3. identifier with a line break (script injection): not found without query */
+    simcliOBJECT_INFO injected;
+    strcpy(injected.name, "vega\nquery id sirius");
+
+    if ((simcliGetCoordinatesBatch(&injected, 1) == mcsFAILURE) || IS_TRUE(injected.found))
+    {
+        printf("Identifier with a line break resolved\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Recorded response parsed\n");
+
+    /* Close MCS services */
+    mcsExit();
+
+    /* Exit from the application with SUCCESS */
+    exit(EXIT_SUCCESS);
+}
+
+
+/*___oOo___*/
@@ -26,6 +26,8 @@
 #include "vobsGENERIC_FILTER.h"
 #include "vobsMAGNITUDE_FILTER.h"
 #include "vobsORIGIN_FILTER.h"
+#include "vobsTILE_CACHE.h"
+#include "vobsARENA.h"
 
 #endif /*!vobs_H*/
 
@@ -0,0 +1,214 @@
+#ifndef vobsARENA_H
+#define vobsARENA_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of vobsARENA class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * System header
+ */
+#include <stddef.h>
+#include <new>
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+/** Arena chunk size (bytes): above the malloc mmap threshold so that freed chunks are given back to the system */
+#define vobsARENA_CHUNK_SIZE        (1024 * 1024)
+
+/** Maximum block size (bytes) allocated in arena chunks (larger blocks are allocated in the heap) */
+#define vobsARENA_MAX_BLOCK_SIZE    (64 * 1024)
+
+/*
+ * Type declaration
+ */
+
+/**
+ * Arena statistics
+ */
+typedef struct
+{
+    mcsUINT64 nbScopes;         /** number of request scopes */
+    mcsUINT64 nbChunks;         /** number of allocated chunks */
+    mcsUINT64 nbFreedChunks;    /** number of freed chunks */
+    mcsUINT64 nbBlocks;         /** number of blocks allocated in chunks */
+    mcsUINT64 nbHeapBlocks;     /** number of blocks allocated in the heap */
+} vobsARENA_STATS;
+
+/*
+ * Class declaration
+ */
+
+/**
+ * vobsARENA is a request-scoped allocator for the many small objects created
+ * while processing a query (stars, property arrays, string values, star list
+ * and crossmatch map nodes).
+ *
+ * When a vobsARENA_SCOPE is active on the current thread, blocks are carved
+ * (bump pointer) from large chunks owned by the scope; otherwise they are
+ * allocated in the heap. Each chunk counts its live blocks (plus one reference
+ * for its scope) and is freed as a whole once the scope ended and all its
+ * blocks were freed: objects outliving the request (cached copies) remain
+ * valid as they only keep their chunk alive.
+ *
+ * Memory is therefore given back per chunk, not at the end of the scope: the
+ * release is not O(1) and a single surviving block pins its whole chunk
+ * (vobsARENA_CHUNK_SIZE). Long-lived data (caches, local catalogs, pooled
+ * servers) must be allocated in the heap using vobsARENA_SCOPE(false).
+ *
+ * Blocks may be freed by any thread.
+ */
+class vobsARENA
+{
+public:
+    // Allocate a block (in the current arena or in the heap) or return NULL
+    static void* Allocate(size_t size);
+
+    /**
+     * Allocate a block (in the current arena or in the heap)
+     * @param size block size
+     * @return allocated block
+     * @throw std::bad_alloc if no memory is available
+     */
+    inline static void* New(size_t size) __attribute__ ((always_inline))
+    {
+        void* ptr = Allocate(size);
+        if (ptr == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    // Free the given block (allocated by Allocate() or New())
+    static void Free(void* ptr);
+
+    // Return the arena statistics
+    static void GetStats(vobsARENA_STATS* stats);
+
+private:
+    // Declaration of constructors and assignment operator as private
+    // methods, in order to hide them from the users.
+    vobsARENA();
+    vobsARENA(const vobsARENA&);
+    vobsARENA& operator=(const vobsARENA&) ;
+} ;
+
+/**
+ * vobsARENA_SCOPE installs a new arena on the current thread (or the heap if
+ * useArena is false) until it is destroyed; scopes can be nested.
+ */
+class vobsARENA_SCOPE
+{
+public:
+    explicit vobsARENA_SCOPE(bool useArena = true);
+    ~vobsARENA_SCOPE();
+
+    /** per-thread allocation state */
+    struct State
+    {
+        bool  useArena;         /** true to allocate in chunks */
+        void* chunk;            /** current chunk or NULL */
+    } ;
+
+private:
+    // Declaration of copy constructor and assignment operator as private
+    // methods, in order to hide them from the users.
+    vobsARENA_SCOPE(const vobsARENA_SCOPE&);
+    vobsARENA_SCOPE& operator=(const vobsARENA_SCOPE&) ;
+
+    State  _state;
+    State* _previous;
+} ;
+
+/**
+ * STL allocator using vobsARENA (star lists and crossmatch maps)
+ */
+template <class T>
+class vobsARENA_ALLOCATOR
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef vobsARENA_ALLOCATOR<U> other;
+    } ;
+
+    vobsARENA_ALLOCATOR() throw () { }
+
+    vobsARENA_ALLOCATOR(const vobsARENA_ALLOCATOR&) throw () { }
+
+    template <class U>
+    vobsARENA_ALLOCATOR(const vobsARENA_ALLOCATOR<U>&) throw () { }
+
+    pointer address(reference x) const
+    {
+        return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+        return &x;
+    }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer> (vobsARENA::New(n * sizeof (T)));
+    }
+
+    void deallocate(pointer p, size_type)
+    {
+        vobsARENA::Free(p);
+    }
+
+    size_type max_size() const throw ()
+    {
+        return size_t(-1) / sizeof (T);
+    }
+
+    void construct(pointer p, const T& val)
+    {
+        new((void*) p) T(val);
+    }
+
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+} ;
+
+template <class T, class U>
+inline bool operator==(const vobsARENA_ALLOCATOR<T>&, const vobsARENA_ALLOCATOR<U>&)
+{
+    return true;
+}
+
+template <class T, class U>
+inline bool operator!=(const vobsARENA_ALLOCATOR<T>&, const vobsARENA_ALLOCATOR<U>&)
+{
+    return false;
+}
+
+#endif /*!vobsARENA_H*/
+
+
+/*___oOo___*/
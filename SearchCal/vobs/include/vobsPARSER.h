@@ -22,6 +22,15 @@
 /** Time out (in seconds) to get the CDS XML file */
 #define vobsTIME_OUT 600
 
+/** Max request rate to one VizieR host (nb / sec) */
+#define vobsMAX_RATE 20
+/** Max burst of requests to one VizieR host (nb) */
+#define vobsMAX_BURST 10
+/** Max concurrent queries to the CDS (all requests) */
+#define vobsMAX_QUERIES 10
+/** Concurrent queries reserved to interactive requests (see thrdPriorityGate) */
+#define vobsRESERVED_QUERIES 2
+
 /*
  * header files
  */
@@ -32,6 +32,9 @@ mcsLOGICAL vobsGetLowMemFlag();
 /* Return mcsTRUE if the deprecated flag is enabled (env var); mcsFALSE otherwise */
 mcsLOGICAL vobsGetDeprecatedFlag();
 
+/* Return mcsTRUE if the tile cache flag is enabled (env var); mcsFALSE otherwise */
+mcsLOGICAL vobsGetTileCacheFlag();
+
 /**
  * Fast strcat alternative (destination and source MUST not overlap)
  * No buffer overflow checks
@@ -32,6 +32,7 @@ void vobsFreeVizierURI();
 
 /* Cancel flag stored in thread local storage */
 bool vobsIsCancelled(void);
+bool* vobsGetCancelFlag(void);
 void vobsSetCancelFlag(bool* cancelFlag);
 
 /* Thread Cancel Flag handling */
@@ -69,11 +70,23 @@ public:
     mcsCOMPL_STAT PostProcessList(vobsSTAR_LIST &list);
 
 private:
+    /* vobsREMOTE_TILE_FETCHER is a friend class to fetch sky tiles (FetchTile) */
+    friend class vobsREMOTE_TILE_FETCHER;
+
     // Declaration of assignment operator as private
     // method, in order to hide them from the users.
     vobsREMOTE_CATALOG& operator=(const vobsCATALOG&) ;
     vobsREMOTE_CATALOG(const vobsCATALOG&);
 
+    // Method to serve the primary request from the sky tile cache
+    mcsCOMPL_STAT SearchTiles(vobsSCENARIO_RUNTIME &ctx, vobsREQUEST &request, vobsSTAR_LIST &list, const char* option,
+                              vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap, const char* logFileName, bool &served);
+
+    // Method to get all stars of one sky tile at the fixed magnitude depth
+    mcsCOMPL_STAT FetchTile(vobsSCENARIO_RUNTIME &ctx, const char* band, const char* option,
+                            mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius, vobsSTAR_LIST &list,
+                            vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap, const char* logFileName, bool &truncated);
+
     // Method to prepare the request in a string format
     mcsCOMPL_STAT PrepareQuery(miscoDYN_BUF* query, vobsREQUEST &request, const char* option);
     mcsCOMPL_STAT PrepareQuery(vobsSCENARIO_RUNTIME &ctx, miscoDYN_BUF* query, vobsREQUEST &request, vobsSTAR_LIST &tmpList, const char* option);
@@ -86,6 +99,7 @@ private:
     mcsCOMPL_STAT WriteQuerySpecificPart(miscoDYN_BUF* query);
     mcsCOMPL_STAT WriteQuerySpecificPart(miscoDYN_BUF* query, vobsREQUEST &request);
     mcsCOMPL_STAT WriteReferenceStarPosition(miscoDYN_BUF* query, vobsREQUEST &request);
+    mcsCOMPL_STAT WriteQueryPosition(miscoDYN_BUF* query, mcsDOUBLE ra, mcsDOUBLE dec);
     mcsCOMPL_STAT WriteQueryStarListPart(vobsSCENARIO_RUNTIME &ctx, miscoDYN_BUF* query, vobsSTAR_LIST &list);
 
     // Write option
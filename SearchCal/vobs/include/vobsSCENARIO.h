@@ -97,6 +97,9 @@ public:
 
     mcsCOMPL_STAT Clear(void);
 
+    // Free the data of the last request (idle scenario)
+    virtual void ReleaseData(void);
+
     inline void SetRemoveDuplicates(const bool flag) __attribute__ ((always_inline))
     {
         _removeDuplicates = flag;
@@ -147,11 +150,17 @@ public:
     }
 
     /**
-     * Initialize all "standard" criteria lists
+     * Initialize all "standard" criteria lists (only once as they do not
+     * depend on the request; prepared criteria are kept when the scenario is reused)
      * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
      */
     inline mcsCOMPL_STAT InitCriteriaLists(void) __attribute__ ((always_inline))
     {
+        if (_criteriaListsReady)
+        {
+            return mcsSUCCESS;
+        }
+
         // Define raDec radius to 1.5 arcsec for cross matching criteria by default:
         // note: Sirius A (-546.01 -1223.07 mas/yr) leads to a distance = 1.450 arcsec
 
@@ -234,6 +243,8 @@ public:
         // Add gaia criteria
         FAIL(_criteriaListRaDecGaiaAP.Add(vobsSTAR_ID_GAIA));
 
+        _criteriaListsReady = true;
+
         return mcsSUCCESS;
     }
 
@@ -256,6 +267,8 @@ protected:
     // flag to remove duplicates before the merge operation
     bool _removeDuplicates;
 
+    // flag indicating that "standard" criteria lists are built
+    bool _criteriaListsReady;
     // criteria list: RA/DEC within 1.5 arcsec
     vobsSTAR_COMP_CRITERIA_LIST _criteriaListRaDec;
     // criteria list: RA/DEC within 2.0 arcsec
@@ -17,7 +17,9 @@
  * System Headers 
  */
 #include <vector>
+#include <string>
 #include <stdio.h>
+#include <time.h>
 
 /*
  * MCS header
@@ -50,6 +52,15 @@ typedef std::pair<char*, char*> vobsTARGET_ID_PAIR;
 /* target Id length (char*) */
 #define TARGET_ID_LENGTH 21
 
+/** Default deadline (in seconds) of the catalog queries of one request */
+#define vobsDEADLINE_DEFAULT 120
+
+/** Minimum time (in seconds) left before the deadline to query optional catalogs (vobsUPDATE_ONLY) */
+#define vobsDEADLINE_MIN_OPTIONAL 15
+
+/** Minimum timeout (in seconds) given to mandatory catalog queries once the deadline is reached */
+#define vobsDEADLINE_MIN_TIMEOUT 60
+
 /*
  * Class declaration
  */
@@ -70,6 +81,10 @@ public:
     {
         // define targetId index to NULL: 
         _targetIdIndex = NULL;
+
+        // no deadline:
+        _deadline = 0;
+        _optionalStep = false;
     }
 
     // Class destructor
@@ -187,6 +202,146 @@ public:
         }
     }
 
+    /**
+     * Free the runtime buffers (reserved again by the next request)
+     */
+    inline void ReleaseBuffers() __attribute__((always_inline))
+    {
+        _queryBuffer.Reset();
+        _queryBuffer.Strip();
+        _responseBuffer.Reset();
+        _responseBuffer.Strip();
+        _cData.Reset();
+        _cData.Strip();
+        _dataBuffer.Reset();
+        _dataBuffer.Strip();
+
+        // free targetId pool:
+        ClearTargetIdIndex();
+
+        for (std::vector<char*>::iterator iter = _targetIdPool.begin(); iter != _targetIdPool.end(); iter++)
+        {
+            delete[](*iter);
+        }
+        std::vector<char*>().swap(_targetIdPool);
+    }
+
+    /**
+     * Define the deadline of the catalog queries and reset the skipped
+     * catalogs (new request)
+     *
+     * @param budget maximum duration (in seconds) or 0 if none
+     */
+    inline void SetDeadline(mcsUINT32 budget) __attribute__((always_inline))
+    {
+        _deadline = (budget != 0) ? time(NULL) + budget : 0;
+        _optionalStep = false;
+        _skippedCatalogs.clear();
+    }
+
+    /**
+     * Return the deadline of the catalog queries
+     *
+     * @return absolute deadline (see time()) or 0 if none
+     */
+    inline time_t GetDeadline() const __attribute__((always_inline))
+    {
+        return _deadline;
+    }
+
+    /**
+     * Return true if the time left before the deadline is less than the given duration
+     *
+     * @param duration duration in seconds
+     */
+    inline bool IsDeadlineNear(mcsUINT32 duration) const __attribute__((always_inline))
+    {
+        return (_deadline != 0) && (time(NULL) + duration >= _deadline);
+    }
+
+    /**
+     * Return the timeout (in seconds) of one catalog query: optional queries
+     * end at the deadline; mandatory ones get at least vobsDEADLINE_MIN_TIMEOUT
+     *
+     * @param timeout maximum timeout (in seconds)
+     */
+    inline mcsUINT32 GetQueryTimeout(mcsUINT32 timeout) const __attribute__((always_inline))
+    {
+        if (_deadline != 0)
+        {
+            const time_t remaining = _deadline - time(NULL);
+            const time_t minimum = _optionalStep ? 1 : vobsDEADLINE_MIN_TIMEOUT;
+
+            if (remaining < (time_t) timeout)
+            {
+                return (mcsUINT32) ((remaining > minimum) ? remaining : minimum);
+            }
+        }
+        return timeout;
+    }
+
+    /**
+     * Return the wait duration (in seconds) before retrying a catalog query,
+     * limited to the time left before the deadline (0 once reached)
+     *
+     * @param duration wait duration (in seconds)
+     */
+    inline mcsUINT32 GetRetryWait(mcsUINT32 duration) const __attribute__((always_inline))
+    {
+        if (_deadline != 0)
+        {
+            const time_t remaining = _deadline - time(NULL);
+
+            if (remaining < (time_t) duration)
+            {
+                return (mcsUINT32) ((remaining > 0) ? remaining : 0);
+            }
+        }
+        return duration;
+    }
+
+    /**
+     * Define whether the current scenario step is optional (vobsUPDATE_ONLY
+     * secondary query): optional queries may be skipped or truncated
+     */
+    inline void SetOptionalStep(bool optional) __attribute__((always_inline))
+    {
+        _optionalStep = optional;
+    }
+
+    inline bool IsOptionalStep() const __attribute__((always_inline))
+    {
+        return _optionalStep;
+    }
+
+    /**
+     * Record the given catalog as skipped or truncated (partial results)
+     */
+    inline void AddSkippedCatalog(const char* catalogName) __attribute__((always_inline))
+    {
+        if (!_skippedCatalogs.empty())
+        {
+            _skippedCatalogs.append(" ");
+        }
+        _skippedCatalogs.append(catalogName);
+    }
+
+    /**
+     * Return true if optional catalogs were skipped or truncated
+     */
+    inline bool IsPartial() const __attribute__((always_inline))
+    {
+        return !_skippedCatalogs.empty();
+    }
+
+    /**
+     * Return the skipped or truncated catalogs (space separated)
+     */
+    inline const char* GetSkippedCatalogs() const __attribute__((always_inline))
+    {
+        return _skippedCatalogs.c_str();
+    }
+
     inline char* GetTargetId() __attribute__((always_inline))
     {
         char* targetId = NULL;
@@ -232,6 +387,15 @@ private:
     /** targetId object pool */
     std::vector<char*> _targetIdPool;
 
+    /** deadline of the catalog queries (time()) or 0 if none */
+    time_t _deadline;
+
+    /** true if the current step is optional (vobsUPDATE_ONLY secondary query) */
+    bool _optionalStep;
+
+    /** skipped or truncated catalogs (partial results) */
+    std::string _skippedCatalogs;
+
 };
 
 #endif /*!vobsSCENARIO_RUNTIME_H*/
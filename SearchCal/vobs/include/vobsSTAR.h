@@ -431,6 +431,17 @@ public:
     // Destructor
     virtual ~vobsSTAR();
 
+    // stars are allocated in the request arena (see vobsARENA)
+    inline static void* operator new(size_t size) __attribute__ ((always_inline))
+    {
+        return vobsARENA::New(size);
+    }
+
+    inline static void operator delete(void* ptr) __attribute__ ((always_inline))
+    {
+        vobsARENA::Free(ptr);
+    }
+
     // Clear means free
     void Clear(void);
 
@@ -1808,6 +1819,9 @@ protected:
     static void AddPropertyErrorMeta(const char* id, const char* name,
                                      const char* unit, const char* description = NULL);
 
+    // Define the previously added property meta data as optional.
+    static void SetPropertyMetaOptional(void);
+
     static void initializeIndex(void);
 
     static mcsCOMPL_STAT DumpPropertyIndexAsXML(miscoDYN_BUF& buffer, const char* name, const mcsINT32 from, const mcsINT32 end);
@@ -26,6 +26,7 @@
  */
 #include "vobsCATALOG_META.h"
 #include "vobsSTAR.h"
+#include "vobsARENA.h"
 
 /*
  * Type declaration
@@ -68,16 +69,17 @@ typedef enum
     vobsSTAR_PRECESS_BOTH,
 } vobsSTAR_PRECESS_MODE;
 
-/** Star pointer ordered list */
-typedef std::list<vobsSTAR*> vobsSTAR_PTR_LIST;
+/** Star pointer ordered list (nodes allocated in the request arena) */
+typedef std::list<vobsSTAR*, vobsARENA_ALLOCATOR<vobsSTAR*> > vobsSTAR_PTR_LIST;
 
 /** Star pointer set */
 typedef std::set<vobsSTAR*> vobsSTAR_PTR_SET;
 
 /** Star pointer / double value pair */
 typedef std::pair<mcsDOUBLE, vobsSTAR*> vobsSTAR_PTR_DBL_PAIR;
-/** Star pointer / double value mapping (declination or distance) */
-typedef std::multimap<mcsDOUBLE, vobsSTAR*> vobsSTAR_PTR_DBL_MAP;
+/** Star pointer / double value mapping (declination or distance; nodes allocated in the request arena) */
+typedef std::multimap<mcsDOUBLE, vobsSTAR*, std::less<mcsDOUBLE>,
+        vobsARENA_ALLOCATOR<std::pair<const mcsDOUBLE, vobsSTAR*> > > vobsSTAR_PTR_DBL_MAP;
 
 /**
  * Information stored for an xmatch entry
@@ -156,8 +158,9 @@ private:
 
 /** Star pointer tuple / double value (score) pair */
 typedef std::pair<mcsDOUBLE, vobsSTAR_PTR_MATCH_ENTRY> vobsSTAR_PTR_MATCH_PAIR;
-/** Star pointer tuple / double value (score) mapping (distance map) */
-typedef std::multimap<mcsDOUBLE, vobsSTAR_PTR_MATCH_ENTRY> vobsSTAR_PTR_MATCH_MAP;
+/** Star pointer tuple / double value (score) mapping (distance map; nodes allocated in the request arena) */
+typedef std::multimap<mcsDOUBLE, vobsSTAR_PTR_MATCH_ENTRY, std::less<mcsDOUBLE>,
+        vobsARENA_ALLOCATOR<std::pair<const mcsDOUBLE, vobsSTAR_PTR_MATCH_ENTRY> > > vobsSTAR_PTR_MATCH_MAP;
 
 /** Star pointer / distance map pointer pair */
 typedef std::pair<vobsSTAR*, vobsSTAR_PTR_MATCH_MAP*> vobsSTAR_PTR_MATCH_MAP_PAIR;
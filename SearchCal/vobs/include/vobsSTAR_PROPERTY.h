@@ -23,6 +23,7 @@
  * Local headers
  */
 #include "vobsSTAR_PROPERTY_META.h"
+#include "vobsARENA.h"
 
 
 
@@ -178,6 +179,17 @@ public:
     // Class destructor
     ~vobsSTAR_PROPERTY();
 
+    // property arrays are allocated in the request arena (see vobsARENA)
+    inline static void* operator new[](size_t size) __attribute__ ((always_inline))
+    {
+        return vobsARENA::New(size);
+    }
+
+    inline static void operator delete[](void* ptr) __attribute__ ((always_inline))
+    {
+        vobsARENA::Free(ptr);
+    }
+
     void SetMetaIndex(mcsUINT8 metaIdx);
 
     // Property value setters
@@ -653,7 +665,7 @@ private:
 
                     if (IS_NOT_NULL(editStrVar->strValue))
                     {
-                        delete[](editStrVar->strValue);
+                        vobsARENA::Free(editStrVar->strValue);
                     }
                     // anyway:
                     SetFlagVarChar(false);
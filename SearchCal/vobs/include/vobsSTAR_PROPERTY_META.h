@@ -316,6 +316,25 @@ public:
         _errorMeta = errorMeta;
     }
 
+    /**
+     * Get the flag to indicate if this property is optional i.e. its column is
+     * left out of VOTables when no value is set (even without trimming columns)
+     *
+     * @return true for an optional property; false otherwise
+     */
+    inline bool IsOptional(void) const __attribute__ ((always_inline))
+    {
+        return _isOptional;
+    }
+
+    /**
+     * Define this property as optional (see IsOptional)
+     */
+    inline void SetOptional(void) const __attribute__ ((always_inline))
+    {
+        _isOptional = true;
+    }
+
     /**
      * Dump the property meta into given buffer
      *
@@ -494,6 +513,8 @@ private:
     bool        _isError;       // flag to indicate if this meta data describes a property error or a property value
     // error metadata (constant but mutable to be modified even by const methods
     mutable const vobsSTAR_PROPERTY_META* _errorMeta;
+    // flag to leave the column out of VOTables when no value is set (mutable as _errorMeta)
+    mutable bool _isOptional;
 } ;
 
 #endif /*!vobsSTAR_PROPERTY_META_H*/
@@ -0,0 +1,179 @@
+#ifndef vobsTILE_CACHE_H
+#define vobsTILE_CACHE_H
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Declaration of vobsTILE_CACHE class.
+ */
+
+#ifndef __cplusplus
+#error This is a C++ include file and cannot be used from plain C
+#endif
+
+/*
+ * System Headers
+ */
+#include <vector>
+#include <math.h>
+
+/*
+ * MCS header
+ */
+#include "mcs.h"
+
+/*
+ * Local header
+ */
+#include "vobsREQUEST.h"
+#include "vobsSTAR_LIST.h"
+
+/** HEALPix order of sky tiles (nside = 2^8 = 256 i.e. ~13.7 arcmin tiles) */
+#define vobsTILE_CACHE_ORDER        8
+
+/** Lower bound of the fixed magnitude depth used to fetch tiles */
+#define vobsTILE_CACHE_MAG_MIN      -5.0
+
+/** Upper bound of the fixed magnitude depth used to fetch tiles */
+#define vobsTILE_CACHE_MAG_MAX      14.0
+
+/** Maximum number of stars kept in the tile cache (least recently used tiles are evicted first) */
+#define vobsTILE_CACHE_MAX_STARS    50000
+
+/** Maximum number of missing tiles fetched to serve one search (otherwise the direct query is used) */
+#define vobsTILE_CACHE_MAX_MISSES   4
+
+/** Number of missing tiles fetched by a search not served by the tile cache (filled for later requests) */
+#define vobsTILE_CACHE_MAX_FILLS    2
+
+/*
+ * Type declaration
+ */
+
+/**
+ * Area and magnitude range of a primary query to be served by the tile cache.
+ * Sizes are the ones sent to VizieR (rounded arcmin).
+ */
+typedef struct
+{
+    mcsDOUBLE ra;                   /** center right ascension (J2000 deg) */
+    mcsDOUBLE dec;                  /** center declination (J2000 deg) */
+    vobsSEARCH_AREA_GEOM geometry;  /** cone or box */
+    mcsDOUBLE radius;               /** cone radius (arcmin) */
+    mcsDOUBLE deltaRa;              /** box width on the sky (arcmin) */
+    mcsDOUBLE deltaDec;             /** box height (arcmin) */
+    const char* magPropertyId;      /** star property holding the search band magnitude */
+    mcsDOUBLE minMag;               /** minimum magnitude (inclusive) */
+    mcsDOUBLE maxMag;               /** maximum magnitude (inclusive) */
+    mcsUINT32 maxSize;              /** maximum number of returned stars */
+    bool sortByDistance;            /** true to sort stars by distance to the center */
+    vobsORIGIN_INDEX catalogId;     /** catalog identifier of the output list */
+    const vobsCATALOG_META* catalogMeta; /** catalog meta data of the output list */
+} vobsTILE_QUERY;
+
+/**
+ * vobsTILE_FETCHER is the interface used by the tile cache to get all stars
+ * of one sky tile at the fixed magnitude depth (cache miss).
+ */
+class vobsTILE_FETCHER
+{
+public:
+    virtual ~vobsTILE_FETCHER()
+    {
+    }
+
+    /**
+     * Fetch all stars within the given cone at the fixed magnitude depth
+     * [vobsTILE_CACHE_MAG_MIN .. vobsTILE_CACHE_MAG_MAX].
+     *
+     * @param ra cone center right ascension (J2000 deg)
+     * @param dec cone center declination (J2000 deg)
+     * @param radius cone radius (arcmin)
+     * @param list output star list
+     * @param propertyCatalogMap property / catalog mapping to fill
+     * @param truncated set to true if the result was truncated (incomplete tile)
+     *
+     * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+     */
+    virtual mcsCOMPL_STAT FetchTile(mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius,
+                                    vobsSTAR_LIST &list,
+                                    vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                                    bool &truncated) = 0;
+} ;
+
+/*
+ * Class declaration
+ */
+
+/**
+ * vobsTILE_CACHE is a process-wide cache of primary query results split in
+ * HEALPix (nested scheme) sky tiles.
+ *
+ * A primary cone or box query is rewritten into tile fetches at a fixed
+ * magnitude depth; cached tiles are served locally and the result is the
+ * union of tiles cropped to the requested area and magnitude range.
+ * Tiles are keyed by the caller given key (catalog, band and query option).
+ *
+ * A search missing more than a few tiles (cold cache) is left to the direct
+ * query and only fetches the missing tiles closest to its center, so that
+ * later requests on the same sky area are progressively served by the cache.
+ */
+class vobsTILE_CACHE
+{
+public:
+    // Serve the given query using cached tiles (or fetch missing ones)
+    static mcsCOMPL_STAT Search(const char* key,
+                                const vobsTILE_QUERY &query,
+                                vobsTILE_FETCHER &fetcher,
+                                vobsSTAR_LIST &list,
+                                vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                                bool &served);
+
+    // Return the tile (HEALPix nested index) containing the given position
+    static mcsINT64 GetTileIndex(mcsDOUBLE ra, mcsDOUBLE dec);
+
+    // Return the center of the given tile
+    static void GetTileCenter(mcsINT64 tile, mcsDOUBLE &ra, mcsDOUBLE &dec);
+
+    // Return all tiles intersecting the given cone
+    static void GetTiles(mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius, std::vector<mcsINT64> &tiles);
+
+    // Return the cache statistics
+    static void GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions, mcsUINT64 &bypasses, mcsUINT32 &nbStars);
+
+    // Free all cached tiles
+    static void Clear(void);
+
+    /**
+     * Return the radius (arcmin) of a cone enclosing any tile around its center
+     * (largest HEALPix pixel radius ~ 1.03 x resolution plus margin).
+     * @return tile radius (arcmin)
+     */
+    inline static mcsDOUBLE GetTileRadius(void) __attribute__ ((always_inline))
+    {
+        return 1.1 * GetTileResolution();
+    }
+
+    /**
+     * Return the tile resolution (arcmin) i.e. the square root of the tile area.
+     * @return tile resolution (arcmin)
+     */
+    inline static mcsDOUBLE GetTileResolution(void) __attribute__ ((always_inline))
+    {
+        return sqrt(M_PI / 3.0) / (1 << vobsTILE_CACHE_ORDER) * 180.0 / M_PI * 60.0;
+    }
+
+private:
+    // Declaration of constructors and assignment operator as private
+    // methods, in order to hide them from the users.
+    vobsTILE_CACHE();
+    vobsTILE_CACHE(const vobsTILE_CACHE&);
+    vobsTILE_CACHE& operator=(const vobsTILE_CACHE&) ;
+} ;
+
+#endif /*!vobsTILE_CACHE_H*/
+
+
+/*___oOo___*/
@@ -52,6 +52,34 @@ public:
     mcsCOMPL_STAT Search(vobsSCENARIO *scenario,
                          vobsSTAR_LIST &starList);
 
+    // Define the deadline of the catalog queries of the next searches
+    void SetDeadline(mcsUINT32 budget);
+
+    /**
+     * Free the scenario runtime buffers (idle server)
+     */
+    inline void ReleaseBuffers() __attribute__((always_inline))
+    {
+        _ctx.ReleaseBuffers();
+    }
+
+    /**
+     * Return true if optional catalogs were skipped or truncated since the
+     * last SetDeadline() call (deadline reached)
+     */
+    inline bool IsPartial() const __attribute__((always_inline))
+    {
+        return _ctx.IsPartial();
+    }
+
+    /**
+     * Return the skipped or truncated catalogs (space separated)
+     */
+    inline const char* GetSkippedCatalogs() const __attribute__((always_inline))
+    {
+        return _ctx.GetSkippedCatalogs();
+    }
+
 protected:
 
 private:
@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of vobsARENA class.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <pthread.h>
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * Local Headers
+ */
+#include "vobsARENA.h"
+#include "vobsPrivate.h"
+
+/*
+ * Local Types
+ */
+
+/** chunk header (16 bytes to keep the malloc alignment of blocks) */
+typedef union
+{
+    struct
+    {
+        volatile mcsUINT32 refCount;    /* live blocks + 1 (scope) */
+        mcsUINT32 used;                 /* used bytes (header included) */
+    } info;
+    mcsDOUBLE align[2];
+} vobsARENA_CHUNK;
+
+/** block header (16 bytes to keep the malloc alignment of blocks) */
+typedef union
+{
+    vobsARENA_CHUNK* chunk;             /* owner chunk or NULL (heap) */
+    mcsDOUBLE align[2];
+} vobsARENA_BLOCK;
+
+/*
+ * Local Variables
+ */
+
+/* thread-local allocation state (vobsARENA_SCOPE) */
+static pthread_key_t vobsArenaKey;
+static pthread_once_t vobsArenaKeyOnce = PTHREAD_ONCE_INIT;
+
+/* statistics */
+static vobsARENA_STATS vobsArenaStats = { 0, 0, 0, 0, 0 };
+
+/*
+ * Local Functions
+ */
+
+static void vobsArenaKeyInit(void)
+{
+    pthread_key_create(&vobsArenaKey, NULL); // no destructor (scope state on the stack)
+}
+
+/* return the allocation state of the current thread or NULL (heap) */
+static vobsARENA_SCOPE::State* vobsArenaGetState(void)
+{
+    pthread_once(&vobsArenaKeyOnce, vobsArenaKeyInit);
+
+    return (vobsARENA_SCOPE::State*) pthread_getspecific(vobsArenaKey);
+}
+
+/* release one reference on the given chunk; the last one frees it */
+static void vobsArenaReleaseChunk(vobsARENA_CHUNK* chunk)
+{
+    if (__sync_sub_and_fetch(&chunk->info.refCount, 1) == 0)
+    {
+        __sync_fetch_and_add(&vobsArenaStats.nbFreedChunks, 1);
+        free(chunk);
+    }
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Allocate a block in the arena of the current thread (if any) or in the heap.
+ *
+ * @param size block size
+ *
+ * @return allocated block (16 bytes aligned) or NULL if no memory is available
+ */
+void* vobsARENA::Allocate(size_t size)
+{
+    const size_t blockSize = ((size + 15) & ~((size_t) 15)) + sizeof (vobsARENA_BLOCK);
+
+    vobsARENA_SCOPE::State* state = vobsArenaGetState();
+    vobsARENA_BLOCK* block;
+
+    if (IS_NOT_NULL(state) && state->useArena && (blockSize <= vobsARENA_MAX_BLOCK_SIZE))
+    {
+        vobsARENA_CHUNK* chunk = (vobsARENA_CHUNK*) state->chunk;
+
+        if (IS_NULL(chunk) || (chunk->info.used + blockSize > vobsARENA_CHUNK_SIZE))
+        {
+            // retire the full chunk (freed with its last block):
+            if (IS_NOT_NULL(chunk))
+            {
+                vobsArenaReleaseChunk(chunk);
+                state->chunk = NULL;
+            }
+
+            chunk = (vobsARENA_CHUNK*) malloc(vobsARENA_CHUNK_SIZE);
+            if (IS_NULL(chunk))
+            {
+                return NULL;
+            }
+            chunk->info.refCount = 1;
+            chunk->info.used = sizeof (vobsARENA_CHUNK);
+
+            state->chunk = chunk;
+            __sync_fetch_and_add(&vobsArenaStats.nbChunks, 1);
+        }
+
+        block = (vobsARENA_BLOCK*) ((char*) chunk + chunk->info.used);
+        block->chunk = chunk;
+
+        chunk->info.used += blockSize;
+        __sync_fetch_and_add(&chunk->info.refCount, 1);
+        __sync_fetch_and_add(&vobsArenaStats.nbBlocks, 1);
+    }
+    else
+    {
+        block = (vobsARENA_BLOCK*) malloc(blockSize);
+        if (IS_NULL(block))
+        {
+            return NULL;
+        }
+        block->chunk = NULL;
+        __sync_fetch_and_add(&vobsArenaStats.nbHeapBlocks, 1);
+    }
+    return block + 1;
+}
+
+/**
+ * Free the given block (allocated by Allocate() or New()); blocks allocated
+ * in chunks release their chunk.
+ *
+ * @param ptr block to free (may be NULL)
+ */
+void vobsARENA::Free(void* ptr)
+{
+    if (IS_NULL(ptr))
+    {
+        return;
+    }
+
+    vobsARENA_BLOCK* block = ((vobsARENA_BLOCK*) ptr) - 1;
+
+    if (IS_NULL(block->chunk))
+    {
+        free(block);
+    }
+    else
+    {
+        vobsArenaReleaseChunk(block->chunk);
+    }
+}
+
+/**
+ * Return the arena statistics
+ *
+ * @param stats statistics to fill
+ */
+void vobsARENA::GetStats(vobsARENA_STATS* stats)
+{
+    stats->nbScopes      = vobsArenaStats.nbScopes;
+    stats->nbChunks      = vobsArenaStats.nbChunks;
+    stats->nbFreedChunks = vobsArenaStats.nbFreedChunks;
+    stats->nbBlocks      = vobsArenaStats.nbBlocks;
+    stats->nbHeapBlocks  = vobsArenaStats.nbHeapBlocks;
+}
+
+/**
+ * Install a new arena (or the heap) on the current thread
+ *
+ * @param useArena true to allocate in a new arena; false to allocate in the heap
+ */
+vobsARENA_SCOPE::vobsARENA_SCOPE(bool useArena)
+{
+    _state.useArena = useArena;
+    _state.chunk    = NULL;
+
+    _previous = vobsArenaGetState();
+
+    pthread_setspecific(vobsArenaKey, &_state);
+
+    if (useArena)
+    {
+        __sync_fetch_and_add(&vobsArenaStats.nbScopes, 1);
+    }
+}
+
+/**
+ * Restore the previous allocation state: the current chunk is released and
+ * freed once all its blocks are freed.
+ */
+vobsARENA_SCOPE::~vobsARENA_SCOPE()
+{
+    if (IS_NOT_NULL(_state.chunk))
+    {
+        vobsArenaReleaseChunk((vobsARENA_CHUNK*) _state.chunk);
+        _state.chunk = NULL;
+    }
+
+    pthread_setspecific(vobsArenaKey, _previous);
+}
+
+
+/*___oOo___*/
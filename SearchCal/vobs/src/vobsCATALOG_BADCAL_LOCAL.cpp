@@ -154,6 +154,9 @@ mcsCOMPL_STAT vobsCATALOG_BADCAL_LOCAL::Load(vobsCATALOG_STAR_PROPERTY_CATALOG_M
 
     if (IS_FALSE(_loaded))
     {
+        // loaded stars are kept between requests (heap):
+        vobsARENA_SCOPE heapScope(false);
+
         _starList.Clear();
 
         // Load catalog file
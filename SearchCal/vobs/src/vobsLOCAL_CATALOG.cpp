@@ -82,6 +82,9 @@ mcsCOMPL_STAT vobsLOCAL_CATALOG::Load(vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING*
 
     // Catalog has not already been loaded
 
+    // loaded stars are kept between requests (heap):
+    vobsARENA_SCOPE heapScope(false);
+
     // Search for file location
     char* catalogFileName = miscLocateFile(_filename);
     FAIL_NULL(catalogFileName);
@@ -17,6 +17,8 @@ using namespace std;
 #include <iostream>
 #include <string.h>
 #include <unistd.h>
+#include <map>
+#include <string>
 
 #include <libxml/parser.h>
 /*
@@ -26,6 +28,7 @@ using namespace std;
 #include "log.h"
 #include "err.h"
 #include "misc.h"
+#include "thrd.h"
 
 /*
  * Local Headers
@@ -34,9 +37,103 @@ using namespace std;
 #include "vobsPrivate.h"
 #include "vobsErrors.h"
 
+/*
+ * Local Variables
+ */
+
+/** rate limiter pointer map keyed by URI */
+typedef map<string, thrdRATE_LIMITER*> vobsRATE_LIMITER_PTR_MAP;
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX vobsRateLimiterMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** rate limiters resolved per URI (NULL if not available) */
+static vobsRATE_LIMITER_PTR_MAP vobsRateLimiterMap;
+
 /*
  * Local Functions
  */
+
+/**
+ * Return the rate limiter shared by all clients of the host of the given URI,
+ * resolved once per URI
+ *
+ * @param uri URI to query
+ *
+ * @return the rate limiter or NULL if none is available (no rate limiting)
+ */
+static thrdRATE_LIMITER* vobsGetRateLimiter(const char* uri)
+{
+    thrdRATE_LIMITER* limiter = NULL;
+
+    mcsMutexLock(&vobsRateLimiterMutex);
+
+    vobsRATE_LIMITER_PTR_MAP::const_iterator iter = vobsRateLimiterMap.find(uri);
+
+    if (iter != vobsRateLimiterMap.end())
+    {
+        limiter = iter->second;
+    }
+    else
+    {
+        limiter = thrdRateLimiterGet(uri, vobsMAX_RATE, vobsMAX_BURST);
+
+        if (IS_NULL(limiter))
+        {
+            // too many hosts (thrdRATE_LIMITER_MAX): do not fail queries
+            logWarning("No rate limiter available for '%s'; queries are not rate limited", uri);
+            errResetStack();
+        }
+        vobsRateLimiterMap.insert(vobsRATE_LIMITER_PTR_MAP::value_type(uri, limiter));
+    }
+
+    mcsMutexUnlock(&vobsRateLimiterMutex);
+
+    return limiter;
+}
+
+/**
+ * Return the priority gate serializing the gdome calls: callers are served by
+ * priority (interactive requests first)
+ */
+static thrdPRIORITY_GATE* vobsGetGdomeGate(void)
+{
+    static thrdPRIORITY_GATE* gdomeGate = thrdPriorityGateGet("gdome", 1, 0);
+
+    return gdomeGate;
+}
+
+/**
+ * Lock the gdome mutex (through its priority gate)
+ */
+static void vobsLockGdome(void)
+{
+    thrdPRIORITY_GATE* gdomeGate = vobsGetGdomeGate();
+
+    if (IS_NOT_NULL(gdomeGate))
+    {
+        thrdPriorityGateAcquire(gdomeGate, thrdPriorityGet());
+    }
+    mcsLockGdomeMutex();
+}
+
+/**
+ * Unlock the gdome mutex and its priority gate
+ */
+static void vobsUnlockGdome(void)
+{
+    thrdPRIORITY_GATE* gdomeGate = vobsGetGdomeGate();
+
+    mcsUnlockGdomeMutex();
+
+    if (IS_NOT_NULL(gdomeGate))
+    {
+        thrdPriorityGateRelease(gdomeGate);
+    }
+}
+
 // Class constructor
 
 vobsPARSER::vobsPARSER()
@@ -105,11 +202,15 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         /* Erase the error stack */
         errResetStack();
 
-        /* sleep 3 seconds before retrying query */
+        /* sleep before retrying query (not beyond the request deadline) */
         if (tryCount != 0)
         {
-            logInfo("Waiting %ds before retrying...", waitDuration);
-            sleep(waitDuration);
+            const mcsUINT32 wait = ctx.GetRetryWait(waitDuration);
+            if (wait != 0)
+            {
+                logInfo("Waiting %ds before retrying...", wait);
+                sleep(wait);
+            }
             waitDuration *= 2;
         }
 
@@ -119,10 +220,25 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         // Reset and get the response buffer:
         responseBuffer = ctx.GetResponseBuffer();
 
-        // Query the CDS (with potentially 3 HTTP retries)
-        mcsINT8 executionStatus = miscPerformHttpPost(uri, data,
-                                                      responseBuffer->GetInternalMiscDYN_BUF(),
-                                                      vobsTIME_OUT);
+        // Wait for a query slot (interactive requests first, batch requests use idle slots):
+        static thrdPRIORITY_GATE* queryGate = thrdPriorityGateGet("query", vobsMAX_QUERIES, vobsRESERVED_QUERIES);
+        FAIL(thrdPriorityGateAcquire(queryGate, thrdPriorityGet()));
+
+        // Wait for the rate limiter shared by all clients of this host:
+        thrdRATE_LIMITER* limiter = vobsGetRateLimiter(uri);
+        if (IS_NOT_NULL(limiter))
+        {
+            FAIL_DO(thrdRateLimiterAcquire(limiter), thrdPriorityGateRelease(queryGate));
+        }
+
+        // Query the CDS (with potentially 3 HTTP retries) limited by the request deadline
+        // (optional queries end at the deadline):
+        mcsINT8 executionStatus = miscPerformHttpPostWithDeadline(uri, data,
+                                                                  responseBuffer->GetInternalMiscDYN_BUF(),
+                                                                  ctx.GetQueryTimeout(vobsTIME_OUT),
+                                                                  ctx.IsOptionalStep() ? ctx.GetDeadline() : 0);
+
+        thrdPriorityGateRelease(queryGate);
 
         tryCount++;
 
@@ -212,7 +328,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         if (!doRetry)
         {
             /* Parse the VOTable using gdome (not thread-safe but using gdome mutex) */
-            mcsLockGdomeMutex();
+            vobsLockGdome();
 
             // Get a DOMImplementation reference
             domimpl = gdome_di_mkref();
@@ -227,7 +343,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
                 gdome_doc_unref(doc, &ex);
                 gdome_di_unref(domimpl, &ex);
 
-                mcsUnlockGdomeMutex();
+                vobsUnlockGdome();
 
                 /* ensure null pointers */
                 doc = NULL;
@@ -240,7 +356,8 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
             }
         }
     }
-    while (IS_NULL(doc) && (tryCount < 3));
+    while (IS_NULL(doc) && (tryCount < 3)
+           && !(ctx.IsOptionalStep() && ctx.IsDeadlineNear(waitDuration)));
 
     if (IS_NULL(doc))
     {
@@ -261,7 +378,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         gdome_doc_unref(doc, &ex);
         gdome_di_unref(domimpl, &ex);
 
-        mcsUnlockGdomeMutex();
+        vobsUnlockGdome();
 
         return mcsFAILURE;
     }
@@ -278,7 +395,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         gdome_doc_unref(doc, &ex);
         gdome_di_unref(domimpl, &ex);
 
-        mcsUnlockGdomeMutex();
+        vobsUnlockGdome();
 
         return mcsFAILURE;
     }
@@ -296,7 +413,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         gdome_doc_unref(doc, &ex);
         gdome_di_unref(domimpl, &ex);
 
-        mcsUnlockGdomeMutex();
+        vobsUnlockGdome();
 
         return mcsFAILURE;
     }
@@ -326,7 +443,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
         gdome_doc_unref(doc, &ex);
         gdome_di_unref(domimpl, &ex);
 
-        mcsUnlockGdomeMutex();
+        vobsUnlockGdome();
 
         return mcsFAILURE;
     }
@@ -336,7 +453,7 @@ mcsCOMPL_STAT vobsPARSER::Parse(vobsSCENARIO_RUNTIME &ctx,
     gdome_doc_unref(doc, &ex);
     gdome_di_unref(domimpl, &ex);
 
-    mcsUnlockGdomeMutex();
+    vobsUnlockGdome();
 
     // Print out CDATA description and Save xml file
     if ((IS_NOT_NULL(logFileName) && IS_FALSE(miscIsSpaceStr(logFileName))) || doLog(logDEBUG))
@@ -33,6 +33,7 @@ using namespace std;
 #include "vobsErrors.h"
 #include "vobsSTAR.h"
 #include "vobsPARSER.h"
+#include "vobsTILE_CACHE.h"
 
 /* max query size */
 #define vobsMAX_QUERY_SIZE "1000"
@@ -74,6 +75,13 @@ static mcsLOGICAL vobsDeprecatedFlag = mcsFALSE;
 /** Deprecated flag initialization flag */
 static mcsLOGICAL vobsDeprecatedFlagInitialized = mcsFALSE;
 
+/** TILE_CACHE Flag environment variable */
+static const mcsSTRING32 vobsTileCacheFlagEnvVarName = "VOBS_TILE_CACHE_FLAG";
+/** Tile cache flag */
+static mcsLOGICAL vobsTileCacheFlag = mcsFALSE;
+/** Tile cache flag initialization flag */
+static mcsLOGICAL vobsTileCacheFlagInitialized = mcsFALSE;
+
 /** thread local storage key for cancel flag */
 static pthread_key_t tlsKey_cancelFlag;
 /** flag to indicate that the thread local storage is initialized */
@@ -114,6 +122,16 @@ bool vobsIsCancelled(void)
     return false;
 }
 
+/* return the cancellation flag of the current thread (or NULL) to share it with worker threads */
+bool* vobsGetCancelFlag(void)
+{
+    if (vobsCancelInitialized)
+    {
+        return (bool*) pthread_getspecific(tlsKey_cancelFlag);
+    }
+    return NULL;
+}
+
 void vobsSetCancelFlag(bool* cancelFlag)
 {
     if (vobsCancelInitialized && IS_NOT_NULL(cancelFlag))
@@ -346,6 +364,48 @@ mcsLOGICAL vobsGetDeprecatedFlag()
     return vobsDeprecatedFlag;
 }
 
+/* Return mcsTRUE if the tile cache flag is enabled (env var); mcsFALSE otherwise */
+mcsLOGICAL vobsGetTileCacheFlag()
+{
+    if (IS_TRUE(vobsTileCacheFlagInitialized))
+    {
+        return vobsTileCacheFlag;
+    }
+    // compute it once:
+    vobsTileCacheFlagInitialized = mcsTRUE;
+
+    mcsSTRING1024 envTileCacheFlag = "";
+    if (miscGetEnvVarValue2(vobsTileCacheFlagEnvVarName, envTileCacheFlag, sizeof (envTileCacheFlag), mcsTRUE) == mcsSUCCESS)
+    {
+        // Check the env. var. is not empty
+        if (strlen(envTileCacheFlag) != 0)
+        {
+            logDebug("Found '%s' environment variable content for the tile cache flag.", vobsTileCacheFlagEnvVarName);
+
+            if ((strcmp("1", envTileCacheFlag) == 0) || (strcmp("true", envTileCacheFlag) == 0))
+            {
+                vobsTileCacheFlag = mcsTRUE;
+            }
+            else if ((strcmp("0", envTileCacheFlag) == 0) || (strcmp("false", envTileCacheFlag) == 0))
+            {
+                vobsTileCacheFlag = mcsFALSE;
+            }
+            else
+            {
+                logInfo("'%s' environment variable does not contain a valid tile cache flag: %s", vobsTileCacheFlagEnvVarName, envTileCacheFlag);
+            }
+        }
+        else
+        {
+            logInfo("'%s' environment variable does not contain a valid tile cache flag (empty).", vobsTileCacheFlagEnvVarName);
+        }
+    }
+
+    logQuiet("vobsTileCacheFlag: %s", IS_TRUE(vobsTileCacheFlag) ? "true" : "false");
+
+    return vobsTileCacheFlag;
+}
+
 /*
  * Class constructor
  * @param name catalog identifier / name
@@ -439,11 +499,22 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::Search(vobsSCENARIO_RUNTIME &ctx,
     // if ok, the asking is writing according to only the request
     if (listSize == 0)
     {
-        FAIL(PrepareQuery(query, request, option));
+        bool served = false;
 
-        // The parser get the query result through Internet, and analyse it
-        vobsPARSER parser;
-        FAIL(parser.Parse(ctx, vizierURI, query->GetBuffer(), catalogId, catalogMeta, list, propertyCatalogMap, logFileName));
+        // Try serving the primary request from the sky tile cache:
+        if (IS_TRUE(vobsGetTileCacheFlag()))
+        {
+            FAIL(SearchTiles(ctx, request, list, option, propertyCatalogMap, logFileName, served));
+        }
+
+        if (!served)
+        {
+            FAIL(PrepareQuery(query, request, option));
+
+            // The parser get the query result through Internet, and analyse it
+            vobsPARSER parser;
+            FAIL(parser.Parse(ctx, vizierURI, query->GetBuffer(), catalogId, catalogMeta, list, propertyCatalogMap, logFileName));
+        }
 
         // Check cancellation:
         FAIL_COND(vobsIsCancelled());
@@ -493,6 +564,7 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::Search(vobsSCENARIO_RUNTIME &ctx,
              */
 
             mcsINT32 count = 0, total = 0, i = 0;
+            bool truncated = false;
 
             vobsSTAR* currentStar = shadow.GetNextStar(mcsTRUE);
 
@@ -508,6 +580,13 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::Search(vobsSCENARIO_RUNTIME &ctx,
                     // define the free pointer flag to avoid double frees (shadow and subset are storing same star pointers):
                     subset.SetFreeStarPointers(false);
 
+                    // Optional step: stop querying remaining chunks when the deadline is near:
+                    if (ctx.IsOptionalStep() && ctx.IsDeadlineNear(vobsDEADLINE_MIN_OPTIONAL))
+                    {
+                        truncated = true;
+                        break;
+                    }
+
                     i++;
 
                     logTest("Search: Iteration %d = %d", i, total);
@@ -537,8 +616,17 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::Search(vobsSCENARIO_RUNTIME &ctx,
                 currentStar = shadow.GetNextStar();
             }
 
+            if (truncated)
+            {
+                logWarning("Search: deadline reached - %s truncated after %d stars (%d)", GetName(), (total - count), listSize);
+
+                ctx.AddSkippedCatalog(GetName());
+
+                // remaining stars are not updated:
+                subset.Clear();
+            }
             // finish the list
-            if (subset.Size() > 0)
+            else if (subset.Size() > 0)
             {
                 // define the free pointer flag to avoid double frees (shadow and subset are storing same star pointers):
                 subset.SetFreeStarPointers(false);
@@ -576,6 +664,208 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::Search(vobsSCENARIO_RUNTIME &ctx,
  * Private methods
  */
 
+/**
+ * Sky tile fetcher querying VizieR for one tile (cone) at the fixed magnitude depth
+ */
+class vobsREMOTE_TILE_FETCHER : public vobsTILE_FETCHER
+{
+public:
+
+    vobsREMOTE_TILE_FETCHER(vobsREMOTE_CATALOG* catalog, vobsSCENARIO_RUNTIME &ctx,
+                            const char* band, const char* option, const char* logFileName) : _ctx(ctx)
+    {
+        _catalog = catalog;
+        _band = band;
+        _option = option;
+        _logFileName = logFileName;
+    }
+
+    mcsCOMPL_STAT FetchTile(mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius,
+                            vobsSTAR_LIST &list,
+                            vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                            bool &truncated)
+    {
+        return _catalog->FetchTile(_ctx, _band, _option, ra, dec, radius, list, propertyCatalogMap, _logFileName, truncated);
+    }
+
+private:
+    vobsREMOTE_CATALOG* _catalog;
+    vobsSCENARIO_RUNTIME &_ctx;
+    const char* _band;
+    const char* _option;
+    const char* _logFileName;
+} ;
+
+/**
+ * Serve the primary request (cone or box around the science object) from the
+ * sky tile cache (see vobsTILE_CACHE).
+ *
+ * The request is not served (served = false) if the catalog epoch is not 2000,
+ * if the magnitude range exceeds the fixed tile magnitude depth or if the
+ * catalog has no magnitude column for the search band.
+ *
+ * @param request vobsREQUEST which have all the constraints for the search
+ * @param list output star list
+ * @param served true if the request was served by the tile cache
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT vobsREMOTE_CATALOG::SearchTiles(vobsSCENARIO_RUNTIME &ctx,
+                                              vobsREQUEST &request,
+                                              vobsSTAR_LIST &list,
+                                              const char* option,
+                                              vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                                              const char* logFileName,
+                                              bool &served)
+{
+    served = false;
+
+    const vobsCATALOG_META* catalogMeta = GetCatalogMeta();
+
+    // Tiles are defined on J2000 positions (no epoch correction):
+    if (IS_FALSE(catalogMeta->IsEpoch2000()))
+    {
+        return mcsSUCCESS;
+    }
+
+    // Use the same rounding as WriteQuerySpecificPart():
+    mcsSTRING32 value;
+    sprintf(value, "%.2lf", request.GetMinMagRange());
+    const mcsDOUBLE minMag = atof(value);
+    sprintf(value, "%.2lf", request.GetMaxMagRange());
+    const mcsDOUBLE maxMag = atof(value);
+
+    if ((minMag < vobsTILE_CACHE_MAG_MIN) || (maxMag > vobsTILE_CACHE_MAG_MAX))
+    {
+        logTest("Search: Magnitude range [%.2lf..%.2lf] out of the tile cache depth", minMag, maxMag);
+        return mcsSUCCESS;
+    }
+
+    // Get the magnitude column of the search band:
+    const char* band = request.GetSearchBand();
+
+    mcsSTRING32 columnId;
+    sprintf(columnId, "%smag", band);
+
+    const vobsCATALOG_COLUMN* column = catalogMeta->GetColumnMeta(columnId);
+    if (IS_NULL(column) || IS_NULL(column->GetPropertyId()))
+    {
+        return mcsSUCCESS;
+    }
+
+    vobsTILE_QUERY tileQuery;
+    tileQuery.ra = request.GetObjectRaInDeg();
+    tileQuery.dec = request.GetObjectDecInDeg();
+    tileQuery.geometry = request.GetSearchAreaGeometry();
+    tileQuery.radius = 0.0;
+    tileQuery.deltaRa = 0.0;
+    tileQuery.deltaDec = 0.0;
+
+    if (tileQuery.geometry == vobsBOX)
+    {
+        mcsDOUBLE deltaRa, deltaDec;
+        FAIL(request.GetSearchArea(deltaRa, deltaDec));
+
+        sprintf(value, "%.0lf", deltaRa + 0.5);
+        tileQuery.deltaRa = atof(value);
+        sprintf(value, "%.0lf", deltaDec + 0.5);
+        tileQuery.deltaDec = atof(value);
+    }
+    else
+    {
+        mcsDOUBLE radius;
+        FAIL(request.GetSearchArea(radius));
+
+        sprintf(value, "%.0lf", radius + 0.5);
+        tileQuery.radius = atof(value);
+    }
+
+    tileQuery.magPropertyId = column->GetPropertyId();
+    tileQuery.minMag = minMag;
+    tileQuery.maxMag = maxMag;
+    tileQuery.maxSize = atoi(vobsMAX_QUERY_SIZE);
+    tileQuery.sortByDistance = IS_TRUE(catalogMeta->DoSortByDistance());
+    tileQuery.catalogId = catalogMeta->GetCatalogId();
+    tileQuery.catalogMeta = catalogMeta;
+
+    // Cache key: catalog, band and options:
+    miscoDYN_BUF key;
+    FAIL(key.AppendString(GetName()));
+    FAIL(key.AppendString("|"));
+    FAIL(key.AppendString(band));
+    FAIL(key.AppendString("|"));
+    if (IS_NOT_NULL(option))
+    {
+        FAIL(key.AppendString(option));
+    }
+
+    vobsREMOTE_TILE_FETCHER fetcher(this, ctx, band, option, logFileName);
+
+    return vobsTILE_CACHE::Search(key.GetBuffer(), tileQuery, fetcher, list, propertyCatalogMap, served);
+}
+
+/**
+ * Get all stars of one sky tile (cone) at the fixed magnitude depth
+ * [vobsTILE_CACHE_MAG_MIN .. vobsTILE_CACHE_MAG_MAX] on the given band.
+ *
+ * @param band search band
+ * @param ra cone center right ascension (J2000 deg)
+ * @param dec cone center declination (J2000 deg)
+ * @param radius cone radius (arcmin)
+ * @param list output star list
+ * @param truncated set to true if the result reached the max query size
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT vobsREMOTE_CATALOG::FetchTile(vobsSCENARIO_RUNTIME &ctx,
+                                            const char* band,
+                                            const char* option,
+                                            mcsDOUBLE ra,
+                                            mcsDOUBLE dec,
+                                            mcsDOUBLE radius,
+                                            vobsSTAR_LIST &list,
+                                            vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                                            const char* logFileName,
+                                            bool &truncated)
+{
+    // Check cancellation:
+    FAIL_COND(vobsIsCancelled());
+
+    // Reset and get the query buffer:
+    miscoDYN_BUF* query = ctx.GetQueryBuffer();
+    FAIL(query->Reset());
+
+    FAIL(WriteQueryURIPart(query));
+
+    FAIL(WriteQueryPosition(query, ra, dec));
+
+    mcsSTRING32 separation;
+    sprintf(separation, "%.0lf", ceil(radius));
+
+    logTest("Search: Tile cone search area=%s arcmin", separation);
+
+    query->AppendString("&-c.rm="); // -c.rm means radius in arcmin
+    query->AppendString(separation);
+
+    mcsSTRING32 rangeMag;
+    sprintf(rangeMag, "%.2lf..%.2lf", vobsTILE_CACHE_MAG_MIN, vobsTILE_CACHE_MAG_MAX);
+
+    FAIL(WriteQueryBandPart(query, band, rangeMag));
+
+    // options:
+    FAIL(WriteOption(query, option));
+
+    // properties to retrieve
+    FAIL(WriteQuerySpecificPart(query));
+
+    vobsPARSER parser;
+    FAIL(parser.Parse(ctx, vobsGetVizierURI(), query->GetBuffer(), GetCatalogId(), GetCatalogMeta(), list, propertyCatalogMap, logFileName));
+
+    truncated = (list.Size() >= (mcsUINT32) atoi(vobsMAX_QUERY_SIZE));
+
+    return mcsSUCCESS;
+}
+
 /**
  * Prepare the asking.
  *
@@ -925,7 +1215,6 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::WriteReferenceStarPosition(miscoDYN_BUF* query
 {
     mcsDOUBLE ra, dec;
     mcsDOUBLE pmRa, pmDec;
-    mcsSTRING16 raDeg, decDeg;
 
     ra = request.GetObjectRaInDeg();
     dec = request.GetObjectDecInDeg();
@@ -946,6 +1235,21 @@ mcsCOMPL_STAT vobsREMOTE_CATALOG::WriteReferenceStarPosition(miscoDYN_BUF* query
         dec = vobsSTAR::GetPrecessedDEC(dec, pmDec, EPOCH_2000, epochMed);
     }
 
+    return WriteQueryPosition(query, ra, dec);
+}
+
+/**
+ * Build the position part of the asking (RA/DEC in decimal degrees).
+ *
+ * @param ra right ascension (deg)
+ * @param dec declination (deg)
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT vobsREMOTE_CATALOG::WriteQueryPosition(miscoDYN_BUF* query, mcsDOUBLE ra, mcsDOUBLE dec)
+{
+    mcsSTRING16 raDeg, decDeg;
+
     vobsSTAR::raToDeg(ra, raDeg);
     vobsSTAR::decToDeg(dec, decDeg);
 
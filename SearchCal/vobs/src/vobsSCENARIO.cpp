@@ -77,6 +77,8 @@ vobsSCENARIO::vobsSCENARIO(sdbENTRY* progress)
 
     // enable remove duplicates detection before the merge operation:
     _removeDuplicates = true;
+
+    _criteriaListsReady = false;
 }
 
 /*
@@ -617,6 +619,16 @@ mcsCOMPL_STAT vobsSCENARIO::Execute(vobsSCENARIO_RUNTIME &ctx, vobsSTAR_LIST &st
                 /* Do not perform secondary requests (vobsUPDATE_ONLY) if the input list is empty */
                 logTest("Execute: Step %d - Skipping querying %s (empty input list)", nStep, catalogName);
             }
+            else if ((action == vobsUPDATE_ONLY) && ctx.IsDeadlineNear(vobsDEADLINE_MIN_OPTIONAL))
+            {
+                /* Skip optional secondary requests (vobsUPDATE_ONLY) if the deadline is near (partial results) */
+                logWarning("Execute: Step %d - Skipping querying %s (deadline reached)", nStep, catalogName);
+
+                ctx.AddSkippedCatalog(catalogName);
+
+                // input stars are not updated:
+                tmpListA.Clear();
+            }
             else
             {
                 // Get catalog name, and replace '/' by '_'
@@ -741,9 +753,30 @@ mcsCOMPL_STAT vobsSCENARIO::Execute(vobsSCENARIO_RUNTIME &ctx, vobsSTAR_LIST &st
 
                 if (loadedStatus == mcsFAILURE)
                 {
-                    // if research failed, return mcsFAILURE and tempList is empty
-                    FAIL_DO(tempCatalog->Search(ctx, *request, tmpListA, entry->GetQueryOption(), &_propertyCatalogMap, _saveSearchXml),
-                            timlogCancel(timLogActionName));
+                    // secondary requests (vobsUPDATE_ONLY) may be skipped or truncated at the deadline:
+                    ctx.SetOptionalStep(action == vobsUPDATE_ONLY);
+
+                    if (tempCatalog->Search(ctx, *request, tmpListA, entry->GetQueryOption(), &_propertyCatalogMap, _saveSearchXml) == mcsFAILURE)
+                    {
+                        if (!ctx.IsOptionalStep() || !ctx.IsDeadlineNear(vobsDEADLINE_MIN_OPTIONAL) || vobsIsCancelled())
+                        {
+                            ctx.SetOptionalStep(false);
+                            timlogCancel(timLogActionName);
+
+                            // if research failed, return mcsFAILURE and tempList is empty
+                            return mcsFAILURE;
+                        }
+
+                        // optional query failed at the deadline: ignore error (partial results)
+                        logWarning("Execute: Step %d - Query %s failed (deadline reached)", nStep, catalogName);
+                        errResetStack();
+
+                        ctx.AddSkippedCatalog(catalogName);
+
+                        // input stars are not updated:
+                        tmpListA.Clear();
+                    }
+                    ctx.SetOptionalStep(false);
                 }
 
                 // Stop time counter
@@ -972,5 +1005,13 @@ mcsCOMPL_STAT vobsSCENARIO::Clear(void)
     return mcsSUCCESS;
 }
 
+/**
+ * Free the data of the last request (star lists) kept by the scenario until
+ * its next execution; nothing by default.
+ */
+void vobsSCENARIO::ReleaseData(void)
+{
+}
+
 
 /*___oOo___*/
@@ -1163,6 +1163,22 @@ void vobsSTAR::AddPropertyErrorMeta(const char* id, const char* name,
     }
 }
 
+/**
+ * Define the previously added property meta as optional: its column is left
+ * out of VOTables when no value is set (see vobsSTAR_PROPERTY_META::IsOptional)
+ */
+void vobsSTAR::SetPropertyMetaOptional(void)
+{
+    if (vobsSTAR_PROPERTY_META::vobsStar_PropertyMetaList.empty())
+    {
+        logError("No property meta defined; can not define it as optional");
+    }
+    else
+    {
+        vobsSTAR_PROPERTY_META::vobsStar_PropertyMetaList.back()->SetOptional();
+    }
+}
+
 /**
  * Initialize the shared property index (NOT THREAD SAFE)
  */
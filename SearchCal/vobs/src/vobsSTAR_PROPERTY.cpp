@@ -626,7 +626,7 @@ void vobsSTAR_PROPERTY::copyValue(const char* value)
                 printf("copyValue: alloc[%u] for len = %u\n", aLen, len);
             }
             /* Create the char* storage with adjusted length > (len + 1) */
-            writeValue = new char[aLen];
+            writeValue = (char*) vobsARENA::New(aLen);
             editStrVar->strValue = writeValue;
             SetFlagVarChar(true);
         }
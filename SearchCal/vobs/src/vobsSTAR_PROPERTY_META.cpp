@@ -110,6 +110,7 @@ vobsSTAR_PROPERTY_META::vobsSTAR_PROPERTY_META(const char* id,
 
     _isError     = isError;
     _errorMeta   = NULL;
+    _isOptional  = false;
 }
 
 /**
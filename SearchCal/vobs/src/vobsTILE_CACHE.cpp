@@ -0,0 +1,747 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * @file
+ * Definition of vobsTILE_CACHE class.
+ *
+ * Sky tiles are HEALPix pixels (nested scheme) of order vobsTILE_CACHE_ORDER,
+ * see Gorski et al. 2005, ApJ 622, 759.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <map>
+#include <list>
+#include <set>
+using namespace std;
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * SCALIB Headers
+ */
+#include "alx.h"
+
+/*
+ * Local Headers
+ */
+#include "vobsTILE_CACHE.h"
+#include "vobsPrivate.h"
+#include "vobsErrors.h"
+
+/* HEALPix nside */
+#define vobsTILE_NSIDE ((mcsINT64) 1 << vobsTILE_CACHE_ORDER)
+
+/*
+ * Local Types
+ */
+
+/** cached tile: stars at the fixed magnitude depth + property / catalog mapping */
+typedef struct
+{
+    vobsSTAR_LIST* starList;
+    vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING propertyCatalogMap;
+    list<string>::iterator lruPos;
+} vobsTILE_ENTRY;
+
+/** tile entry pointer map keyed by '<key>#<tile index>' */
+typedef map<string, vobsTILE_ENTRY*> vobsTILE_ENTRY_PTR_MAP;
+
+/*
+ * Local Variables
+ */
+
+/*
+ * To prevent concurrent access to shared ressources in multi-threaded context.
+ */
+static mcsMUTEX vobsTileCacheMutex = MCS_MUTEX_STATIC_INITIALIZER;
+
+/** cached tiles */
+static vobsTILE_ENTRY_PTR_MAP vobsTileCacheMap;
+/** tile keys ordered by last access (most recent first) */
+static list<string> vobsTileCacheLru;
+/** number of cached stars */
+static mcsUINT32 vobsTileCacheNbStars = 0;
+
+/* statistics */
+static mcsUINT64 vobsTileCacheHits = 0;
+static mcsUINT64 vobsTileCacheMisses = 0;
+static mcsUINT64 vobsTileCacheEvictions = 0;
+static mcsUINT64 vobsTileCacheBypasses = 0;
+
+/*
+ * Local Functions
+ */
+
+/* spread the bits of the given value to even positions (x -> nested index) */
+static mcsINT64 vobsTileSpreadBits(mcsINT64 value)
+{
+    mcsINT64 result = 0;
+    for (mcsINT32 i = 0; i < vobsTILE_CACHE_ORDER; i++)
+    {
+        result |= ((value >> i) & 1LL) << (2 * i);
+    }
+    return result;
+}
+
+/* compress the even bits of the given value (nested index -> x) */
+static mcsINT64 vobsTileCompressBits(mcsINT64 value)
+{
+    mcsINT64 result = 0;
+    for (mcsINT32 i = 0; i < vobsTILE_CACHE_ORDER; i++)
+    {
+        result |= ((value >> (2 * i)) & 1LL) << i;
+    }
+    return result;
+}
+
+/* return the '<key>#<tile index>' cache key */
+static string vobsTileGetEntryKey(const char* key, mcsINT64 tile)
+{
+    mcsSTRING32 tileId;
+    sprintf(tileId, "#%lld", (long long) tile);
+
+    string entryKey(key);
+    entryKey.append(tileId);
+    return entryKey;
+}
+
+/* merge the given property / catalog mapping into the destination mapping (same rule as vobsCDATA::Extract) */
+static void vobsTileMergePropertyCatalogMap(const vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING &source,
+                                            vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* dest)
+{
+    if (IS_NULL(dest))
+    {
+        return;
+    }
+    for (vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING::const_iterator iter = source.begin(); iter != source.end(); iter++)
+    {
+        bool add = true;
+
+        if (dest->count(iter->first) > 0)
+        {
+            std::pair<vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING::iterator, vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING::iterator> range = dest->equal_range(iter->first);
+
+            // Find the last catalogName:
+            range.second--;
+            if (strcmp(range.second->second, iter->second) == 0)
+            {
+                add = false;
+            }
+        }
+        if (add)
+        {
+            dest->insert(vobsCATALOG_STAR_PROPERTY_CATALOG_PAIR(iter->first, iter->second));
+        }
+    }
+}
+
+/*
+ * Crop the given star (area and magnitude range).
+ * Return true and its distance to the center (deg) if the star matches the given query
+ */
+static bool vobsTileMatch(const vobsTILE_QUERY &query, const vobsSTAR* star, mcsDOUBLE &distance)
+{
+    mcsDOUBLE ra, dec, mag;
+
+    if ((star->GetRaDec(ra, dec) == mcsFAILURE)
+            || (star->GetPropertyValue(query.magPropertyId, &mag) == mcsFAILURE))
+    {
+        // VizieR discards stars without magnitude when the magnitude range is given
+        errResetStack();
+        return false;
+    }
+
+    // note: query magnitudes are rounded to 0.01 like %.2lf in VizieR queries
+    if ((mag < query.minMag) || (mag > query.maxMag))
+    {
+        return false;
+    }
+
+    alxComputeDistanceInDegrees(query.ra, query.dec, ra, dec, &distance);
+
+    if (query.geometry == vobsBOX)
+    {
+        mcsDOUBLE deltaRa = ra - query.ra;
+        if (deltaRa > 180.0)
+        {
+            deltaRa -= 360.0;
+        }
+        else if (deltaRa < -180.0)
+        {
+            deltaRa += 360.0;
+        }
+        deltaRa *= cos(query.dec * alxDEG_IN_RAD);
+
+        return (fabs(deltaRa) * alxDEG_IN_ARCMIN <= 0.5 * query.deltaRa)
+                && (fabs(dec - query.dec) * alxDEG_IN_ARCMIN <= 0.5 * query.deltaDec);
+    }
+    return (distance * alxDEG_IN_ARCMIN <= query.radius);
+}
+
+/* copy stars of the given tile list matching the query into the candidate map (distance, star) */
+static void vobsTileCollect(const vobsTILE_QUERY &query, const vobsSTAR_LIST &tileList, vobsSTAR_PTR_DBL_MAP &candidates)
+{
+    mcsDOUBLE distance;
+    const mcsUINT32 nbStars = tileList.Size();
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        vobsSTAR* star = tileList.GetNextStar((mcsLOGICAL) (el == 0));
+
+        if (vobsTileMatch(query, star, distance))
+        {
+            candidates.insert(vobsSTAR_PTR_DBL_PAIR((query.sortByDistance) ? distance : 0.0, new vobsSTAR(*star)));
+        }
+    }
+}
+
+/* free the given tile entry */
+static void vobsTileFreeEntry(vobsTILE_ENTRY* entry)
+{
+    delete(entry->starList);
+    delete(entry);
+}
+
+/* free the given candidate stars */
+static void vobsTileFreeCandidates(vobsSTAR_PTR_DBL_MAP &candidates)
+{
+    for (vobsSTAR_PTR_DBL_MAP::iterator iter = candidates.begin(); iter != candidates.end(); iter++)
+    {
+        delete(iter->second);
+    }
+    candidates.clear();
+}
+
+/*
+ * Fetch the given tile at the fixed magnitude depth.
+ * Set entry to the new tile entry or NULL if the tile is incomplete (truncated result)
+ */
+static mcsCOMPL_STAT vobsTileFetch(mcsINT64 tile, vobsTILE_FETCHER &fetcher, vobsTILE_ENTRY* &entry)
+{
+    entry = NULL;
+
+    mcsDOUBLE tileRa, tileDec;
+    vobsTILE_CACHE::GetTileCenter(tile, tileRa, tileDec);
+
+    vobsSTAR_LIST fetchList("TileFetch");
+
+    // cached tiles are kept between requests (heap):
+    vobsARENA_SCOPE heapScope(false);
+
+    vobsTILE_ENTRY* newEntry = new vobsTILE_ENTRY();
+    newEntry->starList = new vobsSTAR_LIST("Tile");
+
+    bool truncated = false;
+    if (fetcher.FetchTile(tileRa, tileDec, vobsTILE_CACHE::GetTileRadius(), fetchList, &newEntry->propertyCatalogMap, truncated) == mcsFAILURE)
+    {
+        vobsTileFreeEntry(newEntry);
+        return mcsFAILURE;
+    }
+
+    if (truncated)
+    {
+        logInfo("Tile cache: tile %lld is incomplete (%d stars)", (long long) tile, fetchList.Size());
+
+        vobsTileFreeEntry(newEntry);
+        return mcsSUCCESS;
+    }
+
+    // keep only stars belonging to this tile (fetch cone overlaps neighbour tiles):
+    newEntry->starList->SetCatalogMeta(fetchList.GetCatalogId(), fetchList.GetCatalogMeta());
+
+    mcsDOUBLE ra, dec;
+    const mcsUINT32 nbStars = fetchList.Size();
+    for (mcsUINT32 el = 0; el < nbStars; el++)
+    {
+        vobsSTAR* star = fetchList.GetNextStar((mcsLOGICAL) (el == 0));
+
+        if ((star->GetRaDec(ra, dec) == mcsSUCCESS) && (vobsTILE_CACHE::GetTileIndex(ra, dec) == tile))
+        {
+            newEntry->starList->AddAtTail(*star);
+        }
+    }
+    errResetStack();
+
+    entry = newEntry;
+    return mcsSUCCESS;
+}
+
+/* store the given fetched tile entry (freed if the tile was fetched concurrently) */
+static void vobsTileStore(const char* key, mcsINT64 tile, vobsTILE_ENTRY* entry)
+{
+    string entryKey = vobsTileGetEntryKey(key, tile);
+
+    mcsMutexLock(&vobsTileCacheMutex);
+
+    vobsTileCacheMisses++;
+
+    if (vobsTileCacheMap.find(entryKey) != vobsTileCacheMap.end())
+    {
+        // concurrent fetch of the same tile:
+        vobsTileFreeEntry(entry);
+    }
+    else
+    {
+        vobsTileCacheLru.push_front(entryKey);
+        entry->lruPos = vobsTileCacheLru.begin();
+        vobsTileCacheMap.insert(vobsTILE_ENTRY_PTR_MAP::value_type(entryKey, entry));
+        vobsTileCacheNbStars += entry->starList->Size();
+
+        // Evict least recently used tiles (keep at least the new one):
+        while ((vobsTileCacheNbStars > vobsTILE_CACHE_MAX_STARS) && (vobsTileCacheLru.size() > 1))
+        {
+            vobsTILE_ENTRY_PTR_MAP::iterator iter = vobsTileCacheMap.find(vobsTileCacheLru.back());
+
+            vobsTileCacheNbStars -= iter->second->starList->Size();
+            vobsTileFreeEntry(iter->second);
+            vobsTileCacheMap.erase(iter);
+            vobsTileCacheLru.pop_back();
+            vobsTileCacheEvictions++;
+        }
+    }
+
+    mcsMutexUnlock(&vobsTileCacheMutex);
+}
+
+/*
+ * Fetch and store the missing tiles closest to the query center (at most
+ * vobsTILE_CACHE_MAX_FILLS) for later requests. Errors are logged only as the
+ * direct query serves the current request.
+ */
+static void vobsTileFill(const char* key, const vobsTILE_QUERY &query, vobsTILE_FETCHER &fetcher,
+                         const std::vector<mcsINT64> &missingTiles)
+{
+    // missing tiles sorted by distance to the center:
+    multimap<mcsDOUBLE, mcsINT64> sortedTiles;
+
+    mcsDOUBLE tileRa, tileDec, distance;
+    for (std::vector<mcsINT64>::const_iterator iter = missingTiles.begin(); iter != missingTiles.end(); iter++)
+    {
+        vobsTILE_CACHE::GetTileCenter(*iter, tileRa, tileDec);
+        alxComputeDistanceInDegrees(query.ra, query.dec, tileRa, tileDec, &distance);
+
+        sortedTiles.insert(pair<mcsDOUBLE, mcsINT64>(distance, *iter));
+    }
+
+    mcsUINT32 nbFills = 0;
+    for (multimap<mcsDOUBLE, mcsINT64>::const_iterator iter = sortedTiles.begin();
+            (iter != sortedTiles.end()) && (nbFills < vobsTILE_CACHE_MAX_FILLS); iter++, nbFills++)
+    {
+        vobsTILE_ENTRY* entry;
+        if (vobsTileFetch(iter->second, fetcher, entry) == mcsFAILURE)
+        {
+            errCloseStack();
+            return;
+        }
+        if (IS_NOT_NULL(entry))
+        {
+            vobsTileStore(key, iter->second, entry);
+        }
+    }
+}
+
+/*
+ * Public methods
+ */
+
+/**
+ * Serve the given primary query using cached tiles; missing tiles are fetched
+ * at the fixed magnitude depth using the given fetcher then cached.
+ *
+ * If too many tiles are missing (more than vobsTILE_CACHE_MAX_MISSES) or
+ * any fetched tile is incomplete (truncated result), the query is not
+ * served (served = false) and the caller must perform its usual query.
+ * In the first case, the missing tiles closest to the query center (at most
+ * vobsTILE_CACHE_MAX_FILLS) are fetched and cached for later requests.
+ *
+ * @param key cache key (catalog, band and query option)
+ * @param query area and magnitude range to serve
+ * @param fetcher tile fetcher used on cache misses
+ * @param list output star list (cleared)
+ * @param propertyCatalogMap property / catalog mapping to fill (may be NULL)
+ * @param served true if the query was served by the tile cache
+ *
+ * @return mcsSUCCESS on successful completion. Otherwise mcsFAILURE is returned.
+ */
+mcsCOMPL_STAT vobsTILE_CACHE::Search(const char* key,
+                                     const vobsTILE_QUERY &query,
+                                     vobsTILE_FETCHER &fetcher,
+                                     vobsSTAR_LIST &list,
+                                     vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                                     bool &served)
+{
+    served = false;
+
+    // Enclosing cone radius (arcmin):
+    mcsDOUBLE radius = query.radius;
+    if (query.geometry == vobsBOX)
+    {
+        radius = 0.5 * sqrt(query.deltaRa * query.deltaRa + query.deltaDec * query.deltaDec);
+    }
+
+    std::vector<mcsINT64> tiles;
+    GetTiles(query.ra, query.dec, radius, tiles);
+
+    const mcsUINT32 nbTiles = tiles.size();
+
+    // candidate stars sorted by distance (or insertion order):
+    vobsSTAR_PTR_DBL_MAP candidates;
+    vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING mapping;
+    std::vector<mcsINT64> missingTiles;
+
+    // 1. Serve cached tiles:
+    mcsMutexLock(&vobsTileCacheMutex);
+
+    std::vector<vobsTILE_ENTRY*> cachedTiles;
+    for (mcsUINT32 i = 0; i < nbTiles; i++)
+    {
+        vobsTILE_ENTRY_PTR_MAP::iterator iter = vobsTileCacheMap.find(vobsTileGetEntryKey(key, tiles[i]));
+
+        if (iter == vobsTileCacheMap.end())
+        {
+            missingTiles.push_back(tiles[i]);
+        }
+        else
+        {
+            cachedTiles.push_back(iter->second);
+        }
+    }
+    const mcsUINT32 nbHits = cachedTiles.size();
+    const mcsUINT32 nbMisses = missingTiles.size();
+
+    // Too many tiles to fetch: one direct query is cheaper than many tile queries
+    if (nbMisses > vobsTILE_CACHE_MAX_MISSES)
+    {
+        vobsTileCacheBypasses++;
+
+        mcsMutexUnlock(&vobsTileCacheMutex);
+
+        logInfo("Tile cache: %d tile(s) missing (max %d); tile cache not used", nbMisses, vobsTILE_CACHE_MAX_MISSES);
+
+        // fill the cache for later requests:
+        vobsTileFill(key, query, fetcher, missingTiles);
+
+        return mcsSUCCESS;
+    }
+
+    for (mcsUINT32 i = 0; i < nbHits; i++)
+    {
+        vobsTILE_ENTRY* entry = cachedTiles[i];
+
+        // move to front (most recently used):
+        vobsTileCacheLru.splice(vobsTileCacheLru.begin(), vobsTileCacheLru, entry->lruPos);
+
+        vobsTileCollect(query, *entry->starList, candidates);
+        vobsTileMergePropertyCatalogMap(entry->propertyCatalogMap, &mapping);
+    }
+    vobsTileCacheHits += nbHits;
+
+    mcsMutexUnlock(&vobsTileCacheMutex);
+
+    // 2. Fetch missing tiles (unlocked):
+    for (mcsUINT32 i = 0; i < nbMisses; i++)
+    {
+        const mcsINT64 tile = missingTiles[i];
+
+        vobsTILE_ENTRY* entry;
+        if (vobsTileFetch(tile, fetcher, entry) == mcsFAILURE)
+        {
+            vobsTileFreeCandidates(candidates);
+            return mcsFAILURE;
+        }
+        if (IS_NULL(entry))
+        {
+            logInfo("Tile cache: incomplete tile; tile cache not used");
+
+            vobsTileFreeCandidates(candidates);
+            return mcsSUCCESS;
+        }
+
+        vobsTileCollect(query, *entry->starList, candidates);
+        vobsTileMergePropertyCatalogMap(entry->propertyCatalogMap, &mapping);
+
+        // Store the new tile:
+        vobsTileStore(key, tile, entry);
+    }
+
+    // 3. Fill the output list (sorted by distance if needed, truncated to max size):
+    list.Clear();
+    list.SetCatalogMeta(query.catalogId, query.catalogMeta);
+
+    for (vobsSTAR_PTR_DBL_MAP::iterator iter = candidates.begin(); iter != candidates.end(); iter++)
+    {
+        if (list.Size() < query.maxSize)
+        {
+            list.AddRefAtTail(iter->second);
+        }
+        else
+        {
+            delete(iter->second);
+        }
+    }
+
+    vobsTileMergePropertyCatalogMap(mapping, propertyCatalogMap);
+
+    served = true;
+
+    logInfo("Tile cache: %d tile(s) hit, %d tile(s) missed: %d stars [total hits: %llu misses: %llu]",
+            nbHits, nbMisses, list.Size(),
+            (unsigned long long) vobsTileCacheHits, (unsigned long long) vobsTileCacheMisses);
+
+    return mcsSUCCESS;
+}
+
+/**
+ * Return the tile (HEALPix nested index) containing the given position
+ *
+ * @param ra right ascension (deg)
+ * @param dec declination (deg)
+ *
+ * @return tile index in [0; 12 x nside^2[
+ */
+mcsINT64 vobsTILE_CACHE::GetTileIndex(mcsDOUBLE ra, mcsDOUBLE dec)
+{
+    const mcsINT64 nside = vobsTILE_NSIDE;
+    const mcsDOUBLE z = sin(dec * alxDEG_IN_RAD);
+    const mcsDOUBLE za = fabs(z);
+
+    // tt in [0; 4[
+    mcsDOUBLE tt = fmod(ra / 90.0, 4.0);
+    if (tt < 0.0)
+    {
+        tt += 4.0;
+    }
+
+    mcsINT64 face, ix, iy;
+
+    if (za <= 2.0 / 3.0)
+    {
+        // equatorial region:
+        const mcsDOUBLE temp1 = nside * (0.5 + tt);
+        const mcsDOUBLE temp2 = nside * (z * 0.75);
+        const mcsINT64 jp = (mcsINT64) (temp1 - temp2);
+        const mcsINT64 jm = (mcsINT64) (temp1 + temp2);
+        const mcsINT64 ifp = jp >> vobsTILE_CACHE_ORDER;
+        const mcsINT64 ifm = jm >> vobsTILE_CACHE_ORDER;
+
+        face = (ifp == ifm) ? (ifp | 4) : ((ifp < ifm) ? ifp : (ifm + 8));
+        ix = jm & (nside - 1);
+        iy = nside - (jp & (nside - 1)) - 1;
+    }
+    else
+    {
+        // polar caps:
+        mcsINT32 ntt = (mcsINT32) tt;
+        if (ntt > 3)
+        {
+            ntt = 3;
+        }
+        const mcsDOUBLE tp = tt - ntt;
+        const mcsDOUBLE tmp = nside * sqrt(3.0 * (1.0 - za));
+
+        mcsINT64 jp = (mcsINT64) (tp * tmp);
+        mcsINT64 jm = (mcsINT64) ((1.0 - tp) * tmp);
+        jp = mcsMIN(jp, nside - 1);
+        jm = mcsMIN(jm, nside - 1);
+
+        if (z >= 0.0)
+        {
+            face = ntt;
+            ix = nside - jm - 1;
+            iy = nside - jp - 1;
+        }
+        else
+        {
+            face = ntt + 8;
+            ix = jp;
+            iy = jm;
+        }
+    }
+    return (face << (2 * vobsTILE_CACHE_ORDER)) + vobsTileSpreadBits(ix) + (vobsTileSpreadBits(iy) << 1);
+}
+
+/**
+ * Return the center of the given tile
+ *
+ * @param tile tile index (HEALPix nested index)
+ * @param ra right ascension (deg) in [0; 360[
+ * @param dec declination (deg)
+ */
+void vobsTILE_CACHE::GetTileCenter(mcsINT64 tile, mcsDOUBLE &ra, mcsDOUBLE &dec)
+{
+    static const mcsINT32 jrll[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+    static const mcsINT32 jpll[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+
+    const mcsINT64 nside = vobsTILE_NSIDE;
+    const mcsDOUBLE fact2 = 4.0 / (12.0 * nside * nside);
+    const mcsDOUBLE fact1 = (nside << 1) * fact2;
+
+    const mcsINT64 face = tile >> (2 * vobsTILE_CACHE_ORDER);
+    const mcsINT64 pixel = tile & ((1LL << (2 * vobsTILE_CACHE_ORDER)) - 1);
+    const mcsINT64 ix = vobsTileCompressBits(pixel);
+    const mcsINT64 iy = vobsTileCompressBits(pixel >> 1);
+
+    // ring index:
+    const mcsINT64 jr = ((mcsINT64) jrll[face] << vobsTILE_CACHE_ORDER) - ix - iy - 1;
+
+    mcsINT64 nr;
+    mcsDOUBLE z;
+    mcsINT32 kshift;
+
+    if (jr < nside)
+    {
+        nr = jr;
+        z = 1.0 - nr * nr * fact2;
+        kshift = 0;
+    }
+    else if (jr > 3 * nside)
+    {
+        nr = 4 * nside - jr;
+        z = nr * nr * fact2 - 1.0;
+        kshift = 0;
+    }
+    else
+    {
+        nr = nside;
+        z = (2 * nside - jr) * fact1;
+        kshift = (jr - nside) & 1;
+    }
+
+    mcsINT64 jp = (jpll[face] * nr + ix - iy + 1 + kshift) / 2;
+    if (jp > 4 * nside)
+    {
+        jp -= 4 * nside;
+    }
+    if (jp < 1)
+    {
+        jp += 4 * nside;
+    }
+
+    ra = (jp - (kshift + 1) * 0.5) * (90.0 / nr);
+    dec = asin(z) * alxRAD_IN_DEG;
+}
+
+/**
+ * Return all tiles intersecting the given cone (sorted by index)
+ *
+ * The cone enlarged by the tile radius is sampled on a grid finer than tiles,
+ * then tiles whose center is too far from the cone are discarded.
+ *
+ * @param ra cone center right ascension (deg)
+ * @param dec cone center declination (deg)
+ * @param radius cone radius (arcmin)
+ * @param tiles output tile indexes
+ */
+void vobsTILE_CACHE::GetTiles(mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius, std::vector<mcsINT64> &tiles)
+{
+    tiles.clear();
+
+    // all angles in degrees:
+    const mcsDOUBLE tileRadius = GetTileRadius() / alxDEG_IN_ARCMIN;
+    const mcsDOUBLE coneRadius = radius / alxDEG_IN_ARCMIN;
+    const mcsDOUBLE maxRadius = coneRadius + tileRadius;
+    const mcsDOUBLE step = 0.25 * GetTileResolution() / alxDEG_IN_ARCMIN;
+
+    std::set<mcsINT64> tileSet;
+    tileSet.insert(GetTileIndex(ra, dec));
+
+    const mcsDOUBLE decMin = mcsMAX(-90.0, dec - maxRadius);
+    const mcsDOUBLE decMax = mcsMIN(90.0, dec + maxRadius);
+    const bool pole = (fabs(dec) + maxRadius >= 89.0);
+
+    mcsDOUBLE raHalfWidth = 180.0;
+    if (!pole)
+    {
+        raHalfWidth = mcsMIN(180.0, maxRadius / cos((fabs(dec) + maxRadius) * alxDEG_IN_RAD) + step);
+    }
+
+    mcsDOUBLE distance;
+
+    for (mcsDOUBLE decPt = decMin; decPt <= decMax + step; decPt += step)
+    {
+        const mcsDOUBLE d = mcsMIN(decPt, decMax);
+        const mcsDOUBLE raStep = mcsMIN(360.0, step / mcsMAX(cos(d * alxDEG_IN_RAD), 1e-6));
+
+        for (mcsDOUBLE raPt = ra - raHalfWidth; raPt <= ra + raHalfWidth + raStep; raPt += raStep)
+        {
+            const mcsDOUBLE r = mcsMIN(raPt, ra + raHalfWidth);
+
+            alxComputeDistanceInDegrees(ra, dec, r, d, &distance);
+
+            if (distance <= maxRadius)
+            {
+                tileSet.insert(GetTileIndex(r, d));
+            }
+        }
+    }
+
+    // keep tiles that may intersect the cone:
+    mcsDOUBLE tileRa, tileDec;
+    for (std::set<mcsINT64>::const_iterator iter = tileSet.begin(); iter != tileSet.end(); iter++)
+    {
+        GetTileCenter(*iter, tileRa, tileDec);
+
+        alxComputeDistanceInDegrees(ra, dec, tileRa, tileDec, &distance);
+
+        if (distance <= maxRadius)
+        {
+            tiles.push_back(*iter);
+        }
+    }
+}
+
+/**
+ * Return the cache statistics
+ *
+ * @param hits number of tiles served from the cache
+ * @param misses number of tiles fetched
+ * @param evictions number of evicted tiles
+ * @param bypasses number of searches not served (too many missing tiles)
+ * @param nbStars number of cached stars
+ */
+void vobsTILE_CACHE::GetStats(mcsUINT64 &hits, mcsUINT64 &misses, mcsUINT64 &evictions, mcsUINT64 &bypasses, mcsUINT32 &nbStars)
+{
+    mcsMutexLock(&vobsTileCacheMutex);
+
+    hits = vobsTileCacheHits;
+    misses = vobsTileCacheMisses;
+    evictions = vobsTileCacheEvictions;
+    bypasses = vobsTileCacheBypasses;
+    nbStars = vobsTileCacheNbStars;
+
+    mcsMutexUnlock(&vobsTileCacheMutex);
+}
+
+/**
+ * Free all cached tiles (statistics are kept)
+ */
+void vobsTILE_CACHE::Clear(void)
+{
+    mcsMutexLock(&vobsTileCacheMutex);
+
+    for (vobsTILE_ENTRY_PTR_MAP::iterator iter = vobsTileCacheMap.begin(); iter != vobsTileCacheMap.end(); iter++)
+    {
+        vobsTileFreeEntry(iter->second);
+    }
+    vobsTileCacheMap.clear();
+    vobsTileCacheLru.clear();
+    vobsTileCacheNbStars = 0;
+
+    mcsMutexUnlock(&vobsTileCacheMutex);
+}
+
+
+/*___oOo___*/
@@ -109,5 +109,17 @@ mcsCOMPL_STAT vobsVIRTUAL_OBSERVATORY::Search(vobsSCENARIO *scenario,
     return mcsSUCCESS;
 }
 
+/**
+ * Define the deadline of the catalog queries of the next searches (one
+ * request): once the deadline is near, optional catalogs (vobsUPDATE_ONLY) are
+ * skipped or truncated and the results are partial (see IsPartial()).
+ *
+ * @param budget maximum duration (in seconds) or 0 if none
+ */
+void vobsVIRTUAL_OBSERVATORY::SetDeadline(mcsUINT32 budget)
+{
+    _ctx.SetDeadline(budget);
+}
+
 
 /*___oOo___*/
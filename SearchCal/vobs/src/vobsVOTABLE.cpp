@@ -320,8 +320,8 @@ mcsCOMPL_STAT vobsVOTABLE::GetVotable(const vobsSTAR_LIST& starList,
 
             strncpy(propertyInfos[propIdx], statBuf.GetBuffer(), sizeof (propertyInfos[propIdx]) - 1);
 
-            // Filter property (column) if no value set and trim column enabled:
-            if ((nbSet != 0) || !doTrimProperties)
+            // Filter property (column) if no value set and trim column enabled or optional property:
+            if ((nbSet != 0) || (!doTrimProperties && !property->GetMeta()->IsOptional()))
             {
                 filteredPropertyIndexes[filterPropIdx++] = propIdx;
                 propertyErrorField     [propIdx]         = (nbError != 0) || (!doTrimPropertiesFull && propErrorMeta);
@@ -0,0 +1,360 @@
+/*******************************************************************************
+ * JMMC project ( http://www.jmmc.fr ) - Copyright (C) CNRS.
+ ******************************************************************************/
+
+/**
+ * \file
+ * Test file on the sky tile cache (vobsTILE_CACHE) using a recorded response
+ * stand-in instead of VizieR queries.
+ */
+
+
+/*
+ * System Headers
+ */
+#include <stdlib.h>
+#include <iostream>
+#include <set>
+#include <string>
+
+/**
+ * \namespace std
+ * Export standard iostream objects (cin, cout,...).
+ */
+using namespace std;
+
+
+/*
+ * MCS Headers
+ */
+#include "mcs.h"
+#include "log.h"
+#include "err.h"
+
+/*
+ * SCALIB Headers
+ */
+#include "alx.h"
+
+/*
+ * Local Headers
+ */
+#include "vobs.h"
+#include "vobsPrivate.h"
+
+
+/*
+ * Local Variables
+ */
+
+/* recorded field center (deg) */
+#define FIELD_RA    83.82
+#define FIELD_DEC   -5.39
+/* recorded field radius (deg) */
+#define FIELD_RADIUS 1.5
+/* number of recorded stars */
+#define FIELD_NB_STARS 20000
+
+/**
+ * Recorded response stand-in: serves cone queries from a recorded star list
+ * (like VizieR would do) and counts fetched tiles.
+ */
+class vobsRECORDED_TILE_FETCHER : public vobsTILE_FETCHER
+{
+public:
+
+    vobsRECORDED_TILE_FETCHER(vobsSTAR_LIST &recorded) : _recorded(recorded)
+    {
+        _nbFetches = 0;
+    }
+
+    mcsCOMPL_STAT FetchTile(mcsDOUBLE ra, mcsDOUBLE dec, mcsDOUBLE radius,
+                            vobsSTAR_LIST &list,
+                            vobsCATALOG_STAR_PROPERTY_CATALOG_MAPPING* propertyCatalogMap,
+                            bool &truncated)
+    {
+        _nbFetches++;
+
+        mcsDOUBLE starRa, starDec, mag, distance;
+        for (mcsUINT32 el = 0; el < _recorded.Size(); el++)
+        {
+            vobsSTAR* star = _recorded.GetNextStar((mcsLOGICAL) (el == 0));
+
+            FAIL(star->GetRaDec(starRa, starDec));
+            FAIL(star->GetPropertyValue(vobsSTAR_PHOT_JHN_K, &mag));
+            FAIL(alxComputeDistanceInDegrees(ra, dec, starRa, starDec, &distance));
+
+            if ((distance * alxDEG_IN_ARCMIN <= radius)
+                    && (mag >= vobsTILE_CACHE_MAG_MIN) && (mag <= vobsTILE_CACHE_MAG_MAX))
+            {
+                list.AddAtTail(*star);
+            }
+        }
+        truncated = false;
+
+        return mcsSUCCESS;
+    }
+
+    mcsUINT32 _nbFetches;
+
+private:
+    vobsSTAR_LIST &_recorded;
+} ;
+
+/* format the given RA (deg) as 'HH MM SS.SSSS' */
+static void formatRa(mcsDOUBLE ra, mcsSTRING32 &raHms)
+{
+    ra /= 15.0;
+    const mcsINT32 hh = (mcsINT32) ra;
+    const mcsINT32 mm = (mcsINT32) ((ra - hh) * 60.0);
+    sprintf(raHms, "%02d %02d %07.4lf", hh, mm, ((ra - hh) * 60.0 - mm) * 60.0);
+}
+
+/* format the given DEC (deg) as '+DD MM SS.SSS' */
+static void formatDec(mcsDOUBLE dec, mcsSTRING32 &decDms)
+{
+    const char sign = (dec < 0.0) ? '-' : '+';
+    dec = fabs(dec);
+    const mcsINT32 dd = (mcsINT32) dec;
+    const mcsINT32 mm = (mcsINT32) ((dec - dd) * 60.0);
+    sprintf(decDms, "%c%02d %02d %06.3lf", sign, dd, mm, ((dec - dd) * 60.0 - mm) * 60.0);
+}
+
+/* return the star identifiers of the given list */
+static void getIds(vobsSTAR_LIST &list, set<string> &ids)
+{
+    ids.clear();
+    for (mcsUINT32 el = 0; el < list.Size(); el++)
+    {
+        ids.insert(string(list.GetNextStar((mcsLOGICAL) (el == 0))->GetPropertyValue(vobsSTAR_ID_2MASS)));
+    }
+}
+
+/* direct crop of the recorded field (reference result) */
+static mcsCOMPL_STAT crop(vobsSTAR_LIST &recorded, const vobsTILE_QUERY &query, set<string> &ids)
+{
+    ids.clear();
+
+    mcsDOUBLE ra, dec, mag, distance;
+    for (mcsUINT32 el = 0; el < recorded.Size(); el++)
+    {
+        vobsSTAR* star = recorded.GetNextStar((mcsLOGICAL) (el == 0));
+
+        FAIL(star->GetRaDec(ra, dec));
+        FAIL(star->GetPropertyValue(vobsSTAR_PHOT_JHN_K, &mag));
+        FAIL(alxComputeDistanceInDegrees(query.ra, query.dec, ra, dec, &distance));
+
+        bool inside;
+        if (query.geometry == vobsBOX)
+        {
+            inside = (fabs(ra - query.ra) * cos(query.dec * alxDEG_IN_RAD) * alxDEG_IN_ARCMIN <= 0.5 * query.deltaRa)
+                    && (fabs(dec - query.dec) * alxDEG_IN_ARCMIN <= 0.5 * query.deltaDec);
+        }
+        else
+        {
+            inside = (distance * alxDEG_IN_ARCMIN <= query.radius);
+        }
+
+        if (inside && (mag >= query.minMag) && (mag <= query.maxMag))
+        {
+            ids.insert(string(star->GetPropertyValue(vobsSTAR_ID_2MASS)));
+        }
+    }
+    return mcsSUCCESS;
+}
+
+/* run the given query through the tile cache and compare with the direct crop */
+static mcsCOMPL_STAT check(const char* name, vobsSTAR_LIST &recorded, vobsRECORDED_TILE_FETCHER &fetcher,
+                           const vobsTILE_QUERY &query)
+{
+    vobsSTAR_LIST list("TileList");
+    bool served = false;
+
+    FAIL(vobsTILE_CACHE::Search("II/246/out|K|", query, fetcher, list, NULL, served));
+
+    set<string> ids, refIds;
+    getIds(list, ids);
+    FAIL(crop(recorded, query, refIds));
+
+    mcsUINT64 hits, misses, evictions, bypasses;
+    mcsUINT32 nbStars;
+    vobsTILE_CACHE::GetStats(hits, misses, evictions, bypasses, nbStars);
+
+    logTest("%s: served=%s stars=%d (expected %d) fetches=%d hits=%llu misses=%llu",
+            name, served ? "true" : "false", list.Size(), (int) refIds.size(), fetcher._nbFetches,
+            (unsigned long long) hits, (unsigned long long) misses);
+
+    if (!served || (ids != refIds) || (list.Size() != refIds.size()))
+    {
+        logError("%s: tile cache result differs from the direct query", name);
+        return mcsFAILURE;
+    }
+    return mcsSUCCESS;
+}
+
+/*
+ * Main
+ */
+
+int main(int argc, char *argv[])
+{
+    // Initialize MCS services
+    if (mcsInit(argv[0]) == mcsFAILURE)
+    {
+        // Exit from the application with FAILURE
+        exit(EXIT_FAILURE);
+    }
+
+    logSetStdoutLogLevel(logTEST);
+    logSetPrintDate(mcsFALSE);
+    logSetPrintFileLine(mcsFALSE);
+
+    logInfo("Starting ...");
+
+    // Tile indexes:
+    mcsDOUBLE ra, dec;
+    for (mcsINT64 tile = 0; tile < 12LL << (2 * vobsTILE_CACHE_ORDER); tile += 97)
+    {
+        vobsTILE_CACHE::GetTileCenter(tile, ra, dec);
+
+        if (vobsTILE_CACHE::GetTileIndex(ra, dec) != tile)
+        {
+            logError("Tile %lld: center (%.6lf %.6lf) is not in this tile", (long long) tile, ra, dec);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Initialize star property meta data (first star):
+    {
+        vobsSTAR star;
+    }
+
+    // Record the field (deterministic):
+    vobsSTAR_LIST recorded("Recorded");
+    srand(1);
+    for (mcsINT32 i = 0; i < FIELD_NB_STARS; i++)
+    {
+        mcsSTRING32 raHms, decDms, id;
+
+        dec = FIELD_DEC + FIELD_RADIUS * (2.0 * rand() / RAND_MAX - 1.0);
+        ra = FIELD_RA + FIELD_RADIUS * (2.0 * rand() / RAND_MAX - 1.0) / cos(dec * alxDEG_IN_RAD);
+
+        formatRa(ra, raHms);
+        formatDec(dec, decDms);
+        sprintf(id, "J%08d", i);
+
+        vobsSTAR star;
+        star.SetPropertyValue(vobsSTAR_ID_2MASS, id, vobsNO_CATALOG_ID);
+        star.SetPropertyValue(vobsSTAR_POS_EQ_RA_MAIN, raHms, vobsNO_CATALOG_ID);
+        star.SetPropertyValue(vobsSTAR_POS_EQ_DEC_MAIN, decDms, vobsNO_CATALOG_ID);
+        star.SetPropertyValue(vobsSTAR_PHOT_JHN_K, 2.0 + 13.0 * rand() / RAND_MAX, vobsNO_CATALOG_ID);
+
+        recorded.AddAtTail(star);
+    }
+
+    vobsRECORDED_TILE_FETCHER fetcher(recorded);
+
+    vobsTILE_QUERY query;
+    query.ra = FIELD_RA;
+    query.dec = FIELD_DEC;
+    query.geometry = vobsCIRCLE;
+    query.radius = 20.0;
+    query.deltaRa = 0.0;
+    query.deltaDec = 0.0;
+    query.magPropertyId = vobsSTAR_PHOT_JHN_K;
+    query.minMag = 5.0;
+    query.maxMag = 12.0;
+    query.maxSize = 100000;
+    query.sortByDistance = true;
+    query.catalogId = vobsCATALOG_MASS_ID;
+    query.catalogMeta = NULL;
+
+    // 1. cold cache: not served while missing tiles are filled for later requests
+    {
+        mcsINT32 nbSearches = 0;
+        bool served = false;
+
+        while (!served)
+        {
+            const mcsUINT32 nbFetchesBefore = fetcher._nbFetches;
+
+            vobsSTAR_LIST list("TileList");
+            if (vobsTILE_CACHE::Search("II/246/out|K|", query, fetcher, list, NULL, served) == mcsFAILURE)
+            {
+                exit(EXIT_FAILURE);
+            }
+            nbSearches++;
+
+            if ((!served && (fetcher._nbFetches - nbFetchesBefore != vobsTILE_CACHE_MAX_FILLS))
+                    || (fetcher._nbFetches - nbFetchesBefore > vobsTILE_CACHE_MAX_MISSES) || (nbSearches > 100))
+            {
+                logError("Cold cone: %d tile(s) fetched by search %d (served=%s)",
+                         fetcher._nbFetches - nbFetchesBefore, nbSearches, served ? "true" : "false");
+                exit(EXIT_FAILURE);
+            }
+        }
+        logTest("Cold cone: served after %d searches (%d fetches)", nbSearches, fetcher._nbFetches);
+    }
+    if (check("Cone", recorded, fetcher, query) == mcsFAILURE)
+    {
+        exit(EXIT_FAILURE);
+    }
+    const mcsUINT32 nbFetches = fetcher._nbFetches;
+
+    // 2. same query: only hits
+    if (check("Cone (again)", recorded, fetcher, query) == mcsFAILURE)
+    {
+        exit(EXIT_FAILURE);
+    }
+    if (fetcher._nbFetches != nbFetches)
+    {
+        logError("Cached tiles were fetched again");
+        exit(EXIT_FAILURE);
+    }
+
+    // 3. overlapping query (other magnitude range):
+    query.ra += 0.1;
+    query.radius = 12.0;
+    query.minMag = 3.0;
+    query.maxMag = 10.5;
+    if (check("Overlapping cone", recorded, fetcher, query) == mcsFAILURE)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // 4. box:
+    query.geometry = vobsBOX;
+    query.deltaRa = 30.0;
+    query.deltaDec = 15.0;
+    if (check("Box", recorded, fetcher, query) == mcsFAILURE)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // 5. large cone (too many missing tiles): not served, a few tiles filled
+    {
+        const mcsUINT32 nbFetchesBefore = fetcher._nbFetches;
+
+        query.geometry = vobsCIRCLE;
+        query.radius = 120.0;
+
+        vobsSTAR_LIST list("TileList");
+        bool served = true;
+        if ((vobsTILE_CACHE::Search("II/246/out|K|", query, fetcher, list, NULL, served) == mcsFAILURE)
+                || served || (fetcher._nbFetches - nbFetchesBefore != vobsTILE_CACHE_MAX_FILLS))
+        {
+            logError("Large cone: tile cache used (served=%s fetches=%d)", served ? "true" : "false",
+                     fetcher._nbFetches - nbFetchesBefore);
+            exit(EXIT_FAILURE);
+        }
+        logTest("Large cone: served=false");
+    }
+
+    vobsTILE_CACHE::Clear();
+
+    logInfo("Exiting ...");
+    exit(EXIT_SUCCESS);
+}
+
+
+/*___oOo___*/